@@ -2,6 +2,7 @@
 #include <stdbool.h>
 #include <assert.h>
 #include <math.h>
+#include <string.h>
 
 #include "average_results.h"
 #include "float_ring_buffer.h"
@@ -140,32 +141,47 @@ int low_pass_filter_IIR(const struct aoa_results *results, struct aoa_results* f
 
 int low_pass_filter_FIR(const struct aoa_results *results, struct aoa_results* filtered)
 {
-	if (results == NULL || filtered == NULL) {
-		return -EINVAL;
-	}
-
-	static struct float_ring_buffer azimuth_buffer;
-	static struct float_ring_buffer elevation_buffer;
+	static struct fir_filter filter;
 
 	static bool init = false;
 	if (init == false) {
-		ring_buffer_init(&azimuth_buffer);
-		ring_buffer_init(&elevation_buffer);
+		fir_filter_init(&filter);
 
 		init = true;
 	}
 
+	return fir_filter_process(&filter, results, filtered);
+}
+
+void fir_filter_init(struct fir_filter *filter)
+{
+	assert(filter != NULL);
+
+	ring_buffer_init(&filter->azimuth_buffer);
+	ring_buffer_init(&filter->elevation_buffer);
+}
+
+int fir_filter_process(struct fir_filter *filter,
+		       const struct aoa_results *results,
+		       struct aoa_results *filtered)
+{
+	if (filter == NULL || results == NULL || filtered == NULL) {
+		return -EINVAL;
+	}
+
+	struct float_ring_buffer *azimuth_buffer = &filter->azimuth_buffer;
+	struct float_ring_buffer *elevation_buffer = &filter->elevation_buffer;
 	struct complex angle;
 
 	angle = angle_to_complex(results->raw_result.azimuth);
-	ring_buffer_push(&azimuth_buffer, &angle);
+	ring_buffer_push(azimuth_buffer, &angle);
 	angle = angle_to_complex(results->raw_result.elevation);
-	ring_buffer_push(&elevation_buffer, &angle);
+	ring_buffer_push(elevation_buffer, &angle);
 
 	struct complex azimuth_filtered = { 0.0, 0.0 };
 	struct complex elevation_filtered = { 0.0, 0.0 };
 
-	size_t len = ring_buffer_len(&azimuth_buffer);
+	size_t len = ring_buffer_len(azimuth_buffer);
 	float alpha = (len == 1) ? 1.0: 2.0/(float)len;
 	float dt = alpha/(len+1);
 
@@ -177,7 +193,7 @@ int low_pass_filter_FIR(const struct aoa_results *results, struct aoa_results* f
 
 	struct float_ring_buffer_iter iter;
 
-	ring_buffer_get_iterator(&azimuth_buffer, &iter);
+	ring_buffer_get_iterator(azimuth_buffer, &iter);
 
 	struct complex sample = {0.0, 0.0};
 	while(ring_buffer_iter_is_end(&iter) == false){
@@ -190,7 +206,7 @@ int low_pass_filter_FIR(const struct aoa_results *results, struct aoa_results* f
 		ring_buffer_iter_advance(&iter);
 	}
 
-	ring_buffer_get_iterator(&elevation_buffer, &iter);
+	ring_buffer_get_iterator(elevation_buffer, &iter);
 
 	alpha = dt;
 
@@ -209,6 +225,105 @@ int low_pass_filter_FIR(const struct aoa_results *results, struct aoa_results* f
 	return 0;
 }
 
+/** Wraps angle difference to range (-180, 180] degrees
+ *
+ * @param[in] angle	Angle difference in degrees
+ *
+ * @retrun Returns the shortest difference on unit circle.
+ */
+static float wrap_angle_diff(float angle)
+{
+	angle = fmodf(angle, 360.0f);
+
+	if (angle > 180.0f) {
+		angle -= 360.0f;
+	} else if (angle <= -180.0f) {
+		angle += 360.0f;
+	}
+
+	return angle;
+}
+
+/** Wraps angle to range [0, 360) degrees
+ *
+ * @param[in] angle	Angle in degrees
+ *
+ * @retrun Returns wrapped angle.
+ */
+static float wrap_angle(float angle)
+{
+	angle = fmodf(angle, 360.0f);
+
+	return (angle >= 0.0f) ? angle : (360.0f + angle);
+}
+
+static void angle_tracker_axis_update(struct angle_tracker *tracker,
+				      struct angle_tracker_axis *axis,
+				      float measured)
+{
+	float predicted = axis->angle + axis->rate;
+	float residual = wrap_angle_diff(measured - predicted);
+
+	if (tracker->gate > 0.0f && fabsf(residual) > tracker->gate) {
+		++tracker->outliers;
+
+		if (++axis->rejected <= ANGLE_TRACKER_MAX_REJECTED) {
+			/* Coast on prediction, the measurement is ignored */
+			axis->angle = wrap_angle(predicted);
+			return;
+		}
+
+		/* Too many rejections, the angle really changed */
+		axis->angle = measured;
+		axis->rate = 0.0f;
+		axis->rejected = 0;
+		return;
+	}
+
+	axis->rejected = 0;
+	axis->angle = wrap_angle(predicted + (tracker->alpha * residual));
+	axis->rate += tracker->beta * residual;
+}
+
+void angle_tracker_init(struct angle_tracker *tracker, float alpha, float beta,
+			float gate)
+{
+	assert(tracker != NULL);
+	assert(alpha > 0.0f && alpha <= 1.0f);
+	assert(beta >= 0.0f && beta < 2.0f);
+
+	memset(tracker, 0, sizeof(*tracker));
+
+	tracker->alpha = alpha;
+	tracker->beta = beta;
+	tracker->gate = gate;
+}
+
+int angle_tracker_update(struct angle_tracker *tracker,
+			 const struct aoa_results *results,
+			 struct aoa_results *filtered)
+{
+	if (tracker == NULL || results == NULL || filtered == NULL) {
+		return -EINVAL;
+	}
+
+	if (!tracker->started) {
+		tracker->azimuth.angle = results->raw_result.azimuth;
+		tracker->elevation.angle = results->raw_result.elevation;
+		tracker->started = true;
+	} else {
+		angle_tracker_axis_update(tracker, &tracker->azimuth,
+					  results->raw_result.azimuth);
+		angle_tracker_axis_update(tracker, &tracker->elevation,
+					  results->raw_result.elevation);
+	}
+
+	filtered->raw_result.azimuth = tracker->azimuth.angle;
+	filtered->raw_result.elevation = tracker->elevation.angle;
+
+	return 0;
+}
+
 static struct complex angle_to_complex(float angle)
 {
 	assert( angle >= 0.0f && angle < 360.0f );
@@ -1,7 +1,20 @@
 #ifndef SRC_AVERAGE_RESULTS_H_
 #define SRC_AVERAGE_RESULTS_H_
 
+#include <stdbool.h>
+#include <zephyr/types.h>
+
 #include "aoa.h"
+#include "float_ring_buffer.h"
+
+/** @brief State of FIR filter of azimuth and elevation angles
+ *
+ * Separate instance is required for every filtered source of angles.
+ */
+struct fir_filter {
+	struct float_ring_buffer azimuth_buffer;
+	struct float_ring_buffer elevation_buffer;
+};
 
 /** @brief Evaluates average value of azimuth and elevation angles
  *
@@ -56,4 +69,93 @@ int low_pass_filter_IIR(const struct aoa_results *results, struct aoa_results* f
  */
 int low_pass_filter_FIR(const struct aoa_results *results, struct aoa_results* filtered);
 
+/** @brief Initializes FIR filter state
+ *
+ * @param[out]	filter		filter state
+ */
+void fir_filter_init(struct fir_filter *filter);
+
+/** @brief Does FIR filtration of azimuth and elevation angles using provided state
+ *
+ * The same as @ref low_pass_filter_FIR, but historical data are stored in
+ * @p filter instead of internal ring buffers.
+ *
+ * @param[in,out]	filter		filter state, initialized by @ref fir_filter_init
+ * @param[in]		results		current results
+ * @param[out]		filtered	filtered results
+ *
+ * @retval		zero if average evaluated successfully
+ * @retval		-EINVAL if @p filter, @p results or @p average is a NULL pointer
+ */
+int fir_filter_process(struct fir_filter *filter,
+		       const struct aoa_results *results,
+		       struct aoa_results *filtered);
+
+/** @brief Number of consecutive measurements rejected by outlier gate
+ * after which the angle tracker is restarted from the current measurement.
+ *
+ * It allows to follow a real, sudden change of the angle.
+ */
+#define ANGLE_TRACKER_MAX_REJECTED 3
+
+/** @brief State of a single angle tracked by alpha-beta filter */
+struct angle_tracker_axis {
+	/** Estimated angle in degrees, in range [0, 360) */
+	float angle;
+	/** Estimated angle change per update in degrees */
+	float rate;
+	/** Number of consecutive measurements rejected by outlier gate */
+	u8_t rejected;
+};
+
+/** @brief State of alpha-beta tracker of azimuth and elevation angles
+ *
+ * The tracker uses constant velocity model. Angles are treated as points
+ * on unit circle, so the difference between measured and predicted angle
+ * is always taken the shorter way around (e.g. 359 and 1 degree differ
+ * by 2 degrees).
+ */
+struct angle_tracker {
+	struct angle_tracker_axis azimuth;
+	struct angle_tracker_axis elevation;
+	/** Gain applied to angle residual */
+	float alpha;
+	/** Gain applied to angle rate */
+	float beta;
+	/** Measurements that differ from prediction by more than gate [deg]
+	 * are rejected. Zero disables the gate.
+	 */
+	float gate;
+	/** Number of measurements rejected by outlier gate */
+	u32_t outliers;
+	/** True if the tracker received first measurement */
+	bool started;
+};
+
+/** @brief Initializes alpha-beta angle tracker
+ *
+ * @param[out]	tracker		tracker state
+ * @param[in]	alpha		gain applied to angle residual, in range (0, 1]
+ * @param[in]	beta		gain applied to angle rate, in range [0, 2)
+ * @param[in]	gate		outlier gate in degrees, zero disables the gate
+ */
+void angle_tracker_init(struct angle_tracker *tracker, float alpha, float beta,
+			float gate);
+
+/** @brief Updates alpha-beta tracker with current results
+ *
+ * The function costs the same regardless of tracker history, there is no
+ * buffer of historical data.
+ *
+ * @param[in,out]	tracker		tracker state
+ * @param[in]		results		current results
+ * @param[out]		filtered	tracked angles
+ *
+ * @retval		zero if angles tracked successfully
+ * @retval		-EINVAL if @p tracker, @p results or @p filtered is a NULL pointer
+ */
+int angle_tracker_update(struct angle_tracker *tracker,
+			 const struct aoa_results *results,
+			 struct aoa_results *filtered);
+
 #endif /* SRC_AVERAGE_RESULTS_H_ */
@@ -4,12 +4,203 @@
  * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
  */
 
+#include <errno.h>
+#include <kernel.h>
+#include <sys/atomic.h>
 #include <sys/printk.h>
 #include <bluetooth/bluetooth.h>
 #include <bluetooth/hci.h>
 
 #include "ble.h"
 
+/** @brief Queue defined by BLE Controller to provide IQ samples data
+ */
+extern struct k_msgq df_packet_msgq;
+
+/** @brief Minimum number of an advertiser's reports that followed a CTE */
+#define ADV_CTE_REPORTS_MIN 4
+/** @brief Reports counters are halved when this number is reached */
+#define ADV_REPORTS_WINDOW 32
+
+/** @brief Advertiser whose reports are checked for CTE */
+struct adv_entry {
+	/** Address of the advertiser */
+	bt_addr_le_t addr;
+	/** Number of advertising reports received */
+	u8_t reports;
+	/** Number of advertising reports that followed a CTE */
+	u8_t cte_reports;
+	/** Value of @ref g_adv_seq when the advertiser was last seen */
+	u32_t last_seen;
+};
+
+/** @brief Advertisers in range, accessed by Bluetooth RX thread only */
+static struct adv_entry g_advs[CONFIG_AOA_LOCATOR_CTE_ADVERTISERS_MAX];
+/** @brief Number of used entries in @ref g_advs */
+static size_t g_advs_num;
+/** @brief Number of advertising reports received */
+static u32_t g_adv_seq;
+
+/** @brief Storage of CTE reports, filled in place by Bluetooth RX thread */
+K_MEM_SLAB_DEFINE(cte_report_slab, sizeof(struct ble_cte_report),
+		  CONFIG_AOA_LOCATOR_CTE_REPORTS_NUM, 4);
+
+/** @brief CTE reports paired with advertiser address */
+K_MSGQ_DEFINE(cte_report_msgq, sizeof(struct ble_cte_report *),
+	      CONFIG_AOA_LOCATOR_CTE_REPORTS_NUM, 4);
+
+static atomic_t g_cte_paired;
+static atomic_t g_cte_unidentified;
+static atomic_t g_cte_overflow;
+
+/** @brief Checks if most of advertiser's reports followed a CTE */
+static bool adv_sends_cte(const struct adv_entry *adv)
+{
+	return (adv->cte_reports >= ADV_CTE_REPORTS_MIN) &&
+	       (2 * adv->cte_reports > adv->reports);
+}
+
+/** @brief Checks if entry @p a should be reused before entry @p b */
+static bool adv_reuse_before(const struct adv_entry *a,
+			     const struct adv_entry *b)
+{
+	if (a->cte_reports != b->cte_reports) {
+		return a->cte_reports < b->cte_reports;
+	}
+
+	return (s32_t)(a->last_seen - b->last_seen) < 0;
+}
+
+/** @brief Finds entry of an advertiser or reuses one for it
+ *
+ * If the table is full, entry of the advertiser with the fewest reports
+ * that followed a CTE is reused, the least recently seen one if there are
+ * more. Advertisers that do not send CTE are replaced first, so they do not
+ * evict advertisers sending CTE before they are recognized.
+ */
+static struct adv_entry *adv_get(const bt_addr_le_t *addr)
+{
+	struct adv_entry *oldest = NULL;
+	struct adv_entry *adv;
+
+	for (size_t idx = 0; idx < g_advs_num; ++idx) {
+		adv = &g_advs[idx];
+
+		if (!bt_addr_le_cmp(&adv->addr, addr)) {
+			adv->last_seen = g_adv_seq;
+			return adv;
+		}
+
+		if (!oldest || adv_reuse_before(adv, oldest)) {
+			oldest = adv;
+		}
+	}
+
+	if (g_advs_num < ARRAY_SIZE(g_advs)) {
+		adv = &g_advs[g_advs_num++];
+	} else {
+		adv = oldest;
+	}
+
+	bt_addr_le_copy(&adv->addr, addr);
+	adv->reports = 0;
+	adv->cte_reports = 0;
+	adv->last_seen = g_adv_seq;
+
+	return adv;
+}
+
+/** @brief Counts advertising report, returns true if advertiser sends CTE */
+static bool adv_report(const bt_addr_le_t *addr, bool cte)
+{
+	struct adv_entry *adv;
+
+	++g_adv_seq;
+	adv = adv_get(addr);
+
+	if (adv->reports == ADV_REPORTS_WINDOW) {
+		adv->reports /= 2;
+		adv->cte_reports /= 2;
+	}
+
+	++adv->reports;
+	if (cte) {
+		++adv->cte_reports;
+	}
+
+	return adv_sends_cte(adv);
+}
+
+/** @brief Pairs IQ samples with the advertising report of the same PDU
+ *
+ * Controller queues IQ samples of a CTE before the report of the PDU that
+ * carried it is provided to the host. If exactly one packet is pending when
+ * a report arrives, it is paired with that advertiser, but only if most of
+ * the advertiser's reports follow a CTE. Otherwise the report of the PDU
+ * with CTE was lost and the report belongs to another advertiser, which may
+ * not send CTE at all. If more packets are pending, reports of other PDUs
+ * were lost or are still to come. In both cases source of the samples is
+ * unknown and they are dropped.
+ */
+static void scan_cb(const bt_addr_le_t *addr, s8_t rssi, u8_t adv_type,
+		    struct net_buf_simple *buf)
+{
+	u32_t pending = k_msgq_num_used_get(&df_packet_msgq);
+	struct ble_cte_report *report;
+
+	if (pending > 1) {
+		k_msgq_purge(&df_packet_msgq);
+		atomic_add(&g_cte_unidentified, pending);
+		return;
+	}
+
+	if (!adv_report(addr, pending == 1)) {
+		if (pending == 1) {
+			k_msgq_purge(&df_packet_msgq);
+			atomic_inc(&g_cte_unidentified);
+		}
+		return;
+	}
+
+	if (pending == 0) {
+		return;
+	}
+
+	if (k_mem_slab_alloc(&cte_report_slab, (void **)&report, K_NO_WAIT)) {
+		k_msgq_purge(&df_packet_msgq);
+		atomic_inc(&g_cte_overflow);
+		return;
+	}
+
+	if (k_msgq_get(&df_packet_msgq, &report->packet, K_NO_WAIT)) {
+		k_mem_slab_free(&cte_report_slab, (void **)&report);
+		return;
+	}
+
+	bt_addr_le_copy(&report->addr, addr);
+
+	/* Queue holds as many reports as the slab, so there is room */
+	(void)k_msgq_put(&cte_report_msgq, &report, K_NO_WAIT);
+
+	atomic_inc(&g_cte_paired);
+}
+
+int ble_cte_report_get(struct ble_cte_report **report, k_timeout_t timeout)
+{
+	return k_msgq_get(&cte_report_msgq, report, timeout);
+}
+
+void ble_cte_report_release(struct ble_cte_report *report)
+{
+	k_mem_slab_free(&cte_report_slab, (void **)&report);
+}
+
+void ble_cte_stats_get(struct ble_cte_stats *stats)
+{
+	stats->paired = atomic_get(&g_cte_paired);
+	stats->unidentified = atomic_get(&g_cte_unidentified);
+	stats->overflow = atomic_get(&g_cte_overflow);
+}
 
 int ble_initialization(void)
 {
@@ -31,7 +222,7 @@ int ble_initialization(void)
 	}
 
 	printk("[BT] Starting scanning\r\n");
-	err = bt_le_scan_start(&scan_param, NULL);
+	err = bt_le_scan_start(&scan_param, scan_cb);
 	if (err)
 	{
 		printk("[BT] Start scanning failed (err %d)\n", err);
@@ -7,8 +7,62 @@
 #ifndef __BLE_H
 #define __BLE_H
 
+#include <kernel.h>
+#include <bluetooth/addr.h>
+#include <bluetooth/dfe_data.h>
+
 /** @brief Initialize Bluetooth stack and starts scanning
  */
 int ble_initialization();
 
+/** @brief IQ samples of a CTE together with address of its source */
+struct ble_cte_report {
+	/** Address of the advertiser that sent the CTE */
+	bt_addr_le_t addr;
+	/** IQ samples received by the controller */
+	struct dfe_packet packet;
+};
+
+/** @brief Statistics of pairing CTEs with advertising reports */
+struct ble_cte_stats {
+	/** Number of CTEs paired with advertiser address */
+	u32_t paired;
+	/** Number of CTEs dropped because their source was not identified */
+	u32_t unidentified;
+	/** Number of paired CTEs dropped because reports queue was full */
+	u32_t overflow;
+};
+
+/** @brief Provides IQ samples of a CTE and address of the advertiser
+ *
+ * DFE packet header provided by the controller does not hold advertiser
+ * address. IQ samples are paired with the advertising report of the PDU
+ * that carried the CTE, if the advertiser is known to send CTE. CTEs whose
+ * source can not be identified are dropped, so every provided report has
+ * a valid address.
+ *
+ * Report is not copied, it must be released with
+ * @ref ble_cte_report_release when it is processed.
+ *
+ * @param[out] report	CTE report
+ * @param[in] timeout	Time to wait for a report
+ *
+ * @retval 0		report provided
+ * @retval -ENOMSG	no report available and timeout is K_NO_WAIT
+ * @retval -EAGAIN	waiting period timed out
+ */
+int ble_cte_report_get(struct ble_cte_report **report, k_timeout_t timeout);
+
+/** @brief Releases CTE report provided by @ref ble_cte_report_get
+ *
+ * @param[in] report	CTE report
+ */
+void ble_cte_report_release(struct ble_cte_report *report);
+
+/** @brief Provides statistics of pairing CTEs with advertising reports
+ *
+ * @param[out] stats	Statistics
+ */
+void ble_cte_stats_get(struct ble_cte_stats *stats);
+
 #endif
@@ -9,39 +9,43 @@
 #include <assert.h>
 #include <zephyr/types.h>
 #include <kernel.h>
+#include <sys/util.h>
 
 #include "dfe_local_config.h"
 #include "dfe_data_preprocess.h"
+#include "dfe_raw_samples.h"
 
-void dfe_map_iq_samples_to_antennas(struct dfe_mapped_packet *mapped_data,
-									struct dfe_iq_data_storage *iq_storage,
-									struct dfe_slot_samples_storage *slots_storage,
-									const struct dfe_packet *raw_data,
-									const struct dfe_sampling_config *sampling_conf,
-									const struct dfe_antenna_config *ant_config)
+void dfe_packet_view_init(struct dfe_packet_view *view,
+			  const struct dfe_packet *raw_data,
+			  const struct dfe_sampling_config *sampling_conf,
+			  const struct dfe_antenna_config *ant_config)
 {
+	assert(view != NULL);
 	assert(raw_data != NULL);
-	assert(mapped_data != NULL);
+	assert(sampling_conf != NULL);
+	assert(ant_config != NULL);
 
-	u16_t ref_samples_num = get_ref_samples_num(sampling_conf);
-	mapped_data->ref_data.antenna_id = ant_config->ref_ant_idx;
+	u16_t available = raw_data->hdr.length;
 
-	for(uint16_t idx = 0; idx < ref_samples_num; ++idx) {
-		mapped_data->ref_data.data[idx].i = raw_data->data[idx].iq.i;
-		mapped_data->ref_data.data[idx].q = raw_data->data[idx].iq.q;
-	}
-	mapped_data->ref_data.samples_num = ref_samples_num;
+	view->raw_data = raw_data;
+	view->ant_config = ant_config;
+	view->ref_samples_num = MIN(get_ref_samples_num(sampling_conf), available);
+	view->samples_num = dfe_get_sampling_slot_samples_num(sampling_conf);
 
 	/* Depending on DFE duration, the number of antennas used for sample
 	 * may be greater than the number of antennas in configuration.
 	 * If there is time left after end of antennas sequence, then radio
 	 * starts to use the same antennas again.
 	 */
-	u16_t effective_slots_num = dfe_get_effective_slots_num(sampling_conf);
+	u16_t slots_num = dfe_get_effective_slots_num(sampling_conf);
 
-	u8_t samples_num = dfe_get_sampling_slot_samples_num(sampling_conf);
-
-	u8_t effective_sample_idx;
+	if (view->samples_num > 0) {
+		available -= view->ref_samples_num;
+		slots_num = MIN(slots_num, available / view->samples_num);
+	} else {
+		slots_num = 0;
+	}
+	view->slots_num = slots_num;
 
 	enum dfe_sampling_type sampling_type = dfe_get_sampling_type(sampling_conf);
 
@@ -55,58 +59,145 @@ void dfe_map_iq_samples_to_antennas(struct dfe_mapped_packet *mapped_data,
 	 * For over sampling radio takes samples even in switching slot, so antenna
 	 * step is slower than slots number increate by factor of two.
 	 */
-	u16_t ant_step = 1;
-	if(sampling_type == DFE_UNDER_SAMPLING)
-	{
+	view->ant_step = 1;
+	if (sampling_type == DFE_UNDER_SAMPLING) {
 		u16_t sampl_spacing = dfe_get_sample_spacing_ns(sampling_conf->sample_spacing);
 		u16_t switch_spacing = dfe_get_switch_spacing_ns(sampling_conf->switch_spacing);
 
 		assert(switch_spacing > 0);
-		ant_step = sampl_spacing/switch_spacing;
+		view->ant_step = sampl_spacing/switch_spacing;
+	}
+	view->over_sampling = (sampling_type == DFE_OVER_SAMPLING);
+}
+
+void dfe_slot_iter_init(struct dfe_slot_iter *iter,
+			const struct dfe_packet_view *view,
+			bool skip_switch_slots)
+{
+	assert(iter != NULL);
+	assert(view != NULL);
+
+	iter->view = view;
+	iter->slot_idx = 0;
+	iter->ant_idx = 0;
+	iter->skip_switch_slots = skip_switch_slots;
+}
+
+bool dfe_slot_iter_next(struct dfe_slot_iter *iter, struct dfe_slot_span *span)
+{
+	assert(iter != NULL);
+	assert(span != NULL);
+
+	const struct dfe_packet_view *view = iter->view;
+	const struct dfe_antenna_config *ant_config = view->ant_config;
+
+	/* In over sampling every odd slot is a switch slot */
+	if (view->over_sampling && (iter->slot_idx & 0x1) &&
+	    iter->skip_switch_slots) {
+		++iter->slot_idx;
 	}
 
-	for(u16_t slot_idx = 0, ant_idx = 0; slot_idx < effective_slots_num; ++slot_idx) {
-		u8_t ant;
-		struct dfe_samples *sample = &slots_storage->data[slot_idx];
-
-		if (sampling_type == DFE_OVER_SAMPLING) {
-			if (slot_idx & 0x1) {
-				ant = DFE_ANT_INCORRECT;
-			} else {
-				ant = ant_config->antennae_switch_idx[ant_idx];
-				ant_idx += ant_step;
-				if (ant_idx >= ant_config->antennae_switch_idx_len) {
-					ant_idx = 0;
-				}
-			}
-		} else {
-			ant = ant_config->antennae_switch_idx[ant_idx];
-			ant_idx += ant_step;
-			if (ant_idx >= ant_config->antennae_switch_idx_len) {
-				ant_idx = 0;
-			}
+	if (iter->slot_idx >= view->slots_num) {
+		return false;
+	}
+
+	u8_t ant;
+
+	if (view->over_sampling && (iter->slot_idx & 0x1)) {
+		ant = DFE_ANT_INCORRECT;
+	} else {
+		ant = ant_config->antennae_switch_idx[iter->ant_idx];
+		iter->ant_idx += view->ant_step;
+		if (iter->ant_idx >= ant_config->antennae_switch_idx_len) {
+			iter->ant_idx = 0;
 		}
+	}
+
+	span->antenna_id = ant;
+	span->samples_num = view->samples_num;
+	span->slot_idx = iter->slot_idx;
+	span->first_sample = dfe_raw_sample_idx(view->ref_samples_num,
+						iter->slot_idx, view->samples_num, 0);
+
+	++iter->slot_idx;
+
+	return true;
+}
+
+/** @brief Stores samples provided by the iterator in mapped data */
+static void map_slots(struct dfe_mapped_packet *mapped_data,
+		      struct dfe_iq_data_storage *iq_storage,
+		      struct dfe_slot_samples_storage *slots_storage,
+		      const struct dfe_packet_view *view,
+		      bool skip_switch_slots)
+{
+	assert(mapped_data != NULL);
+	assert(iq_storage != NULL);
+	assert(slots_storage != NULL);
+
+	mapped_data->ref_data.antenna_id = view->ant_config->ref_ant_idx;
+
+	for (u16_t idx = 0; idx < view->ref_samples_num; ++idx) {
+		mapped_data->ref_data.data[idx].i = dfe_packet_view_i(view, idx);
+		mapped_data->ref_data.data[idx].q = dfe_packet_view_q(view, idx);
+	}
+	mapped_data->ref_data.samples_num = view->ref_samples_num;
 
-		sample->antenna_id = ant;
+	assert(view->samples_num <= iq_storage->samples_num);
 
-		assert(slot_idx <= iq_storage->slots_num);
-		assert(samples_num <= iq_storage->samples_num);
-		union dfe_iq_f *iq_data = iq_storage->data[slot_idx];
+	struct dfe_slot_iter iter;
+	struct dfe_slot_span span;
+	u16_t out_idx = 0;
+
+	dfe_slot_iter_init(&iter, view, skip_switch_slots);
+
+	while (dfe_slot_iter_next(&iter, &span)) {
+		assert(out_idx < iq_storage->slots_num);
+		assert(out_idx < slots_storage->slots_num);
+
+		struct dfe_samples *sample = &slots_storage->data[out_idx];
+		union dfe_iq_f *iq_data = iq_storage->data[out_idx];
 
-		for(u8_t sample_idx = 0; sample_idx < samples_num; ++sample_idx) {
-			effective_sample_idx = ref_samples_num + (slot_idx * samples_num) + sample_idx;
-			iq_data[sample_idx].i = raw_data->data[effective_sample_idx].iq.i;
-			iq_data[sample_idx].q = raw_data->data[effective_sample_idx].iq.q;
+		for (u8_t sample_idx = 0; sample_idx < span.samples_num; ++sample_idx) {
+			u16_t raw_idx = span.first_sample + sample_idx;
+
+			iq_data[sample_idx].i = dfe_packet_view_i(view, raw_idx);
+			iq_data[sample_idx].q = dfe_packet_view_q(view, raw_idx);
 		}
-		sample->samples_num = samples_num;
+		sample->antenna_id = span.antenna_id;
+		sample->samples_num = span.samples_num;
 		sample->data = iq_data;
+		++out_idx;
 	}
 
-	mapped_data->header.length = effective_slots_num;
-	mapped_data->header.frequency = raw_data->hdr.frequency;
+	mapped_data->header.length = out_idx;
+	mapped_data->header.frequency = view->raw_data->hdr.frequency;
 	mapped_data->sampl_data = slots_storage->data;
 }
 
+void dfe_map_packet_view(struct dfe_mapped_packet *mapped_data,
+			 struct dfe_iq_data_storage *iq_storage,
+			 struct dfe_slot_samples_storage *slots_storage,
+			 const struct dfe_packet_view *view)
+{
+	assert(view != NULL);
+
+	map_slots(mapped_data, iq_storage, slots_storage, view, true);
+}
+
+void dfe_map_iq_samples_to_antennas(struct dfe_mapped_packet *mapped_data,
+									struct dfe_iq_data_storage *iq_storage,
+									struct dfe_slot_samples_storage *slots_storage,
+									const struct dfe_packet *raw_data,
+									const struct dfe_sampling_config *sampling_conf,
+									const struct dfe_antenna_config *ant_config)
+{
+	struct dfe_packet_view view;
+
+	dfe_packet_view_init(&view, raw_data, sampling_conf, ant_config);
+	map_slots(mapped_data, iq_storage, slots_storage, &view, false);
+}
+
 int remove_samples_from_switch_slot(struct dfe_mapped_packet *data,
 				    const struct dfe_sampling_config *sampling_conf)
 {
@@ -121,15 +212,10 @@ int remove_samples_from_switch_slot(struct dfe_mapped_packet *data,
 		const struct dfe_samples *sample_in = &data->sampl_data[in_idx];
 
 		if (sample_in->antenna_id != DFE_ANT_INCORRECT) {
-			struct dfe_samples *sample_out = &data->sampl_data[out_idx];
-
-			sample_out->antenna_id = sample_in->antenna_id;
-			sample_out->samples_num = sample_in->samples_num;
-
-			for(u8_t sample_idx = 0; sample_idx <= sample_in->samples_num; ++sample_idx) {
-				sample_out->data[sample_idx].i = sample_in->data[sample_idx].i;
-				sample_out->data[sample_idx].q = sample_in->data[sample_idx].q;
-			}
+			/* Slot descriptor points to its samples, so samples
+			 * stay where they are.
+			 */
+			data->sampl_data[out_idx] = *sample_in;
 			++out_idx;
 		}
 	}
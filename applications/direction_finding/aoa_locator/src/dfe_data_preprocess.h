@@ -7,7 +7,10 @@
 #ifndef SRC_DFE_DATA_PREPROCESS_H_
 #define SRC_DFE_DATA_PREPROCESS_H_
 
+#include <stdbool.h>
+#include <zephyr/types.h>
 #include <bluetooth/dfe_data.h>
+#include "dfe_local_config.h"
 #include "dfe_samples_data.h"
 
 /** @brief Storage for IQ samples collected during CTE sampling
@@ -31,6 +34,116 @@ struct dfe_slot_samples_storage {
 	struct dfe_samples data[DFE_TOTAL_SLOTS_NUM];
 };
 
+/** @brief View on raw IQ samples received from BLE controller
+ *
+ * The view does not copy samples. It holds the raw packet together with
+ * sampling parameters required to find samples of every sampling slot.
+ * Samples of consecutive slots are placed in the raw packet with a constant
+ * stride equal to number of samples in a slot.
+ */
+struct dfe_packet_view {
+	const struct dfe_packet *raw_data;	//!< raw IQ samples
+	const struct dfe_antenna_config *ant_config;	//!< antenna switching configuration
+	u16_t ref_samples_num;			//!< number of reference samples
+	u16_t slots_num;			//!< number of sampling slots in the packet
+	u8_t samples_num;			//!< number of samples in a single slot
+	u8_t ant_step;				//!< antenna step between sampling slots
+	bool over_sampling;			//!< samples are taken in switch slots
+};
+
+/** @brief Samples of a single sampling slot in a @ref dfe_packet_view */
+struct dfe_slot_span {
+	u8_t antenna_id;			//!< antenna used in the slot
+	u8_t samples_num;			//!< number of samples in the slot
+	u16_t slot_idx;				//!< slot number in the packet
+	u16_t first_sample;			//!< index of first slot sample in raw packet
+};
+
+/** @brief Iterator over sampling slots of a @ref dfe_packet_view */
+struct dfe_slot_iter {
+	const struct dfe_packet_view *view;
+	u16_t slot_idx;				//!< next slot number
+	u16_t ant_idx;				//!< index in antennae switch sequence
+	bool skip_switch_slots;			//!< do not provide switch slots
+};
+
+/** @brief Initializes view on raw IQ samples
+ *
+ * Number of slots is limited to samples available in the raw packet, so
+ * samples left in the buffer by previous packets are never provided.
+ *
+ * @param[out] view		View to initialize
+ * @param[in] raw_data		Raw IQ samples received from BLE controller
+ * @param[in] sampling_conf	Sampling configuration
+ * @param[in] ant_config	Antenna switching configuration
+ */
+void dfe_packet_view_init(struct dfe_packet_view *view,
+			  const struct dfe_packet *raw_data,
+			  const struct dfe_sampling_config *sampling_conf,
+			  const struct dfe_antenna_config *ant_config);
+
+/** @brief Initializes iterator over sampling slots
+ *
+ * @param[out] iter		Iterator to initialize
+ * @param[in] view		View on raw IQ samples
+ * @param[in] skip_switch_slots	If true, slots sampled during antenna
+ *				switching are skipped
+ */
+void dfe_slot_iter_init(struct dfe_slot_iter *iter,
+			const struct dfe_packet_view *view,
+			bool skip_switch_slots);
+
+/** @brief Provides next sampling slot
+ *
+ * Antenna used in the slot is evaluated on the fly, according to the
+ * sampling type. Slot sampled during antenna switching has antenna set to
+ * @ref DFE_ANT_INCORRECT.
+ *
+ * @param[in,out] iter	Iterator
+ * @param[out] span	Samples of the slot
+ *
+ * @retval true		span holds next slot
+ * @retval false	there are no more slots
+ */
+bool dfe_slot_iter_next(struct dfe_slot_iter *iter, struct dfe_slot_span *span);
+
+/** @brief Provides I component of a raw sample
+ *
+ * @param[in] view	View on raw IQ samples
+ * @param[in] idx	Sample index in raw packet
+ */
+static inline s16_t dfe_packet_view_i(const struct dfe_packet_view *view, u16_t idx)
+{
+	return view->raw_data->data[idx].iq.i;
+}
+
+/** @brief Provides Q component of a raw sample
+ *
+ * @param[in] view	View on raw IQ samples
+ * @param[in] idx	Sample index in raw packet
+ */
+static inline s16_t dfe_packet_view_q(const struct dfe_packet_view *view, u16_t idx)
+{
+	return view->raw_data->data[idx].iq.q;
+}
+
+/** @brief Maps IQ samples seen through a view to antennas
+ *
+ * Slots sampled during antenna switching are skipped while samples are
+ * stored, so @ref remove_samples_from_switch_slot is not required.
+ * Every valid sample is converted to the format required by AoA evaluation
+ * exactly once.
+ *
+ * @param[out] mapped_data	Storage for mapped data for PDDA evaluation
+ * @param[out] iq_storage	Storage for IQ samples
+ * @param[out] slots_storage	Storage for sampling slots data
+ * @param[in] view		View on raw IQ samples
+ */
+void dfe_map_packet_view(struct dfe_mapped_packet *mapped_data,
+			 struct dfe_iq_data_storage *iq_storage,
+			 struct dfe_slot_samples_storage *slots_storage,
+			 const struct dfe_packet_view *view);
+
 /** @brief Maps IQ samples to antennas.
  *
  * Maps IQ samples to antennas used to collect particular samples.
@@ -62,6 +175,8 @@ void dfe_map_iq_samples_to_antennas(struct dfe_mapped_packet *mapped_data,
  * and introduce error. Because of that they are removed from mapped samples set
  * before following steps of evaluation.
  *
+ * Samples are not moved, only descriptors of slots are compacted.
+ *
  * @param[out]	data		Storage for mapped IQ samples
  * @param[in]	sampl_conf	Sampling configuration
  */
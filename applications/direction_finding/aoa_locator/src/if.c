@@ -11,9 +11,16 @@
 #include "if.h"
 
 static struct if_data g_if;
-static void if_uart_app_isr(struct device *dev);
 static void uart_send(uint8_t *buffer, uint16_t length);
 
+#if defined(CONFIG_AOA_LOCATOR_TX_PIPELINE)
+static void if_uart_async_cb(struct uart_event *evt, void *user_data);
+static int uart_send_async(const u8_t *buffer, u16_t length,
+			   if_tx_done_t tx_done);
+#else
+static void if_uart_app_isr(struct device *dev);
+#endif
+
 struct if_data *if_initialization(void)
 {
 	g_if.dev = device_get_binding(CONFIG_AOA_LOCATOR_UART_PORT);
@@ -22,16 +29,58 @@ struct if_data *if_initialization(void)
 		return NULL;
 	}
 
+#if defined(CONFIG_AOA_LOCATOR_TX_PIPELINE)
+	int err = uart_callback_set(g_if.dev, if_uart_async_cb, NULL);
+
+	if (err) {
+		printk("[UART] - Async API cannot be used (err %d)\r\n", err);
+		return NULL;
+	}
+
+	g_if.send_async = uart_send_async;
+#else
 	uart_irq_rx_disable(g_if.dev);
 	uart_irq_tx_disable(g_if.dev);
 	uart_irq_callback_set(g_if.dev, if_uart_app_isr);
 	uart_irq_rx_enable(g_if.dev);
+#endif
 
 	g_if.send = uart_send;
 
 	return &g_if;
 }
 
+#if defined(CONFIG_AOA_LOCATOR_TX_PIPELINE)
+static void if_uart_async_cb(struct uart_event *evt, void *user_data)
+{
+	if_tx_done_t tx_done = g_if.tx_done;
+
+	switch (evt->type) {
+	case UART_TX_DONE:
+		if (tx_done) {
+			tx_done(0);
+		}
+		break;
+	case UART_TX_ABORTED:
+		printk("[UART] - transmission aborted\r\n");
+		if (tx_done) {
+			tx_done(-EIO);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+static int uart_send_async(const u8_t *buffer, u16_t length,
+			   if_tx_done_t tx_done)
+{
+	g_if.tx_done = tx_done;
+
+	return uart_tx(g_if.dev, buffer, length, SYS_FOREVER_MS);
+}
+#else
+
 static void if_uart_app_isr(struct device *dev)
 {
 	while (uart_irq_update(dev) && uart_irq_is_pending(dev))
@@ -51,6 +100,7 @@ static void if_uart_app_isr(struct device *dev)
 		}
 	}
 }
+#endif
 
 static void uart_send(uint8_t *buffer, uint16_t length)
 {
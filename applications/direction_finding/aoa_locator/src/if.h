@@ -15,6 +15,13 @@
  */
 struct device;
 
+/** @brief Callback called when asynchronous transmission is finished
+ *
+ * @param err	zero if all data were sent, non zero value if transmission
+ *		was aborted
+ */
+typedef void (*if_tx_done_t)(int err);
+
 /* @brief Output interface data structure
  */
 struct if_data
@@ -31,6 +38,13 @@ struct if_data
 
 	/* callback to send data */
 	void (*send)(u8_t *, u16_t);
+
+#if defined(CONFIG_AOA_LOCATOR_TX_PIPELINE)
+	/* callback to start DMA transmission, returns immediately */
+	int (*send_async)(const u8_t *, u16_t, if_tx_done_t);
+	/* callback to be called when DMA transmission is finished */
+	if_tx_done_t tx_done;
+#endif
 };
 
 /* @brief Initializes output interface
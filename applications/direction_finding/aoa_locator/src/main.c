@@ -25,6 +25,10 @@
 
 #include "average_results.h"
 #include "float_ring_buffer.h"
+#include "tag_tracker.h"
+#if defined(CONFIG_AOA_LOCATOR_TX_PIPELINE)
+#include "tx_pipeline.h"
+#endif
 
 /** @brief Number of ms to wait for a data before printing no data note
  */
@@ -48,10 +52,6 @@ static const struct aoa_system_interface sys_iface =
 	.uptime_get = k_uptime_get,
 };
 
-/** @brief Queue defined by BLE Controller to provide IQ samples data
- */
-extern struct k_msgq df_packet_msgq;
-
 /** @brief Variable to store handle received from aoa_library initialization
  */
 static void* handle;
@@ -73,6 +73,61 @@ static struct dfe_slot_samples_storage slots_storage = {
 		.slots_num = DFE_TOTAL_SLOTS_NUM,
 };
 
+#if defined(CONFIG_AOA_LOCATOR_TX_PIPELINE)
+/** @brief Output frame being prepared by processing thread */
+static struct tx_frame *tx_frame;
+#endif
+
+/** @brief Starts preparation of output data for a new CTE
+ *
+ * If TX pipeline is enabled, data are stored in a frame from the pool,
+ * so they may be sent with DMA while next CTE is processed.
+ *
+ * @retval true		output data may be stored
+ * @retval false	no free frame available, output of this CTE is dropped
+ */
+static bool output_begin(void)
+{
+#if defined(CONFIG_AOA_LOCATOR_TX_PIPELINE)
+	tx_frame = tx_pipeline_frame_alloc();
+	if (tx_frame == NULL) {
+		return false;
+	}
+
+	data_transfer_set_buffer(tx_frame->buf, sizeof(tx_frame->buf));
+#endif
+	data_tranfer_prepare_header();
+
+	return true;
+}
+
+/** @brief Sends output data prepared for a CTE
+ *
+ * If TX pipeline is enabled the function only queues the frame for
+ * transmission, it does not wait until data are sent.
+ */
+static void output_send(void)
+{
+#if defined(CONFIG_AOA_LOCATOR_TX_PIPELINE)
+	tx_frame->len = data_transfer_get_len();
+	tx_pipeline_frame_submit(tx_frame);
+	tx_frame = NULL;
+#else
+	data_tranfer_send();
+#endif
+}
+
+/** @brief Drops output data prepared for a CTE */
+static void output_drop(void)
+{
+#if defined(CONFIG_AOA_LOCATOR_TX_PIPELINE)
+	if (tx_frame != NULL) {
+		tx_pipeline_frame_free(tx_frame);
+		tx_frame = NULL;
+	}
+#endif
+}
+
 /** @brief Main function of the example.
  *
  * The function is responsible for:
@@ -80,16 +135,19 @@ static struct dfe_slot_samples_storage slots_storage = {
  * - initialization of Direction Finding in Bluetooth stack
  * - initialization of Bluetooth stack
  * - initialization of angle of arrival library
- * - receive DFE data from Bluetooth controller
- * - mapping received data to antenna numbers
+ * - receive DFE data paired with address of the advertiser that sent it
  * - store raw IQ samples in a transfer buffer
- * - remove IQ samples gathered during antenna switchign
+ * - mapping received data to antenna numbers, IQ samples gathered during
+ *   antenna switching are skipped
  * - evaluate angle of arrival
- * - filter evaluated angles
+ * - find tracking state of the tag that sent the CTE
+ * - filter evaluated angles of the tag
  * - store angles in transfer data
  * - forwarding data by UART
  *
  * Steps between receive and forward data are processed in infinite loop.
+ * If CONFIG_AOA_LOCATOR_TX_PIPELINE is enabled, forwarding of data is done
+ * by separate thread, so the loop does not wait for end of UART transmission.
  */
 void main(void)
 {
@@ -110,6 +168,14 @@ void main(void)
 		return;
 	}
 
+#if defined(CONFIG_AOA_LOCATOR_TX_PIPELINE)
+	err = tx_pipeline_init(iface);
+	if (err) {
+		printk("Locator stopped!\r\n");
+		return;
+	}
+#endif
+
 	const struct dfe_sampling_config* sampl_conf = NULL;
 	const struct dfe_antenna_config* ant_conf = NULL;
 	const struct dfe_ant_gpio* ant_gpio = NULL;
@@ -132,6 +198,8 @@ void main(void)
 		return;
 	}
 
+	tag_tracker_init();
+
 	printk("Initialize Bluetooth\r\n");
 	ble_initialization();
 
@@ -156,50 +224,90 @@ void main(void)
 
 	while(1)
 	{
-		static struct dfe_packet df_data_packet;
+		struct ble_cte_report *cte_report;
 		static struct dfe_mapped_packet df_data_mapped;
-
-		//static struct dfe_mapped_packet df_data_cleanet;
-
-		memset(&df_data_packet, 0, sizeof(df_data_packet));
-		memset(&df_data_mapped, 0, sizeof(df_data_mapped));
-		//memset(&df_data_cleanet, 0, sizeof(df_data_cleanet));
-		k_msgq_get(&df_packet_msgq, &df_data_packet, K_MSEC(WAIT_FOR_DATA_BEFORE_PRINT));
-		if (df_data_packet.hdr.length != 0) {
+		struct dfe_packet_view df_data_view;
+
+		/* Packets are not cleared, view on received samples is limited
+		 * to the packet length.
+		 */
+		err = ble_cte_report_get(&cte_report,
+					 K_MSEC(WAIT_FOR_DATA_BEFORE_PRINT));
+		if (!err && cte_report->packet.hdr.length != 0) {
 			printk("\r\nData arrived...\r\n");
 
-			dfe_map_iq_samples_to_antennas(&df_data_mapped,
-										   &iq_storage,
-										   &slots_storage,
-										   &df_data_packet,
-										   sampl_conf, ant_conf);
+			dfe_packet_view_init(&df_data_view, &cte_report->packet,
+					     sampl_conf, ant_conf);
 
-			data_tranfer_prepare_header();
-			data_transfer_prepare_samples(sampl_conf,&df_data_mapped);
+			bool output = output_begin();
 
-			remove_samples_from_switch_slot(&df_data_mapped, sampl_conf);
+			if (output) {
+				data_transfer_prepare_samples(sampl_conf, &df_data_view);
+			}
+
+			/* Switch slots are skipped while samples are mapped */
+			dfe_map_packet_view(&df_data_mapped, &iq_storage,
+					    &slots_storage, &df_data_view);
 			int err = aoa_handling(handle, &df_data_mapped, &results);
 			if (err) {
 				printk("AoA_Handling error: %d! Stopping the evaluation.\r\n", err);
+				output_drop();
+				ble_cte_report_release(cte_report);
 				break;
 			}
 
-			err = low_pass_filter_FIR(&results, &avg_results);
+			struct tag_state *tag = tag_tracker_get(&cte_report->addr);
+
+			/* Samples are mapped and address is held by the tag */
+			ble_cte_report_release(cte_report);
+
+			++tag->cte_count;
+
+			err = tag_tracker_filter(tag, &results, &avg_results);
 			if (err) {
 				printk("Averaging error: %d\r\n", err);
+				output_drop();
 				break;
 			}
 			results.filtered_result.azimuth = avg_results.raw_result.azimuth;
 			results.filtered_result.elevation = avg_results.raw_result.elevation;
 
-			data_tranfer_prepare_results(sampl_conf, &results);
-			data_tranfer_prepare_footer();
-			data_tranfer_send();
+			if (output) {
+				data_tranfer_prepare_tag(&tag->addr);
+				data_tranfer_prepare_results(sampl_conf, &results);
+				data_tranfer_prepare_footer();
+				output_send();
+			}
 		}
 		else
 		{
+			struct tag_tracker_stats tag_stats;
+			struct ble_cte_stats cte_stats;
+
+			if (!err) {
+				/* Report of empty packet */
+				ble_cte_report_release(cte_report);
+			}
+
 			printk("\r\nNo data received.");
+			tag_tracker_stats_get(&tag_stats);
+			printk("\r\nTags tracked: %u evicted: %u",
+			       tag_stats.tags, tag_stats.evicted);
+			ble_cte_stats_get(&cte_stats);
+			printk("\r\nCTEs paired: %u unidentified: %u overflow: %u",
+			       cte_stats.paired, cte_stats.unidentified,
+			       cte_stats.overflow);
+#if defined(CONFIG_AOA_LOCATOR_TX_PIPELINE)
+			struct tx_pipeline_stats stats;
+
+			tx_pipeline_stats_get(&stats);
+			printk("\r\nTX frames queued: %u sent: %u dropped: %u aborted: %u pending: %u",
+			       stats.queued, stats.sent, stats.dropped,
+			       stats.aborted, stats.pending);
+#endif
 		}
+#if !defined(CONFIG_AOA_LOCATOR_TX_PIPELINE)
 		k_sleep(K_MSEC(CONFIG_AOA_LOCATOR_DATA_SEND_WAIT_MS));
+#endif
 	}
 }
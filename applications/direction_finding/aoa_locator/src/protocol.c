@@ -11,13 +11,47 @@
 #include <assert.h>
 
 #include <sys/printk.h>
+#include <sys/util.h>
 
 #include "protocol.h"
 #include "if.h"
 
 #define SAMPLING_TIME_UNIT (125) //!< smallest possible time between samples [ns]
 
+#if defined(CONFIG_AOA_LOCATOR_TX_PIPELINE)
+/* Transmission buffers are provided by TX pipeline frames. */
 static struct protocol_data g_protocol_data;
+#else
+static char g_string_packet[PROTOCOL_STRING_BUFFER_SIZE];
+
+static struct protocol_data g_protocol_data = {
+	.string_packet = g_string_packet,
+	.string_packet_size = sizeof(g_string_packet),
+};
+#endif
+
+/** @brief Puts single IQ sample into transfer buffer
+ *
+ * @param[in] idx	Sample number
+ * @param[in] time	Sample time in @ref SAMPLING_TIME_UNIT units
+ * @param[in] ant	Antenna index
+ * @param[in] i		I component of the sample
+ * @param[in] q		Q component of the sample
+ */
+static void put_iq_sample(u16_t idx, u16_t time, u8_t ant, s16_t i, s16_t q)
+{
+#if defined(CONFIG_DF_PROTOCOL_FORMAT_BINARY)
+	ARG_UNUSED(idx);
+
+	df_frame_iq_put(&g_protocol_data.frame, time, ant, i, q);
+#else
+	char *buffer = &g_protocol_data.string_packet[g_protocol_data.stored_data_len];
+
+	g_protocol_data.stored_data_len += sprintf(buffer, "IQ:%d,%d,%d,%d,%d\r\n",
+						   idx, time, (int)ant,
+						   (int)q, (int)i);
+#endif
+}
 
 
 int data_transfer_init(struct if_data* iface)
@@ -31,31 +65,51 @@ int data_transfer_init(struct if_data* iface)
 	return 0;
 }
 
+void data_transfer_set_buffer(char *buffer, size_t size)
+{
+	assert(buffer != NULL);
+
+	g_protocol_data.string_packet = buffer;
+	g_protocol_data.string_packet_size = size;
+	g_protocol_data.stored_data_len = 0;
+}
+
+size_t data_transfer_get_len(void)
+{
+	return g_protocol_data.stored_data_len;
+}
+
 void data_tranfer_prepare_header()
 {
+#if defined(CONFIG_DF_PROTOCOL_FORMAT_BINARY)
+	df_frame_begin(&g_protocol_data.frame, (u8_t *)g_protocol_data.string_packet,
+		       g_protocol_data.string_packet_size, g_protocol_data.sequence++);
+	g_protocol_data.stored_data_len = 0;
+#else
 	g_protocol_data.stored_data_len = sprintf(g_protocol_data.string_packet,
 						  "DF_BEGIN\r\n");
+#endif
 }
 
 void data_transfer_prepare_samples(const struct dfe_sampling_config* sampl_conf,
-										  const struct dfe_mapped_packet *mapped_data)
+				   const struct dfe_packet_view *view)
 {
 	assert(sampl_conf != NULL);
-	assert(mapped_data != NULL);
-
-	u16_t strlen = 0;
-	char *buffer = &g_protocol_data.string_packet[g_protocol_data.stored_data_len];
+	assert(view != NULL);
 
 	u16_t time_u = dfe_get_sample_spacing_ref_ns(sampl_conf->sample_spacing_ref) / SAMPLING_TIME_UNIT;
 	u16_t ref_idx;
 
-	for(ref_idx = 0; ref_idx < mapped_data->ref_data.samples_num; ++ref_idx)
+#if defined(CONFIG_DF_PROTOCOL_FORMAT_BINARY)
+	df_frame_iq_begin(&g_protocol_data.frame, 0);
+#endif
+
+	for(ref_idx = 0; ref_idx < view->ref_samples_num; ++ref_idx)
 	{
-		strlen += sprintf(&buffer[strlen], "IQ:%d,%d,%d,%d,%d\r\n", ref_idx,
-				time_u * ref_idx,
-				 (int)mapped_data->ref_data.antenna_id,
-				 (int)mapped_data->ref_data.data[ref_idx].q,
-				 (int)mapped_data->ref_data.data[ref_idx].i);
+		put_iq_sample(ref_idx, time_u * ref_idx,
+			      view->ant_config->ref_ant_idx,
+			      dfe_packet_view_i(view, ref_idx),
+			      dfe_packet_view_q(view, ref_idx));
 	}
 	/* compute delay  between last sample in reference period and first sample
 	 * in antenna switching period.
@@ -64,23 +118,51 @@ void data_transfer_prepare_samples(const struct dfe_sampling_config* sampl_conf,
 	delay += (time_u * (ref_idx-1));
 	time_u = dfe_get_sample_spacing_ns(sampl_conf->sample_spacing) / SAMPLING_TIME_UNIT;
 
-	for(u16_t idx=0; idx<mapped_data->header.length; ++idx)
-	{
-		const struct dfe_samples* sampl_data = &mapped_data->sampl_data[idx];
+	/* Samples taken in switch slots are sent too, they are marked
+	 * with antenna index 255.
+	 */
+	struct dfe_slot_iter iter;
+	struct dfe_slot_span span;
+
+	dfe_slot_iter_init(&iter, view, false);
 
-		for(u16_t jdx = 0; jdx < sampl_data->samples_num; ++jdx)
+	while (dfe_slot_iter_next(&iter, &span))
+	{
+		for(u16_t jdx = 0; jdx < span.samples_num; ++jdx)
 		{
-			u16_t idx_offset = (sampl_data->samples_num * idx) + jdx;
+			u16_t idx_offset = (span.samples_num * span.slot_idx) + jdx;
 
-			strlen += sprintf(&buffer[strlen], "IQ:%d,%d,%d,%d,%d\r\n", ref_idx + idx_offset,
-					delay + (idx_offset) * time_u,
-					 (int)sampl_data->antenna_id,
-					 (int)sampl_data->data[jdx].q,
-					 (int)sampl_data->data[jdx].i);
+			put_iq_sample(ref_idx + idx_offset,
+				      delay + (idx_offset) * time_u,
+				      span.antenna_id,
+				      dfe_packet_view_i(view, span.first_sample + jdx),
+				      dfe_packet_view_q(view, span.first_sample + jdx));
 		}
 	}
 
-	g_protocol_data.stored_data_len += strlen;
+#if defined(CONFIG_DF_PROTOCOL_FORMAT_BINARY)
+	df_frame_iq_end(&g_protocol_data.frame);
+#endif
+}
+
+void data_tranfer_prepare_tag(const bt_addr_le_t *addr)
+{
+	assert(addr != NULL);
+
+#if defined(CONFIG_DF_PROTOCOL_FORMAT_BINARY)
+	struct df_frame_tag tag = {
+		.type = addr->type,
+	};
+
+	memcpy(tag.addr, addr->a.val, sizeof(tag.addr));
+	df_frame_put_tag(&g_protocol_data.frame, &tag);
+#else
+	char addr_str[BT_ADDR_LE_STR_LEN];
+	char *buffer = &g_protocol_data.string_packet[g_protocol_data.stored_data_len];
+
+	bt_addr_le_to_str(addr, addr_str, sizeof(addr_str));
+	g_protocol_data.stored_data_len += sprintf(buffer, "AD:%s\r\n", addr_str);
+#endif
 }
 
 void data_tranfer_prepare_results(const struct dfe_sampling_config* sampl_conf,
@@ -89,6 +171,23 @@ void data_tranfer_prepare_results(const struct dfe_sampling_config* sampl_conf,
 	assert(sampl_conf != NULL);
 	assert(result != NULL);
 
+#if defined(CONFIG_DF_PROTOCOL_FORMAT_BINARY)
+	struct df_frame_sampling sampling = {
+		.switch_spacing = sampl_conf->switch_spacing,
+		.sample_spacing_ref = sampl_conf->sample_spacing_ref,
+		.sample_spacing = sampl_conf->sample_spacing,
+		.frequency = result->frequency,
+	};
+	struct df_frame_angles angles = {
+		.elevation = result->raw_result.elevation,
+		.azimuth = result->raw_result.azimuth,
+		.filtered_elevation = result->filtered_result.elevation,
+		.filtered_azimuth = result->filtered_result.azimuth,
+	};
+
+	df_frame_put_sampling(&g_protocol_data.frame, &sampling);
+	df_frame_put_angles(&g_protocol_data.frame, &angles);
+#else
 	u16_t strlen = 0;
 	char *buffer = &g_protocol_data.string_packet[g_protocol_data.stored_data_len];
 
@@ -103,17 +202,33 @@ void data_tranfer_prepare_results(const struct dfe_sampling_config* sampl_conf,
 	strlen += sprintf(&buffer[strlen], "KA:%d\r\n", (int)result->filtered_result.azimuth);
 
 	g_protocol_data.stored_data_len += strlen;
+#endif
 }
 
 void data_tranfer_prepare_footer()
 {
+#if defined(CONFIG_DF_PROTOCOL_FORMAT_BINARY)
+	int len = df_frame_end(&g_protocol_data.frame);
+
+	if (len < 0) {
+		printk("[PROTOCOL] - frame preparation failed: %d\r\n", len);
+		g_protocol_data.stored_data_len = 0;
+	} else {
+		g_protocol_data.stored_data_len = len;
+	}
+#else
 	u16_t strlen = 0;
 	char *buffer = &g_protocol_data.string_packet[g_protocol_data.stored_data_len];
 	g_protocol_data.stored_data_len += sprintf(&buffer[strlen], "DF_END\r\n");
+#endif
 }
 
 void data_tranfer_send()
 {
+	if (g_protocol_data.stored_data_len == 0) {
+		return;
+	}
+
 	g_protocol_data.uart->send(g_protocol_data.string_packet,
 				   g_protocol_data.stored_data_len);
 }
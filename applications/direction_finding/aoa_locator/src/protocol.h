@@ -9,9 +9,12 @@
 
 #include <zephyr/types.h>
 #include <bluetooth/dfe_data.h>
+#include <bluetooth/addr.h>
 #include "dfe_local_config.h"
+#include "dfe_data_preprocess.h"
 #include "if.h"
 #include "aoa.h"
+#include "df_frame.h"
 
 /** @brief  Header added to data message send via UART
  */
@@ -29,10 +32,21 @@ struct protocol_data
 	struct if_data *uart;
 	/** @brief transmission data buffer
 	 */
-	char string_packet[PROTOCOL_STRING_BUFFER_SIZE];
+	char *string_packet;
+	/** @brief size of transmission data buffer
+	 */
+	size_t string_packet_size;
 	/** @brief number of bytes stored in transmission buffer
 	 */
 	size_t stored_data_len;
+#if defined(CONFIG_DF_PROTOCOL_FORMAT_BINARY)
+	/** @brief binary frame writer working on transmission buffer
+	 */
+	struct df_frame_writer frame;
+	/** @brief sequence number of next binary frame
+	 */
+	u16_t sequence;
+#endif
 };
 
 /** @brief Initializes data transfer internals
@@ -44,31 +58,59 @@ struct protocol_data
  */
 int data_transfer_init(struct if_data *iface);
 
+/** @brief Sets buffer used to store data of next transfer
+ *
+ * By default data are stored in internal buffer of
+ * @ref PROTOCOL_STRING_BUFFER_SIZE bytes. The function allows to prepare
+ * the data directly in a buffer owned by a caller, e.g. a frame that will be
+ * sent with DMA while the next one is prepared.
+ *
+ * @param buffer	memory to store transfer data
+ * @param size		size of memory provided by @p buffer
+ */
+void data_transfer_set_buffer(char *buffer, size_t size);
+
+/** @brief Returns number of bytes stored in transmission buffer
+ *
+ * @return number of bytes to be sent
+ */
+size_t data_transfer_get_len(void);
+
 /** @brief Prepares data transfer
  *
  * The function should be used at the beginning of transfer transaction.
  * It resets number of bytes stored in transmission buffer.
  * Also it puts data package header into transfer buffer.
  *
+ * If CONFIG_DF_PROTOCOL_FORMAT_BINARY is enabled, the data are stored as
+ * binary frame described in df_frame.h instead of text.
+ *
  * @note After first transfer init function call the number of bytes
  * stored in transfer buffer will never be zero.
  * That is caused by placement message header into the buffer during init.
  */
 void data_tranfer_prepare_header();
 
-/** @brief Puts mapped IQ samples into transfer buffer
+/** @brief Puts IQ samples into transfer buffer
  *
  * The function stores IQ samples including information like: mapped antenna
  * index, time delay from the beginning of CTE reception (first sample).
+ * Samples are read directly from the raw packet seen through the view.
  * Pay attention that antenna index 255 means sample taken during switch period.
  * Time data related with particular samples is an integer value.
  * The unit of the value is 125[us]. E.g. Time 4 means 4*125=500[us].
  *
  * @param smapl_conf	pointer to sampling configuration
- * @param mapped_data	pointer to IQ samples mapped to antennas
+ * @param view		pointer to view on raw IQ samples
  */
 void data_transfer_prepare_samples(const struct dfe_sampling_config *sampl_conf,
-				  const struct dfe_mapped_packet *mapped_data);
+				   const struct dfe_packet_view *view);
+/** @brief Puts address of the tag that sent the CTE in transfer buffer
+ *
+ * @param addr		advertiser address of the tag
+ */
+void data_tranfer_prepare_tag(const bt_addr_le_t *addr);
+
 /** @brief Puts angle of arrival results in transfer buffer
  *
  * @param smapl_conf	pointer to sampling configuration
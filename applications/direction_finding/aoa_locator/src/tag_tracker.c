@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <assert.h>
+#include <string.h>
+#include <toolchain.h>
+
+#include "tag_tracker.h"
+
+/** @brief Index used to mark end of a list */
+#define TAG_NONE 0xFF
+
+BUILD_ASSERT(TAG_TRACKER_CAPACITY > 0 && TAG_TRACKER_CAPACITY < TAG_NONE);
+
+/** @brief Storage of tags states, size is fixed at build time */
+static struct tag_state g_tags[TAG_TRACKER_CAPACITY];
+/** @brief Index of the first entry of every hash table bucket */
+static u8_t g_buckets[TAG_TRACKER_BUCKETS_NUM];
+/** @brief Least recently seen tag */
+static u8_t g_lru_oldest;
+/** @brief Most recently seen tag */
+static u8_t g_lru_newest;
+/** @brief Number of used entries in @ref g_tags */
+static u8_t g_tags_num;
+/** @brief Number of reused entries */
+static u32_t g_evicted;
+
+/** @brief FNV-1a hash of advertiser address */
+static u32_t addr_hash(const bt_addr_le_t *addr)
+{
+	u32_t hash = 2166136261u;
+
+	for (size_t idx = 0; idx < sizeof(addr->a.val); ++idx) {
+		hash = (hash ^ addr->a.val[idx]) * 16777619u;
+	}
+	hash = (hash ^ addr->type) * 16777619u;
+
+	return hash % TAG_TRACKER_BUCKETS_NUM;
+}
+
+static void lru_unlink(u8_t idx)
+{
+	struct tag_state *tag = &g_tags[idx];
+
+	if (tag->lru_prev != TAG_NONE) {
+		g_tags[tag->lru_prev].lru_next = tag->lru_next;
+	} else {
+		g_lru_oldest = tag->lru_next;
+	}
+
+	if (tag->lru_next != TAG_NONE) {
+		g_tags[tag->lru_next].lru_prev = tag->lru_prev;
+	} else {
+		g_lru_newest = tag->lru_prev;
+	}
+}
+
+static void lru_append(u8_t idx)
+{
+	struct tag_state *tag = &g_tags[idx];
+
+	tag->lru_prev = g_lru_newest;
+	tag->lru_next = TAG_NONE;
+
+	if (g_lru_newest != TAG_NONE) {
+		g_tags[g_lru_newest].lru_next = idx;
+	} else {
+		g_lru_oldest = idx;
+	}
+	g_lru_newest = idx;
+}
+
+static void bucket_remove(u8_t idx)
+{
+	u8_t *link = &g_buckets[addr_hash(&g_tags[idx].addr)];
+
+	while (*link != idx) {
+		assert(*link != TAG_NONE);
+		link = &g_tags[*link].hash_next;
+	}
+	*link = g_tags[idx].hash_next;
+}
+
+void tag_tracker_init(void)
+{
+	memset(g_buckets, TAG_NONE, sizeof(g_buckets));
+	g_lru_oldest = TAG_NONE;
+	g_lru_newest = TAG_NONE;
+	g_tags_num = 0;
+	g_evicted = 0;
+}
+
+struct tag_state *tag_tracker_get(const bt_addr_le_t *addr)
+{
+	assert(addr != NULL);
+
+	u32_t bucket = addr_hash(addr);
+	u8_t idx;
+
+	for (idx = g_buckets[bucket]; idx != TAG_NONE; idx = g_tags[idx].hash_next) {
+		if (!bt_addr_le_cmp(&g_tags[idx].addr, addr)) {
+			if (idx != g_lru_newest) {
+				lru_unlink(idx);
+				lru_append(idx);
+			}
+			return &g_tags[idx];
+		}
+	}
+
+	if (g_tags_num < TAG_TRACKER_CAPACITY) {
+		idx = g_tags_num++;
+	} else {
+		idx = g_lru_oldest;
+		bucket_remove(idx);
+		lru_unlink(idx);
+		++g_evicted;
+	}
+
+	struct tag_state *tag = &g_tags[idx];
+
+	bt_addr_le_copy(&tag->addr, addr);
+#if defined(CONFIG_AOA_LOCATOR_FILTER_ALPHA_BETA)
+	angle_tracker_init(&tag->tracker,
+			   CONFIG_AOA_LOCATOR_TRACKER_ALPHA / 1000.0f,
+			   CONFIG_AOA_LOCATOR_TRACKER_BETA / 1000.0f,
+			   CONFIG_AOA_LOCATOR_TRACKER_GATE);
+#else
+	fir_filter_init(&tag->filter);
+#endif
+	tag->cte_count = 0;
+
+	tag->hash_next = g_buckets[bucket];
+	g_buckets[bucket] = idx;
+	lru_append(idx);
+
+	return tag;
+}
+
+int tag_tracker_filter(struct tag_state *tag, const struct aoa_results *results,
+		       struct aoa_results *filtered)
+{
+	assert(tag != NULL);
+
+#if defined(CONFIG_AOA_LOCATOR_FILTER_ALPHA_BETA)
+	return angle_tracker_update(&tag->tracker, results, filtered);
+#else
+	return fir_filter_process(&tag->filter, results, filtered);
+#endif
+}
+
+void tag_tracker_stats_get(struct tag_tracker_stats *stats)
+{
+	assert(stats != NULL);
+
+	stats->tags = g_tags_num;
+	stats->evicted = g_evicted;
+}
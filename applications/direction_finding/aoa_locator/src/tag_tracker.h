@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef AOA_LOCATOR_SRC_TAG_TRACKER_H_
+#define AOA_LOCATOR_SRC_TAG_TRACKER_H_
+
+#include <zephyr/types.h>
+#include <bluetooth/addr.h>
+
+#include "average_results.h"
+
+/** @brief Maximum number of tags tracked at once */
+#if defined(CONFIG_AOA_LOCATOR_TAGS_MAX)
+#define TAG_TRACKER_CAPACITY CONFIG_AOA_LOCATOR_TAGS_MAX
+#else
+#define TAG_TRACKER_CAPACITY 16
+#endif
+
+/** @brief Number of hash table buckets.
+ *
+ * Twice the capacity keeps chains short, so lookup is O(1) on average.
+ */
+#define TAG_TRACKER_BUCKETS_NUM (2 * TAG_TRACKER_CAPACITY)
+
+/** @brief Tracking state of a single tag (beacon) */
+struct tag_state {
+	/** Advertiser address of the tag */
+	bt_addr_le_t addr;
+	/** Filter of angles evaluated for the tag */
+#if defined(CONFIG_AOA_LOCATOR_FILTER_ALPHA_BETA)
+	struct angle_tracker tracker;
+#else
+	struct fir_filter filter;
+#endif
+	/** Number of CTEs received from the tag */
+	u32_t cte_count;
+	/** Next entry in hash table bucket */
+	u8_t hash_next;
+	/** Less recently used entry */
+	u8_t lru_prev;
+	/** More recently used entry */
+	u8_t lru_next;
+};
+
+/** @brief Tag tracker statistics */
+struct tag_tracker_stats {
+	/** Number of tags currently tracked */
+	u32_t tags;
+	/** Number of tags whose state was reused for a new tag */
+	u32_t evicted;
+};
+
+/** @brief Initializes tag tracker
+ *
+ * Removes all tracked tags.
+ */
+void tag_tracker_init(void);
+
+/** @brief Provides tracking state of a tag
+ *
+ * If the tag is not tracked yet, a new state is created. When all states
+ * are used, state of the least recently seen tag is reused.
+ * The tag becomes the most recently seen one.
+ *
+ * @param[in] addr	Advertiser address of the tag
+ *
+ * @return Tracking state of the tag, never NULL.
+ */
+struct tag_state *tag_tracker_get(const bt_addr_le_t *addr);
+
+/** @brief Filters angles evaluated for a tag
+ *
+ * Filter selected by CONFIG_AOA_LOCATOR_FILTER is used.
+ *
+ * @param[in,out] tag	Tracking state of the tag
+ * @param[in] results	Current results
+ * @param[out] filtered	Filtered results
+ *
+ * @retval 0		angles filtered successfully
+ * @retval -EINVAL	invalid argument
+ */
+int tag_tracker_filter(struct tag_state *tag, const struct aoa_results *results,
+		       struct aoa_results *filtered);
+
+/** @brief Provides tag tracker statistics
+ *
+ * @param[out] stats	Statistics
+ */
+void tag_tracker_stats_get(struct tag_tracker_stats *stats);
+
+#endif /* AOA_LOCATOR_SRC_TAG_TRACKER_H_ */
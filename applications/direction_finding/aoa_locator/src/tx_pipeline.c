@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <errno.h>
+#include <assert.h>
+#include <kernel.h>
+#include <sys/atomic.h>
+#include <sys/printk.h>
+
+#include "tx_pipeline.h"
+
+/** @brief Pool of output frames */
+static struct tx_frame g_frames[CONFIG_AOA_LOCATOR_TX_FRAMES_NUM];
+
+/** @brief Queue of frames that may be filled by processing thread */
+K_MSGQ_DEFINE(free_frames_msgq, sizeof(struct tx_frame *),
+	      CONFIG_AOA_LOCATOR_TX_FRAMES_NUM, 4);
+/** @brief Queue of frames waiting for transmission */
+K_MSGQ_DEFINE(ready_frames_msgq, sizeof(struct tx_frame *),
+	      CONFIG_AOA_LOCATOR_TX_FRAMES_NUM, 4);
+
+/** @brief Semaphore given from UART ISR when DMA transmission is finished */
+static K_SEM_DEFINE(tx_done_sem, 0, 1);
+
+static K_THREAD_STACK_DEFINE(tx_thread_stack,
+			     CONFIG_AOA_LOCATOR_TX_THREAD_STACK_SIZE);
+static struct k_thread tx_thread;
+
+static struct if_data *g_iface;
+
+static atomic_t g_queued;
+static atomic_t g_sent;
+static atomic_t g_dropped;
+static atomic_t g_aborted;
+static int g_tx_err;
+
+static void tx_done(int err)
+{
+	g_tx_err = err;
+	k_sem_give(&tx_done_sem);
+}
+
+/** @brief Transmit thread
+ *
+ * Takes frames prepared by processing thread and sends them with DMA.
+ * Processing of next CTE is done in parallel with transmission.
+ */
+static void tx_thread_fn(void *p1, void *p2, void *p3)
+{
+	struct tx_frame *frame;
+	int err;
+
+	while (true) {
+		k_msgq_get(&ready_frames_msgq, &frame, K_FOREVER);
+
+		err = g_iface->send_async(frame->buf, frame->len, tx_done);
+		if (!err) {
+			k_sem_take(&tx_done_sem, K_FOREVER);
+			err = g_tx_err;
+		}
+
+		if (err) {
+			atomic_inc(&g_aborted);
+		} else {
+			atomic_inc(&g_sent);
+		}
+
+		tx_pipeline_frame_free(frame);
+	}
+}
+
+int tx_pipeline_init(struct if_data *iface)
+{
+	if (iface == NULL || iface->send_async == NULL) {
+		printk("[TX] - iface does not support DMA, cannot initialize\r\n");
+		return -EINVAL;
+	}
+
+	g_iface = iface;
+
+	for (size_t idx = 0; idx < ARRAY_SIZE(g_frames); ++idx) {
+		struct tx_frame *frame = &g_frames[idx];
+
+		k_msgq_put(&free_frames_msgq, &frame, K_NO_WAIT);
+	}
+
+	k_thread_create(&tx_thread, tx_thread_stack,
+			K_THREAD_STACK_SIZEOF(tx_thread_stack),
+			tx_thread_fn, NULL, NULL, NULL,
+			CONFIG_AOA_LOCATOR_TX_THREAD_PRIORITY, 0, K_NO_WAIT);
+	k_thread_name_set(&tx_thread, "aoa_tx");
+
+	return 0;
+}
+
+struct tx_frame *tx_pipeline_frame_alloc(void)
+{
+	struct tx_frame *frame;
+
+	if (k_msgq_get(&free_frames_msgq, &frame, K_NO_WAIT)) {
+		atomic_inc(&g_dropped);
+		return NULL;
+	}
+
+	frame->len = 0;
+	return frame;
+}
+
+void tx_pipeline_frame_submit(struct tx_frame *frame)
+{
+	assert(frame != NULL);
+
+	if (frame->len == 0) {
+		tx_pipeline_frame_free(frame);
+		return;
+	}
+
+	/* Queue has room for every frame from the pool, so it never blocks. */
+	k_msgq_put(&ready_frames_msgq, &frame, K_NO_WAIT);
+	atomic_inc(&g_queued);
+}
+
+void tx_pipeline_frame_free(struct tx_frame *frame)
+{
+	assert(frame != NULL);
+
+	k_msgq_put(&free_frames_msgq, &frame, K_NO_WAIT);
+}
+
+void tx_pipeline_stats_get(struct tx_pipeline_stats *stats)
+{
+	assert(stats != NULL);
+
+	stats->queued = atomic_get(&g_queued);
+	stats->sent = atomic_get(&g_sent);
+	stats->dropped = atomic_get(&g_dropped);
+	stats->aborted = atomic_get(&g_aborted);
+	stats->pending = k_msgq_num_used_get(&ready_frames_msgq);
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef AOA_LOCATOR_SRC_TX_PIPELINE_H_
+#define AOA_LOCATOR_SRC_TX_PIPELINE_H_
+
+#include <zephyr/types.h>
+#include "if.h"
+
+/** @brief Output frame exchanged between processing and transmit threads
+ */
+struct tx_frame {
+	/** @brief number of bytes stored in @ref buf */
+	size_t len;
+	/** @brief frame data */
+	char buf[CONFIG_AOA_LOCATOR_TX_FRAME_SIZE];
+};
+
+/** @brief TX pipeline statistics
+ */
+struct tx_pipeline_stats {
+	/** @brief number of frames queued for transmission */
+	u32_t queued;
+	/** @brief number of frames sent */
+	u32_t sent;
+	/** @brief number of frames dropped because no free frame was available */
+	u32_t dropped;
+	/** @brief number of frames which transmission was aborted */
+	u32_t aborted;
+	/** @brief number of frames currently waiting for transmission */
+	u32_t pending;
+};
+
+/** @brief Initializes TX pipeline and starts transmit thread
+ *
+ * @param iface	pointer to output interface that supports DMA transmission
+ *
+ * @retval 0		successful initialization
+ * @retval -EINVAL	if @p iface is NULL or does not support DMA transmission
+ */
+int tx_pipeline_init(struct if_data *iface);
+
+/** @brief Gets free frame from the pool
+ *
+ * The function does not block. If all frames are queued or being sent
+ * the packet should be dropped, that is accounted in statistics.
+ *
+ * @return pointer to free frame, NULL if there is no free frame
+ */
+struct tx_frame *tx_pipeline_frame_alloc(void);
+
+/** @brief Queues frame for transmission
+ *
+ * Ownership of the frame is passed to transmit thread. The frame returns
+ * to the pool after its transmission is finished.
+ *
+ * @param frame	frame got from @ref tx_pipeline_frame_alloc
+ */
+void tx_pipeline_frame_submit(struct tx_frame *frame);
+
+/** @brief Returns frame to the pool without transmission
+ *
+ * @param frame	frame got from @ref tx_pipeline_frame_alloc
+ */
+void tx_pipeline_frame_free(struct tx_frame *frame);
+
+/** @brief Provides TX pipeline statistics
+ *
+ * @param stats	pointer where to store statistics
+ */
+void tx_pipeline_stats_get(struct tx_pipeline_stats *stats);
+
+#endif /* AOA_LOCATOR_SRC_TX_PIPELINE_H_ */
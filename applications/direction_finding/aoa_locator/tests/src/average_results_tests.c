@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+#include <ztest.h>
+#include <math.h>
+
+#include <average_results.h>
+#include "average_results_tests.h"
+
+#define TEST_ALPHA 0.4f
+#define TEST_BETA 0.05f
+#define TEST_GATE 45.0f
+
+/** @brief Number of results in benchmark trace */
+#define TEST_TRACE_LEN 400
+/** @brief Number of results ignored at the beginning of the trace,
+ * so filters are settled before errors are measured.
+ */
+#define TEST_TRACE_WARMUP 40
+/** @brief Azimuth change between results [deg] */
+#define TEST_TRACE_RATE 1.5f
+/** @brief Peak to peak noise of measured angles [deg] */
+#define TEST_TRACE_NOISE 6.0f
+/** @brief Every n-th result of the trace is an outlier */
+#define TEST_TRACE_OUTLIER_PERIOD 37
+
+static u32_t g_rand_state;
+
+static float test_rand(void)
+{
+	g_rand_state = (g_rand_state * 1664525u) + 1013904223u;
+	return (float)(g_rand_state >> 8) / (float)(1 << 24);
+}
+
+static float angle_diff(float a, float b)
+{
+	float diff = fmodf(a - b, 360.0f);
+
+	if (diff > 180.0f) {
+		diff -= 360.0f;
+	} else if (diff <= -180.0f) {
+		diff += 360.0f;
+	}
+	return fabsf(diff);
+}
+
+static float wrap(float angle)
+{
+	angle = fmodf(angle, 360.0f);
+	return (angle >= 0.0f) ? angle : angle + 360.0f;
+}
+
+static void set_results(struct aoa_results *results, float azimuth,
+			float elevation)
+{
+	results->raw_result.azimuth = azimuth;
+	results->raw_result.elevation = elevation;
+}
+
+void test_angle_tracker_wraps_around_full_angle()
+{
+	struct angle_tracker tracker;
+	struct aoa_results results;
+	struct aoa_results filtered;
+
+	angle_tracker_init(&tracker, TEST_ALPHA, TEST_BETA, TEST_GATE);
+
+	for (int idx = 0; idx < 10; ++idx) {
+		set_results(&results, (idx & 0x1) ? 1.0f : 359.0f, 45.0f);
+		zassert_equal(angle_tracker_update(&tracker, &results, &filtered), 0,
+			      "Tracker update failed");
+		zassert_true(angle_diff(filtered.raw_result.azimuth, 0.0f) < 2.0f,
+			     "Angle not tracked across 0 degree");
+		zassert_true(filtered.raw_result.azimuth >= 0.0f &&
+			     filtered.raw_result.azimuth < 360.0f,
+			     "Angle out of range");
+	}
+
+	zassert_equal(tracker.outliers, 0, "Measurements rejected");
+	zassert_equal(angle_tracker_update(NULL, &results, &filtered), -EINVAL,
+		      "NULL tracker accepted");
+}
+
+void test_angle_tracker_gate_rejects_outliers()
+{
+	struct angle_tracker tracker;
+	struct aoa_results results;
+	struct aoa_results filtered;
+
+	angle_tracker_init(&tracker, TEST_ALPHA, TEST_BETA, TEST_GATE);
+
+	for (int idx = 0; idx < 10; ++idx) {
+		set_results(&results, 100.0f, 45.0f);
+		angle_tracker_update(&tracker, &results, &filtered);
+	}
+
+	set_results(&results, 250.0f, 45.0f);
+	angle_tracker_update(&tracker, &results, &filtered);
+
+	zassert_equal(tracker.outliers, 1, "Outlier not rejected");
+	zassert_true(angle_diff(filtered.raw_result.azimuth, 100.0f) < 0.1f,
+		     "Outlier affected tracked angle");
+
+	set_results(&results, 100.0f, 45.0f);
+	angle_tracker_update(&tracker, &results, &filtered);
+	zassert_equal(tracker.azimuth.rejected, 0, "Rejections not cleared");
+}
+
+void test_angle_tracker_gate_follows_real_jump()
+{
+	struct angle_tracker tracker;
+	struct aoa_results results;
+	struct aoa_results filtered;
+
+	angle_tracker_init(&tracker, TEST_ALPHA, TEST_BETA, TEST_GATE);
+
+	for (int idx = 0; idx < 10; ++idx) {
+		set_results(&results, 100.0f, 45.0f);
+		angle_tracker_update(&tracker, &results, &filtered);
+	}
+
+	for (int idx = 0; idx <= ANGLE_TRACKER_MAX_REJECTED; ++idx) {
+		set_results(&results, 200.0f, 45.0f);
+		angle_tracker_update(&tracker, &results, &filtered);
+	}
+
+	zassert_true(angle_diff(filtered.raw_result.azimuth, 200.0f) < 0.1f,
+		     "Tracker did not follow angle change");
+	zassert_equal(tracker.outliers, ANGLE_TRACKER_MAX_REJECTED + 1,
+		      "Wrong number of outliers");
+}
+
+/** @brief Compares lag and cost of alpha-beta tracker and FIR filter
+ *
+ * The trace emulates a tag moving around the locator: azimuth changes at
+ * constant rate and crosses 0 degree, measurements are noisy and some of
+ * them are outliers (e.g. reflections). Mean error against true azimuth
+ * shows lag of the filters. Cycle counts are printed only, on native_posix
+ * they reflect simulated time.
+ */
+void test_angle_tracker_vs_fir_benchmark()
+{
+	static struct fir_filter fir;
+	struct angle_tracker tracker;
+	struct aoa_results results;
+	struct aoa_results filtered;
+	float fir_error = 0.0f;
+	float tracker_error = 0.0f;
+	u32_t fir_cycles = 0;
+	u32_t tracker_cycles = 0;
+	u32_t start;
+
+	fir_filter_init(&fir);
+	angle_tracker_init(&tracker, TEST_ALPHA, TEST_BETA, TEST_GATE);
+	g_rand_state = 0xa0a;
+
+	for (int idx = 0; idx < TEST_TRACE_LEN; ++idx) {
+		float azimuth = wrap(300.0f + (TEST_TRACE_RATE * idx));
+		float measured = azimuth + (TEST_TRACE_NOISE * (test_rand() - 0.5f));
+
+		if ((idx % TEST_TRACE_OUTLIER_PERIOD) == (TEST_TRACE_OUTLIER_PERIOD - 1)) {
+			measured += 120.0f;
+		}
+
+		set_results(&results, wrap(measured),
+			    45.0f + (TEST_TRACE_NOISE * (test_rand() - 0.5f)));
+
+		start = k_cycle_get_32();
+		fir_filter_process(&fir, &results, &filtered);
+		fir_cycles += k_cycle_get_32() - start;
+
+		if (idx >= TEST_TRACE_WARMUP) {
+			fir_error += angle_diff(filtered.raw_result.azimuth, azimuth);
+		}
+
+		start = k_cycle_get_32();
+		angle_tracker_update(&tracker, &results, &filtered);
+		tracker_cycles += k_cycle_get_32() - start;
+
+		if (idx >= TEST_TRACE_WARMUP) {
+			tracker_error += angle_diff(filtered.raw_result.azimuth, azimuth);
+		}
+	}
+
+	fir_error /= (TEST_TRACE_LEN - TEST_TRACE_WARMUP);
+	tracker_error /= (TEST_TRACE_LEN - TEST_TRACE_WARMUP);
+
+	TC_PRINT("Moving tag, %d results:\n", TEST_TRACE_LEN);
+	TC_PRINT("\tFIR:        mean error %d mdeg, %u cycles per update\n",
+		 (int)(fir_error * 1000), fir_cycles / TEST_TRACE_LEN);
+	TC_PRINT("\talpha-beta: mean error %d mdeg, %u cycles per update, %u outliers\n",
+		 (int)(tracker_error * 1000), tracker_cycles / TEST_TRACE_LEN,
+		 tracker.outliers);
+
+	zassert_true(tracker_error < fir_error,
+		     "Tracker lags more than FIR filter");
+	zassert_true(tracker.outliers >= (TEST_TRACE_LEN / TEST_TRACE_OUTLIER_PERIOD),
+		     "Outliers not rejected");
+}
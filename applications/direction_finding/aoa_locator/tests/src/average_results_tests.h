@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+#ifndef TESTS_SRC_AVERAGE_RESULTS_TESTS_H_
+#define TESTS_SRC_AVERAGE_RESULTS_TESTS_H_
+
+void test_angle_tracker_wraps_around_full_angle();
+void test_angle_tracker_gate_rejects_outliers();
+void test_angle_tracker_gate_follows_real_jump();
+void test_angle_tracker_vs_fir_benchmark();
+
+#endif /* TESTS_SRC_AVERAGE_RESULTS_TESTS_H_ */
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+#include <ztest.h>
+#include <errno.h>
+
+#include <df_frame.h>
+#include "df_frame_tests.h"
+
+/** @brief Number of IQ samples put into test frame */
+#define TEST_IQ_SAMPLES_NUM 160
+/** @brief Antenna index used for samples taken in switch slots */
+#define TEST_ANT_INCORRECT 0xFF
+
+static u8_t g_test_frame_buf[DF_FRAME_HEADER_LEN + DF_FRAME_FOOTER_LEN +
+			     (4 * DF_FRAME_RECORD_HEADER_LEN) +
+			     DF_FRAME_SAMPLING_LEN + DF_FRAME_ANGLES_LEN +
+			     DF_FRAME_TAG_LEN +
+			     DF_FRAME_IQ_HEADER_LEN +
+			     (TEST_IQ_SAMPLES_NUM * DF_FRAME_IQ_SAMPLE_LEN)];
+
+static const struct df_frame_sampling g_test_sampling = {
+	.switch_spacing = 2,
+	.sample_spacing_ref = 5,
+	.sample_spacing = 5,
+	.frequency = 2402,
+};
+
+static const struct df_frame_angles g_test_angles = {
+	.elevation = 89,
+	.azimuth = 310,
+	.filtered_elevation = 88,
+	.filtered_azimuth = 308,
+};
+
+static const struct df_frame_tag g_test_tag = {
+	.type = 1,
+	.addr = { 0x55, 0x44, 0x33, 0x22, 0x11, 0xC0 },
+};
+
+/** @brief Builds IQ sample data from its index.
+ *
+ * Negative values and 12 bit extremes are used to check sign handling.
+ */
+static void get_test_sample(u16_t idx, struct df_frame_iq_sample *sample)
+{
+	sample->time = idx * 2;
+	sample->antenna_id = (idx & 0x1) ? TEST_ANT_INCORRECT : (idx % 12) + 1;
+	sample->i = (s16_t)(idx * 13) - 2048;
+	sample->q = 2047 - (s16_t)(idx * 7);
+}
+
+static int build_test_frame(u8_t *buf, size_t size, u16_t sequence)
+{
+	struct df_frame_writer writer;
+	struct df_frame_iq_sample sample;
+	int err;
+
+	err = df_frame_begin(&writer, buf, size, sequence);
+	if (err) {
+		return err;
+	}
+
+	df_frame_iq_begin(&writer, 0);
+	for (u16_t idx = 0; idx < TEST_IQ_SAMPLES_NUM; ++idx) {
+		get_test_sample(idx, &sample);
+		df_frame_iq_put(&writer, sample.time, sample.antenna_id,
+				sample.i, sample.q);
+	}
+	df_frame_iq_end(&writer);
+
+	df_frame_put_tag(&writer, &g_test_tag);
+	df_frame_put_sampling(&writer, &g_test_sampling);
+	df_frame_put_angles(&writer, &g_test_angles);
+
+	return df_frame_end(&writer);
+}
+
+void test_df_frame_round_trip()
+{
+	struct df_frame_reader reader;
+	struct df_frame_record record;
+	struct df_frame_iq_sample expected;
+	struct df_frame_iq_sample sample;
+	struct df_frame_sampling sampling;
+	struct df_frame_angles angles;
+	struct df_frame_tag tag;
+	u16_t first_idx;
+	int records_num = 0;
+
+	int len = build_test_frame(g_test_frame_buf, sizeof(g_test_frame_buf), 7);
+
+	zassert_equal(len, sizeof(g_test_frame_buf), "Wrong frame length");
+
+	zassert_equal(df_frame_open(&reader, g_test_frame_buf, len), 0,
+		      "Valid frame not accepted");
+	zassert_equal(reader.sequence, 7, "Wrong sequence number");
+
+	while (df_frame_next_record(&reader, &record) == 0) {
+		switch (record.type) {
+		case DF_FRAME_RECORD_IQ:
+			zassert_equal(df_frame_iq_count(&record, &first_idx),
+				      TEST_IQ_SAMPLES_NUM, "Wrong IQ samples number");
+			zassert_equal(first_idx, 0, "Wrong first sample index");
+			for (u16_t idx = 0; idx < TEST_IQ_SAMPLES_NUM; ++idx) {
+				get_test_sample(idx, &expected);
+				zassert_equal(df_frame_iq_get(&record, idx, &sample), 0,
+					      "IQ sample decoding failed");
+				zassert_equal(sample.time, expected.time, "Wrong time");
+				zassert_equal(sample.antenna_id, expected.antenna_id,
+					      "Wrong antenna id");
+				zassert_equal(sample.i, expected.i, "Wrong I value");
+				zassert_equal(sample.q, expected.q, "Wrong Q value");
+			}
+			zassert_equal(df_frame_iq_get(&record, TEST_IQ_SAMPLES_NUM, &sample),
+				      -EINVAL, "Sample out of block decoded");
+			break;
+		case DF_FRAME_RECORD_SAMPLING:
+			zassert_equal(df_frame_get_sampling(&record, &sampling), 0,
+				      "Sampling decoding failed");
+			zassert_equal(sampling.switch_spacing,
+				      g_test_sampling.switch_spacing,
+				      "Wrong switch spacing");
+			zassert_equal(sampling.sample_spacing_ref,
+				      g_test_sampling.sample_spacing_ref,
+				      "Wrong reference sample spacing");
+			zassert_equal(sampling.sample_spacing,
+				      g_test_sampling.sample_spacing,
+				      "Wrong sample spacing");
+			zassert_equal(sampling.frequency,
+				      g_test_sampling.frequency,
+				      "Wrong frequency");
+			break;
+		case DF_FRAME_RECORD_ANGLES:
+			zassert_equal(df_frame_get_angles(&record, &angles), 0,
+				      "Angles decoding failed");
+			zassert_equal(angles.elevation, g_test_angles.elevation,
+				      "Wrong elevation");
+			zassert_equal(angles.azimuth, g_test_angles.azimuth,
+				      "Wrong azimuth");
+			zassert_equal(angles.filtered_elevation,
+				      g_test_angles.filtered_elevation,
+				      "Wrong filtered elevation");
+			zassert_equal(angles.filtered_azimuth,
+				      g_test_angles.filtered_azimuth,
+				      "Wrong filtered azimuth");
+			break;
+		case DF_FRAME_RECORD_TAG:
+			zassert_equal(df_frame_get_tag(&record, &tag), 0,
+				      "Tag decoding failed");
+			zassert_equal(tag.type, g_test_tag.type,
+				      "Wrong address type");
+			zassert_mem_equal(tag.addr, g_test_tag.addr,
+					  sizeof(tag.addr), "Wrong address");
+			break;
+		default:
+			zassert_unreachable("Unknown record type");
+		}
+		++records_num;
+	}
+
+	zassert_equal(records_num, 4, "Wrong number of records");
+}
+
+void test_df_frame_corrupted_crc_is_rejected()
+{
+	struct df_frame_reader reader;
+
+	int len = build_test_frame(g_test_frame_buf, sizeof(g_test_frame_buf), 0);
+
+	zassert_true(len > 0, "Frame not built");
+
+	g_test_frame_buf[DF_FRAME_HEADER_LEN + 10] ^= 0x01;
+	zassert_equal(df_frame_open(&reader, g_test_frame_buf, len), -EBADMSG,
+		      "Corrupted frame accepted");
+}
+
+void test_df_frame_truncated_frame_is_incomplete()
+{
+	struct df_frame_reader reader;
+
+	int len = build_test_frame(g_test_frame_buf, sizeof(g_test_frame_buf), 0);
+
+	zassert_true(len > 0, "Frame not built");
+	zassert_equal(df_frame_open(&reader, g_test_frame_buf, len - 1), -EAGAIN,
+		      "Truncated frame accepted");
+	zassert_equal(df_frame_open(&reader, g_test_frame_buf, 4), -EAGAIN,
+		      "Truncated header accepted");
+}
+
+void test_df_frame_too_small_buffer()
+{
+	int len = build_test_frame(g_test_frame_buf, sizeof(g_test_frame_buf) - 1, 0);
+
+	zassert_equal(len, -ENOMEM, "Frame exceeding buffer built");
+
+	struct df_frame_writer writer;
+
+	zassert_equal(df_frame_begin(&writer, g_test_frame_buf, DF_FRAME_HEADER_LEN, 0),
+		      -ENOMEM, "Frame without room for footer started");
+}
+
+void test_df_frame_unclosed_record()
+{
+	struct df_frame_writer writer;
+
+	zassert_equal(df_frame_begin(&writer, g_test_frame_buf,
+				     sizeof(g_test_frame_buf), 0), 0,
+		      "Frame not started");
+	df_frame_iq_begin(&writer, 0);
+	df_frame_put_angles(&writer, &g_test_angles);
+
+	zassert_equal(df_frame_end(&writer), -EINVAL,
+		      "Frame with nested records built");
+}
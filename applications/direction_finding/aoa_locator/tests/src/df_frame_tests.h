@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+#ifndef TESTS_SRC_DF_FRAME_TESTS_H_
+#define TESTS_SRC_DF_FRAME_TESTS_H_
+
+void test_df_frame_round_trip();
+void test_df_frame_corrupted_crc_is_rejected();
+void test_df_frame_truncated_frame_is_incomplete();
+void test_df_frame_too_small_buffer();
+void test_df_frame_unclosed_record();
+
+#endif /* TESTS_SRC_DF_FRAME_TESTS_H_ */
@@ -169,6 +169,88 @@ void test_iq_samples_to_ant_mapping_if_undersampling_is_configured(void)
 	}
 }
 
+void test_packet_view_mapping_skips_switch_slots(void)
+{
+	struct dfe_sampling_config *sampl_config = get_test_sampl_config();
+	struct dfe_antenna_config *ant_conf = get_test_ant_config();
+	struct dfe_packet_view view;
+
+	dfe_packet_view_init(&view, &g_test_df_data_packet, sampl_config, ant_conf);
+	dfe_map_packet_view(&g_test_df_data_mapped, &g_test_iq_storage,
+			    &g_test_slots_storage, &view);
+
+	/* In case of oversampling every 2nd slot is a switch slot */
+	uint16_t effective_slots_num = dfe_get_effective_slots_num(sampl_config);
+	uint8_t samples_num = dfe_get_sampling_slot_samples_num(sampl_config);
+	uint16_t ref_samples_num = get_ref_samples_num(sampl_config);
+
+	zassert_equal(g_test_df_data_mapped.header.length, (effective_slots_num + 1) / 2,
+		      "Wrong length of mapped IQ data");
+
+	for (uint16_t idx = 0; idx < ref_samples_num; ++idx) {
+		zassert_equal((int)g_test_df_data_mapped.ref_data.data[idx].i, idx,
+			      "Wrong reference sample");
+	}
+
+	for (uint16_t slot_idx = 0; slot_idx < g_test_df_data_mapped.header.length; ++slot_idx) {
+		const struct dfe_samples *sampl_data = &g_test_df_data_mapped.sampl_data[slot_idx];
+		uint8_t ant_num = ant_conf->antennae_switch_idx[slot_idx % ant_conf->antennae_switch_idx_len];
+
+		zassert_equal(sampl_data->antenna_id, ant_num,
+			      "Wrong antenna idx found. Does not match to configuration");
+		zassert_equal(sampl_data->samples_num, samples_num,
+			      "Wrong number of samples in a slot");
+
+		/* Raw samples have I equal to sample index, Q equal to 2 * I */
+		for (uint8_t sample_idx = 0; sample_idx < samples_num; ++sample_idx) {
+			int raw_idx = ref_samples_num + (2 * slot_idx * samples_num) + sample_idx;
+
+			zassert_equal((int)sampl_data->data[sample_idx].i, raw_idx,
+				      "Sample taken from wrong slot");
+			zassert_equal((int)sampl_data->data[sample_idx].q, 2 * raw_idx,
+				      "Sample taken from wrong slot");
+		}
+	}
+}
+
+void test_packet_view_is_limited_to_packet_length(void)
+{
+	struct dfe_sampling_config *sampl_config = get_test_sampl_config();
+	struct dfe_antenna_config *ant_conf = get_test_ant_config();
+	struct dfe_packet_view view;
+	struct dfe_slot_iter iter;
+	struct dfe_slot_span span;
+
+	uint8_t samples_num = dfe_get_sampling_slot_samples_num(sampl_config);
+	uint16_t ref_samples_num = get_ref_samples_num(sampl_config);
+
+	/* Three complete slots and part of the fourth one */
+	g_test_df_data_packet.hdr.length = ref_samples_num + (3 * samples_num) + 1;
+
+	dfe_packet_view_init(&view, &g_test_df_data_packet, sampl_config, ant_conf);
+	zassert_equal(view.slots_num, 3, "Incomplete slot available in view");
+
+	uint16_t slots = 0;
+
+	dfe_slot_iter_init(&iter, &view, false);
+	while (dfe_slot_iter_next(&iter, &span)) {
+		zassert_equal(span.slot_idx, slots, "Wrong slot number");
+		zassert_equal(span.first_sample, ref_samples_num + (slots * samples_num),
+			      "Wrong first sample of a slot");
+		++slots;
+	}
+	zassert_equal(slots, 3, "Wrong number of slots provided by iterator");
+
+	/* Only reference samples */
+	g_test_df_data_packet.hdr.length = ref_samples_num - 1;
+
+	dfe_packet_view_init(&view, &g_test_df_data_packet, sampl_config, ant_conf);
+	zassert_equal(view.ref_samples_num, ref_samples_num - 1, "Wrong number of reference samples");
+	zassert_equal(view.slots_num, 0, "Slots available in view without samples");
+
+	g_test_df_data_packet.hdr.length = DFE_TOTAL_SAMPLES_NUM;
+}
+
 void prepare_samples_mapped_to_antennas_every_2nd_slot_to_remove()
 {
 	struct dfe_sampling_config *sampl_config = get_test_sampl_config();
@@ -274,6 +356,13 @@ void test_remove_samples_from_switching_slots_every_2nd_slot_to_remove()
 	}
 	effective_slots_num /= 2;
 	zassert_equal(g_test_df_data_mapped.header.length, effective_slots_num, "Wrong number of slots found in mapped data");
+
+	/* Samples are not moved, remaining slots refer to original storage */
+	for (int slot_idx = 0; slot_idx < g_test_df_data_mapped.header.length; ++slot_idx) {
+		zassert_equal_ptr(g_test_df_data_mapped.sampl_data[slot_idx].data,
+				  g_test_iq_storage.data[2 * slot_idx],
+				  "Slot refers to wrong samples");
+	}
 }
 
 void test_remove_samples_from_switching_slots_no_slot_to_remove()
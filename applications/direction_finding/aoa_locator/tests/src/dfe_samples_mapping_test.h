@@ -11,6 +11,8 @@ void setup_fixture_prepare_iq_data_and_over_sampling_config();
 void test_iq_samples_to_ant_mapping_if_oversampling_configured();
 void test_iq_samples_to_ant_mapping_if_ble_compliant_sampling_is_configured();
 void test_iq_samples_to_ant_mapping_if_undersampling_is_configured();
+void test_packet_view_mapping_skips_switch_slots();
+void test_packet_view_is_limited_to_packet_length();
 
 void test_remove_samples_from_switching_slots_every_2nd_slot_to_remove();
 void test_remove_samples_from_switching_slots_no_slot_to_remove();
@@ -12,6 +12,9 @@
 #include "dfe_samples_mapping_test.h"
 #include "configuration_fixtures.h"
 #include "dfe_configuration_tests.h"
+#include "df_frame_tests.h"
+#include "tag_tracker_tests.h"
+#include "average_results_tests.h"
 
 void test_main(void)
 {
@@ -34,7 +37,9 @@ void test_main(void)
 		ztest_unit_test_setup_teardown(test_iq_samples_to_ant_mapping_if_ble_compliant_sampling_is_configured, setup_fixture_prepare_bt_sampling_1us_switch_slot, common_teardown),
 		ztest_unit_test_setup_teardown(test_iq_samples_to_ant_mapping_if_ble_compliant_sampling_is_configured, setup_fixture_prepare_bt_sampling_2us_switch_slot, common_teardown),
 		ztest_unit_test_setup_teardown(test_iq_samples_to_ant_mapping_if_undersampling_is_configured, setup_fixture_prepare_undersampling_sample_every_2nd_slot, common_teardown),
-		ztest_unit_test_setup_teardown(test_iq_samples_to_ant_mapping_if_undersampling_is_configured, setup_fixture_prepare_undersampling_sample_every_4th_slot, common_teardown));
+		ztest_unit_test_setup_teardown(test_iq_samples_to_ant_mapping_if_undersampling_is_configured, setup_fixture_prepare_undersampling_sample_every_4th_slot, common_teardown),
+		ztest_unit_test_setup_teardown(test_packet_view_mapping_skips_switch_slots, setup_fixture_prepare_iq_data_and_over_sampling_config, common_teardown),
+		ztest_unit_test_setup_teardown(test_packet_view_is_limited_to_packet_length, setup_fixture_prepare_iq_data_and_over_sampling_config, common_teardown));
 
 	ztest_test_suite(test_remove_samples_from_switching_slots,
 		ztest_unit_test_setup_teardown(test_remove_samples_from_switching_slots_every_2nd_slot_to_remove, setup_fixture_prepare_over_sampling, common_teardown),
@@ -42,8 +47,30 @@ void test_main(void)
 		ztest_unit_test_setup_teardown(test_remove_samples_from_switching_slots_no_slot_to_remove, setup_fixture_prepare_over_sampling, common_teardown));
 
 
+	ztest_test_suite(test_df_binary_frame,
+		ztest_unit_test(test_df_frame_round_trip),
+		ztest_unit_test(test_df_frame_corrupted_crc_is_rejected),
+		ztest_unit_test(test_df_frame_truncated_frame_is_incomplete),
+		ztest_unit_test(test_df_frame_too_small_buffer),
+		ztest_unit_test(test_df_frame_unclosed_record));
+
+	ztest_test_suite(test_tag_tracker,
+		ztest_unit_test_setup_teardown(test_tag_tracker_same_address_same_state, setup_tag_tracker, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_tag_tracker_address_type_is_part_of_key, setup_tag_tracker, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_tag_tracker_evicts_least_recently_used, setup_tag_tracker, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_tag_tracker_filters_are_independent, setup_tag_tracker, unit_test_noop));
+
+	ztest_test_suite(test_angle_tracker,
+		ztest_unit_test(test_angle_tracker_wraps_around_full_angle),
+		ztest_unit_test(test_angle_tracker_gate_rejects_outliers),
+		ztest_unit_test(test_angle_tracker_gate_follows_real_jump),
+		ztest_unit_test(test_angle_tracker_vs_fir_benchmark));
+
 	ztest_run_test_suite(sampling_type_tests);
 	ztest_run_test_suite(calculation_of_effective_slots_tests);
 	ztest_run_test_suite(test_iq_samples_and_antenna_mapping);
 	ztest_run_test_suite(test_remove_samples_from_switching_slots);
+	ztest_run_test_suite(test_df_binary_frame);
+	ztest_run_test_suite(test_tag_tracker);
+	ztest_run_test_suite(test_angle_tracker);
 }
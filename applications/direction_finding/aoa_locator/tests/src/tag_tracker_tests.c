@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+#include <ztest.h>
+#include <math.h>
+
+#include <tag_tracker.h>
+#include "tag_tracker_tests.h"
+
+/** @brief Builds test address from its index */
+static void get_test_addr(u32_t idx, u8_t type, bt_addr_le_t *addr)
+{
+	addr->type = type;
+	addr->a.val[0] = idx & 0xFF;
+	addr->a.val[1] = (idx >> 8) & 0xFF;
+	addr->a.val[2] = 0x33;
+	addr->a.val[3] = 0x22;
+	addr->a.val[4] = 0x11;
+	addr->a.val[5] = 0xC0;
+}
+
+void setup_tag_tracker(void)
+{
+	tag_tracker_init();
+}
+
+void test_tag_tracker_same_address_same_state()
+{
+	bt_addr_le_t addr;
+	struct tag_tracker_stats stats;
+
+	get_test_addr(1, BT_ADDR_LE_RANDOM, &addr);
+
+	struct tag_state *tag = tag_tracker_get(&addr);
+
+	zassert_not_null(tag, "No tag state provided");
+	zassert_equal(bt_addr_le_cmp(&tag->addr, &addr), 0, "Wrong tag address");
+	zassert_equal(tag->cte_count, 0, "New tag has CTEs counted");
+	tag->cte_count = 5;
+
+	zassert_equal_ptr(tag_tracker_get(&addr), tag, "Tag state not found");
+	zassert_equal(tag->cte_count, 5, "Tag state was reset");
+
+	tag_tracker_stats_get(&stats);
+	zassert_equal(stats.tags, 1, "Wrong number of tags");
+	zassert_equal(stats.evicted, 0, "Tag evicted");
+}
+
+void test_tag_tracker_address_type_is_part_of_key()
+{
+	bt_addr_le_t addr_public;
+	bt_addr_le_t addr_random;
+
+	get_test_addr(1, BT_ADDR_LE_PUBLIC, &addr_public);
+	get_test_addr(1, BT_ADDR_LE_RANDOM, &addr_random);
+
+	struct tag_state *tag_public = tag_tracker_get(&addr_public);
+	struct tag_state *tag_random = tag_tracker_get(&addr_random);
+
+	zassert_not_equal(tag_public, tag_random,
+			  "Different address types share the state");
+}
+
+void test_tag_tracker_evicts_least_recently_used()
+{
+	bt_addr_le_t addr;
+	struct tag_tracker_stats stats;
+	struct tag_state *first;
+
+	get_test_addr(0, BT_ADDR_LE_RANDOM, &addr);
+	first = tag_tracker_get(&addr);
+	first->cte_count = 1;
+
+	for (u32_t idx = 1; idx < TAG_TRACKER_CAPACITY; ++idx) {
+		get_test_addr(idx, BT_ADDR_LE_RANDOM, &addr);
+		tag_tracker_get(&addr)->cte_count = 1;
+	}
+
+	/* The first tag becomes the most recently seen one, so the second
+	 * tag is the least recently seen one.
+	 */
+	get_test_addr(0, BT_ADDR_LE_RANDOM, &addr);
+	zassert_equal_ptr(tag_tracker_get(&addr), first, "First tag lost");
+
+	get_test_addr(TAG_TRACKER_CAPACITY, BT_ADDR_LE_RANDOM, &addr);
+	zassert_equal(tag_tracker_get(&addr)->cte_count, 0,
+		      "New tag state not initialized");
+
+	tag_tracker_stats_get(&stats);
+	zassert_equal(stats.tags, TAG_TRACKER_CAPACITY, "Wrong number of tags");
+	zassert_equal(stats.evicted, 1, "Wrong number of evicted tags");
+
+	get_test_addr(0, BT_ADDR_LE_RANDOM, &addr);
+	zassert_equal_ptr(tag_tracker_get(&addr), first, "First tag evicted");
+	zassert_equal(first->cte_count, 1, "First tag state was reset");
+
+	/* Second tag was evicted, so its state is created again */
+	get_test_addr(1, BT_ADDR_LE_RANDOM, &addr);
+	zassert_equal(tag_tracker_get(&addr)->cte_count, 0,
+		      "Evicted tag still tracked");
+
+	tag_tracker_stats_get(&stats);
+	zassert_equal(stats.evicted, 2, "Wrong number of evicted tags");
+}
+
+void test_tag_tracker_filters_are_independent()
+{
+	bt_addr_le_t addr_a;
+	bt_addr_le_t addr_b;
+	struct aoa_results results = { 0 };
+	struct aoa_results filtered;
+
+	get_test_addr(10, BT_ADDR_LE_RANDOM, &addr_a);
+	get_test_addr(11, BT_ADDR_LE_RANDOM, &addr_b);
+
+	for (int idx = 0; idx < 10; ++idx) {
+		results.raw_result.azimuth = 30.0f;
+		results.raw_result.elevation = 80.0f;
+		zassert_equal(tag_tracker_filter(tag_tracker_get(&addr_a),
+						 &results, &filtered), 0,
+			      "Filter failed");
+
+		results.raw_result.azimuth = 200.0f;
+		results.raw_result.elevation = 10.0f;
+		zassert_equal(tag_tracker_filter(tag_tracker_get(&addr_b),
+						 &results, &filtered), 0,
+			      "Filter failed");
+	}
+
+	results.raw_result.azimuth = 30.0f;
+	results.raw_result.elevation = 80.0f;
+	tag_tracker_filter(tag_tracker_get(&addr_a), &results, &filtered);
+
+	zassert_true(fabsf(filtered.raw_result.azimuth - 30.0f) < 0.01f,
+		     "Azimuth mixed between tags");
+	zassert_true(fabsf(filtered.raw_result.elevation - 80.0f) < 0.01f,
+		     "Elevation mixed between tags");
+}
@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+#ifndef TESTS_SRC_TAG_TRACKER_TESTS_H_
+#define TESTS_SRC_TAG_TRACKER_TESTS_H_
+
+void setup_tag_tracker(void);
+void test_tag_tracker_same_address_same_state();
+void test_tag_tracker_address_type_is_part_of_key();
+void test_tag_tracker_evicts_least_recently_used();
+void test_tag_tracker_filters_are_independent();
+
+#endif /* TESTS_SRC_TAG_TRACKER_TESTS_H_ */
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <complex.h>
+#include <math.h>
+
+#include "dfe_local_config.h"
+#include "angle_evaluation.h"
+
+/**
+ * @brief Calculate sum of the samples
+ *
+ * @param sampl_data Data chunk to calculate sum of
+ *
+ * @return The sum of the samples in data chunk
+ */
+static float complex antenna_samples_sum(const struct dfe_samples* sampl_data)
+{
+	float complex sum = 0;
+
+	for (u16_t i = 0; i < sampl_data->samples_num; ++i)
+	{
+		sum += sampl_data->data[i].i + sampl_data->data[i].q*I;
+	}
+	return sum;
+}
+
+float antenna_data_to_phase_diff(const struct dfe_mapped_packet *mapped_data,
+				 u8_t a1, u8_t a2)
+{
+	float complex sum1 = 0, sum2 = 0;
+
+	for (u16_t idx=0; idx<mapped_data->header.length; ++idx)
+	{
+		const struct dfe_samples* sampl_data = &mapped_data->sampl_data[idx];
+		if (sampl_data->antenna_id == a1)
+			sum1 += antenna_samples_sum(sampl_data);
+		if (sampl_data->antenna_id == a2)
+			sum2 += antenna_samples_sum(sampl_data);
+	}
+	return cargf(sum1/sum2);
+}
+
+float phase_to_angle(float phase, float d, float freq)
+{
+	float arg = (phase * (float)WAVE_SPEED) / (2 * (float)PI * freq * d);
+
+	if (arg > 1.0f)
+		arg = 1.0f;
+	else if (arg < -1.0f)
+		arg = -1.0f;
+	return acos(arg);
+}
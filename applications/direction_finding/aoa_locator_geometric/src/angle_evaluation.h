@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef SRC_ANGLE_EVALUATION_H_
+#define SRC_ANGLE_EVALUATION_H_
+
+#include <zephyr/types.h>
+#include "dfe_samples_data.h"
+
+/**
+ * @brief Calculate phase difference between antennas
+ *
+ * The selected antennas phases are averaged and then the wave angle is calculated.
+ *
+ * @note This function expects the angles to be corrected to frequency 0 (DC).
+ *
+ * @param mapped_data The data do process
+ * @param a1          First antenna number
+ * @param a2          Second antenna number
+ *
+ * @return The phase difference between phases on antennas 1 and 2.
+ */
+float antenna_data_to_phase_diff(const struct dfe_mapped_packet *mapped_data,
+				 u8_t a1, u8_t a2);
+
+/**
+ * @brief Calculate the phase difference into angle in radians
+ *
+ * @param phase Phase difference between antennas
+ * @param d     Distance between antennas
+ * @param freq  Radio frequency to calculate wavelength
+ *
+ * @return The calculated angle
+ */
+float phase_to_angle(float phase, float d, float freq);
+
+#endif /* SRC_ANGLE_EVALUATION_H_ */
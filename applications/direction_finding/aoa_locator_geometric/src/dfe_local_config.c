@@ -12,6 +12,8 @@
 #include <nrf.h>
 
 #include "dfe_local_config.h"
+#include "dfe_raw_samples.h"
+#include "iq_fixed.h"
 
 const static struct dfe_sampling_config g_sampl_config = {
 	.dfe_mode = RADIO_DFEMODE_DFEOPMODE_AoA,
@@ -245,8 +247,13 @@ void dfe_map_iq_samples_to_antennas(struct dfe_mapped_packet *mapped_data,
 	mapped_data->ref_data.antenna_id = ant_config->ref_ant_idx;
 
 	for(uint16_t idx = 0; idx < ref_samples_num; ++idx) {
+#if defined(CONFIG_AOA_LOCATOR_FIXED_POINT)
+		mapped_data->ref_data.data[idx].q15.i = iq_fixed_from_raw(raw_data->data[idx].iq.i);
+		mapped_data->ref_data.data[idx].q15.q = iq_fixed_from_raw(raw_data->data[idx].iq.q);
+#else
 		mapped_data->ref_data.data[idx].i = raw_data->data[idx].iq.i;
 		mapped_data->ref_data.data[idx].q = raw_data->data[idx].iq.q;
+#endif
 	}
 	mapped_data->ref_data.samples_num = ref_samples_num;
 
@@ -259,7 +266,6 @@ void dfe_map_iq_samples_to_antennas(struct dfe_mapped_packet *mapped_data,
 
 	u8_t samples_num = get_sampling_slot_samples_num(sampling_conf);
 
-	u8_t effective_sample_idx;
 
 	bool oversampl = is_oversampling_enabled(sampling_conf);
 
@@ -286,9 +292,16 @@ void dfe_map_iq_samples_to_antennas(struct dfe_mapped_packet *mapped_data,
 		sample->antenna_id = ant;
 
 		for(u8_t sample_idx = 0; sample_idx < samples_num; ++sample_idx) {
-			effective_sample_idx = ref_samples_num + (ant_idx * samples_num) + sample_idx;
+			u16_t effective_sample_idx = dfe_raw_sample_idx(ref_samples_num, ant_idx,
+								   samples_num, sample_idx);
+
+#if defined(CONFIG_AOA_LOCATOR_FIXED_POINT)
+			sample->data[sample_idx].q15.i = iq_fixed_from_raw(raw_data->data[effective_sample_idx].iq.i);
+			sample->data[sample_idx].q15.q = iq_fixed_from_raw(raw_data->data[effective_sample_idx].iq.q);
+#else
 			sample->data[sample_idx].i = raw_data->data[effective_sample_idx].iq.i;
 			sample->data[sample_idx].q = raw_data->data[effective_sample_idx].iq.q;
+#endif
 		}
 		sample->samples_num = samples_num;
 	}
@@ -331,9 +344,9 @@ int remove_samples_from_switch_slot(struct dfe_mapped_packet *data,
 			sample_out->antenna_id = sample_in->antenna_id;
 			sample_out->samples_num = sample_in->samples_num;
 
-			for(u8_t sample_idx = 0; sample_idx <= sample_in->samples_num; ++sample_idx) {
-				sample_out->data[sample_idx].i = sample_in->data[sample_idx].i;
-				sample_out->data[sample_idx].q = sample_in->data[sample_idx].q;
+			for(u8_t sample_idx = 0; sample_idx < sample_in->samples_num; ++sample_idx) {
+				/* Copy whole union, it may hold float or Q15 sample */
+				sample_out->data[sample_idx] = sample_in->data[sample_idx];
 			}
 			++out_idx;
 		}
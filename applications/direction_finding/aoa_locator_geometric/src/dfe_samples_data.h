@@ -21,6 +21,8 @@ struct dfe_header {
  *
  * The data are stored as a union.
  * Second member data is an array that is a helper used by math ARM functions.
+ * Member q15 holds the sample when fixed-point processing is enabled
+ * (CONFIG_AOA_LOCATOR_FIXED_POINT), see iq_fixed.h.
  */
 union dfe_iq_f {
 	struct {
@@ -28,6 +30,10 @@ union dfe_iq_f {
 		float q; //!< 12bit
 	};
 	float data[2];
+	struct {
+		int16_t i;
+		int16_t q;
+	} q15;
 } __attribute__((packed));
 
 /* Max length of SWITH PERIOD supported by our radio is 8us.
@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <assert.h>
+
+#include "iq_fixed.h"
+
+/** @brief Number of bits of CORDIC input after normalization.
+ *
+ * CORDIC gain (~1.647) together with sqrt(2) of diagonal inputs must not
+ * overflow 32 bit signed values.
+ */
+#define CORDIC_INPUT_BITS 29
+
+/** @brief Number of intervals in quarter wave sine table */
+#define SIN_TABLE_INTERVALS 128
+
+/** @brief atan(2^-i) as binary angle */
+static const s32_t cordic_atan_table[IQ_FIXED_CORDIC_ITERATIONS] = {
+	536870912, 316933406, 167458907, 85004756, 42667331, 21354465,
+	10679838, 5340245, 2670163, 1335087, 667544, 333772,
+	166886, 83443, 41722, 20861, 10430, 5215,
+	2608, 1304, 652, 326, 163, 81,
+};
+
+/** @brief sin(x) in Q15 for x in [0, PI/2] */
+static const s16_t sin_table[SIN_TABLE_INTERVALS + 1] = {
+	0, 402, 804, 1206, 1608, 2009, 2410, 2811,
+	3212, 3612, 4011, 4410, 4808, 5205, 5602, 5998,
+	6393, 6786, 7179, 7571, 7962, 8351, 8739, 9126,
+	9512, 9896, 10278, 10659, 11039, 11417, 11793, 12167,
+	12539, 12910, 13279, 13645, 14010, 14372, 14732, 15090,
+	15446, 15800, 16151, 16499, 16846, 17189, 17530, 17869,
+	18204, 18537, 18868, 19195, 19519, 19841, 20159, 20475,
+	20787, 21096, 21403, 21705, 22005, 22301, 22594, 22884,
+	23170, 23452, 23731, 24007, 24279, 24547, 24811, 25072,
+	25329, 25582, 25832, 26077, 26319, 26556, 26790, 27019,
+	27245, 27466, 27683, 27896, 28105, 28310, 28510, 28706,
+	28898, 29085, 29268, 29447, 29621, 29791, 29956, 30117,
+	30273, 30424, 30571, 30714, 30852, 30985, 31113, 31237,
+	31356, 31470, 31580, 31685, 31785, 31880, 31971, 32057,
+	32137, 32213, 32285, 32351, 32412, 32469, 32521, 32567,
+	32609, 32646, 32678, 32705, 32728, 32745, 32757, 32765,
+	32767,
+};
+
+static inline u64_t abs64(s64_t value)
+{
+	return (value < 0) ? -(u64_t)value : (u64_t)value;
+}
+
+/** @brief Scales complex number so it fits CORDIC input range
+ *
+ * @param[in,out] y Imaginary part
+ * @param[in,out] x Real part
+ */
+static void cordic_normalize(s64_t *y, s64_t *x)
+{
+	u64_t max = abs64(*x) | abs64(*y);
+	int shift = (64 - __builtin_clzll(max)) - CORDIC_INPUT_BITS;
+
+	if (shift > 0) {
+		*x >>= shift;
+		*y >>= shift;
+	} else {
+		*x *= ((s64_t)1 << -shift);
+		*y *= ((s64_t)1 << -shift);
+	}
+}
+
+/** @brief Rotates vector onto positive real axis
+ *
+ * @param[in,out] x Real part, magnitude multiplied by CORDIC gain on return
+ * @param[in,out] y Imaginary part, close to zero on return
+ *
+ * @return Angle of the input vector
+ */
+static iq_angle_t cordic_vectoring(s32_t *x, s32_t *y)
+{
+	s32_t xi = *x;
+	s32_t yi = *y;
+	s32_t tmp;
+	/* Unsigned arithmetic, the angle wraps around at PI */
+	u32_t angle = 0;
+
+	/* CORDIC converges for vectors in right half plane only */
+	if (xi < 0) {
+		tmp = xi;
+		if (yi >= 0) {
+			xi = yi;
+			yi = -tmp;
+			angle = IQ_ANGLE_PI_2;
+		} else {
+			xi = -yi;
+			yi = tmp;
+			angle = -IQ_ANGLE_PI_2;
+		}
+	}
+
+	for (u8_t i = 0; i < IQ_FIXED_CORDIC_ITERATIONS; ++i) {
+		s32_t dx = xi >> i;
+		s32_t dy = yi >> i;
+
+		if (yi > 0) {
+			xi += dy;
+			yi -= dx;
+			angle += cordic_atan_table[i];
+		} else {
+			xi -= dy;
+			yi += dx;
+			angle -= cordic_atan_table[i];
+		}
+	}
+
+	*x = xi;
+	*y = yi;
+
+	return (iq_angle_t)angle;
+}
+
+iq_angle_t iq_fixed_atan2(s64_t y, s64_t x)
+{
+	if (x == 0 && y == 0) {
+		return 0;
+	}
+
+	cordic_normalize(&y, &x);
+
+	s32_t xi = (s32_t)x;
+	s32_t yi = (s32_t)y;
+
+	return cordic_vectoring(&xi, &yi);
+}
+
+static inline s16_t sin_table_interpolate(u32_t idx, u32_t next, s32_t frac)
+{
+	s32_t a = sin_table[idx];
+	s32_t b = sin_table[next];
+
+	return (s16_t)(a + (((b - a) * frac) >> 16));
+}
+
+void iq_fixed_sincos(iq_angle_t angle, s16_t *sin, s16_t *cos)
+{
+	assert(sin != NULL);
+	assert(cos != NULL);
+
+	u32_t a = (u32_t)angle;
+	u32_t quadrant = a >> 30;
+	/* 7 bits of table index followed by 16 bits of interpolation */
+	u32_t idx = (a >> 23) & (SIN_TABLE_INTERVALS - 1);
+	s32_t frac = (a >> 7) & 0xFFFF;
+
+	s16_t s = sin_table_interpolate(idx, idx + 1, frac);
+	s16_t c = sin_table_interpolate(SIN_TABLE_INTERVALS - idx,
+					SIN_TABLE_INTERVALS - idx - 1, frac);
+
+	switch (quadrant) {
+	case 0:
+		*sin = s;
+		*cos = c;
+		break;
+	case 1:
+		*sin = c;
+		*cos = -s;
+		break;
+	case 2:
+		*sin = -s;
+		*cos = -c;
+		break;
+	default:
+		*sin = -c;
+		*cos = s;
+		break;
+	}
+}
+
+/** @brief Rotates Q15 sample by binary angle */
+static inline void rotate_sample(union dfe_iq_f *iq, iq_angle_t angle)
+{
+	s16_t s, c;
+
+	iq_fixed_sincos(angle, &s, &c);
+
+	s32_t i = iq->q15.i;
+	s32_t q = iq->q15.q;
+
+	iq->q15.i = (s16_t)(((i * c) - (q * s) + (1 << 14)) >> 15);
+	iq->q15.q = (s16_t)(((i * s) + (q * c) + (1 << 14)) >> 15);
+}
+
+iq_angle_t iq_fixed_phase_avg_difference(const struct dfe_ref_samples *ref_data)
+{
+	assert(ref_data != NULL);
+
+	uint16_t samples_num = ref_data->samples_num;
+	s64_t sum = 0;
+
+	for (uint16_t idx = 0; idx < samples_num - 1; ++idx) {
+		s32_t i1 = ref_data->data[idx].q15.i;
+		s32_t q1 = ref_data->data[idx].q15.q;
+		s32_t i2 = ref_data->data[idx + 1].q15.i;
+		s32_t q2 = ref_data->data[idx + 1].q15.q;
+
+		/* arg(z1 * conj(z2)) */
+		sum += iq_fixed_atan2((q1 * i2) - (i1 * q2),
+				      (i1 * i2) + (q1 * q2));
+	}
+
+	return (iq_angle_t)(sum / (samples_num - 1));
+}
+
+void iq_fixed_phase_time_machine(struct dfe_mapped_packet *data,
+				 uint16_t slot_samples_num)
+{
+	assert(data != NULL);
+
+	/* Binary angles are multiplied in unsigned arithmetic, overflow
+	 * wraps the correction around full circle.
+	 */
+	u32_t phase_diff = iq_fixed_phase_avg_difference(&data->ref_data);
+
+	/* correct phase in ref. period*/
+	for (uint16_t idx = 0; idx < data->ref_data.samples_num; ++idx) {
+		rotate_sample(&data->ref_data.data[idx],
+			      (iq_angle_t)(phase_diff * idx));
+	}
+
+	/* correct phase in switching period.
+	 * Pay attention that sampling is started just after first switch slot,
+	 * that means there is additional time delay of TSWITCHING/2 */
+	uint16_t time_delay = data->ref_data.samples_num + slot_samples_num;
+	uint16_t switch_sampl_num = slot_samples_num * 2;
+
+	for (uint16_t ant_idx = 0; ant_idx < data->header.length; ++ant_idx) {
+		struct dfe_samples *sampl_data = &data->sampl_data[ant_idx];
+		u32_t delay = time_delay + (ant_idx * switch_sampl_num);
+
+		for (uint16_t idx = 0; idx < sampl_data->samples_num; ++idx) {
+			rotate_sample(&sampl_data->data[idx],
+				      (iq_angle_t)(phase_diff * (delay + idx)));
+		}
+	}
+}
+
+iq_angle_t iq_fixed_antenna_phase_diff(const struct dfe_mapped_packet *mapped_data,
+				       u8_t a1, u8_t a2)
+{
+	assert(mapped_data != NULL);
+
+	s32_t i1 = 0, q1 = 0;
+	s32_t i2 = 0, q2 = 0;
+
+	for (u16_t idx = 0; idx < mapped_data->header.length; ++idx) {
+		const struct dfe_samples *sampl_data = &mapped_data->sampl_data[idx];
+		s32_t i = 0, q = 0;
+
+		if (sampl_data->antenna_id != a1 && sampl_data->antenna_id != a2) {
+			continue;
+		}
+
+		for (u16_t jdx = 0; jdx < sampl_data->samples_num; ++jdx) {
+			i += sampl_data->data[jdx].q15.i;
+			q += sampl_data->data[jdx].q15.q;
+		}
+
+		if (sampl_data->antenna_id == a1) {
+			i1 += i;
+			q1 += q;
+		}
+		if (sampl_data->antenna_id == a2) {
+			i2 += i;
+			q2 += q;
+		}
+	}
+
+	/* arg(sum1 / sum2) == arg(sum1 * conj(sum2)) */
+	return iq_fixed_atan2(((s64_t)q1 * i2) - ((s64_t)i1 * q2),
+			      ((s64_t)i1 * i2) + ((s64_t)q1 * q2));
+}
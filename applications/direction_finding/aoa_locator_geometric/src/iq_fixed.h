@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef SRC_IQ_FIXED_H_
+#define SRC_IQ_FIXED_H_
+
+#include <zephyr/types.h>
+#include "dfe_samples_data.h"
+
+/** @brief Fixed-point IQ samples processing
+ *
+ * IQ samples are stored in @ref dfe_iq_f::q15 as Q15 values. Raw 12 bit
+ * samples provided by the radio are shifted by @ref IQ_FIXED_RAW_SHIFT,
+ * that leaves one bit of headroom, so rotated samples never saturate.
+ *
+ * Angles are kept as @ref iq_angle_t: a signed 32 bit binary angle where
+ * 2^31 equals PI. Integer overflow wraps the angle around full circle, so
+ * no modulo operation is required when phase corrections are accumulated.
+ */
+
+/** @brief Number of bits raw IQ samples are shifted left to get Q15 */
+#define IQ_FIXED_RAW_SHIFT 3
+
+/** @brief Number of CORDIC iterations used by angle evaluation */
+#define IQ_FIXED_CORDIC_ITERATIONS 24
+
+/** @brief Binary angle, 2^31 equals PI */
+typedef s32_t iq_angle_t;
+
+/** @brief Binary angle equal to PI/2 */
+#define IQ_ANGLE_PI_2 ((iq_angle_t)0x40000000)
+
+/** @brief Converts binary angle to radians */
+#define IQ_ANGLE_TO_RAD(angle) ((float)(angle) * 1.4629180792671596e-09f)
+
+/** @brief Converts raw IQ sample component to Q15 */
+static inline s16_t iq_fixed_from_raw(s16_t raw)
+{
+	return (s16_t)(raw * (1 << IQ_FIXED_RAW_SHIFT));
+}
+
+/** @brief Converts Q15 IQ sample component back to raw range */
+static inline s16_t iq_fixed_to_raw(s16_t q15)
+{
+	return q15 >> IQ_FIXED_RAW_SHIFT;
+}
+
+/** @brief Evaluates angle of a complex number using CORDIC
+ *
+ * Inputs of any magnitude are accepted, they are normalized before
+ * CORDIC iterations start.
+ *
+ * @param y Imaginary part
+ * @param x Real part
+ *
+ * @return Angle of x + jy, 0 if both inputs are 0.
+ */
+iq_angle_t iq_fixed_atan2(s64_t y, s64_t x);
+
+/** @brief Evaluates sine and cosine of binary angle
+ *
+ * Values are interpolated from quarter wave lookup table.
+ *
+ * @param[in]  angle Binary angle
+ * @param[out] sin   Sine in Q15
+ * @param[out] cos   Cosine in Q15
+ */
+void iq_fixed_sincos(iq_angle_t angle, s16_t *sin, s16_t *cos);
+
+/** @brief Compute average phase difference between samples in reference
+ *
+ * Fixed-point counterpart of compute_phase_avg_diffrence().
+ *
+ * @param ref_data Reference data samples in Q15
+ *
+ * @return The average phase offset between samples
+ */
+iq_angle_t iq_fixed_phase_avg_difference(const struct dfe_ref_samples *ref_data);
+
+/** @brief Shifts phase of Q15 I/Q samples back into one point in time
+ *
+ * Fixed-point counterpart of phase_time_machine().
+ *
+ * @param data              Mapped samples in Q15 with removed switch slots
+ * @param slot_samples_num  Number of samples in a single slot
+ */
+void iq_fixed_phase_time_machine(struct dfe_mapped_packet *data,
+				 uint16_t slot_samples_num);
+
+/** @brief Calculate phase difference between antennas
+ *
+ * Samples of each antenna are summed in integer arithmetic and the phase
+ * of the first sum relative to the second one is evaluated by CORDIC.
+ *
+ * @param mapped_data Mapped samples in Q15, corrected to frequency 0 (DC)
+ * @param a1          First antenna number
+ * @param a2          Second antenna number
+ *
+ * @return The phase difference between phases on antennas 1 and 2.
+ */
+iq_angle_t iq_fixed_antenna_phase_diff(const struct dfe_mapped_packet *mapped_data,
+				       u8_t a1, u8_t a2);
+
+#endif /* SRC_IQ_FIXED_H_ */
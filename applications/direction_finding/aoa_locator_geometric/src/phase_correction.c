@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <assert.h>
+#include <math.h>
+
+#include "phase_correction.h"
+
+/** @brief Unit complex number used to rotate IQ samples
+ *
+ * Real and imaginary parts are kept as separate floats instead of
+ * float complex. That way multiplication does not go through the C99
+ * complex multiply helper which checks for infinities and NaNs.
+ */
+struct phasor {
+	float re;
+	float im;
+};
+
+static inline struct phasor phasor_from_angle(float angle)
+{
+	struct phasor p = {
+		.re = cosf(angle),
+		.im = sinf(angle),
+	};
+
+	return p;
+}
+
+static inline void phasor_mul(struct phasor *a, const struct phasor *b)
+{
+	float re = (a->re * b->re) - (a->im * b->im);
+	float im = (a->re * b->im) + (a->im * b->re);
+
+	a->re = re;
+	a->im = im;
+}
+
+/** @brief Brings phasor magnitude back to 1
+ *
+ * The phasor is expected to be close to unit length, so a single Newton
+ * step of 1/sqrt(x) around 1 is enough: k = (3 - |a|^2) / 2.
+ */
+static inline void phasor_renormalize(struct phasor *a)
+{
+	float k = (3.0f - ((a->re * a->re) + (a->im * a->im))) * 0.5f;
+
+	a->re *= k;
+	a->im *= k;
+}
+
+static inline void rotate_sample(union dfe_iq_f *iq, const struct phasor *p)
+{
+	float i = (iq->i * p->re) - (iq->q * p->im);
+	float q = (iq->i * p->im) + (iq->q * p->re);
+
+	iq->i = i;
+	iq->q = q;
+}
+
+float compute_phase_avg_diffrence(const struct dfe_ref_samples *ref_data)
+{
+	assert(ref_data != NULL);
+
+	uint16_t samples_num = ref_data->samples_num;
+	float sum = 0.0f;
+
+	for (uint16_t idx = 0; idx < samples_num - 1; ++idx) {
+		const union dfe_iq_f *z1 = &ref_data->data[idx];
+		const union dfe_iq_f *z2 = &ref_data->data[idx + 1];
+
+		/* arg(z1 / z2) == arg(z1 * conj(z2)), no division required */
+		float re = (z1->i * z2->i) + (z1->q * z2->q);
+		float im = (z1->q * z2->i) - (z1->i * z2->q);
+
+		sum += atan2f(im, re);
+	}
+
+	return sum / (samples_num - 1);
+}
+
+void phase_time_machine(struct dfe_mapped_packet *data,
+			uint16_t slot_samples_num)
+{
+	assert(data != NULL);
+
+	float phase_diff = compute_phase_avg_diffrence(&data->ref_data);
+	struct phasor step = phasor_from_angle(phase_diff);
+	struct phasor correction = { .re = 1.0f, .im = 0.0f };
+
+	/* correct phase in ref. period*/
+	for (uint16_t idx = 0; idx < data->ref_data.samples_num; ++idx) {
+		rotate_sample(&data->ref_data.data[idx], &correction);
+		phasor_mul(&correction, &step);
+
+		if (((idx + 1) % PHASE_CORRECTION_RENORM_INTERVAL) == 0) {
+			phasor_renormalize(&correction);
+		}
+	}
+
+	/* correct phase in switching period.
+	 * Pay attention that sampling is started just after first switch slot,
+	 * that means there is additional time delay of TSWITCHING/2 */
+	uint16_t time_delay = data->ref_data.samples_num + slot_samples_num;
+	uint16_t switch_sampl_num = slot_samples_num * 2;
+
+	struct phasor slot_correction = phasor_from_angle(phase_diff * time_delay);
+	struct phasor slot_step = phasor_from_angle(phase_diff * switch_sampl_num);
+
+	for (uint16_t ant_idx = 0; ant_idx < data->header.length; ++ant_idx) {
+		struct dfe_samples *sampl_data = &data->sampl_data[ant_idx];
+
+		correction = slot_correction;
+
+		for (uint16_t idx = 0; idx < sampl_data->samples_num; ++idx) {
+			rotate_sample(&sampl_data->data[idx], &correction);
+			phasor_mul(&correction, &step);
+		}
+
+		phasor_mul(&slot_correction, &slot_step);
+		phasor_renormalize(&slot_correction);
+	}
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef SRC_PHASE_CORRECTION_H_
+#define SRC_PHASE_CORRECTION_H_
+
+#include <zephyr/types.h>
+#include "dfe_samples_data.h"
+
+/** @brief Number of consecutive phasor rotations after which the running
+ * correction phasor is renormalized to unit length.
+ */
+#define PHASE_CORRECTION_RENORM_INTERVAL 16
+
+/** @brief Compute average phase difference between samples in reference
+ *
+ * The function computes average difference between samples from reference period.
+ *
+ * @param ref_data Reference data samples
+ *
+ * @return The average phase offset between samples
+ */
+float compute_phase_avg_diffrence(const struct dfe_ref_samples *ref_data);
+
+/** @brief Function that shifts phase of I/Q samples back into one point in time
+ *
+ * The samples are sampled one after another.
+ * The mathematical model used to calculate the AoA requires all the samples
+ * to be taken in single moment in time.
+ * The function here calculates phase shift between samples in reference period
+ * and uses it to correct the phase for the samples in reference and sampling
+ * periods in such a way like they were all taken in the same time.
+ *
+ * The correction of consecutive samples is generated as a running product
+ * of a unit phasor, so trigonometric functions are evaluated only a few times
+ * per packet instead of once per sample. The running phasor is renormalized
+ * every @ref PHASE_CORRECTION_RENORM_INTERVAL samples and at the beginning
+ * of every sampling slot to stop accumulation of rounding errors.
+ *
+ * @param[in,out]  data		Pointer to I/Q samples. After end of evaluation
+ * 				the data are overwritten with corrected values.
+ * @param[in]      slot_samples_num Number of samples in single slot.
+ */
+void phase_time_machine(struct dfe_mapped_packet *data,
+			uint16_t slot_samples_num);
+
+#endif /* SRC_PHASE_CORRECTION_H_ */
@@ -17,6 +17,7 @@
 
 #include "protocol.h"
 #include "if.h"
+#include "iq_fixed.h"
 
 
 
@@ -24,6 +25,25 @@
 
 static struct protocol_data g_protocol_data;
 
+/** @brief Provides I component of a sample in raw samples range */
+static inline int sample_i(const union dfe_iq_f *sample)
+{
+#if defined(CONFIG_AOA_LOCATOR_FIXED_POINT)
+	return iq_fixed_to_raw(sample->q15.i);
+#else
+	return (int)sample->i;
+#endif
+}
+
+/** @brief Provides Q component of a sample in raw samples range */
+static inline int sample_q(const union dfe_iq_f *sample)
+{
+#if defined(CONFIG_AOA_LOCATOR_FIXED_POINT)
+	return iq_fixed_to_raw(sample->q15.q);
+#else
+	return (int)sample->q;
+#endif
+}
 
 static u16_t protocol_iq_samples_to_string(const struct dfe_sampling_config* sampl_conf,
 					   const struct dfe_mapped_packet *mapped_data,
@@ -40,8 +60,8 @@ static u16_t protocol_iq_samples_to_string(const struct dfe_sampling_config* sam
 				   ref_idx,
 				   time_u * ref_idx,
 				   (int)mapped_data->ref_data.antenna_id,
-				   (int)mapped_data->ref_data.data[ref_idx].q,
-				   (int)mapped_data->ref_data.data[ref_idx].i);
+				   sample_q(&mapped_data->ref_data.data[ref_idx]),
+				   sample_i(&mapped_data->ref_data.data[ref_idx]));
 	}
 	/* compute delay  between last sample in reference period and first sample
 	 * in antenna switching period.
@@ -62,8 +82,8 @@ static u16_t protocol_iq_samples_to_string(const struct dfe_sampling_config* sam
 					   "IQ:%d,%d,%d,%d,%d\r\n", ref_idx + idx_offset,
 					   delay + (idx_offset) * time_u,
 					   (int)sampl_data->antenna_id,
-					   (int)sampl_data->data[jdx].q,
-					   (int)sampl_data->data[jdx].i);
+					   sample_q(&sampl_data->data[jdx]),
+					   sample_i(&sampl_data->data[jdx]));
 		}
 	}
 
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+#include <ztest.h>
+#include <complex.h>
+#include <math.h>
+
+#include <phase_correction.h>
+#include <iq_fixed.h>
+#include "iq_fixed_tests.h"
+
+#define TEST_PI 3.14159265358979323846f
+
+/** @brief Maximum error of CORDIC atan2 [rad] */
+#define TEST_MAX_ATAN2_ERROR 1.0e-6f
+/** @brief Maximum error of sine and cosine in Q15 LSBs */
+#define TEST_MAX_SINCOS_ERROR 2
+/** @brief Angle error budget of fixed-point path versus float path [rad].
+ * It equals 0.25 degree of phase difference between antennas.
+ */
+#define TEST_MAX_PHASE_DIFF_ERROR (0.25f * TEST_PI / 180.0f)
+
+/** @brief Antennas compared by the regression test */
+#define TEST_ANT1 12
+#define TEST_ANT2 1
+#define TEST_ANT_NUM 12
+
+/** @brief Number of samples in a sampling slot used by tests */
+#define TEST_SLOT_SAMPLES_NUM DFE_SAMPLES_PER_SLOT_NUM
+/** @brief Number of sampling slots left after switch slots are removed */
+#define TEST_SLOTS_NUM (DFE_TOTAL_SLOTS_NUM / 2)
+/** @brief Number of CTEs processed by the regression test */
+#define TEST_PACKETS_NUM 64
+
+static struct dfe_mapped_packet g_float_packet;
+static struct dfe_mapped_packet g_fixed_packet;
+
+static u32_t g_rand_state;
+
+/** @brief Deterministic pseudo random generator, so results are repeatable */
+static float test_rand(void)
+{
+	g_rand_state = (g_rand_state * 1664525u) + 1013904223u;
+	return (float)(g_rand_state >> 8) / (float)(1 << 24);
+}
+
+static float wrap_angle(float angle)
+{
+	while (angle > TEST_PI) {
+		angle -= 2 * TEST_PI;
+	}
+	while (angle <= -TEST_PI) {
+		angle += 2 * TEST_PI;
+	}
+	return angle;
+}
+
+/** @brief Float implementation of phase difference between antennas,
+ * the same as used by the application when fixed-point is disabled.
+ */
+static float antenna_data_to_phase_diff_float(const struct dfe_mapped_packet *mapped_data,
+					      u8_t a1, u8_t a2)
+{
+	float complex sum1 = 0, sum2 = 0;
+
+	for (u16_t idx = 0; idx < mapped_data->header.length; ++idx) {
+		const struct dfe_samples *sampl_data = &mapped_data->sampl_data[idx];
+
+		for (u16_t jdx = 0; jdx < sampl_data->samples_num; ++jdx) {
+			float complex z = sampl_data->data[jdx].i +
+					  sampl_data->data[jdx].q * I;
+
+			if (sampl_data->antenna_id == a1) {
+				sum1 += z;
+			}
+			if (sampl_data->antenna_id == a2) {
+				sum2 += z;
+			}
+		}
+	}
+	return cargf(sum1 / sum2);
+}
+
+static void put_sample(union dfe_iq_f *float_iq, union dfe_iq_f *fixed_iq,
+		       float amplitude, float phase, float noise)
+{
+	/* Radio provides 12 bit integer samples */
+	s16_t i = (s16_t)roundf((amplitude * cosf(phase)) + (noise * (test_rand() - 0.5f)));
+	s16_t q = (s16_t)roundf((amplitude * sinf(phase)) + (noise * (test_rand() - 0.5f)));
+
+	float_iq->i = i;
+	float_iq->q = q;
+	fixed_iq->q15.i = iq_fixed_from_raw(i);
+	fixed_iq->q15.q = iq_fixed_from_raw(q);
+}
+
+/** @brief Prepares the same CTE in float and in Q15 form
+ *
+ * Tone has frequency offset of @p phase_step per sample. Every antenna
+ * has its own phase offset, the antenna pair under test differs by
+ * @p ant_phase_diff.
+ */
+static void prepare_packets(float amplitude, float phase_step,
+			    float ant_phase_diff, float noise)
+{
+	uint16_t ref_samples_num = DFE_REF_SAMPLES_NUM;
+	uint16_t time_delay = ref_samples_num + TEST_SLOT_SAMPLES_NUM;
+	float start_phase = 2 * TEST_PI * test_rand();
+
+	g_float_packet.ref_data.samples_num = ref_samples_num;
+	g_fixed_packet.ref_data.samples_num = ref_samples_num;
+
+	for (uint16_t idx = 0; idx < ref_samples_num; ++idx) {
+		put_sample(&g_float_packet.ref_data.data[idx],
+			   &g_fixed_packet.ref_data.data[idx],
+			   amplitude, start_phase + (phase_step * idx), noise);
+	}
+
+	g_float_packet.header.length = TEST_SLOTS_NUM;
+	g_fixed_packet.header.length = TEST_SLOTS_NUM;
+
+	for (uint16_t ant_idx = 0; ant_idx < TEST_SLOTS_NUM; ++ant_idx) {
+		u8_t ant = (ant_idx % TEST_ANT_NUM) + 1;
+		float ant_offset = (ant == TEST_ANT1) ? ant_phase_diff : 0.1f * ant;
+
+		if (ant == TEST_ANT2) {
+			ant_offset = 0.0f;
+		}
+
+		g_float_packet.sampl_data[ant_idx].antenna_id = ant;
+		g_float_packet.sampl_data[ant_idx].samples_num = TEST_SLOT_SAMPLES_NUM;
+		g_fixed_packet.sampl_data[ant_idx].antenna_id = ant;
+		g_fixed_packet.sampl_data[ant_idx].samples_num = TEST_SLOT_SAMPLES_NUM;
+
+		for (uint16_t idx = 0; idx < TEST_SLOT_SAMPLES_NUM; ++idx) {
+			uint16_t n = time_delay + idx +
+				     (ant_idx * 2 * TEST_SLOT_SAMPLES_NUM);
+
+			put_sample(&g_float_packet.sampl_data[ant_idx].data[idx],
+				   &g_fixed_packet.sampl_data[ant_idx].data[idx],
+				   amplitude,
+				   start_phase + (phase_step * n) + ant_offset,
+				   noise);
+		}
+	}
+}
+
+void test_iq_fixed_atan2()
+{
+	const s64_t scales[] = { 1, 1000, 1 << 20, (s64_t)1 << 40 };
+
+	for (size_t s = 0; s < ARRAY_SIZE(scales); ++s) {
+		for (int step = -180; step < 180; ++step) {
+			float angle = step * (TEST_PI / 180.0f);
+			float mag = (float)scales[s] * 1000.0f;
+			s64_t x = (s64_t)roundf(mag * cosf(angle));
+			s64_t y = (s64_t)roundf(mag * sinf(angle));
+			float expected = atan2f((float)y, (float)x);
+			float result = IQ_ANGLE_TO_RAD(iq_fixed_atan2(y, x));
+
+			zassert_true(fabsf(wrap_angle(result - expected)) <
+				     (TEST_MAX_ATAN2_ERROR + (1.0f / mag)),
+				     "CORDIC atan2 result out of range");
+		}
+	}
+
+	zassert_equal(iq_fixed_atan2(0, 0), 0, "atan2(0, 0) should be 0");
+}
+
+void test_iq_fixed_sincos()
+{
+	s16_t s, c;
+
+	for (u32_t step = 0; step < 4096; ++step) {
+		iq_angle_t angle = (iq_angle_t)((step << 20) + (step * 977));
+		float rad = IQ_ANGLE_TO_RAD(angle);
+
+		iq_fixed_sincos(angle, &s, &c);
+
+		zassert_true(abs(s - (int)roundf(32767.0f * sinf(rad))) <= TEST_MAX_SINCOS_ERROR,
+			     "Sine out of range");
+		zassert_true(abs(c - (int)roundf(32767.0f * cosf(rad))) <= TEST_MAX_SINCOS_ERROR,
+			     "Cosine out of range");
+	}
+}
+
+/** @brief Compares angles evaluated by float and fixed-point paths
+ *
+ * Both paths process the same CTEs. Test vectors emulate recorded data:
+ * integer 12 bit samples with noise, random start phase, carrier frequency
+ * offset and signal strength from weak to close to ADC full scale.
+ */
+void test_iq_fixed_angle_error_budget()
+{
+	float max_error = 0.0f;
+
+	g_rand_state = 0x5eed;
+
+	for (int packet = 0; packet < TEST_PACKETS_NUM; ++packet) {
+		float amplitude = 50.0f + (1900.0f * test_rand());
+		float phase_step = 0.8f * (test_rand() - 0.5f);
+		float ant_phase_diff = 2.0f * TEST_PI * (test_rand() - 0.5f);
+
+		prepare_packets(amplitude, phase_step, ant_phase_diff, 0.05f * amplitude);
+
+		phase_time_machine(&g_float_packet, TEST_SLOT_SAMPLES_NUM);
+		iq_fixed_phase_time_machine(&g_fixed_packet, TEST_SLOT_SAMPLES_NUM);
+
+		float float_diff = antenna_data_to_phase_diff_float(&g_float_packet,
+								    TEST_ANT1, TEST_ANT2);
+		float fixed_diff = IQ_ANGLE_TO_RAD(
+			iq_fixed_antenna_phase_diff(&g_fixed_packet, TEST_ANT1, TEST_ANT2));
+
+		max_error = MAX(max_error, fabsf(wrap_angle(fixed_diff - float_diff)));
+	}
+
+	TC_PRINT("Fixed-point max phase difference error: %d mdeg\n",
+		 (int)(max_error * 180000.0f / TEST_PI));
+	zassert_true(max_error < TEST_MAX_PHASE_DIFF_ERROR,
+		     "Fixed-point path exceeds angle error budget");
+}
@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+#ifndef TESTS_SRC_IQ_FIXED_TESTS_H_
+#define TESTS_SRC_IQ_FIXED_TESTS_H_
+
+void test_iq_fixed_atan2();
+void test_iq_fixed_sincos();
+void test_iq_fixed_angle_error_budget();
+
+#endif /* TESTS_SRC_IQ_FIXED_TESTS_H_ */
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <ztest.h>
+#include "phase_correction_tests.h"
+#include "iq_fixed_tests.h"
+#include "replay_tests.h"
+
+void test_main(void)
+{
+	ztest_test_suite(phase_correction_tests,
+		ztest_unit_test(test_phase_avg_difference_matches_libm),
+		ztest_unit_test(test_phase_time_machine_matches_libm_small_step),
+		ztest_unit_test(test_phase_time_machine_matches_libm_negative_step),
+		ztest_unit_test(test_phase_time_machine_matches_libm_large_step),
+		ztest_unit_test(test_phase_time_machine_benchmark),
+		ztest_unit_test(test_iq_fixed_atan2),
+		ztest_unit_test(test_iq_fixed_sincos),
+		ztest_unit_test(test_iq_fixed_angle_error_budget));
+
+	ztest_test_suite(replay_tests,
+		ztest_unit_test(test_replay_recordings_accuracy));
+
+	ztest_run_test_suite(phase_correction_tests);
+	ztest_run_test_suite(replay_tests);
+}
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+#include <ztest.h>
+#include <complex.h>
+#include <math.h>
+
+#include <phase_correction.h>
+#include "phase_correction_tests.h"
+
+/** @brief Amplitude of artificial IQ samples (12 bit ADC range) */
+#define TEST_IQ_AMPLITUDE 1000.0f
+/** @brief Maximum allowed difference between corrected samples evaluated
+ * by phasor rotation and by libm. It is a fraction of a single ADC step.
+ */
+#define TEST_MAX_SAMPLE_ERROR 0.5f
+/** @brief Maximum allowed difference of average phase difference [rad] */
+#define TEST_MAX_PHASE_ERROR 1.0e-5f
+/** @brief Number of packets processed to measure execution time */
+#define TEST_BENCHMARK_ITERATIONS 20
+
+/** @brief Number of samples in a sampling slot used by tests */
+#define TEST_SLOT_SAMPLES_NUM DFE_SAMPLES_PER_SLOT_NUM
+/** @brief Number of sampling slots left after switch slots are removed */
+#define TEST_SLOTS_NUM (DFE_TOTAL_SLOTS_NUM / 2)
+
+static struct dfe_mapped_packet g_test_packet;
+static struct dfe_mapped_packet g_test_packet_ref;
+static struct dfe_mapped_packet g_test_packet_src;
+
+/** @brief Reference implementation of average phase difference evaluation
+ * that uses C99 complex arithmetic and libm.
+ */
+static float compute_phase_avg_diffrence_libm(const struct dfe_ref_samples *ref_data)
+{
+	uint16_t samples_num = ref_data->samples_num;
+	float complex z1 = 0, z2 = 0;
+	float sum= 0.0;
+
+	for(uint16_t idx=0; idx<samples_num-1; ++idx)
+	{
+		float temp;
+		z1 = ref_data->data[idx].i   + ref_data->data[idx].q*I;
+		z2 = ref_data->data[idx+1].i + ref_data->data[idx+1].q*I;
+		temp = cargf(z1/z2);
+
+		sum += temp;
+	}
+
+	return sum / (samples_num - 1);
+}
+
+/** @brief Reference implementation of phase correction that evaluates
+ * correction of every sample with cosf()/sinf().
+ */
+static void phase_time_machine_libm(struct dfe_mapped_packet *data,
+				    uint16_t slot_samples_num)
+{
+	float complex phase_correction;
+	float complex source_phase, out_phase;
+	float phase_diff = compute_phase_avg_diffrence_libm(&data->ref_data);
+
+	for(uint16_t idx=0; idx<data->ref_data.samples_num; ++idx)
+	{
+		source_phase = data->ref_data.data[idx].i + data->ref_data.data[idx].q*I;
+		float total_fix = phase_diff * (float)idx;
+		phase_correction = cosf(total_fix) + sinf(total_fix)*I;
+		out_phase = source_phase * phase_correction;
+		data->ref_data.data[idx].i = crealf(out_phase);
+		data->ref_data.data[idx].q = cimagf(out_phase);
+	}
+
+	uint16_t time_delay = data->ref_data.samples_num + slot_samples_num;
+	uint16_t switch_sampl_num = slot_samples_num * 2;
+	uint16_t sample_effective_delay;
+	float phase_effective_offset;
+
+	for( uint16_t ant_idx = 0; ant_idx<data->header.length; ++ant_idx) {
+		for(uint16_t idx = 0; idx < data->sampl_data[ant_idx].samples_num; ++idx) {
+			source_phase = data->sampl_data[ant_idx].data[idx].i +
+				       data->sampl_data[ant_idx].data[idx].q*I;
+
+			sample_effective_delay = time_delay + idx + (ant_idx * switch_sampl_num);
+			phase_effective_offset = phase_diff * sample_effective_delay;
+			phase_correction = cosf(phase_effective_offset) + sinf(phase_effective_offset)*I;
+			out_phase = source_phase * phase_correction;
+			data->sampl_data[ant_idx].data[idx].i = crealf(out_phase);
+			data->sampl_data[ant_idx].data[idx].q = cimagf(out_phase);
+		}
+	}
+}
+
+/** @brief Prepares artificial packet with constant tone.
+ *
+ * Phase of consecutive samples changes by @p phase_step. Every antenna
+ * has additional constant phase offset to emulate angle of arrival.
+ * Switch slots are already removed, so there is a gap of
+ * @ref TEST_SLOT_SAMPLES_NUM samples between sampling slots.
+ */
+static void prepare_test_packet(struct dfe_mapped_packet *packet,
+				float phase_step)
+{
+	uint16_t ref_samples_num = DFE_REF_SAMPLES_NUM;
+	uint16_t time_delay = ref_samples_num + TEST_SLOT_SAMPLES_NUM;
+	float phase;
+
+	packet->ref_data.samples_num = ref_samples_num;
+	packet->ref_data.antenna_id = 11;
+
+	for (uint16_t idx = 0; idx < ref_samples_num; ++idx) {
+		phase = phase_step * idx;
+		packet->ref_data.data[idx].i = roundf(TEST_IQ_AMPLITUDE * cosf(phase));
+		packet->ref_data.data[idx].q = roundf(TEST_IQ_AMPLITUDE * sinf(phase));
+	}
+
+	packet->header.length = TEST_SLOTS_NUM;
+
+	for (uint16_t ant_idx = 0; ant_idx < TEST_SLOTS_NUM; ++ant_idx) {
+		struct dfe_samples *sampl_data = &packet->sampl_data[ant_idx];
+		float ant_offset = 0.3f * (ant_idx % 12);
+
+		sampl_data->antenna_id = (ant_idx % 12) + 1;
+		sampl_data->samples_num = TEST_SLOT_SAMPLES_NUM;
+
+		for (uint16_t idx = 0; idx < TEST_SLOT_SAMPLES_NUM; ++idx) {
+			uint16_t n = time_delay + idx +
+				     (ant_idx * 2 * TEST_SLOT_SAMPLES_NUM);
+
+			phase = (phase_step * n) + ant_offset;
+			sampl_data->data[idx].i = roundf(TEST_IQ_AMPLITUDE * cosf(phase));
+			sampl_data->data[idx].q = roundf(TEST_IQ_AMPLITUDE * sinf(phase));
+		}
+	}
+}
+
+static void compare_with_libm(float phase_step)
+{
+	float max_error = 0.0f;
+
+	prepare_test_packet(&g_test_packet, phase_step);
+	memcpy(&g_test_packet_ref, &g_test_packet, sizeof(g_test_packet));
+
+	phase_time_machine(&g_test_packet, TEST_SLOT_SAMPLES_NUM);
+	phase_time_machine_libm(&g_test_packet_ref, TEST_SLOT_SAMPLES_NUM);
+
+	for (uint16_t idx = 0; idx < g_test_packet.ref_data.samples_num; ++idx) {
+		max_error = MAX(max_error, fabsf(g_test_packet.ref_data.data[idx].i -
+						 g_test_packet_ref.ref_data.data[idx].i));
+		max_error = MAX(max_error, fabsf(g_test_packet.ref_data.data[idx].q -
+						 g_test_packet_ref.ref_data.data[idx].q));
+	}
+
+	for (uint16_t ant_idx = 0; ant_idx < g_test_packet.header.length; ++ant_idx) {
+		const struct dfe_samples *out = &g_test_packet.sampl_data[ant_idx];
+		const struct dfe_samples *ref = &g_test_packet_ref.sampl_data[ant_idx];
+
+		for (uint16_t idx = 0; idx < out->samples_num; ++idx) {
+			max_error = MAX(max_error, fabsf(out->data[idx].i - ref->data[idx].i));
+			max_error = MAX(max_error, fabsf(out->data[idx].q - ref->data[idx].q));
+		}
+	}
+
+	TC_PRINT("Phase step %d mrad, max error %d/1000 of ADC step\n",
+		 (int)(phase_step * 1000), (int)(max_error * 1000));
+	zassert_true(max_error < TEST_MAX_SAMPLE_ERROR,
+		     "Phasor rotation differs from libm implementation");
+}
+
+void test_phase_avg_difference_matches_libm()
+{
+	const float steps[] = { 0.05f, -0.4f, 1.2f, 3.0f };
+
+	for (size_t idx = 0; idx < ARRAY_SIZE(steps); ++idx) {
+		prepare_test_packet(&g_test_packet, steps[idx]);
+
+		float diff = compute_phase_avg_diffrence(&g_test_packet.ref_data);
+		float diff_ref = compute_phase_avg_diffrence_libm(&g_test_packet.ref_data);
+
+		zassert_true(fabsf(diff - diff_ref) < TEST_MAX_PHASE_ERROR,
+			     "Average phase difference differs from libm");
+		/* Phase difference is evaluated as arg(z[n] / z[n+1]) */
+		zassert_true(fabsf(diff + steps[idx]) < 1.0e-2f,
+			     "Wrong average phase difference");
+	}
+}
+
+void test_phase_time_machine_matches_libm_small_step()
+{
+	compare_with_libm(0.05f);
+}
+
+void test_phase_time_machine_matches_libm_negative_step()
+{
+	compare_with_libm(-0.4f);
+}
+
+void test_phase_time_machine_matches_libm_large_step()
+{
+	/* 250 kHz tone sampled every 1us gives PI/2 step */
+	compare_with_libm(1.5707963f);
+}
+
+/** @brief Compares execution time of phasor rotation and libm implementations.
+ *
+ * Results are printed only. On native_posix cycles reflect simulated time,
+ * so meaningful numbers are collected on a Cortex-M target.
+ */
+void test_phase_time_machine_benchmark()
+{
+	u32_t start;
+	u32_t cycles_phasor = 0;
+	u32_t cycles_libm = 0;
+
+	prepare_test_packet(&g_test_packet_src, 0.3f);
+
+	for (int iter = 0; iter < TEST_BENCHMARK_ITERATIONS; ++iter) {
+		memcpy(&g_test_packet, &g_test_packet_src, sizeof(g_test_packet));
+		start = k_cycle_get_32();
+		phase_time_machine(&g_test_packet, TEST_SLOT_SAMPLES_NUM);
+		cycles_phasor += k_cycle_get_32() - start;
+
+		memcpy(&g_test_packet_ref, &g_test_packet_src, sizeof(g_test_packet_ref));
+		start = k_cycle_get_32();
+		phase_time_machine_libm(&g_test_packet_ref, TEST_SLOT_SAMPLES_NUM);
+		cycles_libm += k_cycle_get_32() - start;
+	}
+
+	TC_PRINT("phase_time_machine: %u samples per packet\n",
+		 DFE_REF_SAMPLES_NUM + (TEST_SLOTS_NUM * TEST_SLOT_SAMPLES_NUM));
+	TC_PRINT("\tphasor rotation: %u cycles per packet\n",
+		 cycles_phasor / TEST_BENCHMARK_ITERATIONS);
+	TC_PRINT("\tlibm cosf/sinf:  %u cycles per packet\n",
+		 cycles_libm / TEST_BENCHMARK_ITERATIONS);
+}
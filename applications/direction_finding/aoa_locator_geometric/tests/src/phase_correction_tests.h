@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+#ifndef TESTS_SRC_PHASE_CORRECTION_TESTS_H_
+#define TESTS_SRC_PHASE_CORRECTION_TESTS_H_
+
+void test_phase_avg_difference_matches_libm();
+void test_phase_time_machine_matches_libm_small_step();
+void test_phase_time_machine_matches_libm_negative_step();
+void test_phase_time_machine_matches_libm_large_step();
+void test_phase_time_machine_benchmark();
+
+#endif /* TESTS_SRC_PHASE_CORRECTION_TESTS_H_ */
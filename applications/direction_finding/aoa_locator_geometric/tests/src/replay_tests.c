@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+#include <ztest.h>
+#include <math.h>
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+#include <time.h>
+#endif
+
+#include <dfe_local_config.h>
+#include <phase_correction.h>
+#include <angle_evaluation.h>
+#include <iq_fixed.h>
+#include "replay_tests.h"
+
+/** @brief Maximum allowed mean error of evaluated angle [deg] */
+#define REPLAY_MAX_MEAN_ERROR 1.0f
+/** @brief Maximum allowed error of angle evaluated for any CTE [deg] */
+#define REPLAY_MAX_ERROR 3.0f
+
+/** @brief Single CTE of a recording */
+struct replay_cte {
+	/** Radio frequency [MHz] */
+	u32_t frequency;
+	/** Number of IQ samples */
+	u16_t samples_num;
+	/** Raw IQ samples, I and Q interleaved */
+	const s16_t *iq;
+};
+
+/** @brief Recording of CTEs received from a beacon placed at known angle */
+struct replay_recording {
+	const char *name;
+	/** Ground truth angle [deg] */
+	float azimuth;
+	/** Sampling configuration the recording was captured with */
+	u8_t number_of_8us;
+	u8_t switch_spacing;
+	u8_t sample_spacing_ref;
+	u8_t sample_spacing;
+	u16_t ctes_num;
+	const struct replay_cte *ctes;
+};
+
+/* Recordings are converted by iq_replay.py at build time */
+#include "replay_recordings.inc"
+
+/** @brief Processing stages measured by the replay */
+enum replay_stage {
+	REPLAY_STAGE_MAP,
+	REPLAY_STAGE_REMOVE_SWITCH_SLOTS,
+	REPLAY_STAGE_PHASE_CORRECTION,
+	REPLAY_STAGE_PHASE_DIFF,
+	REPLAY_STAGE_ANGLE,
+	REPLAY_STAGE_NUM
+};
+
+static const char *const replay_stage_names[REPLAY_STAGE_NUM] = {
+	"dfe_map_iq_samples_to_antennas",
+	"remove_samples_from_switch_slot",
+	"phase_time_machine",
+	"antenna_data_to_phase_diff",
+	"phase_to_angle",
+};
+
+static struct dfe_packet g_replay_packet;
+static struct dfe_mapped_packet g_replay_mapped;
+
+/** @brief Provides timestamp used to measure stages cost
+ *
+ * Kernel cycles do not advance while code is executed on native_posix,
+ * host clock in [ns] is used there instead of cycles.
+ */
+static u32_t replay_timestamp(void)
+{
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u32_t)(((u64_t)ts.tv_sec * NSEC_PER_SEC) + ts.tv_nsec);
+#else
+	return k_cycle_get_32();
+#endif
+}
+
+static void replay_packet_prepare(const struct replay_cte *cte)
+{
+	zassert_true(cte->samples_num <= DFE_TOTAL_SAMPLES_NUM,
+		     "Recording does not fit IQ samples storage");
+
+	for (u16_t idx = 0; idx < cte->samples_num; ++idx) {
+		g_replay_packet.data[idx].iq.i = cte->iq[2 * idx];
+		g_replay_packet.data[idx].iq.q = cte->iq[(2 * idx) + 1];
+	}
+	g_replay_packet.hdr.length = cte->samples_num;
+	g_replay_packet.hdr.frequency = cte->frequency;
+}
+
+/** @brief Evaluates angle of a single CTE the same way as the application
+ *
+ * @param[in] sampl_conf	Sampling configuration of the recording
+ * @param[in,out] stage_time	Execution time of processing stages
+ *
+ * @return Evaluated angle [rad]
+ */
+static float replay_cte_process(const struct dfe_sampling_config *sampl_conf,
+				u32_t stage_time[REPLAY_STAGE_NUM])
+{
+	u16_t slot_samples_num = dfe_get_sampling_slot_samples_num(sampl_conf);
+	u32_t start;
+	float phase;
+
+	start = replay_timestamp();
+	dfe_map_iq_samples_to_antennas(&g_replay_mapped, &g_replay_packet,
+				       sampl_conf, dfe_get_antenna_config());
+	stage_time[REPLAY_STAGE_MAP] += replay_timestamp() - start;
+
+	start = replay_timestamp();
+	remove_samples_from_switch_slot(&g_replay_mapped, sampl_conf);
+	stage_time[REPLAY_STAGE_REMOVE_SWITCH_SLOTS] += replay_timestamp() - start;
+
+#if defined(CONFIG_AOA_LOCATOR_FIXED_POINT)
+	start = replay_timestamp();
+	iq_fixed_phase_time_machine(&g_replay_mapped, slot_samples_num);
+	stage_time[REPLAY_STAGE_PHASE_CORRECTION] += replay_timestamp() - start;
+
+	start = replay_timestamp();
+	phase = IQ_ANGLE_TO_RAD(iq_fixed_antenna_phase_diff(&g_replay_mapped,
+							    DFE_ANT1, DFE_ANT2));
+	stage_time[REPLAY_STAGE_PHASE_DIFF] += replay_timestamp() - start;
+#else
+	start = replay_timestamp();
+	phase_time_machine(&g_replay_mapped, slot_samples_num);
+	stage_time[REPLAY_STAGE_PHASE_CORRECTION] += replay_timestamp() - start;
+
+	start = replay_timestamp();
+	phase = antenna_data_to_phase_diff(&g_replay_mapped, DFE_ANT1, DFE_ANT2);
+	stage_time[REPLAY_STAGE_PHASE_DIFF] += replay_timestamp() - start;
+#endif
+
+	start = replay_timestamp();
+	float angle = phase_to_angle(phase, DFE_ANT_D,
+				     (float)g_replay_mapped.header.frequency * 1.0e6f);
+	stage_time[REPLAY_STAGE_ANGLE] += replay_timestamp() - start;
+
+	return angle;
+}
+
+void test_replay_recordings_accuracy()
+{
+	u32_t stage_time[REPLAY_STAGE_NUM] = {0};
+	u32_t ctes_total = 0;
+
+	zassert_true(ARRAY_SIZE(replay_recordings) > 0, "No recordings to replay");
+
+	for (size_t rec_idx = 0; rec_idx < ARRAY_SIZE(replay_recordings); ++rec_idx) {
+		const struct replay_recording *rec = &replay_recordings[rec_idx];
+		struct dfe_sampling_config sampl_conf = *dfe_get_sampling_config();
+		float error_sum = 0.0f;
+		float error_max = 0.0f;
+
+		sampl_conf.number_of_8us = rec->number_of_8us;
+		sampl_conf.switch_spacing = rec->switch_spacing;
+		sampl_conf.sample_spacing_ref = rec->sample_spacing_ref;
+		sampl_conf.sample_spacing = rec->sample_spacing;
+
+		for (u16_t cte_idx = 0; cte_idx < rec->ctes_num; ++cte_idx) {
+			replay_packet_prepare(&rec->ctes[cte_idx]);
+
+			float angle = replay_cte_process(&sampl_conf, stage_time);
+			float error = fabsf((angle * 180.0f / (float)PI) - rec->azimuth);
+
+			error_sum += error;
+			error_max = MAX(error_max, error);
+		}
+		ctes_total += rec->ctes_num;
+
+		float error_mean = error_sum / rec->ctes_num;
+
+		TC_PRINT("%s: %u CTEs, angle %d mdeg, mean error %d mdeg, max error %d mdeg\n",
+			 rec->name, rec->ctes_num, (int)(rec->azimuth * 1000.0f),
+			 (int)(error_mean * 1000.0f), (int)(error_max * 1000.0f));
+
+		zassert_true(error_mean <= REPLAY_MAX_MEAN_ERROR,
+			     "Mean angle error too big for recording %s", rec->name);
+		zassert_true(error_max <= REPLAY_MAX_ERROR,
+			     "Angle error too big for recording %s", rec->name);
+	}
+
+	TC_PRINT("Processing time per CTE:\n");
+	for (int stage = 0; stage < REPLAY_STAGE_NUM; ++stage) {
+		u32_t time = stage_time[stage] / ctes_total;
+
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+		TC_PRINT("\t%-32s %u ns\n", replay_stage_names[stage], time);
+#else
+		TC_PRINT("\t%-32s %u cycles, %u ns\n", replay_stage_names[stage],
+			 time, (u32_t)k_cyc_to_ns_floor64(time));
+#endif
+	}
+}
@@ -0,0 +1,11 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+#ifndef TESTS_SRC_REPLAY_TESTS_H_
+#define TESTS_SRC_REPLAY_TESTS_H_
+
+void test_replay_recordings_accuracy();
+
+#endif /* TESTS_SRC_REPLAY_TESTS_H_ */
@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2020 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+
+"""Decoder of binary data frames sent by Direction Finding applications.
+
+Frame layout is described in common/src/df_frame.h. The script reads a byte
+stream (serial port dump or stdin), finds frames, validates their CRC and
+prints them in the same form as the text protocol (DF_BEGIN ... DF_END).
+"""
+
+import argparse
+import struct
+import sys
+import zlib
+
+DF_FRAME_MAGIC = 0xA0DF
+DF_FRAME_VERSION = 1
+
+HEADER = struct.Struct('<HBBHH')
+RECORD_HEADER = struct.Struct('<BH')
+FOOTER = struct.Struct('<I')
+SAMPLING = struct.Struct('<BBBH')
+ANGLES = struct.Struct('<hhhh')
+TAG = struct.Struct('<B6s')
+IQ_HEADER = struct.Struct('<H')
+IQ_SAMPLE = struct.Struct('<HBhh')
+
+RECORD_SAMPLING = 1
+RECORD_IQ = 2
+RECORD_ANGLES = 3
+RECORD_TAG = 4
+
+# Names of Bluetooth LE address types, the same as used by bt_addr_le_to_str()
+ADDR_TYPES = {0: 'public', 1: 'random', 2: 'public-id', 3: 'random-id'}
+
+MAGIC_BYTES = struct.pack('<H', DF_FRAME_MAGIC)
+
+
+class DfFrame():
+    def __init__(self, sequence):
+        self.sequence = sequence
+        self.sampling = None
+        self.angles = None
+        self.tag = None
+        # List of (idx, time, antenna_id, i, q) tuples
+        self.iq_samples = []
+
+    def to_text(self):
+        lines = ['DF_BEGIN']
+        for idx, time, ant, i, q in self.iq_samples:
+            lines.append('IQ:{},{},{},{},{}'.format(idx, time, ant, q, i))
+        if self.tag is not None:
+            addr_type, addr = self.tag
+            lines.append('AD:{} ({})'.format(
+                ':'.join('{:02X}'.format(b) for b in reversed(addr)),
+                ADDR_TYPES.get(addr_type, '0x{:02x}'.format(addr_type))))
+        if self.sampling is not None:
+            sw, rr, ss, fr = self.sampling
+            lines.append('SW:{}'.format(sw))
+            lines.append('RR:{}'.format(rr))
+            lines.append('SS:{}'.format(ss))
+            lines.append('FR:{}'.format(fr))
+        if self.angles is not None:
+            me, ma, ke, ka = self.angles
+            lines.append('ME:{}'.format(me))
+            lines.append('MA:{}'.format(ma))
+            lines.append('KE:{}'.format(ke))
+            lines.append('KA:{}'.format(ka))
+        lines.append('DF_END')
+        return '\r\n'.join(lines) + '\r\n'
+
+
+def parse_frame(data):
+    """Parse single frame that starts at the beginning of data.
+
+    Returns (frame, frame_length). frame is None if data does not hold
+    complete frame yet (frame_length is 0) or frame is corrupted
+    (frame_length is number of bytes to drop).
+    """
+    if len(data) < HEADER.size + FOOTER.size:
+        return None, 0
+
+    magic, version, _, sequence, payload_len = HEADER.unpack_from(data)
+    if magic != DF_FRAME_MAGIC or version != DF_FRAME_VERSION:
+        return None, 1
+
+    payload_end = HEADER.size + payload_len
+    frame_len = payload_end + FOOTER.size
+    if len(data) < frame_len:
+        return None, 0
+
+    crc, = FOOTER.unpack_from(data, payload_end)
+    if zlib.crc32(bytes(data[:payload_end])) & 0xFFFFFFFF != crc:
+        return None, 1
+
+    frame = DfFrame(sequence)
+    offset = HEADER.size
+    while offset < payload_end:
+        rec_type, rec_len = RECORD_HEADER.unpack_from(data, offset)
+        offset += RECORD_HEADER.size
+        value = data[offset:offset + rec_len]
+        offset += rec_len
+        if offset > payload_end:
+            return None, 1
+
+        if rec_type == RECORD_SAMPLING:
+            frame.sampling = SAMPLING.unpack_from(value)
+        elif rec_type == RECORD_ANGLES:
+            frame.angles = ANGLES.unpack_from(value)
+        elif rec_type == RECORD_TAG:
+            frame.tag = TAG.unpack_from(value)
+        elif rec_type == RECORD_IQ:
+            first_idx, = IQ_HEADER.unpack_from(value)
+            count = (rec_len - IQ_HEADER.size) // IQ_SAMPLE.size
+            for n in range(count):
+                sample = IQ_SAMPLE.unpack_from(value,
+                                               IQ_HEADER.size + n * IQ_SAMPLE.size)
+                frame.iq_samples.append((first_idx + n,) + sample)
+        # Unknown records are skipped to keep forward compatibility.
+
+    return frame, frame_len
+
+
+def decode_stream(stream):
+    """Generator yielding frames found in a binary stream."""
+    buf = bytearray()
+    while True:
+        chunk = stream.read(4096)
+        if not chunk:
+            break
+        buf += chunk
+
+        while True:
+            start = buf.find(MAGIC_BYTES)
+            if start < 0:
+                # Keep last byte, it may be the first byte of magic.
+                del buf[:-1]
+                break
+            del buf[:start]
+
+            frame, length = parse_frame(buf)
+            if length == 0:
+                break
+            del buf[:length]
+            if frame is not None:
+                yield frame
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Decode binary Direction Finding data frames.')
+    parser.add_argument('input', nargs='?', default='-',
+                        help='File with captured UART data (default: stdin)')
+    args = parser.parse_args()
+
+    if args.input == '-':
+        stream = sys.stdin.buffer
+    else:
+        stream = open(args.input, 'rb')
+
+    with stream:
+        for frame in decode_stream(stream):
+            sys.stdout.write(frame.to_text())
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,303 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2020 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+
+"""Tool for recordings of IQ samples replayed by Direction Finding tests.
+
+Recordings are text dumps of df_iq_samples_grabber output (DF_BEGIN ...
+DF_END blocks). The grabber does not know the direction of the beacon, so
+the ground truth is added to the dump as comment lines placed before the
+first block:
+
+    # azimuth: 60
+    # cte_8us: 5
+
+azimuth is the angle between antennas axis and the beacon in degrees.
+cte_8us is the CTE length in 8us units the dump was captured with.
+
+Commands:
+    convert  converts recordings into C source included by the replay test
+    synth    generates a recording of a beacon placed at known angle
+"""
+
+import argparse
+import cmath
+import math
+import os
+import random
+import sys
+
+# Values of RADIO DFECTRL1 register fields, the same as in nrf.h
+SAMPLE_SPACING_NS = {1: 4000, 2: 2000, 3: 1000, 4: 500, 5: 250, 6: 125}
+SWITCH_SPACING_NS = {0: 8000, 1: 4000, 2: 2000, 3: 1000}
+
+# Antennas used by aoa_locator_geometric, see DFE_ANT1 and DFE_ANT2
+ANT1 = 12
+ANT2 = 1
+ANT_DISTANCE = 0.05
+WAVE_SPEED = 299792458
+
+GUARD_PERIOD_US = 4
+REF_PERIOD_US = 8
+SAMPLING_TIME_UNIT_NS = 125
+
+
+class Cte():
+    def __init__(self):
+        self.switch_spacing = None
+        self.sample_spacing_ref = None
+        self.sample_spacing = None
+        self.frequency = None
+        # Dictionary idx: (i, q)
+        self.samples = {}
+
+    def iq(self):
+        """Returns list of (i, q) ordered by sample index.
+
+        None is returned if some samples are missing.
+        """
+        if sorted(self.samples) != list(range(len(self.samples))):
+            return None
+        return [self.samples[idx] for idx in range(len(self.samples))]
+
+
+class Recording():
+    def __init__(self, name):
+        self.name = name
+        self.azimuth = None
+        self.cte_8us = None
+        self.ctes = []
+
+
+def parse_recording(name, lines):
+    rec = Recording(name)
+    cte = None
+
+    for line in lines:
+        line = line.strip()
+        if line.startswith('#'):
+            key, _, value = line[1:].partition(':')
+            key = key.strip()
+            if key == 'azimuth':
+                rec.azimuth = float(value)
+            elif key == 'cte_8us':
+                rec.cte_8us = int(value)
+            continue
+
+        # Grabber prints DF_BEGIN to the console too, so it may be
+        # repeated. Every DF_BEGIN starts a new block.
+        if line == 'DF_BEGIN':
+            cte = Cte()
+            continue
+        if cte is None:
+            continue
+        if line == 'DF_END':
+            rec.ctes.append(cte)
+            cte = None
+            continue
+
+        key, _, value = line.partition(':')
+        try:
+            if key == 'SW':
+                cte.switch_spacing = int(value)
+            elif key == 'RR':
+                cte.sample_spacing_ref = int(value)
+            elif key == 'SS':
+                cte.sample_spacing = int(value)
+            elif key == 'FR':
+                cte.frequency = int(value)
+            elif key == 'IQ':
+                idx, _, _, q, i = (int(v) for v in value.split(','))
+                cte.samples[idx] = (i, q)
+        except ValueError:
+            # Line corrupted by console output, drop the whole block.
+            cte = None
+
+    return rec
+
+
+def c_identifier(name):
+    return ''.join(c if c.isalnum() else '_' for c in name)
+
+
+def convert(args):
+    out = ['/* Generated by iq_replay.py, do not edit. */', '']
+    entries = []
+
+    for path in args.recordings:
+        with open(path) as f:
+            rec = parse_recording(path, f)
+
+        if rec.azimuth is None or rec.cte_8us is None:
+            sys.exit('{}: azimuth or cte_8us is missing'.format(path))
+
+        ident = 'rec{}'.format(len(entries))
+        config = None
+        ctes = []
+
+        for cte in rec.ctes:
+            iq = cte.iq()
+            cte_config = (cte.switch_spacing, cte.sample_spacing_ref,
+                          cte.sample_spacing)
+            if iq is None or None in cte_config or cte.frequency is None:
+                print('{}: incomplete CTE skipped'.format(path),
+                      file=sys.stderr)
+                continue
+            if config is None:
+                config = cte_config
+            elif config != cte_config:
+                sys.exit('{}: sampling configuration changed'.format(path))
+
+            name = '{}_cte{}_iq'.format(ident, len(ctes))
+            values = ', '.join('{}, {}'.format(i, q) for i, q in iq)
+            out.append('static const s16_t {}[] = {{ {} }};'.format(name,
+                                                                    values))
+            ctes.append((cte.frequency, len(iq), name))
+
+        if not ctes:
+            sys.exit('{}: no complete CTE found'.format(path))
+
+        out.append('')
+        out.append('static const struct replay_cte {}_ctes[] = {{'.format(
+            ident))
+        for frequency, samples_num, name in ctes:
+            out.append('\t{{ .frequency = {}, .samples_num = {}, '
+                       '.iq = {} }},'.format(frequency, samples_num, name))
+        out.append('};')
+        out.append('')
+
+        entries.append((rec, config, ident, len(ctes)))
+
+    out.append('static const struct replay_recording replay_recordings[] = {')
+    for rec, config, ident, ctes_num in entries:
+        sw, rr, ss = config
+        out.append('\t{')
+        name = os.path.splitext(os.path.basename(rec.name))[0]
+        out.append('\t\t.name = "{}",'.format(c_identifier(name)))
+        out.append('\t\t.azimuth = {}f,'.format(rec.azimuth))
+        out.append('\t\t.number_of_8us = {},'.format(rec.cte_8us))
+        out.append('\t\t.switch_spacing = {},'.format(sw))
+        out.append('\t\t.sample_spacing_ref = {},'.format(rr))
+        out.append('\t\t.sample_spacing = {},'.format(ss))
+        out.append('\t\t.ctes_num = {},'.format(ctes_num))
+        out.append('\t\t.ctes = {}_ctes,'.format(ident))
+        out.append('\t},')
+    out.append('};')
+
+    with open(args.output, 'w') as f:
+        f.write('\n'.join(out) + '\n')
+
+
+def synth(args):
+    """Generates CTEs the same way as radio samples them.
+
+    Layout of samples follows dfe_map_iq_samples_to_antennas():
+    reference period samples are taken from ANT1, then every sampling slot
+    is preceded by a switch slot. Samples of switch slots are garbage.
+    """
+    ref_ns = SAMPLE_SPACING_NS[args.sample_spacing_ref]
+    sampl_ns = SAMPLE_SPACING_NS[args.sample_spacing]
+    switch_ns = SWITCH_SPACING_NS[args.switch_spacing]
+
+    if sampl_ns >= switch_ns:
+        sys.exit('only over sampling configurations are supported')
+
+    ref_num = REF_PERIOD_US * 1000 // ref_ns
+    switching_ns = (args.cte_8us * 8 - GUARD_PERIOD_US - REF_PERIOD_US) * 1000
+    slots_num = 2 * (switching_ns // switch_ns)
+    slot_samples_num = switch_ns // (sampl_ns * 2)
+
+    freq_hz = args.frequency * 1.0e6
+    wave_len = WAVE_SPEED / freq_hz
+    ant_phase = {
+        ANT1: 2 * math.pi * ANT_DISTANCE * math.cos(
+            math.radians(args.azimuth)) / wave_len,
+        ANT2: 0.0,
+    }
+    ants = [ANT1, ANT2]
+    rnd = random.Random(args.seed)
+
+    lines = ['# azimuth: {}'.format(args.azimuth),
+             '# cte_8us: {}'.format(args.cte_8us)]
+
+    for _ in range(args.ctes):
+        offset = rnd.uniform(-math.pi, math.pi)
+        samples = []
+
+        def sample(t_ns, phase):
+            z = args.amplitude * cmath.exp(1j * (
+                2 * math.pi * args.tone_khz * 1.0e3 * t_ns * 1.0e-9 +
+                offset + phase))
+            z += complex(rnd.gauss(0, args.noise), rnd.gauss(0, args.noise))
+            return int(round(z.real)), int(round(z.imag))
+
+        for idx in range(ref_num):
+            t = idx * ref_ns
+            samples.append((t, ANT1, sample(t, ant_phase[ANT1])))
+
+        # The first switch slot precedes sampling of the first antenna,
+        # see dfe_delay_before_first_sampl().
+        first_ns = ref_num * ref_ns + switch_ns // 2
+        for slot in range(slots_num):
+            for jdx in range(slot_samples_num):
+                raw_idx = slot * slot_samples_num + jdx
+                t = first_ns + raw_idx * sampl_ns
+                if slot & 1:
+                    ant = 255
+                    phase = rnd.uniform(-math.pi, math.pi)
+                else:
+                    ant = ants[(slot // 2) % len(ants)]
+                    phase = ant_phase[ant]
+                samples.append((t, ant, sample(t, phase)))
+
+        lines.append('DF_BEGIN')
+        lines.append('SW:{}'.format(args.switch_spacing))
+        lines.append('RR:{}'.format(args.sample_spacing_ref))
+        lines.append('SS:{}'.format(args.sample_spacing))
+        lines.append('FR:{}'.format(args.frequency))
+        for idx, (t, ant, (i, q)) in enumerate(samples):
+            lines.append('IQ:{},{},{},{},{}'.format(
+                idx, t // SAMPLING_TIME_UNIT_NS, ant, q, i))
+        lines.append('DF_END')
+
+    with open(args.output, 'w') as f:
+        f.write('\n'.join(lines) + '\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Prepare IQ samples recordings for replay tests.')
+    sub = parser.add_subparsers(dest='command')
+    sub.required = True
+
+    conv = sub.add_parser('convert', help='Convert recordings to C source')
+    conv.add_argument('-o', '--output', required=True)
+    conv.add_argument('recordings', nargs='+')
+    conv.set_defaults(func=convert)
+
+    syn = sub.add_parser('synth', help='Generate synthetic recording')
+    syn.add_argument('-o', '--output', required=True)
+    syn.add_argument('--azimuth', type=float, required=True,
+                     help='Angle of the beacon [deg]')
+    syn.add_argument('--ctes', type=int, default=4)
+    syn.add_argument('--cte-8us', type=int, default=5)
+    syn.add_argument('--switch-spacing', type=int, default=2)
+    syn.add_argument('--sample-spacing-ref', type=int, default=3)
+    syn.add_argument('--sample-spacing', type=int, default=3)
+    syn.add_argument('--frequency', type=int, default=2440,
+                     help='Radio frequency [MHz]')
+    syn.add_argument('--tone-khz', type=float, default=250.0)
+    syn.add_argument('--amplitude', type=float, default=1000.0)
+    syn.add_argument('--noise', type=float, default=20.0,
+                     help='Standard deviation of noise')
+    syn.add_argument('--seed', type=int, default=1)
+    syn.set_defaults(func=synth)
+
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,392 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <errno.h>
+#include <assert.h>
+#include <string.h>
+#include <sys/byteorder.h>
+#include <sys/crc.h>
+
+#include "df_frame.h"
+
+/** @brief Offset of payload length field in frame header */
+#define DF_FRAME_PAYLOAD_LEN_OFFSET	6
+
+/** @brief Reserves space for data in the frame
+ *
+ * @param[in,out] writer	Writer state
+ * @param[in] len		Number of bytes to reserve
+ *
+ * @return Pointer to reserved memory, NULL if there is not enough space
+ *	   left. In that case writer error is set to -ENOMEM.
+ */
+static u8_t *frame_reserve(struct df_frame_writer *writer, size_t len)
+{
+	if (writer->err) {
+		return NULL;
+	}
+
+	/* Space for the footer must always be available. */
+	if (writer->len + len + DF_FRAME_FOOTER_LEN > writer->size) {
+		writer->err = -ENOMEM;
+		return NULL;
+	}
+
+	u8_t *data = &writer->buf[writer->len];
+
+	writer->len += len;
+	return data;
+}
+
+static void record_begin(struct df_frame_writer *writer,
+			 enum df_frame_record_type type)
+{
+	if (writer->record_offset != 0) {
+		writer->err = -EINVAL;
+		return;
+	}
+
+	size_t offset = writer->len;
+	u8_t *data = frame_reserve(writer, DF_FRAME_RECORD_HEADER_LEN);
+
+	if (data) {
+		data[0] = type;
+		writer->record_offset = offset;
+	}
+}
+
+static void record_end(struct df_frame_writer *writer)
+{
+	if (writer->err || writer->record_offset == 0) {
+		return;
+	}
+
+	size_t value_len = writer->len - writer->record_offset -
+			   DF_FRAME_RECORD_HEADER_LEN;
+
+	if (value_len > UINT16_MAX) {
+		writer->err = -ENOMEM;
+		return;
+	}
+
+	sys_put_le16(value_len, &writer->buf[writer->record_offset + 1]);
+	writer->record_offset = 0;
+}
+
+int df_frame_begin(struct df_frame_writer *writer, u8_t *buf, size_t size,
+		   u16_t sequence)
+{
+	assert(writer != NULL);
+	assert(buf != NULL);
+
+	writer->buf = buf;
+	writer->size = size;
+	writer->len = 0;
+	writer->record_offset = 0;
+	writer->err = 0;
+
+	u8_t *hdr = frame_reserve(writer, DF_FRAME_HEADER_LEN);
+
+	if (!hdr) {
+		return writer->err;
+	}
+
+	sys_put_le16(DF_FRAME_MAGIC, &hdr[0]);
+	hdr[2] = DF_FRAME_VERSION;
+	hdr[3] = 0;
+	sys_put_le16(sequence, &hdr[4]);
+	sys_put_le16(0, &hdr[DF_FRAME_PAYLOAD_LEN_OFFSET]);
+
+	return 0;
+}
+
+void df_frame_put_sampling(struct df_frame_writer *writer,
+			   const struct df_frame_sampling *sampling)
+{
+	assert(writer != NULL);
+	assert(sampling != NULL);
+
+	record_begin(writer, DF_FRAME_RECORD_SAMPLING);
+
+	u8_t *data = frame_reserve(writer, DF_FRAME_SAMPLING_LEN);
+
+	if (data) {
+		data[0] = sampling->switch_spacing;
+		data[1] = sampling->sample_spacing_ref;
+		data[2] = sampling->sample_spacing;
+		sys_put_le16(sampling->frequency, &data[3]);
+	}
+
+	record_end(writer);
+}
+
+void df_frame_put_angles(struct df_frame_writer *writer,
+			 const struct df_frame_angles *angles)
+{
+	assert(writer != NULL);
+	assert(angles != NULL);
+
+	record_begin(writer, DF_FRAME_RECORD_ANGLES);
+
+	u8_t *data = frame_reserve(writer, DF_FRAME_ANGLES_LEN);
+
+	if (data) {
+		sys_put_le16(angles->elevation, &data[0]);
+		sys_put_le16(angles->azimuth, &data[2]);
+		sys_put_le16(angles->filtered_elevation, &data[4]);
+		sys_put_le16(angles->filtered_azimuth, &data[6]);
+	}
+
+	record_end(writer);
+}
+
+void df_frame_put_tag(struct df_frame_writer *writer,
+		      const struct df_frame_tag *tag)
+{
+	assert(writer != NULL);
+	assert(tag != NULL);
+
+	record_begin(writer, DF_FRAME_RECORD_TAG);
+
+	u8_t *data = frame_reserve(writer, DF_FRAME_TAG_LEN);
+
+	if (data) {
+		data[0] = tag->type;
+		memcpy(&data[1], tag->addr, DF_FRAME_TAG_ADDR_LEN);
+	}
+
+	record_end(writer);
+}
+
+void df_frame_iq_begin(struct df_frame_writer *writer, u16_t first_idx)
+{
+	assert(writer != NULL);
+
+	record_begin(writer, DF_FRAME_RECORD_IQ);
+
+	u8_t *data = frame_reserve(writer, DF_FRAME_IQ_HEADER_LEN);
+
+	if (data) {
+		sys_put_le16(first_idx, data);
+	}
+}
+
+void df_frame_iq_put(struct df_frame_writer *writer, u16_t time,
+		     u8_t antenna_id, s16_t i, s16_t q)
+{
+	assert(writer != NULL);
+
+	u8_t *data = frame_reserve(writer, DF_FRAME_IQ_SAMPLE_LEN);
+
+	if (data) {
+		sys_put_le16(time, &data[0]);
+		data[2] = antenna_id;
+		sys_put_le16(i, &data[3]);
+		sys_put_le16(q, &data[5]);
+	}
+}
+
+void df_frame_iq_end(struct df_frame_writer *writer)
+{
+	assert(writer != NULL);
+
+	record_end(writer);
+}
+
+int df_frame_end(struct df_frame_writer *writer)
+{
+	assert(writer != NULL);
+
+	if (!writer->err && writer->record_offset != 0) {
+		writer->err = -EINVAL;
+	}
+
+	if (writer->err) {
+		return writer->err;
+	}
+
+	size_t payload_len = writer->len - DF_FRAME_HEADER_LEN;
+
+	if (payload_len > UINT16_MAX) {
+		writer->err = -ENOMEM;
+		return writer->err;
+	}
+
+	sys_put_le16(payload_len, &writer->buf[DF_FRAME_PAYLOAD_LEN_OFFSET]);
+
+	/* Room for the footer is guaranteed by frame_reserve. */
+	u32_t crc = crc32_ieee(writer->buf, writer->len);
+
+	sys_put_le32(crc, &writer->buf[writer->len]);
+	writer->len += DF_FRAME_FOOTER_LEN;
+
+	return writer->len;
+}
+
+int df_frame_open(struct df_frame_reader *reader, const u8_t *buf, size_t len)
+{
+	assert(reader != NULL);
+	assert(buf != NULL);
+
+	if (len < DF_FRAME_HEADER_LEN + DF_FRAME_FOOTER_LEN) {
+		return -EAGAIN;
+	}
+
+	if (sys_get_le16(&buf[0]) != DF_FRAME_MAGIC) {
+		return -EBADMSG;
+	}
+
+	if (buf[2] != DF_FRAME_VERSION) {
+		return -ENOTSUP;
+	}
+
+	size_t payload_end = DF_FRAME_HEADER_LEN +
+			     sys_get_le16(&buf[DF_FRAME_PAYLOAD_LEN_OFFSET]);
+
+	if (len < payload_end + DF_FRAME_FOOTER_LEN) {
+		return -EAGAIN;
+	}
+
+	if (crc32_ieee(buf, payload_end) != sys_get_le32(&buf[payload_end])) {
+		return -EBADMSG;
+	}
+
+	reader->buf = buf;
+	reader->payload_end = payload_end;
+	reader->offset = DF_FRAME_HEADER_LEN;
+	reader->sequence = sys_get_le16(&buf[4]);
+
+	return 0;
+}
+
+int df_frame_next_record(struct df_frame_reader *reader,
+			 struct df_frame_record *record)
+{
+	assert(reader != NULL);
+	assert(record != NULL);
+
+	if (reader->offset >= reader->payload_end) {
+		return -ENODATA;
+	}
+
+	if (reader->offset + DF_FRAME_RECORD_HEADER_LEN > reader->payload_end) {
+		return -EBADMSG;
+	}
+
+	const u8_t *hdr = &reader->buf[reader->offset];
+	u16_t value_len = sys_get_le16(&hdr[1]);
+
+	if (reader->offset + DF_FRAME_RECORD_HEADER_LEN + value_len >
+	    reader->payload_end) {
+		return -EBADMSG;
+	}
+
+	record->type = hdr[0];
+	record->len = value_len;
+	record->value = &hdr[DF_FRAME_RECORD_HEADER_LEN];
+
+	reader->offset += DF_FRAME_RECORD_HEADER_LEN + value_len;
+
+	return 0;
+}
+
+int df_frame_get_sampling(const struct df_frame_record *record,
+			  struct df_frame_sampling *sampling)
+{
+	assert(record != NULL);
+	assert(sampling != NULL);
+
+	if (record->type != DF_FRAME_RECORD_SAMPLING ||
+	    record->len != DF_FRAME_SAMPLING_LEN) {
+		return -EINVAL;
+	}
+
+	sampling->switch_spacing = record->value[0];
+	sampling->sample_spacing_ref = record->value[1];
+	sampling->sample_spacing = record->value[2];
+	sampling->frequency = sys_get_le16(&record->value[3]);
+
+	return 0;
+}
+
+int df_frame_get_angles(const struct df_frame_record *record,
+			struct df_frame_angles *angles)
+{
+	assert(record != NULL);
+	assert(angles != NULL);
+
+	if (record->type != DF_FRAME_RECORD_ANGLES ||
+	    record->len != DF_FRAME_ANGLES_LEN) {
+		return -EINVAL;
+	}
+
+	angles->elevation = sys_get_le16(&record->value[0]);
+	angles->azimuth = sys_get_le16(&record->value[2]);
+	angles->filtered_elevation = sys_get_le16(&record->value[4]);
+	angles->filtered_azimuth = sys_get_le16(&record->value[6]);
+
+	return 0;
+}
+
+int df_frame_get_tag(const struct df_frame_record *record,
+		     struct df_frame_tag *tag)
+{
+	assert(record != NULL);
+	assert(tag != NULL);
+
+	if (record->type != DF_FRAME_RECORD_TAG ||
+	    record->len != DF_FRAME_TAG_LEN) {
+		return -EINVAL;
+	}
+
+	tag->type = record->value[0];
+	memcpy(tag->addr, &record->value[1], DF_FRAME_TAG_ADDR_LEN);
+
+	return 0;
+}
+
+int df_frame_iq_count(const struct df_frame_record *record, u16_t *first_idx)
+{
+	assert(record != NULL);
+
+	if (record->type != DF_FRAME_RECORD_IQ ||
+	    record->len < DF_FRAME_IQ_HEADER_LEN ||
+	    ((record->len - DF_FRAME_IQ_HEADER_LEN) % DF_FRAME_IQ_SAMPLE_LEN)) {
+		return -EINVAL;
+	}
+
+	if (first_idx) {
+		*first_idx = sys_get_le16(record->value);
+	}
+
+	return (record->len - DF_FRAME_IQ_HEADER_LEN) / DF_FRAME_IQ_SAMPLE_LEN;
+}
+
+int df_frame_iq_get(const struct df_frame_record *record, u16_t idx,
+		    struct df_frame_iq_sample *sample)
+{
+	assert(sample != NULL);
+
+	int count = df_frame_iq_count(record, NULL);
+
+	if (count < 0) {
+		return count;
+	}
+
+	if (idx >= count) {
+		return -EINVAL;
+	}
+
+	const u8_t *data = &record->value[DF_FRAME_IQ_HEADER_LEN +
+					  (idx * DF_FRAME_IQ_SAMPLE_LEN)];
+
+	sample->time = sys_get_le16(&data[0]);
+	sample->antenna_id = data[2];
+	sample->i = sys_get_le16(&data[3]);
+	sample->q = sys_get_le16(&data[5]);
+
+	return 0;
+}
@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef DF_COMMON_DF_FRAME_H_
+#define DF_COMMON_DF_FRAME_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <zephyr/types.h>
+
+/** @brief Binary data frame used by Direction Finding applications.
+ *
+ * The frame replaces text protocol (DF_BEGIN ... DF_END) with compact binary
+ * representation. All multi-byte fields are little-endian.
+ *
+ * Frame layout:
+ * - header (@ref DF_FRAME_HEADER_LEN bytes):
+ *	- magic		u16 (@ref DF_FRAME_MAGIC)
+ *	- version	u8  (@ref DF_FRAME_VERSION)
+ *	- flags		u8  (reserved, set to 0)
+ *	- sequence	u16 frame counter
+ *	- payload length u16 number of bytes between header and footer
+ * - payload: any number of records, each built of:
+ *	- type		u8  (@ref df_frame_record_type)
+ *	- length	u16 length of record value
+ *	- value		length bytes
+ * - footer (@ref DF_FRAME_FOOTER_LEN bytes):
+ *	- crc		u32 CRC-32 (IEEE) of header and payload
+ */
+
+/** @brief Frame start marker, transmitted as 0xDF 0xA0 */
+#define DF_FRAME_MAGIC			0xA0DF
+/** @brief Version of a frame format */
+#define DF_FRAME_VERSION		1
+/** @brief Length of a frame header in bytes */
+#define DF_FRAME_HEADER_LEN		8
+/** @brief Length of a record header in bytes */
+#define DF_FRAME_RECORD_HEADER_LEN	3
+/** @brief Length of a frame footer in bytes */
+#define DF_FRAME_FOOTER_LEN		4
+/** @brief Length of single IQ sample entry in IQ record */
+#define DF_FRAME_IQ_SAMPLE_LEN		7
+/** @brief Length of IQ record value header */
+#define DF_FRAME_IQ_HEADER_LEN		2
+/** @brief Length of sampling configuration record value */
+#define DF_FRAME_SAMPLING_LEN		5
+/** @brief Length of angles record value */
+#define DF_FRAME_ANGLES_LEN		8
+/** @brief Length of tag record value */
+#define DF_FRAME_TAG_LEN		7
+/** @brief Length of tag address */
+#define DF_FRAME_TAG_ADDR_LEN		6
+
+/** @brief Types of records stored in frame payload */
+enum df_frame_record_type {
+	/** Sampling configuration, see @ref df_frame_sampling */
+	DF_FRAME_RECORD_SAMPLING = 1,
+	/** Block of IQ samples, see @ref df_frame_iq_sample */
+	DF_FRAME_RECORD_IQ = 2,
+	/** Evaluated angles, see @ref df_frame_angles */
+	DF_FRAME_RECORD_ANGLES = 3,
+	/** Source of the CTE, see @ref df_frame_tag */
+	DF_FRAME_RECORD_TAG = 4,
+};
+
+/** @brief Sampling configuration record
+ *
+ * Values are the same as in text protocol SW, RR, SS and FR entries.
+ */
+struct df_frame_sampling {
+	u8_t switch_spacing;
+	u8_t sample_spacing_ref;
+	u8_t sample_spacing;
+	/** Frequency in MHz */
+	u16_t frequency;
+};
+
+/** @brief Single IQ sample entry
+ *
+ * Sample number is not transmitted. It is evaluated from index of the first
+ * sample in the block and position of the entry in the block.
+ */
+struct df_frame_iq_sample {
+	/** Time as number of 125ns units from beginning of reference period */
+	u16_t time;
+	/** Antenna index, 255 for samples taken in switch slots */
+	u8_t antenna_id;
+	s16_t i;
+	s16_t q;
+};
+
+/** @brief Angles record
+ *
+ * Values are the same as in text protocol ME, MA, KE and KA entries.
+ */
+struct df_frame_angles {
+	s16_t elevation;
+	s16_t azimuth;
+	s16_t filtered_elevation;
+	s16_t filtered_azimuth;
+};
+
+/** @brief Tag record
+ *
+ * Identifies the advertiser (tag) that sent the CTE. Value is the same as
+ * in text protocol AD entry.
+ */
+struct df_frame_tag {
+	/** Bluetooth LE address type */
+	u8_t type;
+	/** Address, least significant byte first */
+	u8_t addr[DF_FRAME_TAG_ADDR_LEN];
+};
+
+/** @brief Frame writer state */
+struct df_frame_writer {
+	/** Memory where the frame is stored */
+	u8_t *buf;
+	/** Size of memory provided by @p buf */
+	size_t size;
+	/** Number of bytes stored in @p buf */
+	size_t len;
+	/** Offset of record that is currently open, zero if none */
+	size_t record_offset;
+	/** First error that happened while frame was built */
+	int err;
+};
+
+/** @brief Frame reader state */
+struct df_frame_reader {
+	/** Frame data */
+	const u8_t *buf;
+	/** Offset of the end of payload */
+	size_t payload_end;
+	/** Offset of next record to read */
+	size_t offset;
+	/** Sequence number of read frame */
+	u16_t sequence;
+};
+
+/** @brief Single record read from frame */
+struct df_frame_record {
+	enum df_frame_record_type type;
+	const u8_t *value;
+	u16_t len;
+};
+
+/** @brief Starts new frame
+ *
+ * Puts frame header in provided memory. Payload length is updated
+ * by @ref df_frame_end.
+ *
+ * @param[out] writer	Writer state
+ * @param[in] buf	Memory to store the frame
+ * @param[in] size	Size of memory provided by @p buf
+ * @param[in] sequence	Sequence number of the frame
+ *
+ * @retval 0		frame started successfully
+ * @retval -ENOMEM	@p buf is too small to hold empty frame
+ */
+int df_frame_begin(struct df_frame_writer *writer, u8_t *buf, size_t size,
+		   u16_t sequence);
+
+/** @brief Puts sampling configuration record into the frame
+ *
+ * @param[in,out] writer	Writer state
+ * @param[in] sampling		Sampling configuration
+ */
+void df_frame_put_sampling(struct df_frame_writer *writer,
+			   const struct df_frame_sampling *sampling);
+
+/** @brief Puts angles record into the frame
+ *
+ * @param[in,out] writer	Writer state
+ * @param[in] angles		Evaluated angles
+ */
+void df_frame_put_angles(struct df_frame_writer *writer,
+			 const struct df_frame_angles *angles);
+
+/** @brief Puts tag record into the frame
+ *
+ * @param[in,out] writer	Writer state
+ * @param[in] tag		Source of the CTE
+ */
+void df_frame_put_tag(struct df_frame_writer *writer,
+		      const struct df_frame_tag *tag);
+
+/** @brief Opens IQ samples record
+ *
+ * Samples are added by @ref df_frame_iq_put. The record must be closed
+ * by @ref df_frame_iq_end before any other record is put into the frame.
+ *
+ * @param[in,out] writer	Writer state
+ * @param[in] first_idx		Number of the first sample in the block
+ */
+void df_frame_iq_begin(struct df_frame_writer *writer, u16_t first_idx);
+
+/** @brief Puts single IQ sample into opened IQ record
+ *
+ * @param[in,out] writer	Writer state
+ * @param[in] time		Sample time in 125ns units
+ * @param[in] antenna_id	Antenna index
+ * @param[in] i			I component
+ * @param[in] q			Q component
+ */
+void df_frame_iq_put(struct df_frame_writer *writer, u16_t time,
+		     u8_t antenna_id, s16_t i, s16_t q);
+
+/** @brief Closes IQ samples record
+ *
+ * @param[in,out] writer	Writer state
+ */
+void df_frame_iq_end(struct df_frame_writer *writer);
+
+/** @brief Finishes the frame
+ *
+ * Stores payload length in the header and puts the footer with CRC.
+ *
+ * @param[in,out] writer	Writer state
+ *
+ * @return Length of the frame in bytes if successful, negative error code
+ *	   stored by writer otherwise (-ENOMEM if frame does not fit in
+ *	   memory, -EINVAL if records were not closed properly).
+ */
+int df_frame_end(struct df_frame_writer *writer);
+
+/** @brief Validates frame and prepares reader
+ *
+ * @param[out] reader	Reader state
+ * @param[in] buf	Frame data
+ * @param[in] len	Length of frame data
+ *
+ * @retval 0		frame is valid
+ * @retval -EAGAIN	@p len is too short to hold complete frame
+ * @retval -EBADMSG	magic or CRC do not match
+ * @retval -ENOTSUP	unsupported frame version
+ */
+int df_frame_open(struct df_frame_reader *reader, const u8_t *buf, size_t len);
+
+/** @brief Reads next record from the frame
+ *
+ * @param[in,out] reader	Reader state
+ * @param[out] record		Read record
+ *
+ * @retval 0		record was read
+ * @retval -ENODATA	there are no more records
+ * @retval -EBADMSG	record exceeds frame payload
+ */
+int df_frame_next_record(struct df_frame_reader *reader,
+			 struct df_frame_record *record);
+
+/** @brief Decodes sampling configuration record */
+int df_frame_get_sampling(const struct df_frame_record *record,
+			  struct df_frame_sampling *sampling);
+
+/** @brief Decodes angles record */
+int df_frame_get_angles(const struct df_frame_record *record,
+			struct df_frame_angles *angles);
+
+/** @brief Decodes tag record */
+int df_frame_get_tag(const struct df_frame_record *record,
+		     struct df_frame_tag *tag);
+
+/** @brief Provides number of samples stored in IQ record
+ *
+ * @param[in] record	IQ record
+ * @param[out] first_idx	Number of the first sample in the block
+ *
+ * @return Number of samples, negative error code if record is not valid
+ */
+int df_frame_iq_count(const struct df_frame_record *record, u16_t *first_idx);
+
+/** @brief Decodes single sample from IQ record
+ *
+ * @param[in] record	IQ record
+ * @param[in] idx	Position of the sample in the block
+ * @param[out] sample	Decoded sample
+ */
+int df_frame_iq_get(const struct df_frame_record *record, u16_t idx,
+		    struct df_frame_iq_sample *sample);
+
+#endif /* DF_COMMON_DF_FRAME_H_ */
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef DF_COMMON_DFE_RAW_SAMPLES_H_
+#define DF_COMMON_DFE_RAW_SAMPLES_H_
+
+#include <zephyr/types.h>
+
+/** @brief Provides index of an IQ sample in a raw DFE packet
+ *
+ * Samples of reference period are stored first, then samples of sampling
+ * slots one after another. A CTE may hold more than 255 samples
+ * (e.g. 160 us sampled every 250 ns), so the index does not fit in u8_t.
+ *
+ * @param[in] ref_samples_num	Number of samples in reference period
+ * @param[in] slot_idx		Number of sampling slot
+ * @param[in] samples_num	Number of samples in a sampling slot
+ * @param[in] sample_idx	Number of sample in the slot
+ *
+ * @return Index of the sample in raw packet
+ */
+static inline u16_t dfe_raw_sample_idx(u16_t ref_samples_num, u16_t slot_idx,
+				       u8_t samples_num, u8_t sample_idx)
+{
+	return ref_samples_num + (slot_idx * samples_num) + sample_idx;
+}
+
+#endif /* DF_COMMON_DFE_RAW_SAMPLES_H_ */
@@ -439,6 +439,126 @@ static bool test_antenna(u8_t antenna_num, u8_t number_of_cte_to_analyze,
 	return test_result;
 }
 
+#if defined(CONFIG_ANT_TEST_BATCH_MODE)
+/** @brief Sends summary of statistics evaluated for a batch of CTEs
+ *
+ * @param[in] stats		Statistics of the batch
+ * @param[in] verbosity		Level of test log verbosity
+ */
+static void send_batch_summary(const struct iq_batch_stats *stats,
+			       enum test_verbosity_level verbosity)
+{
+	protocol_send_msg("[STAT] Batch statistics:\r\n");
+	protocol_send_msg("\tNumber of CTEs tested: %d\r\n", stats->cte_num);
+	if (verbosity >= TEST_VERBOSITY_MED) {
+		protocol_send_msg("\tNumber of samples tested: %d\r\n", stats->samples_num);
+		protocol_send_msg("\tNumber of samples with zeros: %d\r\n", stats->zeros_num);
+		protocol_send_msg("\tNumber of over saturated samples: %d\r\n",
+				  stats->oversaturated_num);
+		protocol_send_msg("\tNumber of phase offsets out of range: %d\r\n",
+				  stats->out_of_range_num);
+		protocol_send_msg("\tPhase offset diff. from expected [deg]: mean %.3f, std. dev. %.3f, min %.3f, max %.3f\r\n",
+				  stats->phase_offset.mean,
+				  sqrtf(iq_stat_variance(&stats->phase_offset)),
+				  stats->phase_offset.min, stats->phase_offset.max);
+		protocol_send_msg("\tMagnitude: mean %.3f, std. dev. %.3f, min %.3f, max %.3f\r\n",
+				  stats->magnitude.mean,
+				  sqrtf(iq_stat_variance(&stats->magnitude)),
+				  stats->magnitude.min, stats->magnitude.max);
+	}
+	protocol_send_msg("[STAT] Reference statistics:\r\n");
+	if (verbosity >= TEST_VERBOSITY_MED) {
+		protocol_send_msg("\tAvg. phase offset between samples [deg]: mean %.3f, std. dev. %.3f\r\n",
+				  stats->ref_phase_off_sampl.mean,
+				  sqrtf(iq_stat_variance(&stats->ref_phase_off_sampl)));
+		protocol_send_msg("\tAvg. phase offset between periods [deg]: mean %.3f, std. dev. %.3f\r\n",
+				  stats->ref_phase_off_periods.mean,
+				  sqrtf(iq_stat_variance(&stats->ref_phase_off_periods)));
+		protocol_send_msg("\tAvg. magnitude: mean %.3f, std. dev. %.3f\r\n",
+				  stats->ref_magnitude.mean,
+				  sqrtf(iq_stat_variance(&stats->ref_magnitude)));
+	}
+}
+
+/** @brief Antenna test procedure run on a batch of CTEs
+ *
+ * Collects CONFIG_ANT_TEST_BATCH_SIZE CTEs for single antenna. Every CTE is
+ * added to statistics of the batch as soon as it is received, so only one
+ * packet is stored in RAM. A single summary is sent for the whole batch.
+ *
+ * @param[in] antenna_num	Number of antenna to test
+ * @param[in] verbosity		Level of test log verbosity
+ *
+ * @return true if test finished successfully, false otherwise
+ */
+static bool test_antenna_batch(u8_t antenna_num,
+			       enum test_verbosity_level verbosity)
+{
+	assert(antenna_num != 0);
+	assert(antenna_num <= ANT_TEST_MAX_ANT_NUMBER);
+
+	int err;
+	const struct dfe_sampling_config* sampl_conf = NULL;
+	const struct dfe_antenna_config* ant_conf = NULL;
+
+	sampl_conf = dfe_get_sampling_config();
+	ant_conf = dfe_get_antenna_config();
+
+	dfe_set_single_antenna_for_whole_cte(antenna_num);
+	err = initlialize_dfe(sampl_conf, ant_conf);
+	if (err) {
+		LOG_ERR("Error while DFE initialization: %d", err);
+		return false;
+	}
+	err = bt_start_scanning();
+	if (err) {
+		return false;
+	}
+
+	static struct dfe_mapped_packet df_mapped_data;
+	static struct iq_batch_stats stats;
+	u16_t samples_spacing_ns = dfe_get_sample_spacing_ref_ns(sampl_conf->sample_spacing_ref);
+	float expected_phase_diff;
+
+	expected_phase_diff = get_expected_phase_offset(CTE_FREQUENCY_HZ, samples_spacing_ns);
+
+	iq_batch_stats_init(&stats);
+
+	for (u8_t idx = 0; idx < CONFIG_ANT_TEST_BATCH_SIZE; ++idx) {
+		err = collect_iq_samples(&df_mapped_data, sampl_conf, ant_conf);
+		if (err) {
+			LOG_ERR("Error while collecting IQ data, CTE numb: %d", idx);
+			break;
+		}
+
+		iq_batch_stats_add(&stats, &df_mapped_data, expected_phase_diff,
+				   (float)CONFIG_ANT_TEST_PHASE_OFFSET_DEVIATION_RANGE_DEG);
+		iq_batch_stats_add_ref(&stats, &df_mapped_data.ref_data,
+				       sampl_conf, CTE_FREQUENCY_HZ);
+
+		if (verbosity >= TEST_VERBOSITY_HIGH) {
+			protocol_send_msg("[STAT] Raw data:\r\n");
+			err = send_iq_data(&df_mapped_data, sampl_conf);
+			if (err) {
+				LOG_ERR("Error while sending IQ data, CTE numb: %d", idx);
+				break;
+			}
+		}
+	}
+
+	int stop_err = bt_stop_scanning();
+
+	if (err || stop_err) {
+		return false;
+	}
+
+	send_batch_summary(&stats, verbosity);
+
+	return (stats.zeros_num == 0 && stats.oversaturated_num == 0 &&
+		stats.out_of_range_num == 0);
+}
+#endif /* CONFIG_ANT_TEST_BATCH_MODE */
+
 bool run_antenna_test_suite(enum test_verbosity_level verbosity)
 {
 	bool result;
@@ -449,7 +569,11 @@ bool run_antenna_test_suite(enum test_verbosity_level verbosity)
 
 	for (int ant_idx = 1; ant_idx <= ANT_TEST_MAX_ANT_NUMBER; ++ant_idx) {
 		protocol_send_msg("[TEST] Antenna %d test START.\r\n", ant_idx);
+#if defined(CONFIG_ANT_TEST_BATCH_MODE)
+		result = test_antenna_batch(ant_idx, verbosity);
+#else
 		result = test_antenna(ant_idx, CONFIG_ANT_TEST_NUMBER_OF_CTE_TO_COLLECT, verbosity);
+#endif
 		if (!result) {
 			protocol_send_msg("[TEST] Antenna %d test FILED. Error: %d\r\n", ant_idx, result);
 		} else {
@@ -12,6 +12,7 @@
 #include <nrf.h>
 
 #include "dfe_local_config.h"
+#include "dfe_raw_samples.h"
 
 #define MODULE df_config
 #include <logging/log.h>
@@ -256,8 +257,6 @@ void dfe_map_iq_samples_to_antennas(struct dfe_mapped_packet *mapped_data,
 
 	u8_t samples_num = get_sampling_slot_samples_num(sampling_conf);
 
-	u8_t effective_sample_idx;
-
 	bool oversampl = is_oversampling_enabled(sampling_conf);
 
 	if (oversampl) {
@@ -283,7 +282,9 @@ void dfe_map_iq_samples_to_antennas(struct dfe_mapped_packet *mapped_data,
 		sample->antenna_id = ant;
 
 		for(u8_t sample_idx = 0; sample_idx < samples_num; ++sample_idx) {
-			effective_sample_idx = ref_samples_num + (ant_idx * samples_num) + sample_idx;
+			u16_t effective_sample_idx = dfe_raw_sample_idx(ref_samples_num, ant_idx,
+								   samples_num, sample_idx);
+
 			sample->data[sample_idx].i = raw_data->data[effective_sample_idx].iq.i;
 			sample->data[sample_idx].q = raw_data->data[effective_sample_idx].iq.q;
 		}
@@ -5,12 +5,15 @@
  */
 
 #include <assert.h>
+#include <stdbool.h>
 #include <zephyr/types.h>
 #include "dfe_local_config.h"
 #include "iq_samples_statistics.h"
 
 /** @brief Number of wave periods in reference data */
 #define PERIODS_NUM_IN_REF 2
+/** @brief Value set in I or Q if over-saturation detected by radio */
+#define IQ_OVERSATURATION_VAL (-32768)
 
 #define MODULE ant_iq_stats
 #include <logging/log.h>
@@ -149,3 +152,141 @@ void evaluate_stats_in_ref(const struct dfe_ref_samples* ref_samples,
 	*avg_phase_off_periods = avg_value;
 	*avg_mag = eval_avg_magnitude_in_ref(ref_samples);
 }
+
+void iq_stat_init(struct iq_stat *stat)
+{
+	assert(stat != NULL);
+
+	stat->count = 0;
+	stat->mean = 0.0f;
+	stat->m2 = 0.0f;
+	stat->min = INFINITY;
+	stat->max = -INFINITY;
+}
+
+void iq_stat_add(struct iq_stat *stat, float value)
+{
+	assert(stat != NULL);
+
+	float delta = value - stat->mean;
+
+	++stat->count;
+	stat->mean += delta / stat->count;
+	stat->m2 += delta * (value - stat->mean);
+
+	if (value < stat->min) {
+		stat->min = value;
+	}
+	if (value > stat->max) {
+		stat->max = value;
+	}
+}
+
+float iq_stat_variance(const struct iq_stat *stat)
+{
+	assert(stat != NULL);
+
+	if (stat->count < 2) {
+		return 0.0f;
+	}
+
+	return stat->m2 / (stat->count - 1);
+}
+
+void iq_batch_stats_init(struct iq_batch_stats *stats)
+{
+	assert(stats != NULL);
+
+	stats->cte_num = 0;
+	stats->samples_num = 0;
+	stats->zeros_num = 0;
+	stats->oversaturated_num = 0;
+	stats->out_of_range_num = 0;
+	iq_stat_init(&stats->phase_offset);
+	iq_stat_init(&stats->magnitude);
+	iq_stat_init(&stats->ref_phase_off_sampl);
+	iq_stat_init(&stats->ref_phase_off_periods);
+	iq_stat_init(&stats->ref_magnitude);
+}
+
+/** @brief Checks a sample for zeros and over saturation and adds its
+ * magnitude to batch statistics
+ */
+static void batch_stats_add_sample(struct iq_batch_stats *stats,
+				   union dfe_iq_f iq)
+{
+	if (iq.i == 0.0f && iq.q == 0.0f) {
+		++stats->zeros_num;
+	}
+	if (iq.i == IQ_OVERSATURATION_VAL && iq.q == IQ_OVERSATURATION_VAL) {
+		++stats->oversaturated_num;
+	}
+	iq_stat_add(&stats->magnitude, eval_sample_magnitude(iq));
+	++stats->samples_num;
+}
+
+void iq_batch_stats_add(struct iq_batch_stats *stats,
+			const struct dfe_mapped_packet *mapped_data,
+			float expected_phase_change,
+			float phase_range_deg)
+{
+	assert(stats != NULL);
+	assert(mapped_data != NULL);
+
+	const struct dfe_ref_samples *ref_data = &mapped_data->ref_data;
+
+	for (int idx = 0; idx < ref_data->samples_num; ++idx) {
+		batch_stats_add_sample(stats, ref_data->data[idx]);
+	}
+
+	float phase;
+	float prev_phase = 0.0f;
+	float diff_from_expected;
+	bool first = true;
+
+	for (int idx = 0; idx < mapped_data->header.length; ++idx) {
+		const struct dfe_samples *samples_data = &mapped_data->sampl_data[idx];
+
+		for (int iq_idx = 0; iq_idx < samples_data->samples_num; ++iq_idx) {
+			union dfe_iq_f iq = samples_data->data[iq_idx];
+
+			batch_stats_add_sample(stats, iq);
+
+			phase = eval_sample_phase(iq);
+			if (!first) {
+				diff_from_expected = wrapp_phase_around_pi(phase - prev_phase -
+									   expected_phase_change);
+				diff_from_expected = rad_to_deg(diff_from_expected);
+
+				if (fabsf(diff_from_expected) > phase_range_deg) {
+					++stats->out_of_range_num;
+				}
+				iq_stat_add(&stats->phase_offset, diff_from_expected);
+			}
+			prev_phase = phase;
+			first = false;
+		}
+	}
+
+	++stats->cte_num;
+}
+
+void iq_batch_stats_add_ref(struct iq_batch_stats *stats,
+			    const struct dfe_ref_samples *ref_samples,
+			    const struct dfe_sampling_config *sampl_conf,
+			    u32_t frequency)
+{
+	assert(stats != NULL);
+
+	float avg_phase_off_sampl;
+	float avg_phase_off_periods;
+	float avg_magnitude;
+
+	evaluate_stats_in_ref(ref_samples, sampl_conf, frequency,
+			      &avg_phase_off_sampl, &avg_phase_off_periods,
+			      &avg_magnitude);
+
+	iq_stat_add(&stats->ref_phase_off_sampl, avg_phase_off_sampl);
+	iq_stat_add(&stats->ref_phase_off_periods, avg_phase_off_periods);
+	iq_stat_add(&stats->ref_magnitude, avg_magnitude);
+}
@@ -147,4 +147,116 @@ void evaluate_stats_in_ref(const struct dfe_ref_samples* ref_samples,
 						   float *avg_phase_off_periods,
 						   float *avg_mag);
 
+/** @brief Streaming statistics of a single value
+ *
+ * Mean and variance are updated with Welford's algorithm, so values do not
+ * have to be stored and sum of squares does not lose precision.
+ */
+struct iq_stat {
+	/** Number of values added */
+	u32_t count;
+	/** Mean of added values */
+	float mean;
+	/** Sum of squared differences from the mean */
+	float m2;
+	/** Smallest added value */
+	float min;
+	/** Largest added value */
+	float max;
+};
+
+/** @brief Statistics of IQ samples collected for single antenna in a batch
+ * of CTEs
+ */
+struct iq_batch_stats {
+	/** Number of CTEs evaluated */
+	u32_t cte_num;
+	/** Number of IQ samples evaluated */
+	u32_t samples_num;
+	/** Number of samples with I and Q equal to zero */
+	u32_t zeros_num;
+	/** Number of over saturated samples */
+	u32_t oversaturated_num;
+	/** Number of samples with phase offset out of allowed range */
+	u32_t out_of_range_num;
+	/** Difference between phase offset of consecutive samples and expected
+	 * phase offset, in degrees
+	 */
+	struct iq_stat phase_offset;
+	/** Magnitude of samples */
+	struct iq_stat magnitude;
+	/** Average phase offset between samples in reference period of every
+	 * CTE, in degrees
+	 */
+	struct iq_stat ref_phase_off_sampl;
+	/** Average phase offset between periods in reference period of every
+	 * CTE, in degrees
+	 */
+	struct iq_stat ref_phase_off_periods;
+	/** Average magnitude in reference period of every CTE */
+	struct iq_stat ref_magnitude;
+};
+
+/** @brief Initializes streaming statistics
+ *
+ * @param[out] stat	Statistics to be initialized
+ */
+void iq_stat_init(struct iq_stat *stat);
+
+/** @brief Adds a value to streaming statistics
+ *
+ * @param[in,out] stat	Statistics to be updated
+ * @param[in] value	Value to be added
+ */
+void iq_stat_add(struct iq_stat *stat, float value);
+
+/** @brief Provides variance of values added to streaming statistics
+ *
+ * @param[in] stat	Statistics
+ *
+ * @return Sample variance, zero if less than two values were added
+ */
+float iq_stat_variance(const struct iq_stat *stat);
+
+/** @brief Initializes batch statistics
+ *
+ * @param[out] stats	Statistics to be initialized
+ */
+void iq_batch_stats_init(struct iq_batch_stats *stats);
+
+/** @brief Adds IQ samples of single CTE to batch statistics
+ *
+ * All samples of the CTE are evaluated in a single pass. Samples are checked
+ * for zeros and over saturation, their magnitude and phase offset between
+ * consecutive samples collected after reference period are added to
+ * statistics.
+ *
+ * @param[in,out] stats			Statistics to be updated
+ * @param[in] mapped_data		Pointer to IQ samples mapped to antennas
+ * @param[in] expected_phase_change	Value of expected phase change between
+ *					consecutive samples in radians
+ * @param[in] phase_range_deg		Allowed deviation of phase offset
+ *					from expected value in degrees
+ */
+void iq_batch_stats_add(struct iq_batch_stats *stats,
+			const struct dfe_mapped_packet *mapped_data,
+			float expected_phase_change,
+			float phase_range_deg);
+
+/** @brief Adds statistics of reference period of single CTE to batch
+ * statistics
+ *
+ * Reference period is evaluated by @ref evaluate_stats_in_ref, its results
+ * are added to statistics of the batch.
+ *
+ * @param[in,out] stats		Statistics to be updated
+ * @param[in] ref_samples	Pointer to reference period data
+ * @param[in] sampl_conf	Pointer to sampling configuration
+ * @param[in] frequency		Expected ideal frequency in Hz
+ */
+void iq_batch_stats_add_ref(struct iq_batch_stats *stats,
+			    const struct dfe_ref_samples *ref_samples,
+			    const struct dfe_sampling_config *sampl_conf,
+			    u32_t frequency);
+
 #endif /* DF_IQ_SAMPLES_STATISTICS_H_ */
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+#include <ztest.h>
+#include <math.h>
+
+#include <dfe_local_config.h>
+#include <iq_samples_statistics.h>
+#include "iq_samples_statistics_tests.h"
+
+/** @brief Frequency of CTE sent in connectionless mode [Hz] */
+#define TEST_CTE_FREQUENCY_HZ 250000
+/** @brief Amplitude of generated IQ samples */
+#define TEST_AMPLITUDE 1000.0f
+/** @brief Allowed deviation of phase offset used by tests [deg] */
+#define TEST_PHASE_RANGE_DEG 5.0f
+/** @brief Phase error added to a sample to get it out of range [deg] */
+#define TEST_PHASE_ERROR_DEG 20.0f
+/** @brief Maximum error of evaluated phase statistics [deg] */
+#define TEST_MAX_PHASE_ERROR 0.01f
+/** @brief Maximum relative error of evaluated magnitude */
+#define TEST_MAX_MAGNITUDE_ERROR 1.0e-3f
+/** @brief Number of sampling slots filled by tests */
+#define TEST_SLOTS_NUM 4
+/** @brief Value set in I and Q if over-saturation is detected by radio */
+#define TEST_OVERSATURATION_VAL (-32768)
+
+static struct dfe_mapped_packet g_mapped_data;
+
+static float test_float_error(float value, float expected)
+{
+	return fabsf(value - expected);
+}
+
+static union dfe_iq_f test_iq_sample(float phase)
+{
+	union dfe_iq_f iq;
+
+	iq.i = TEST_AMPLITUDE * cosf(phase);
+	iq.q = TEST_AMPLITUDE * sinf(phase);
+	return iq;
+}
+
+/** @brief Fills packet with samples of an ideal CTE wave
+ *
+ * Samples of reference period are spaced by reference samples spacing.
+ * Samples of sampling slots are consecutive, so every sample differs from
+ * the previous one by @p phase_step.
+ *
+ * @param[in] sampl_conf	Sampling configuration
+ * @param[in] phase_step	Phase change between consecutive samples [rad]
+ */
+static void test_packet_fill(const struct dfe_sampling_config *sampl_conf,
+			     float phase_step)
+{
+	u16_t ref_spacing_ns = dfe_get_sample_spacing_ref_ns(sampl_conf->sample_spacing_ref);
+	float ref_phase_step = get_expected_phase_offset(TEST_CTE_FREQUENCY_HZ,
+							 ref_spacing_ns);
+	u16_t ref_samples_num = dfe_get_ref_samples_num(sampl_conf);
+	float phase = 0.0f;
+
+	zassert_true(ref_samples_num <= DFE_REF_SAMPLES_NUM,
+		     "Reference samples do not fit storage");
+
+	memset(&g_mapped_data, 0, sizeof(g_mapped_data));
+
+	for (u16_t idx = 0; idx < ref_samples_num; ++idx) {
+		g_mapped_data.ref_data.data[idx] = test_iq_sample(ref_phase_step * idx);
+	}
+	g_mapped_data.ref_data.samples_num = ref_samples_num;
+
+	for (u16_t slot = 0; slot < TEST_SLOTS_NUM; ++slot) {
+		struct dfe_samples *samples = &g_mapped_data.sampl_data[slot];
+
+		for (u8_t idx = 0; idx < DFE_SAMPLES_PER_SLOT_NUM; ++idx) {
+			samples->data[idx] = test_iq_sample(phase);
+			phase += phase_step;
+		}
+		samples->samples_num = DFE_SAMPLES_PER_SLOT_NUM;
+		samples->antenna_id = 1;
+	}
+	g_mapped_data.header.length = TEST_SLOTS_NUM;
+	g_mapped_data.header.frequency = 2402;
+}
+
+static float test_phase_step(const struct dfe_sampling_config *sampl_conf)
+{
+	return get_expected_phase_offset(TEST_CTE_FREQUENCY_HZ,
+			dfe_get_sample_spacing_ref_ns(sampl_conf->sample_spacing_ref));
+}
+
+void test_iq_stat_mean_and_variance()
+{
+	const float values[] = {2.0f, 4.0f, 4.0f, 4.0f, 5.0f, 5.0f, 7.0f, 9.0f};
+	struct iq_stat stat;
+
+	iq_stat_init(&stat);
+	for (size_t idx = 0; idx < ARRAY_SIZE(values); ++idx) {
+		iq_stat_add(&stat, values[idx]);
+	}
+
+	zassert_equal(stat.count, ARRAY_SIZE(values), "Wrong number of values");
+	zassert_true(test_float_error(stat.mean, 5.0f) < 1.0e-6f,
+		     "Wrong mean");
+	zassert_true(test_float_error(iq_stat_variance(&stat), 32.0f / 7.0f) < 1.0e-5f,
+		     "Wrong sample variance");
+	zassert_equal(stat.min, 2.0f, "Wrong minimum");
+	zassert_equal(stat.max, 9.0f, "Wrong maximum");
+}
+
+void test_iq_stat_single_value()
+{
+	struct iq_stat stat;
+
+	iq_stat_init(&stat);
+	zassert_equal(iq_stat_variance(&stat), 0.0f,
+		      "Variance of no values must be zero");
+
+	iq_stat_add(&stat, -3.0f);
+	zassert_equal(stat.mean, -3.0f, "Wrong mean");
+	zassert_equal(iq_stat_variance(&stat), 0.0f,
+		      "Variance of single value must be zero");
+	zassert_equal(stat.min, -3.0f, "Wrong minimum");
+	zassert_equal(stat.max, -3.0f, "Wrong maximum");
+}
+
+void test_batch_stats_ideal_wave()
+{
+	const struct dfe_sampling_config *sampl_conf = dfe_get_sampling_config();
+	float phase_step = test_phase_step(sampl_conf);
+	u32_t samples_num = dfe_get_ref_samples_num(sampl_conf) +
+			    (TEST_SLOTS_NUM * DFE_SAMPLES_PER_SLOT_NUM);
+	struct iq_batch_stats stats;
+
+	test_packet_fill(sampl_conf, phase_step);
+
+	iq_batch_stats_init(&stats);
+	iq_batch_stats_add(&stats, &g_mapped_data, phase_step, TEST_PHASE_RANGE_DEG);
+	iq_batch_stats_add(&stats, &g_mapped_data, phase_step, TEST_PHASE_RANGE_DEG);
+
+	zassert_equal(stats.cte_num, 2, "Wrong number of CTEs");
+	zassert_equal(stats.samples_num, 2 * samples_num, "Wrong number of samples");
+	zassert_equal(stats.zeros_num, 0, "Ideal wave has no zeros");
+	zassert_equal(stats.oversaturated_num, 0, "Ideal wave is not over saturated");
+	zassert_equal(stats.out_of_range_num, 0, "Ideal wave phase is in range");
+	zassert_equal(stats.phase_offset.count,
+		      2 * ((TEST_SLOTS_NUM * DFE_SAMPLES_PER_SLOT_NUM) - 1),
+		      "Phase offset evaluated for wrong number of samples");
+	zassert_true(fabsf(stats.phase_offset.mean) < TEST_MAX_PHASE_ERROR,
+		     "Phase offset of ideal wave differs from expected");
+	zassert_true(test_float_error(stats.magnitude.mean, TEST_AMPLITUDE) <
+		     (TEST_AMPLITUDE * TEST_MAX_MAGNITUDE_ERROR),
+		     "Wrong mean magnitude");
+}
+
+void test_batch_stats_zeros_and_oversaturation()
+{
+	const struct dfe_sampling_config *sampl_conf = dfe_get_sampling_config();
+	float phase_step = test_phase_step(sampl_conf);
+	struct iq_batch_stats stats;
+
+	test_packet_fill(sampl_conf, phase_step);
+	g_mapped_data.ref_data.data[0].i = 0.0f;
+	g_mapped_data.ref_data.data[0].q = 0.0f;
+	g_mapped_data.sampl_data[1].data[2].i = TEST_OVERSATURATION_VAL;
+	g_mapped_data.sampl_data[1].data[2].q = TEST_OVERSATURATION_VAL;
+
+	iq_batch_stats_init(&stats);
+	iq_batch_stats_add(&stats, &g_mapped_data, phase_step, TEST_PHASE_RANGE_DEG);
+
+	zassert_equal(stats.zeros_num, 1, "Sample with zeros not detected");
+	zassert_equal(stats.oversaturated_num, 1,
+		      "Over saturated sample not detected");
+}
+
+void test_batch_stats_phase_out_of_range()
+{
+	const struct dfe_sampling_config *sampl_conf = dfe_get_sampling_config();
+	float phase_step = test_phase_step(sampl_conf);
+	struct iq_batch_stats stats;
+	struct dfe_samples *samples;
+
+	test_packet_fill(sampl_conf, phase_step);
+
+	/* Phase offsets to the previous and to the next sample are wrong */
+	samples = &g_mapped_data.sampl_data[2];
+	samples->data[3] = test_iq_sample((((2 * DFE_SAMPLES_PER_SLOT_NUM) + 3) * phase_step) +
+					  deg_to_rad(TEST_PHASE_ERROR_DEG));
+
+	iq_batch_stats_init(&stats);
+	iq_batch_stats_add(&stats, &g_mapped_data, phase_step, TEST_PHASE_RANGE_DEG);
+
+	zassert_equal(stats.out_of_range_num, 2,
+		      "Phase offsets out of range not detected");
+	zassert_true(test_float_error(stats.phase_offset.max, TEST_PHASE_ERROR_DEG) <
+		     TEST_MAX_PHASE_ERROR, "Wrong maximum phase offset");
+	zassert_true(test_float_error(stats.phase_offset.min, -TEST_PHASE_ERROR_DEG) <
+		     TEST_MAX_PHASE_ERROR, "Wrong minimum phase offset");
+}
+
+void test_batch_stats_reference_period()
+{
+	const struct dfe_sampling_config *sampl_conf = dfe_get_sampling_config();
+	float avg_phase_off_sampl;
+	float avg_phase_off_periods;
+	float avg_magnitude;
+	struct iq_batch_stats stats;
+
+	test_packet_fill(sampl_conf, test_phase_step(sampl_conf));
+
+	evaluate_stats_in_ref(&g_mapped_data.ref_data, sampl_conf,
+			      TEST_CTE_FREQUENCY_HZ, &avg_phase_off_sampl,
+			      &avg_phase_off_periods, &avg_magnitude);
+
+	iq_batch_stats_init(&stats);
+	iq_batch_stats_add_ref(&stats, &g_mapped_data.ref_data, sampl_conf,
+			       TEST_CTE_FREQUENCY_HZ);
+	iq_batch_stats_add_ref(&stats, &g_mapped_data.ref_data, sampl_conf,
+			       TEST_CTE_FREQUENCY_HZ);
+
+	zassert_equal(stats.ref_phase_off_sampl.count, 2,
+		      "Reference period not added for every CTE");
+	zassert_equal(stats.ref_phase_off_sampl.mean, avg_phase_off_sampl,
+		      "Batch differs from single CTE statistics");
+	zassert_equal(stats.ref_phase_off_periods.mean, avg_phase_off_periods,
+		      "Batch differs from single CTE statistics");
+	zassert_equal(stats.ref_magnitude.mean, avg_magnitude,
+		      "Batch differs from single CTE statistics");
+
+	zassert_true(fabsf(avg_phase_off_sampl) < TEST_MAX_PHASE_ERROR,
+		     "Phase offset between samples of ideal wave is not zero");
+	zassert_true(fabsf(avg_phase_off_periods) < TEST_MAX_PHASE_ERROR,
+		     "Phase offset between periods of ideal wave is not zero");
+	zassert_true(test_float_error(avg_magnitude, TEST_AMPLITUDE) <
+		     (TEST_AMPLITUDE * TEST_MAX_MAGNITUDE_ERROR),
+		     "Wrong mean magnitude in reference period");
+	zassert_equal(iq_stat_variance(&stats.ref_magnitude), 0.0f,
+		      "Equal CTEs must not change reference statistics");
+}
@@ -0,0 +1,16 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+#ifndef TESTS_SRC_IQ_SAMPLES_STATISTICS_TESTS_H_
+#define TESTS_SRC_IQ_SAMPLES_STATISTICS_TESTS_H_
+
+void test_iq_stat_mean_and_variance();
+void test_iq_stat_single_value();
+void test_batch_stats_ideal_wave();
+void test_batch_stats_zeros_and_oversaturation();
+void test_batch_stats_phase_out_of_range();
+void test_batch_stats_reference_period();
+
+#endif /* TESTS_SRC_IQ_SAMPLES_STATISTICS_TESTS_H_ */
@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <ztest.h>
+#include "iq_samples_statistics_tests.h"
+
+void test_main(void)
+{
+	ztest_test_suite(iq_samples_statistics_tests,
+		ztest_unit_test(test_iq_stat_mean_and_variance),
+		ztest_unit_test(test_iq_stat_single_value),
+		ztest_unit_test(test_batch_stats_ideal_wave),
+		ztest_unit_test(test_batch_stats_zeros_and_oversaturation),
+		ztest_unit_test(test_batch_stats_phase_out_of_range),
+		ztest_unit_test(test_batch_stats_reference_period));
+
+	ztest_run_test_suite(iq_samples_statistics_tests);
+}
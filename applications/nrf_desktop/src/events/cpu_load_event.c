@@ -14,9 +14,22 @@ static int log_cpu_load_event(const struct event_header *eh, char *buf,
 			      size_t buf_len)
 {
 	const struct cpu_load_event *event = cast_cpu_load_event(eh);
-
-	return snprintf(buf, buf_len, "CPU load: %03u,%03u%%",
-			event->load / 1000, event->load % 1000);
+	int pos = snprintf(buf, buf_len, "CPU load: %03u,%03u%%",
+			   event->load / 1000, event->load % 1000);
+
+#ifdef CONFIG_DESKTOP_CPU_MEAS_BREAKDOWN
+	for (size_t i = 0; (i < event->breakdown_cnt) && (pos >= 0) &&
+			   (pos < buf_len); i++) {
+		const struct cpu_load_ctx *ctx = &event->breakdown[i];
+		int len = snprintf(&buf[pos], buf_len - pos, " %s:%u,%03u%%",
+				   ctx->name, ctx->load / 1000,
+				   ctx->load % 1000);
+
+		pos = (len < 0) ? len : (pos + len);
+	}
+#endif
+
+	return pos;
 }
 
 static void profile_cpu_load_event(struct log_event_buf *buf,
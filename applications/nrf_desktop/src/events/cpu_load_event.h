@@ -13,6 +13,8 @@
  * @{
  */
 
+#include <debug/cpu_load.h>
+
 #include "event_manager.h"
 
 #ifdef __cplusplus
@@ -24,6 +26,15 @@ struct cpu_load_event {
 	struct event_header header; /**< Event header. */
 
 	u32_t load; /**< CPU load [in 0,001% units]. */
+
+#ifdef CONFIG_DESKTOP_CPU_MEAS_BREAKDOWN
+	u8_t breakdown_cnt; /**< Number of valid breakdown entries. */
+
+	/** Threads and interrupts that used the CPU the most,
+	 *  sorted by load.
+	 */
+	struct cpu_load_ctx breakdown[CONFIG_DESKTOP_CPU_MEAS_BREAKDOWN_CNT];
+#endif
 };
 
 EVENT_TYPE_DECLARE(cpu_load_event);
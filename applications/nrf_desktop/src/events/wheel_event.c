@@ -5,6 +5,7 @@
  */
 
 #include <stdio.h>
+#include <limits.h>
 
 #include "wheel_event.h"
 
@@ -16,7 +17,26 @@ static int log_wheel_event(const struct event_header *eh, char *buf,
 	return snprintf(buf, buf_len, "wheel=%d", event->wheel);
 }
 
-EVENT_TYPE_DEFINE(wheel_event,
-		  IS_ENABLED(CONFIG_DESKTOP_INIT_LOG_WHEEL_EVENT),
-		  log_wheel_event,
-		  NULL);
+static bool coalesce_wheel_event(struct event_header *queued,
+				 const struct event_header *eh)
+{
+	struct wheel_event *queued_event = cast_wheel_event(queued);
+	const struct wheel_event *event = cast_wheel_event(eh);
+
+	s32_t wheel = queued_event->wheel + event->wheel;
+
+	if ((wheel < SHRT_MIN) || (wheel > SHRT_MAX)) {
+		return false;
+	}
+
+	queued_event->wheel = wheel;
+
+	return true;
+}
+
+EVENT_TYPE_COALESCE_DEFINE(wheel_event,
+			   EVENT_DISPATCH_CLASS_NORMAL,
+			   coalesce_wheel_event,
+			   IS_ENABLED(CONFIG_DESKTOP_INIT_LOG_WHEEL_EVENT),
+			   log_wheel_event,
+			   NULL);
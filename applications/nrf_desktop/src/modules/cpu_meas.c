@@ -23,6 +23,18 @@ static void send_cpu_load_event(u32_t load)
 	struct cpu_load_event *event = new_cpu_load_event();
 
 	event->load = load;
+
+#ifdef CONFIG_DESKTOP_CPU_MEAS_BREAKDOWN
+	int cnt = cpu_load_breakdown_get(event->breakdown,
+					 ARRAY_SIZE(event->breakdown));
+
+	if (cnt < 0) {
+		LOG_WRN("Cannot get CPU load breakdown, err: %d", cnt);
+		cnt = 0;
+	}
+	event->breakdown_cnt = cnt;
+#endif
+
 	EVENT_SUBMIT(event);
 }
 
@@ -61,7 +61,7 @@ static void enqueue_hid_event(struct hid_report_event *event)
 		item = CONTAINER_OF(sys_slist_get(&enqueued_event_list),
 				    __typeof__(*item),
 				    node);
-		k_free(item->event);
+		event_manager_free(item->event);
 	}
 
 	if (!item) {
@@ -81,7 +81,7 @@ static void forward_hid_report(u8_t report_id, const u8_t *data, size_t size)
 
 	if (!usb_ready) {
 		k_spin_unlock(&lock, key);
-		k_free(event);
+		event_manager_free(event);
 		return;
 	}
 
@@ -461,7 +461,7 @@ static void clear_state(void)
 
 		k_spin_unlock(&lock, key);
 
-		k_free(item->event);
+		event_manager_free(item->event);
 		k_free(item);
 
 		key = k_spin_lock(&lock);
@@ -7,11 +7,14 @@
 #define __CPU_LOAD_H
 
 #include <zephyr/types.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+struct k_thread;
+
 /**
  * @defgroup cpu_load CPU load
  * @brief Module for measuring CPU load.
@@ -27,6 +30,8 @@ extern "C" {
  * @retval 0 The initialization is successful.
  * @retval -ENODEV PPI channels could not be allocated.
  * @retval -EBUSY TIMER instance is busy.
+ * @retval -ENOTSUP Cycle counter used for CPU load attribution is not
+ *		   available.
  */
 int cpu_load_init(void);
 
@@ -46,6 +51,56 @@ void cpu_load_reset(void);
  */
 u32_t cpu_load_get(void);
 
+/** @brief Length of CPU load context name, including terminating zero. */
+#define CPU_LOAD_CTX_NAME_LEN 16
+
+/** @brief Type of context the CPU load is attributed to. */
+enum cpu_load_ctx_type {
+	/** Thread. */
+	CPU_LOAD_CTX_THREAD,
+
+	/** Interrupt line. */
+	CPU_LOAD_CTX_IRQ,
+
+	/** Threads that do not fit into the table and other exceptions. */
+	CPU_LOAD_CTX_OTHER,
+};
+
+/** @brief CPU load of a single context. */
+struct cpu_load_ctx {
+	/** Type of the context. */
+	enum cpu_load_ctx_type type;
+
+	/** Identifier of the context. */
+	union {
+		/** Thread, valid for @ref CPU_LOAD_CTX_THREAD. */
+		const struct k_thread *thread;
+
+		/** IRQ number, valid for @ref CPU_LOAD_CTX_IRQ. */
+		u16_t irq;
+	} id;
+
+	/** Thread name, IRQ number or "other" as a string. */
+	char name[CPU_LOAD_CTX_NAME_LEN];
+
+	/** CPU load of the context in 0,001% units. */
+	u32_t load;
+};
+
+/** @brief Get the CPU load breakdown.
+ *
+ * Active CPU cycles are attributed to threads and interrupt lines since
+ * the last reset of the measurement. The function is available if
+ * CONFIG_CPU_LOAD_ATTRIBUTION is enabled.
+ *
+ * @param[out] ctxs Array of contexts, sorted by load in descending order.
+ * @param[in] cnt Size of the array. Only the most loading contexts are
+ *		  provided if the array is too small.
+ *
+ * @return Number of contexts written to the array or a negative error code.
+ */
+int cpu_load_breakdown_get(struct cpu_load_ctx *ctxs, size_t cnt);
+
 /** @} */
 
 #ifdef __cplusplus
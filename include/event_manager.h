@@ -54,6 +54,27 @@ extern "C" {
 #define SUBS_PRIO_COUNT (SUBS_PRIO_MAX - SUBS_PRIO_MIN + 1)
 
 
+/** @brief Event dispatch class.
+ *
+ * Events of different dispatch classes are processed by separate threads
+ * if CONFIG_DESKTOP_EVENT_MANAGER_DISPATCH_CLASSES is enabled. Order of
+ * events is preserved only within a dispatch class.
+ */
+enum event_dispatch_class {
+	/** Latency-critical events, for example user input. */
+	EVENT_DISPATCH_CLASS_REALTIME,
+
+	/** Default dispatch class. */
+	EVENT_DISPATCH_CLASS_NORMAL,
+
+	/** Events with slow listeners, for example storing settings. */
+	EVENT_DISPATCH_CLASS_BACKGROUND,
+
+	/** Number of dispatch classes. */
+	EVENT_DISPATCH_CLASS_COUNT
+};
+
+
 /** @brief Event header.
  *
  * When defining an event structure, the event header
@@ -65,6 +86,11 @@ struct event_header {
 
 	/** Pointer to the event type object. */
 	const struct event_type *type_id;
+
+#ifdef CONFIG_DESKTOP_EVENT_MANAGER_QUEUE_STATS
+	/** Cycle counter value at event submission. */
+	u32_t submit_cycles;
+#endif
 };
 
 
@@ -82,6 +108,40 @@ struct event_dyndata {
 };
 
 
+/** @def EVENT_LATENCY_HIST_BUCKET_CNT
+ *
+ * @brief Number of latency histogram buckets.
+ *
+ * Bucket 0 counts times shorter than 2 microseconds. Bucket n counts times
+ * from 2^n to 2^(n+1) microseconds. The last bucket counts all longer times.
+ */
+#define EVENT_LATENCY_HIST_BUCKET_CNT 16
+
+
+/** @brief Latency histogram.
+ *
+ * Histograms are updated only by the Event Manager.
+ */
+struct event_latency_hist {
+	/** Number of samples in every bucket. */
+	atomic_t buckets[EVENT_LATENCY_HIST_BUCKET_CNT];
+
+	/** Longest time in microseconds. */
+	atomic_t max_us;
+};
+
+
+/** @brief Latency histograms of an event type.
+ */
+struct event_type_latency {
+	/** Time between event submission and processing start. */
+	struct event_latency_hist wait;
+
+	/** Time of notifying all listeners about the event. */
+	struct event_latency_hist exec;
+};
+
+
 /** @brief Event listener.
  *
  * All event listeners must be defined using @ref EVENT_LISTENER.
@@ -93,6 +153,11 @@ struct event_listener {
 	/** Pointer to the function that is called when an event
 	 *  is handled. */
 	bool (*notification)(const struct event_header *eh);
+
+#ifdef CONFIG_DESKTOP_EVENT_MANAGER_LATENCY_STATS
+	/** Histogram of the notification function execution time. */
+	struct event_latency_hist *latency;
+#endif
 };
 
 
@@ -128,7 +193,12 @@ struct event_type {
 	/** Event name. */
 	const char			*name;
 
-	/** Array of pointers to the array of subscribers. */
+	/** Array of pointers to the array of subscribers.
+	 *
+	 * Subscribers of all priority levels form a single array sorted
+	 * by priority, so subs_stop of a level equals subs_start of the
+	 * next level.
+	 */
 	const struct event_subscriber	*subs_start[SUBS_PRIO_COUNT];
 
 	/** Array of pointers to the element directly after the array of
@@ -138,12 +208,28 @@ struct event_type {
 	/** Bool indicating if the event is logged by default. */
 	bool init_log_enable;
 
+	/** Dispatch class of the event. */
+	enum event_dispatch_class dispatch_class;
+
+	/** Function merging a newer event into a queued event of this type.
+	 *
+	 * Returns true if the newer event was merged. Called with the
+	 * Event Manager lock taken.
+	 */
+	bool (*coalesce)(struct event_header *queued,
+			 const struct event_header *eh);
+
 	/** Function to log data from this event. */
 	int (*log_event)(const struct event_header *eh, char *buf,
 			      size_t buf_len);
 
 	/** Logging and formatting information. */
 	const struct event_info *ev_info;
+
+#ifdef CONFIG_DESKTOP_EVENT_MANAGER_LATENCY_STATS
+	/** Latency histograms of the event. */
+	struct event_type_latency *latency;
+#endif
 };
 
 
@@ -169,7 +255,7 @@ extern const struct event_type __stop_event_types[];
  * @param ename  Name of the event.
  */
 #define EVENT_SUBSCRIBE_EARLY(lname, ename) \
-	_EVENT_SUBSCRIBE(lname, ename, _SUBS_PRIO_ID(_SUBS_PRIO_FIRST))
+	_EVENT_SUBSCRIBE(lname, ename, _SUBS_PRIO_FIRST)
 
 
 /** Subscribe a listener to the normal notification list for an event
@@ -179,7 +265,7 @@ extern const struct event_type __stop_event_types[];
  * @param ename  Name of the event.
  */
 #define EVENT_SUBSCRIBE(lname, ename) \
-	_EVENT_SUBSCRIBE(lname, ename, _SUBS_PRIO_ID(_SUBS_PRIO_NORMAL))
+	_EVENT_SUBSCRIBE(lname, ename, _SUBS_PRIO_NORMAL)
 
 
 /** Subscribe a listener to an event type as final module that is
@@ -189,7 +275,7 @@ extern const struct event_type __stop_event_types[];
  * @param ename  Name of the event.
  */
 #define EVENT_SUBSCRIBE_FINAL(lname, ename)							\
-	_EVENT_SUBSCRIBE(lname, ename, _SUBS_PRIO_ID(_SUBS_PRIO_FINAL));			\
+	_EVENT_SUBSCRIBE(lname, ename, _SUBS_PRIO_FINAL);			\
 	const struct {} _CONCAT(_CONCAT(__event_subscriber_, ename), final_sub_redefined) = {}
 
 
@@ -261,6 +347,50 @@ extern const struct event_type __stop_event_types[];
 	_EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct)
 
 
+/** Define an event type of a given dispatch class.
+ *
+ * This macro works like @ref EVENT_TYPE_DEFINE, but events of the defined
+ * type are dispatched in the given class.
+ *
+ * @param ename     	   Name of the event.
+ * @param dispatch_cls	   Dispatch class (represented as
+ *                         @ref event_dispatch_class).
+ * @param init_log_en	   Bool indicating if the event is logged
+ *                         by default.
+ * @param log_fn  	   Function to stringify an event of this type.
+ * @param ev_info_struct   Data structure describing the event type.
+ */
+#define EVENT_TYPE_CLASS_DEFINE(ename, dispatch_cls, init_log_en, log_fn, ev_info_struct) \
+	_EVENT_TYPE_CLASS_DEFINE(ename, dispatch_cls, init_log_en, log_fn, ev_info_struct)
+
+
+/** Define an event type with coalescing.
+ *
+ * This macro works like @ref EVENT_TYPE_CLASS_DEFINE, but a submitted event
+ * of the defined type can be merged into an event of the same type that
+ * was submitted before and is still waiting for processing. The merge is
+ * done only if that event is the last one in the queue, so the order of
+ * events is preserved.
+ *
+ * The coalescing function is called with the Event Manager lock taken,
+ * possibly from an interrupt. It must be short and must not submit events.
+ * If the function returns true, the newer event is freed and its listeners
+ * are not notified about it.
+ *
+ * @param ename     	   Name of the event.
+ * @param dispatch_cls	   Dispatch class (represented as
+ *                         @ref event_dispatch_class).
+ * @param coalesce_fn	   Function merging the newer event (second argument)
+ *                         into the queued event (first argument).
+ * @param init_log_en	   Bool indicating if the event is logged
+ *                         by default.
+ * @param log_fn  	   Function to stringify an event of this type.
+ * @param ev_info_struct   Data structure describing the event type.
+ */
+#define EVENT_TYPE_COALESCE_DEFINE(ename, dispatch_cls, coalesce_fn, init_log_en, log_fn, ev_info_struct) \
+	_EVENT_TYPE_COALESCE_DEFINE(ename, dispatch_cls, coalesce_fn, init_log_en, log_fn, ev_info_struct)
+
+
 /** Verify if an event ID is valid.
  *
  * The pointer to an event type structure is used as its ID. This macro
@@ -273,6 +403,31 @@ extern const struct event_type __stop_event_types[];
 	__ASSERT_NO_MSG((id >= __start_event_types) && (id < __stop_event_types))
 
 
+/** Allocate memory for an event.
+ *
+ * Memory is taken from the event pools if
+ * CONFIG_DESKTOP_EVENT_MANAGER_EVENT_POOL is enabled, from the heap
+ * otherwise. Out of memory error results in a system reboot.
+ *
+ * @note Events should be allocated with new_<i>%event_type</i> functions.
+ *
+ * @param size  Size of the event.
+ *
+ * @return Pointer to the allocated memory or NULL on error.
+ */
+void *event_manager_alloc(size_t size);
+
+
+/** Free memory allocated for an event.
+ *
+ * Events are freed by the Event Manager after processing. Use this function
+ * to free an event that was allocated but not submitted.
+ *
+ * @param addr  Pointer to the event.
+ */
+void event_manager_free(void *addr);
+
+
 /** Submit an event to the Event Manager.
  *
  * @param eh  Pointer to the event header element in the event object.
@@ -289,6 +444,158 @@ void _event_submit(struct event_header *eh);
 #define EVENT_SUBMIT(event) _event_submit(&event->header)
 
 
+/** Submit a batch of events to the Event Manager.
+ *
+ * Events are put into the queues under a single lock and every queue is
+ * woken up once. Events are processed in the order of the array.
+ *
+ * @param ehs  Array of pointers to the event header elements in the event
+ *             objects.
+ * @param cnt  Number of events in the array.
+ */
+void _event_submit_batch(struct event_header *const *ehs, size_t cnt);
+
+
+/** Submit a batch of events.
+ *
+ * @param ehs  Array of pointers to the event header elements in the event
+ *             objects.
+ * @param cnt  Number of events in the array.
+ */
+#define EVENT_SUBMIT_BATCH(ehs, cnt) _event_submit_batch(ehs, cnt)
+
+
+/** @brief Event queue statistics.
+ */
+struct event_queue_stats {
+	/** Number of processed events. */
+	u32_t processed;
+
+	/** Number of events merged into queued events. */
+	u32_t coalesced;
+
+	/** Number of events waiting for processing. */
+	u32_t depth;
+
+	/** Highest number of events waiting for processing. */
+	u32_t max_depth;
+
+	/** Average time between event submission and processing start
+	 *  in microseconds. */
+	u32_t latency_avg_us;
+
+	/** Highest time between event submission and processing start
+	 *  in microseconds. */
+	u32_t latency_max_us;
+};
+
+
+/** Get number of event queues.
+ *
+ * There is a queue for every dispatch class if
+ * CONFIG_DESKTOP_EVENT_MANAGER_DISPATCH_CLASSES is enabled. Otherwise,
+ * all events use a single queue.
+ *
+ * @return Number of event queues.
+ */
+size_t event_manager_queue_cnt(void);
+
+
+/** Get event queue statistics.
+ *
+ * Statistics are available if CONFIG_DESKTOP_EVENT_MANAGER_QUEUE_STATS
+ * is enabled.
+ *
+ * @param queue_idx  Queue index, equal to the dispatch class if dispatch
+ *                   classes are enabled.
+ * @param stats      Pointer to the statistics.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL If the queue index is invalid.
+ * @retval -ENOTSUP If statistics are disabled.
+ */
+int event_manager_queue_stats_get(size_t queue_idx,
+				  struct event_queue_stats *stats);
+
+
+/** Reset event queue statistics.
+ *
+ * Queue depth is not reset.
+ */
+void event_manager_queue_stats_reset(void);
+
+
+/** @brief Event latency statistics.
+ */
+struct event_latency_stats {
+	/** Number of samples. */
+	u32_t cnt;
+
+	/** Longest time in microseconds. */
+	u32_t max_us;
+
+	/** Number of samples in every bucket
+	 *  (see @ref EVENT_LATENCY_HIST_BUCKET_CNT). */
+	u32_t buckets[EVENT_LATENCY_HIST_BUCKET_CNT];
+};
+
+
+/** Get latency statistics of an event type.
+ *
+ * Statistics are available if CONFIG_DESKTOP_EVENT_MANAGER_LATENCY_STATS
+ * is enabled.
+ *
+ * @param et    Pointer to the event type.
+ * @param wait  Pointer to the statistics of the time between event
+ *              submission and processing start. Can be NULL.
+ * @param exec  Pointer to the statistics of the time of notifying all
+ *              listeners about the event. Can be NULL.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL If the event type is invalid.
+ * @retval -ENOTSUP If statistics are disabled.
+ */
+int event_manager_event_latency_get(const struct event_type *et,
+				    struct event_latency_stats *wait,
+				    struct event_latency_stats *exec);
+
+
+/** Get latency statistics of an event listener.
+ *
+ * Statistics are available if CONFIG_DESKTOP_EVENT_MANAGER_LATENCY_STATS
+ * is enabled.
+ *
+ * @param el    Pointer to the listener.
+ * @param exec  Pointer to the statistics of the notification function
+ *              execution time.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL If the listener is invalid.
+ * @retval -ENOTSUP If statistics are disabled.
+ */
+int event_manager_listener_latency_get(const struct event_listener *el,
+				       struct event_latency_stats *exec);
+
+
+/** Reset latency statistics of all event types and listeners.
+ */
+void event_manager_latency_stats_reset(void);
+
+
+/** Estimate a percentile of latency statistics.
+ *
+ * The estimate is the upper bound of the histogram bucket that contains
+ * the percentile, limited to the longest time.
+ *
+ * @param stats    Pointer to the statistics.
+ * @param percent  Percentile (from 0 to 100).
+ *
+ * @return Estimated time in microseconds.
+ */
+u32_t event_latency_percentile_us(const struct event_latency_stats *stats,
+				  u8_t percent);
+
+
 /** Initialize the Event Manager.
  *
  * @retval 0 If the operation was successful.
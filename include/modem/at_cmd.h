@@ -130,6 +130,43 @@ int at_cmd_write(const char *const cmd,
 		 size_t buf_len,
 		 enum at_cmd_state *state);
 
+/**
+ * @brief AT command in a batch, see at_cmd_write_batch().
+ */
+struct at_cmd_batch_item {
+	/** Pointer to null terminated AT command string. */
+	const char *cmd;
+	/** Buffer to put the response in, NULL pointer is allowed. */
+	char *buf;
+	/** Length of the response buffer. */
+	size_t buf_len;
+	/** State of the command, set when the batch completes. */
+	enum at_cmd_state state;
+	/** Return code of the command, set when the batch completes. */
+	int code;
+};
+
+/**
+ * @brief Function to send a batch of AT commands and receive all responses
+ *
+ * The commands are queued in the given order, and the function returns when
+ * the modem has responded to all of them. With
+ * CONFIG_AT_CMD_PIPELINE_DEPTH larger than 1, the commands are written
+ * without waiting for the previous responses, which saves a modem round trip
+ * per command compared to calling at_cmd_write() for each of them.
+ *
+ * The response, state and return code of each command are stored in its
+ * batch item, as they would be returned by at_cmd_write().
+ *
+ * @param items Array of commands.
+ * @param count Number of commands in @p items.
+ *
+ * @retval 0 If all commands were executed successfully.
+ * @retval -EINVAL is returned if @p items or one of the commands is NULL.
+ * @return Otherwise, the return code of the first command that failed.
+ */
+int at_cmd_write_batch(struct at_cmd_batch_item *items, size_t count);
+
 /**
  * @brief Function to set AT command global notification handler
  *
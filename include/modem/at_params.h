@@ -22,6 +22,11 @@
  * All parameters values are copied in the list. Parameters should be
  * cleared to free that memory. Getter and setter methods are available
  * to read and write parameter values.
+ *
+ * A list can also be backed by memory provided by the user, see
+ * @ref AT_PARAMS_LIST_DEFINE and at_params_list_init_arena(). Such a list
+ * does not use the heap. The values are stored in an arena, which is
+ * emptied when the list is cleared.
  */
 #ifndef AT_PARAMS_H__
 #define AT_PARAMS_H__
@@ -65,6 +70,13 @@ struct at_param {
 	union at_param_value value;
 };
 
+/** @brief Memory holding the parameter values of a list. */
+struct at_params_arena {
+	u8_t *buf;
+	size_t size;
+	size_t used;
+};
+
 /**
  * @brief List of AT parameters that compose an AT command or response.
  *
@@ -74,8 +86,48 @@ struct at_param {
 struct at_param_list {
 	size_t param_count;
 	struct at_param *params;
+	/** Arena for the values, NULL if they are allocated on the heap. */
+	struct at_params_arena *arena;
 };
 
+/**
+ * @brief Arena size sufficient to parse a string into a list.
+ *
+ * String values take at most their length, a null terminator and alignment
+ * padding. Array values take at most twice the length of their text.
+ *
+ * @param len Length of the string to parse.
+ * @param max_params_count Maximum number of parameters in the list.
+ */
+#define AT_PARAMS_ARENA_SIZE(len, max_params_count) \
+	(2 * (len) + 4 * (max_params_count))
+
+/**
+ * @brief Statically define a list of parameters backed by an arena.
+ *
+ * The list is defined as static, and it is ready to use without being
+ * initialized. Putting values into the list does not use the heap. If the
+ * arena is full, putting a string or array value fails with -ENOMEM.
+ *
+ * @param name Name of the list.
+ * @param max_params_count Maximum number of element that the list can
+ * store.
+ * @param arena_size Size of the arena holding string and array values,
+ * see @ref AT_PARAMS_ARENA_SIZE.
+ */
+#define AT_PARAMS_LIST_DEFINE(name, max_params_count, arena_size)	\
+	static struct at_param _at_params_##name[max_params_count];	\
+	static u32_t _at_params_buf_##name[((arena_size) + 3) / 4];	\
+	static struct at_params_arena _at_params_arena_##name = {	\
+		.buf = (u8_t *)_at_params_buf_##name,			\
+		.size = sizeof(_at_params_buf_##name),			\
+	};								\
+	static struct at_param_list name = {				\
+		.param_count = max_params_count,			\
+		.params = _at_params_##name,				\
+		.arena = &_at_params_arena_##name,			\
+	}
+
 /**
  * @brief Create a list of parameters.
  *
@@ -92,10 +144,36 @@ struct at_param_list {
  */
 int at_params_list_init(struct at_param_list *list, size_t max_params_count);
 
+/**
+ * @brief Create a list of parameters backed by an arena.
+ *
+ * The list uses the given parameter array and stores string and array
+ * values in @p buf, so that putting values into the list does not use the
+ * heap. Replacing a string or array value does not release its memory
+ * until the list is cleared. If the arena is full, putting a string or
+ * array value fails with -ENOMEM.
+ *
+ * @param[in] list Parameter list to initialize.
+ * @param[in] params Array of @p max_params_count parameters.
+ * @param[in] max_params_count Maximum number of element that the list can
+ * store.
+ * @param[in] arena Arena to initialize and use for the list.
+ * @param[in] buf Memory holding the string and array values.
+ * @param[in] buf_size Size of @p buf, see @ref AT_PARAMS_ARENA_SIZE.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int at_params_list_init_arena(struct at_param_list *list,
+			      struct at_param *params, size_t max_params_count,
+			      struct at_params_arena *arena,
+			      void *buf, size_t buf_size);
+
 /**
  * @brief Clear/reset all parameter types and values.
  *
- * All parameter types and values are reset to default values.
+ * All parameter types and values are reset to default values. The arena
+ * of a list backed by one is emptied.
  *
  * @param[in] list Parameter list to clear.
  */
@@ -105,6 +183,8 @@ void at_params_list_clear(struct at_param_list *list);
  * @brief Free a list of parameters.
  *
  * First the list is cleared. Then the list and its elements are deleted.
+ * A list backed by an arena is only cleared, as its memory is provided by
+ * the user.
  *
  * @param[in] list Parameter list to free.
  */
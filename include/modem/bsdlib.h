@@ -4,10 +4,26 @@
  * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
  */
 
+#include <zephyr/types.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/** @brief Modem trace statistics. */
+struct bsdlib_trace_stats {
+	/** Number of trace bytes dropped because the UART buffer was full. */
+	u32_t uart_dropped;
+	/** Highest number of trace bytes waiting to be sent over UART. */
+	u32_t uart_max_used;
+	/** Number of trace bytes not written to flash because the flash
+	 *  buffer was full.
+	 */
+	u32_t flash_dropped;
+	/** Number of trace bytes written to flash. */
+	u32_t flash_written;
+};
+
 /**
  * @brief Initialize bsdlib.
  *
@@ -40,6 +56,20 @@ int bsdlib_get_init_ret(void);
  */
 int bsdlib_shutdown(void);
 
+/**
+ * @brief Get modem trace statistics.
+ *
+ * Use the statistics to check whether traces were lost, and to size
+ * the trace buffers.
+ *
+ * @param[out] stats Statistics.
+ *
+ * @retval 0 If the statistics were retrieved.
+ * @retval -EINVAL If @p stats is NULL.
+ * @retval -ENOTSUP If modem traces are disabled.
+ */
+int bsdlib_trace_stats_get(struct bsdlib_trace_stats *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -34,6 +34,13 @@ enum download_client_evt_id {
 	/**
 	 * Event contains a fragment.
 	 * The application may return any non-zero value to stop the download.
+	 *
+	 * If receive buffers have been set using
+	 * @ref download_client_rx_bufs_set, the fragment points into one of
+	 * them and the buffer is handed over to the application, regardless
+	 * of the value returned from the callback. The application must give
+	 * the buffer back using @ref download_client_rx_buf_release once it
+	 * has finished processing the fragment.
 	 */
 	DOWNLOAD_CLIENT_EVT_FRAGMENT,
 	/**
@@ -60,8 +67,13 @@ enum download_client_evt_id {
 	DOWNLOAD_CLIENT_EVT_DONE,
 };
 
+/**
+ * @brief Download fragment.
+ */
 struct download_fragment {
+	/** Fragment data. */
 	const void *buf;
+	/** Fragment length, in bytes. */
 	size_t len;
 };
 
@@ -97,6 +109,10 @@ struct download_client_cfg {
 	 *  or NULL to use the default APN.
 	 */
 	const char *apn;
+	/** Number of range requests sent ahead on the connection.
+	 *  Pass zero to use default, or non-zero to override.
+	 */
+	u8_t pipeline_depth;
 };
 
 /**
@@ -126,8 +142,39 @@ struct download_client {
 	/** Buffer offset. */
 	size_t offset;
 
+	/** Receive buffers supplied by the application,
+	 *  or NULL to receive into @c buf.
+	 */
+	char *rx_bufs;
+	/** Number of receive buffers. */
+	size_t rx_buf_cnt;
+	/** Size of each receive buffer, in bytes. */
+	size_t rx_buf_size;
+	/** Bitmask of receive buffers not owned by the application. */
+	atomic_t rx_buf_free;
+	/** Semaphore counting receive buffers not owned by the application. */
+	struct k_sem rx_buf_sem;
+	/** Index of the receive buffer to try first. */
+	size_t rx_buf_next;
+	/** Buffer the response is being received into. */
+	char *rx;
+	/** Size of the buffer the response is being received into. */
+	size_t rx_size;
+	/** Offset of the payload in the buffer. */
+	size_t body;
+	/** Offset of the end of the range of the response being received. */
+	size_t range_end;
+	/** Offset of the first byte not requested yet. */
+	size_t requested;
+	/** Number of requests sent and not fully answered yet. */
+	size_t pending;
+
 	/** Size of the file being downloaded, in bytes. */
 	size_t file_size;
+	/** Entity tag of the file being downloaded, null-terminated.
+	 *  Empty if the server did not send it.
+	 */
+	char etag[CONFIG_DOWNLOAD_CLIENT_ETAG_SIZE];
 	/** Download progress, number of bytes downloaded. */
 	size_t progress;
 	/** Fragment size being used for this download. */
@@ -190,6 +237,11 @@ int download_client_connect(struct download_client *client, const char *host,
  * which are delivered to the application
  * via @ref DOWNLOAD_CLIENT_EVT_FRAGMENT events.
  *
+ * Once the size of the file is known, up to
+ * @ref download_client_cfg.pipeline_depth range requests are sent ahead on
+ * the connection, so that the server does not wait for a request
+ * after each fragment.
+ *
  * @param[in] client	Client instance.
  * @param[in] file	File to download, null-terminated.
  * @param[in] from	Offset from where to resume the download,
@@ -200,6 +252,46 @@ int download_client_connect(struct download_client *client, const char *host,
 int download_client_start(struct download_client *client, const char *file,
 			  size_t from);
 
+/**
+ * @brief Receive the download into buffers supplied by the application.
+ *
+ * The buffers are used in turn to receive the HTTP responses. The payload is
+ * not copied, a @ref DOWNLOAD_CLIENT_EVT_FRAGMENT event points directly into
+ * the buffer the payload was received into. Ownership of the buffer passes to
+ * the application with the event, and the application must give it back using
+ * @ref download_client_rx_buf_release. This lets the application process
+ * the fragment, for example write it to flash, in another thread while
+ * the next fragment is received. The download waits when the application
+ * owns all of the buffers.
+ *
+ * This function must be called before @ref download_client_start, when
+ * the application does not own any of the previous buffers.
+ *
+ * @param[in] client	Client instance.
+ * @param[in] bufs	Array of @p buf_cnt buffers of @p buf_size bytes each,
+ *			or NULL to receive into the internal buffer.
+ * @param[in] buf_cnt	Number of buffers, at most @c ATOMIC_BITS.
+ * @param[in] buf_size	Size of each buffer, in bytes. It must not be smaller
+ *			than @c CONFIG_DOWNLOAD_CLIENT_MAX_RESPONSE_SIZE.
+ *
+ * @retval int Zero on success, a negative error code otherwise.
+ */
+int download_client_rx_bufs_set(struct download_client *client, void *bufs,
+				size_t buf_cnt, size_t buf_size);
+
+/**
+ * @brief Give back a receive buffer handed over with a fragment.
+ *
+ * This function can be called from any thread or from an interrupt.
+ *
+ * @param[in] client	Client instance.
+ * @param[in] buf	Fragment data pointer, as received in the event.
+ *
+ * @retval int Zero on success, a negative error code otherwise.
+ */
+int download_client_rx_buf_release(struct download_client *client,
+				   const void *buf);
+
 /**
  * @brief Pause the download.
  *
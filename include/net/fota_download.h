@@ -60,6 +60,10 @@ struct fota_download_evt {
 typedef void (*fota_download_callback_t)(const struct fota_download_evt *evt);
 
 /**@brief Initialize the firmware over-the-air download library.
+ *
+ * If @c CONFIG_FOTA_DOWNLOAD_CHECKPOINT is set and a download was interrupted
+ * by a reset, the download is resumed after
+ * @c CONFIG_FOTA_DOWNLOAD_RESUME_DELAY seconds.
  *
  * @param client_callback Callback for the generated events.
  *
@@ -73,6 +77,9 @@ int fota_download_init(fota_download_callback_t client_callback);
  * When the download is complete, the secondary slot of MCUboot is tagged as having
  * valid firmware inside it. The completion is reported through an event.
  *
+ * If @c CONFIG_FOTA_DOWNLOAD_CHECKPOINT is set and an interrupted download
+ * of the same file from the same host is stored, the download is resumed.
+ *
  * @param host Hostname which you should start downloading from.
  * @param file Filepath to the file you wish to download.
  * @param sec_tag Security tag you want to use with HTTPS set to -1 to Disable.
@@ -86,6 +93,22 @@ int fota_download_init(fota_download_callback_t client_callback);
 int fota_download_start(const char *host, const char *file, int sec_tag,
 			u16_t port, const char *apn);
 
+/**@brief Get the SHA-256 hash of the downloaded file.
+ *
+ * The hash is calculated while the file is downloaded, and it is available
+ * after the @ref FOTA_DOWNLOAD_EVT_FINISHED event.
+ * Requires @c CONFIG_FOTA_DOWNLOAD_CHECKPOINT.
+ *
+ * @param hash Buffer of 32 bytes for the hash.
+ *
+ * @retval 0	   If the hash was copied to the buffer.
+ * @retval -ENODATA If the hash is not available, for example because
+ *                 the download was continued from the progress stored by
+ *                 the DFU target without a matching checkpoint.
+ *                 Otherwise, a negative value is returned.
+ */
+int fota_download_sha256_get(u8_t *hash);
+
 #ifdef __cplusplus
 }
 #endif
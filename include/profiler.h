@@ -15,8 +15,10 @@
  */
 
 
+#include <errno.h>
 #include <zephyr/types.h>
 #include <sys/util.h>
+#include <sys/atomic.h>
 #include <sys/__assert.h>
 
 #ifndef CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS
@@ -24,14 +26,15 @@
 #define CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS 0
 #endif
 
-/** @brief Set of flags for enabling/disabling profiling for given event types.
+/** @brief Bitmap of flags for enabling/disabling profiling for given event
+ * types.
  */
-extern u32_t profiler_enabled_events;
+extern atomic_t profiler_enabled_events[];
 
 
 /** @brief Number of event types registered in the Profiler.
  */
-extern u8_t profiler_num_events;
+extern u16_t profiler_num_events;
 
 
 /** @brief Data types for profiling.
@@ -104,7 +107,8 @@ static inline bool is_profiling_enabled(size_t profiler_event_id)
 {
 	if (IS_ENABLED(CONFIG_PROFILER)) {
 		__ASSERT_NO_MSG(profiler_event_id < CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS);
-		return (profiler_enabled_events & BIT(profiler_event_id)) != 0;
+		return atomic_test_bit(profiler_enabled_events,
+				       profiler_event_id);
 	}
 	return false;
 }
@@ -196,6 +200,37 @@ static inline void profiler_log_send(struct log_event_buf *buf,
 #endif
 
 
+/** @brief Ring buffer statistics.
+ */
+struct profiler_ring_stats {
+	/** Size of the ring buffer in bytes. */
+	u32_t size;
+	/** Highest number of bytes used in the ring buffer. */
+	u32_t max_used;
+	/** Number of events sent to the host. */
+	u32_t sent_events;
+	/** Number of events dropped because the ring buffer was full. */
+	u32_t dropped_events;
+};
+
+
+/** @brief Get statistics of the ring buffer.
+ * Statistics are available if CONFIG_PROFILER_NORDIC_RING_BUFFER is enabled.
+ * @param stats Pointer to the statistics.
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL If the pointer is invalid.
+ * @retval -ENOTSUP If the ring buffer is disabled.
+ */
+#ifdef CONFIG_PROFILER_NORDIC_RING_BUFFER
+int profiler_ring_stats_get(struct profiler_ring_stats *stats);
+#else
+static inline int profiler_ring_stats_get(struct profiler_ring_stats *stats)
+{
+	return -ENOTSUP;
+}
+#endif
+
+
 /**
  * @}
  */
@@ -35,6 +35,9 @@ struct cmd_item  {
 	at_cmd_handler_t callback;	/* Callback to execute on result */
 	size_t resp_size;		/* Size of response buffer */
 	enum at_cmd_flags flags;	/* Flags describing the request */
+	int *code;			/* Return code of a sync command */
+	enum at_cmd_state *state;	/* State of a sync command */
+	struct k_sem *done;		/* Given when a sync command is done */
 };
 
 /* Metadata for an AT response */
@@ -51,17 +54,18 @@ static k_tid_t socket_tid;
 static struct k_thread socket_thread;
 static at_cmd_handler_t notification_handler;
 
-/* Structure holding current command. current_cmd.cmd=NULL signifies no cmd. */
-static struct cmd_item current_cmd;
-K_MUTEX_DEFINE(current_cmd_mutex);
+/* Commands written to the socket, awaiting a response. The modem responds
+ * to the commands in the order they are written, so the oldest command is
+ * the one receiving the next response.
+ */
+static struct cmd_item pending_cmds[CONFIG_AT_CMD_PIPELINE_DEPTH];
+static size_t pending_head;
+static size_t pending_count;
+K_MUTEX_DEFINE(pending_cmds_mutex);
 
 /* Queue for queued command metadata */
 K_MSGQ_DEFINE(commands, sizeof(struct cmd_item), CONFIG_AT_CMD_QUEUE_LEN, 4);
 
-/* Message queue to return the result in the case of a synchronous call */
-K_MSGQ_DEFINE(response_sync, sizeof(struct resp_item), 1, 4);
-K_MUTEX_DEFINE(response_sync_get);
-
 static int open_socket(void)
 {
 	common_socket_fd = socket(AF_LTE, SOCK_DGRAM, NPROTO_AT);
@@ -142,52 +146,77 @@ static inline int at_write(const char *const cmd)
 	return 0;
 }
 
-/* Clear the current command safely */
-static void complete_cmd(void)
+/* Report the result of a command to a synchronous caller */
+static void complete_cmd(const struct cmd_item *cmd,
+			 const struct resp_item *resp)
 {
-	k_mutex_lock(&current_cmd_mutex, K_FOREVER);
-	current_cmd.cmd = NULL;
-	k_mutex_unlock(&current_cmd_mutex);
+	if (!(cmd->flags & AT_CMD_SYNC)) {
+		return;
+	}
+
+	*cmd->code = resp->code;
+	*cmd->state = resp->state;
+	k_sem_give(cmd->done);
+}
+
+/* Take the oldest command awaiting a response, returns false if none */
+static bool pending_cmd_get(struct cmd_item *cmd)
+{
+	bool found = false;
+
+	k_mutex_lock(&pending_cmds_mutex, K_FOREVER);
+	if (pending_count > 0) {
+		*cmd = pending_cmds[pending_head];
+		pending_head = (pending_head + 1) % ARRAY_SIZE(pending_cmds);
+		pending_count--;
+		found = true;
+	}
+	k_mutex_unlock(&pending_cmds_mutex);
+
+	return found;
 }
 
 /*
- * Atomically load a new command if appropriate, then write it to the socket.
- * The operations are repeated until the queue is empty or a command is pending
- * a response. This function is called both from the socket thread and calling
- * context.
+ * Atomically load new commands if appropriate, then write them to the socket.
+ * The operations are repeated until the queue is empty or as many commands as
+ * the pipeline allows are pending a response. This function is called both
+ * from the socket thread and calling context.
  */
 static void load_cmd_and_write(void)
 {
 	int ret;
+	struct cmd_item *cmd;
 	struct resp_item resp;
 
-	k_mutex_lock(&current_cmd_mutex, K_FOREVER);
-	do {
-		ret = 0;
+	k_mutex_lock(&pending_cmds_mutex, K_FOREVER);
+	while (pending_count < ARRAY_SIZE(pending_cmds)) {
+		cmd = &pending_cmds[(pending_head + pending_count) %
+				    ARRAY_SIZE(pending_cmds)];
 
-		/* Do not load a new command if already loaded or none queued */
-		if (current_cmd.cmd != NULL ||
-		    k_msgq_get(&commands, &current_cmd, K_NO_WAIT) != 0) {
+		if (k_msgq_get(&commands, cmd, K_NO_WAIT) != 0) {
 			break;
 		}
 
-		ret = at_write(current_cmd.cmd);
+		/* The response cannot be handled before the mutex is released,
+		 * so the command can be marked as pending before writing it.
+		 */
+		pending_count++;
 
-		if (current_cmd.flags & AT_CMD_BUF_CMD) {
-			k_free(current_cmd.cmd);
+		ret = at_write(cmd->cmd);
+
+		if (cmd->flags & AT_CMD_BUF_CMD) {
+			k_free(cmd->cmd);
 		}
 
 		/* If write failed, make an error response and complete cmd */
 		if (ret != 0) {
+			pending_count--;
 			resp.state = AT_CMD_ERROR_WRITE;
 			resp.code = ret;
-			if (current_cmd.flags & AT_CMD_SYNC) {
-				k_msgq_put(&response_sync, &resp, K_FOREVER);
-			}
-			complete_cmd();
+			complete_cmd(cmd, &resp);
 		}
-	} while (ret != 0);
-	k_mutex_unlock(&current_cmd_mutex);
+	}
+	k_mutex_unlock(&pending_cmds_mutex);
 }
 
 static void socket_thread_fn(void *arg1, void *arg2, void *arg3)
@@ -195,6 +224,7 @@ static void socket_thread_fn(void *arg1, void *arg2, void *arg3)
 	static int bytes_read;
 	static size_t payload_len;
 	static struct resp_item ret;
+	static struct cmd_item cmd;
 	static char buf[CONFIG_AT_CMD_RESPONSE_MAX_LEN];
 
 	ARG_UNUSED(arg1);
@@ -224,7 +254,14 @@ static void socket_thread_fn(void *arg1, void *arg2, void *arg3)
 				LOG_INF("AT socket recovered");
 				ret.state = AT_CMD_ERROR_READ;
 				ret.code  = -errno;
-				goto next;
+
+				/* Responses to the commands written to the
+				 * old socket are lost.
+				 */
+				while (pending_cmd_get(&cmd)) {
+					complete_cmd(&cmd, &ret);
+				}
+				continue;
 			}
 
 			LOG_ERR("Unrecoverable reception error (err: %d), "
@@ -235,52 +272,55 @@ static void socket_thread_fn(void *arg1, void *arg2, void *arg3)
 			LOG_ERR("AT message empty");
 			ret.state = AT_CMD_ERROR_READ;
 			ret.code  = -EBADMSG;
-			goto next;
 		} else if (buf[bytes_read - 1] != '\0') {
 			LOG_ERR("AT message too large for reception buffer or "
 				"missing termination character");
 			ret.state = AT_CMD_ERROR_READ;
 			ret.code  = -ENOBUFS;
-			goto next;
+		} else {
+			LOG_DBG("at_cmd_rx %d bytes, %s", bytes_read,
+				log_strdup(buf));
+
+			payload_len = get_return_code(buf, &ret);
 		}
 
-		LOG_DBG("at_cmd_rx %d bytes, %s", bytes_read, log_strdup(buf));
+		/* Notifications are not related to any command */
+		if (ret.state == AT_CMD_NOTIFICATION) {
+			if (notification_handler != NULL) {
+				notification_handler(buf);
+			}
+			continue;
+		}
 
-		payload_len = get_return_code(buf, &ret);
+		/* We have now handled the oldest pending command */
+		if (!pending_cmd_get(&cmd)) {
+			LOG_WRN("Response without a pending command");
+			continue;
+		}
+
+		if (ret.state == AT_CMD_ERROR_READ) {
+			goto next;
+		}
 
 		/* Verify the buffer size if provided, and copy the message */
-		if (current_cmd.cmd != NULL &&
-		    current_cmd.resp != NULL &&
-		    ret.state != AT_CMD_NOTIFICATION) {
-			if (current_cmd.resp_size < payload_len) {
+		if (cmd.resp != NULL) {
+			if (cmd.resp_size < payload_len) {
 				LOG_ERR("Response buffer not large enough");
 				ret.code  = -EMSGSIZE;
 				goto next;
 			}
-			memcpy(current_cmd.resp, buf, payload_len);
+			memcpy(cmd.resp, buf, payload_len);
 		}
 
 		/* Call the relevant callback, if any */
-		if (ret.state == AT_CMD_NOTIFICATION &&
-		    notification_handler != NULL) {
-			notification_handler(buf);
-		} else if (current_cmd.callback != NULL) {
-			current_cmd.callback(buf);
+		if (cmd.callback != NULL) {
+			cmd.callback(buf);
 		}
 
 next:
 		/* Dispatch response for sync call */
-		if (current_cmd.cmd != NULL &&
-		    current_cmd.flags & AT_CMD_SYNC &&
-		    ret.state != AT_CMD_NOTIFICATION) {
-			LOG_DBG("Enqueueing response for sync call");
-			k_msgq_put(&response_sync, &ret, K_FOREVER);
-		}
-
-		/* We have now handled a command if it was not a notification */
-		if (ret.state != AT_CMD_NOTIFICATION) {
-			complete_cmd();
-		}
+		LOG_DBG("Completing command");
+		complete_cmd(&cmd, &ret);
 	}
 }
 
@@ -319,7 +359,9 @@ int at_cmd_write(const char *const cmd,
 		 enum at_cmd_state *state)
 {
 	struct cmd_item command;
-	struct resp_item ret;
+	struct k_sem done;
+	enum at_cmd_state ret_state;
+	int ret;
 
 	__ASSERT(k_current_get() != socket_tid,
 		 "at_cmd deadlock: socket thread blocking self\n");
@@ -330,35 +372,102 @@ int at_cmd_write(const char *const cmd,
 		return -EINVAL;
 	}
 
+	k_sem_init(&done, 0, 1);
+
 	/* This cast is safe; we do not free cmd without AT_CMD_BUF_CMD */
 	command.cmd = (char *)cmd;
 	command.resp = buf;
 	command.resp_size = buf_len;
 	command.callback = NULL;
 	command.flags = AT_CMD_SYNC;
+	command.code = &ret;
+	command.state = &ret_state;
+	command.done = &done;
 
-	/* Ensure we get our own AT response, not an old one */
-	k_mutex_lock(&response_sync_get, K_FOREVER);
-
-	/* We borrow the return code field from the currently unused response */
-	ret.code = k_msgq_put(&commands, &command, K_FOREVER);
-	if (ret.code) {
-		LOG_ERR("Could not enqueue cmd, error %d", ret.code);
+	ret = k_msgq_put(&commands, &command, K_FOREVER);
+	if (ret) {
+		LOG_ERR("Could not enqueue cmd, error %d", ret);
 		*state = AT_CMD_ERROR_QUEUE;
-		return ret.code;
+		return ret;
 	}
 
 	load_cmd_and_write();
 
 	LOG_DBG("Awaiting response for %s", log_strdup(cmd));
-	k_msgq_get(&response_sync, &ret, K_FOREVER);
-	k_mutex_unlock(&response_sync_get);
+	k_sem_take(&done, K_FOREVER);
 
 	if (state) {
-		*state = ret.state;
+		*state = ret_state;
+	}
+
+	return ret;
+}
+
+int at_cmd_write_batch(struct at_cmd_batch_item *items, size_t count)
+{
+	struct cmd_item command;
+	struct k_sem done;
+	size_t queued;
+	int ret = 0;
+
+	__ASSERT(k_current_get() != socket_tid,
+		 "at_cmd deadlock: socket thread blocking self\n");
+
+	if ((items == NULL) || (count == 0)) {
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		if (items[i].cmd == NULL) {
+			LOG_ERR("cmd %zu is NULL", i);
+			return -EINVAL;
+		}
+	}
+
+	k_sem_init(&done, 0, count);
+
+	for (queued = 0; queued < count; queued++) {
+		struct at_cmd_batch_item *item = &items[queued];
+
+		/* This cast is safe; we do not free cmd without
+		 * AT_CMD_BUF_CMD
+		 */
+		command.cmd = (char *)item->cmd;
+		command.resp = item->buf;
+		command.resp_size = item->buf_len;
+		command.callback = NULL;
+		command.flags = AT_CMD_SYNC;
+		command.code = &item->code;
+		command.state = &item->state;
+		command.done = &done;
+
+		/* The queue is emptied by the socket thread if the batch
+		 * does not fit into it.
+		 */
+		ret = k_msgq_put(&commands, &command, K_FOREVER);
+		if (ret) {
+			LOG_ERR("Could not enqueue cmd, error %d", ret);
+			break;
+		}
+
+		load_cmd_and_write();
+	}
+
+	LOG_DBG("Awaiting responses for %zu commands", queued);
+	for (size_t i = 0; i < queued; i++) {
+		k_sem_take(&done, K_FOREVER);
+	}
+
+	for (size_t i = queued; i < count; i++) {
+		items[i].state = AT_CMD_ERROR_QUEUE;
+		items[i].code = ret;
+	}
+
+	for (size_t i = 0; (i < count) && (ret == 0); i++) {
+		ret = items[i].code;
 	}
 
-	return ret.code;
+	return ret;
 }
 
 void at_cmd_set_notification_handler(at_cmd_handler_t handler)
@@ -23,19 +23,48 @@ static void at_param_init(struct at_param *param)
 	memset(param, 0, sizeof(struct at_param));
 }
 
-/* Internal function. Parameter cannot be null. */
-static void at_param_clear(struct at_param *param)
+/* Internal function. Parameters cannot be null. */
+static void at_param_clear(const struct at_param_list *list,
+			   struct at_param *param)
 {
+	__ASSERT(list != NULL, "Parameter list cannot be NULL.");
 	__ASSERT(param != NULL, "Parameter cannot be NULL.");
 
-	if ((param->type == AT_PARAM_TYPE_STRING) ||
-	    (param->type == AT_PARAM_TYPE_ARRAY)) {
+	/* Values stored in an arena are released when the list is cleared. */
+	if ((list->arena == NULL) &&
+	    ((param->type == AT_PARAM_TYPE_STRING) ||
+	     (param->type == AT_PARAM_TYPE_ARRAY))) {
 		k_free(param->value.str_val);
 	}
 
 	param->value.int_val = 0;
 }
 
+/* Internal function. Parameter cannot be null. */
+static void *at_param_value_alloc(const struct at_param_list *list,
+				  size_t size)
+{
+	__ASSERT(list != NULL, "Parameter list cannot be NULL.");
+
+	struct at_params_arena *arena = list->arena;
+
+	if (arena == NULL) {
+		return k_malloc(size);
+	}
+
+	/* Keep the values aligned, array values are accessed as u32_t. */
+	uintptr_t start = ROUND_UP((uintptr_t)arena->buf + arena->used,
+				   sizeof(u32_t));
+	size_t used = start - (uintptr_t)arena->buf + size;
+
+	if (used > arena->size) {
+		return NULL;
+	}
+
+	arena->used = used;
+	return (void *)start;
+}
+
 /* Internal function. Parameter cannot be null. */
 static struct at_param *at_params_get(const struct at_param_list *list,
 				      size_t index)
@@ -81,6 +110,30 @@ int at_params_list_init(struct at_param_list *list, size_t max_params_count)
 	}
 
 	list->param_count = max_params_count;
+	list->arena = NULL;
+	return 0;
+}
+
+int at_params_list_init_arena(struct at_param_list *list,
+			      struct at_param *params, size_t max_params_count,
+			      struct at_params_arena *arena,
+			      void *buf, size_t buf_size)
+{
+	if (list == NULL || params == NULL || arena == NULL ||
+	    (buf == NULL && buf_size != 0)) {
+		return -EINVAL;
+	}
+
+	arena->buf = buf;
+	arena->size = buf_size;
+	arena->used = 0;
+
+	/* Array initialized with empty parameters. */
+	memset(params, 0, max_params_count * sizeof(struct at_param));
+
+	list->param_count = max_params_count;
+	list->params = params;
+	list->arena = arena;
 	return 0;
 }
 
@@ -93,9 +146,13 @@ void at_params_list_clear(struct at_param_list *list)
 	for (size_t i = 0; i < list->param_count; ++i) {
 		struct at_param *params = list->params;
 
-		at_param_clear(&params[i]);
+		at_param_clear(list, &params[i]);
 		at_param_init(&params[i]);
 	}
+
+	if (list->arena != NULL) {
+		list->arena->used = 0;
+	}
 }
 
 void at_params_list_free(struct at_param_list *list)
@@ -106,6 +163,11 @@ void at_params_list_free(struct at_param_list *list)
 
 	at_params_list_clear(list);
 
+	if (list->arena != NULL) {
+		/* The memory of the list is owned by the user. */
+		return;
+	}
+
 	list->param_count = 0;
 	k_free(list->params);
 	list->params = NULL;
@@ -124,7 +186,7 @@ int at_params_short_put(const struct at_param_list *list, size_t index,
 		return -EINVAL;
 	}
 
-	at_param_clear(param);
+	at_param_clear(list, param);
 
 	param->type = AT_PARAM_TYPE_NUM_SHORT;
 	param->value.int_val = (u32_t)(value & USHRT_MAX);
@@ -143,7 +205,7 @@ int at_params_empty_put(const struct at_param_list *list, size_t index)
 		return -EINVAL;
 	}
 
-	at_param_clear(param);
+	at_param_clear(list, param);
 
 	param->type = AT_PARAM_TYPE_EMPTY;
 	param->value.int_val = 0;
@@ -164,7 +226,7 @@ int at_params_int_put(const struct at_param_list *list, size_t index,
 		return -EINVAL;
 	}
 
-	at_param_clear(param);
+	at_param_clear(list, param);
 
 	param->type = AT_PARAM_TYPE_NUM_INT;
 	param->value.int_val = value;
@@ -184,15 +246,16 @@ int at_params_string_put(const struct at_param_list *list, size_t index,
 		return -EINVAL;
 	}
 
-	char *param_value = (char *)k_malloc(str_len + 1);
+	char *param_value = (char *)at_param_value_alloc(list, str_len + 1);
 
 	if (param_value == NULL) {
 		return -ENOMEM;
 	}
 
 	memcpy(param_value, str, str_len);
+	param_value[str_len] = '\0';
 
-	at_param_clear(param);
+	at_param_clear(list, param);
 	param->size = str_len;
 	param->type = AT_PARAM_TYPE_STRING;
 	param->value.str_val = param_value;
@@ -213,7 +276,7 @@ int at_params_array_put(const struct at_param_list *list, size_t index,
 		return -EINVAL;
 	}
 
-	u32_t *param_value = (u32_t *)k_malloc(array_len);
+	u32_t *param_value = (u32_t *)at_param_value_alloc(list, array_len);
 
 	if (param_value == NULL) {
 		return -ENOMEM;
@@ -221,7 +284,7 @@ int at_params_array_put(const struct at_param_list *list, size_t index,
 
 	memcpy(param_value, array, array_len);
 
-	at_param_clear(param);
+	at_param_clear(list, param);
 	param->size = array_len;
 	param->type = AT_PARAM_TYPE_ARRAY;
 	param->value.array_val = param_value;
@@ -17,10 +17,17 @@
 #include <errno.h>
 #include <logging/log.h>
 
+#include <modem/bsdlib.h>
+
 #ifdef CONFIG_BSD_LIBRARY_TRACE_ENABLED
 #include <nrfx_uarte.h>
 #endif
 
+#ifdef CONFIG_BSD_LIBRARY_TRACE_FLASH
+#include <pm_config.h>
+#include <storage/flash_map.h>
+#endif
+
 #ifndef ENOKEY
 #define ENOKEY 2001
 #endif
@@ -46,6 +53,71 @@
 #ifdef CONFIG_BSD_LIBRARY_TRACE_ENABLED
 /* Use UARTE1 as a dedicated peripheral to print traces. */
 static const nrfx_uarte_t uarte_inst = NRFX_UARTE_INSTANCE(1);
+
+#define TRACE_UARTE_IRQ UARTE1_SPIM1_SPIS1_TWIM1_TWIS1_IRQn
+#define TRACE_UARTE_IRQ_PRIORITY NRFX_UARTE_DEFAULT_CONFIG_IRQ_PRIORITY
+/* Max length of a single EasyDMA transfer. */
+#define TRACE_UARTE_MAX_LEN ((1 << UARTE1_EASYDMA_MAXCNT_SIZE) - 1)
+
+BUILD_ASSERT((CONFIG_BSD_LIBRARY_TRACE_BUFFER_SIZE &
+	      (CONFIG_BSD_LIBRARY_TRACE_BUFFER_SIZE - 1)) == 0,
+	     "Trace buffer size must be a power of two.");
+
+/* Single producer, single consumer byte ring buffer.
+ * Traces are put by the modem trace IRQ and taken by a sink.
+ * The indexes run freely and are masked on access.
+ */
+struct trace_ring {
+	u8_t *buf;
+	u32_t size;
+	u32_t head; /* Write index. */
+	u32_t tail; /* Read index. */
+	u32_t dropped; /* Number of bytes that did not fit. */
+	u32_t max_used; /* Highest number of bytes waiting. */
+};
+
+static u8_t uart_buf[CONFIG_BSD_LIBRARY_TRACE_BUFFER_SIZE];
+static struct trace_ring uart_ring = {
+	.buf = uart_buf,
+	.size = sizeof(uart_buf),
+};
+
+/* Length of the ongoing UARTE transfer, zero if UARTE is idle. */
+static u32_t uart_tx_len;
+#endif
+
+#ifdef CONFIG_BSD_LIBRARY_TRACE_FLASH
+#define TRACE_FLASH_PAGE_SIZE 0x1000
+#define TRACE_FLASH_PAGE_COUNT (PM_MODEM_TRACE_SIZE / TRACE_FLASH_PAGE_SIZE)
+/* Flash is written in whole words. */
+#define TRACE_FLASH_WRITE_ALIGN 4
+#define TRACE_FLASH_MAGIC 0x4d545243
+#define TRACE_FLASH_STACK_SIZE 1024
+
+BUILD_ASSERT((PM_MODEM_TRACE_SIZE % TRACE_FLASH_PAGE_SIZE) == 0,
+	     "Trace partition size must be a multiple of the page size.");
+BUILD_ASSERT((CONFIG_BSD_LIBRARY_TRACE_FLASH_BUFFER_SIZE &
+	      (CONFIG_BSD_LIBRARY_TRACE_FLASH_BUFFER_SIZE - 1)) == 0,
+	     "Trace flash buffer size must be a power of two.");
+
+/* Header at the start of each flash page. */
+struct trace_flash_hdr {
+	u32_t magic;
+	u32_t seq; /* Incremented for each page written. */
+};
+
+static u8_t flash_buf[CONFIG_BSD_LIBRARY_TRACE_FLASH_BUFFER_SIZE];
+static struct trace_ring flash_ring = {
+	.buf = flash_buf,
+	.size = sizeof(flash_buf),
+};
+
+static const struct flash_area *flash_fa;
+static bool flash_ready;
+static u32_t flash_off; /* Offset of the next write in the partition. */
+static u32_t flash_seq; /* Sequence number of the current page. */
+static u32_t flash_written;
+static K_SEM_DEFINE(flash_sem, 0, 1);
 #endif
 
 void IPC_IRQHandler(void);
@@ -55,10 +127,17 @@ void IPC_IRQHandler(void);
 LOG_MODULE_REGISTER(bsdlib);
 
 struct sleeping_thread {
-	sys_snode_t node;
+	sys_dnode_t node;
 	struct k_sem sem;
 };
 
+#ifdef CONFIG_BSD_LIBRARY_THREAD_MONITOR_CUSTOM_DATA
+/* The RPC counter value at which bsdlib last checked the 'readiness' of a
+ * thread is kept in the thread custom data. Bit 0 is always set, to tell a
+ * stored value from the initial NULL of a thread which never waited.
+ */
+#define THREAD_MONITOR_CNT(cnt) ((void *)(((uintptr_t)(cnt) << 1) | 1))
+#else
 /* An array of thread ID and RPC counter pairs, used to avoid race conditions.
  * It allows to identify whether it is safe to put the thread to sleep or not.
  */
@@ -66,13 +145,15 @@ static struct thread_monitor_entry {
 	k_tid_t id; /* Thread ID. */
 	int cnt; /* Last RPC event count. */
 } thread_event_monitor[THREAD_MONITOR_ENTRIES];
+#endif
 
 /* A list of threads that are sleeping and should be woken up on next event. */
-static sys_slist_t sleeping_threads;
+static sys_dlist_t sleeping_threads;
 
 /* RPC event counter, incremented on each RPC event. */
 static atomic_t rpc_event_cnt;
 
+#ifndef CONFIG_BSD_LIBRARY_THREAD_MONITOR_CUSTOM_DATA
 /* Get thread monitor structure assigned to a specific thread id, with a RPC
  * counter value at which bsdlib last checked the 'readiness' of a thread
  */
@@ -104,32 +185,46 @@ static struct thread_monitor_entry *thread_monitor_entry_get(k_tid_t id)
 
 	return new_entry;
 }
+#endif
 
-/* Update thread monitor entry RPC counter. */
-static void thread_monitor_entry_update(struct thread_monitor_entry *entry)
+/* Update the RPC counter value of the current thread. Will return information
+ * whether an RPC event occurred since the previous update. Must be called with
+ * interrupts locked.
+ */
+static bool thread_monitor_update(void)
 {
+#ifdef CONFIG_BSD_LIBRARY_THREAD_MONITOR_CUSTOM_DATA
+	void *cnt = THREAD_MONITOR_CNT(atomic_get(&rpc_event_cnt));
+	void *last_cnt = k_thread_custom_data_get();
+
+	k_thread_custom_data_set(cnt);
+
+	return cnt != last_cnt;
+#else
+	struct thread_monitor_entry *entry;
+	bool event_occurred;
+
+	entry = thread_monitor_entry_get(k_current_get());
+	event_occurred = (rpc_event_cnt != entry->cnt);
 	entry->cnt = rpc_event_cnt;
+
+	return event_occurred;
+#endif
 }
 
 /* Verify that thread can be put into sleep (no RPC event occured in a
  * meantime), or whether we should return to bsdlib to re-verify if a sleep is
  * needed.
  */
-static bool can_thread_sleep(struct thread_monitor_entry *entry)
+static bool can_thread_sleep(void)
 {
-	bool allow_to_sleep = true;
-
-	if (rpc_event_cnt != entry->cnt) {
-		thread_monitor_entry_update(entry);
-		allow_to_sleep = false;
-	}
-
-	return allow_to_sleep;
+	return !thread_monitor_update();
 }
 
 /* Initialize sleeping thread structure. */
 static void sleeping_thread_init(struct sleeping_thread *thread)
 {
+	sys_dnode_init(&thread->node);
 	k_sem_init(&thread->sem, 0, 1);
 }
 
@@ -139,15 +234,12 @@ static void sleeping_thread_init(struct sleeping_thread *thread)
 static bool sleeping_thread_add(struct sleeping_thread *thread)
 {
 	bool allow_to_sleep = false;
-	struct thread_monitor_entry *entry;
 
 	u32_t key = irq_lock();
 
-	entry = thread_monitor_entry_get(k_current_get());
-
-	if (can_thread_sleep(entry)) {
+	if (can_thread_sleep()) {
 		allow_to_sleep = true;
-		sys_slist_append(&sleeping_threads, &thread->node);
+		sys_dlist_append(&sleeping_threads, &thread->node);
 	}
 
 	irq_unlock(key);
@@ -158,14 +250,11 @@ static bool sleeping_thread_add(struct sleeping_thread *thread)
 /* Remove a thread form the sleeping threads list. */
 static void sleeping_thread_remove(struct sleeping_thread *thread)
 {
-	struct thread_monitor_entry *entry;
-
 	u32_t key = irq_lock();
 
-	sys_slist_find_and_remove(&sleeping_threads, &thread->node);
+	sys_dlist_remove(&thread->node);
 
-	entry = thread_monitor_entry_get(k_current_get());
-	thread_monitor_entry_update(entry);
+	(void)thread_monitor_update();
 
 	irq_unlock(key);
 }
@@ -371,8 +460,10 @@ ISR_DIRECT_DECLARE(rpc_proxy_irq_handler)
 
 	struct sleeping_thread *thread;
 
-	/* Wake up all sleeping threads. */
-	SYS_SLIST_FOR_EACH_CONTAINER(&sleeping_threads, thread, node) {
+	/* Wake up all sleeping threads. bsdlib does not tell which wait context
+	 * the event is for, so each thread has to check for itself.
+	 */
+	SYS_DLIST_FOR_EACH_CONTAINER(&sleeping_threads, thread, node) {
 		k_sem_give(&thread->sem);
 	}
 
@@ -407,6 +498,256 @@ void read_task_create(void)
 	irq_enable(BSD_APPLICATION_IRQ);
 }
 
+#ifdef CONFIG_BSD_LIBRARY_TRACE_ENABLED
+/* Copy the data into the ring buffer. Data that does not fit as a whole is
+ * dropped, as a partial trace message cannot be decoded.
+ */
+static bool trace_ring_put(struct trace_ring *ring, const u8_t *data,
+			   u32_t len)
+{
+	u32_t key;
+	u32_t used;
+	u32_t idx;
+	u32_t chunk;
+
+	key = irq_lock();
+	used = ring->head - ring->tail;
+	irq_unlock(key);
+
+	if (len > ring->size - used) {
+		ring->dropped += len;
+		return false;
+	}
+
+	/* The consumer does not access the free space,
+	 * so it is safe to copy without locking.
+	 */
+	idx = ring->head & (ring->size - 1);
+	chunk = MIN(len, ring->size - idx);
+
+	memcpy(&ring->buf[idx], data, chunk);
+	memcpy(ring->buf, &data[chunk], len - chunk);
+
+	key = irq_lock();
+	ring->head += len;
+	used = ring->head - ring->tail;
+	irq_unlock(key);
+
+	ring->max_used = MAX(ring->max_used, used);
+
+	return true;
+}
+
+/* Get the longest contiguous block of data, up to max_len bytes. The data
+ * stays in the ring buffer until it is released.
+ */
+static u32_t trace_ring_claim(struct trace_ring *ring, u8_t **data,
+			      u32_t max_len)
+{
+	u32_t key;
+	u32_t used;
+	u32_t idx;
+
+	key = irq_lock();
+	used = ring->head - ring->tail;
+	irq_unlock(key);
+
+	idx = ring->tail & (ring->size - 1);
+	*data = &ring->buf[idx];
+
+	return MIN(MIN(used, ring->size - idx), max_len);
+}
+
+static void trace_ring_release(struct trace_ring *ring, u32_t len)
+{
+	u32_t key = irq_lock();
+
+	ring->tail += len;
+
+	irq_unlock(key);
+}
+
+/* Start a transfer of the next block of traces, unless one is ongoing.
+ * Must be called with interrupts locked.
+ */
+static void trace_uart_tx_start(void)
+{
+	u8_t *data;
+	u32_t len;
+
+	if (uart_tx_len != 0) {
+		return;
+	}
+
+	len = trace_ring_claim(&uart_ring, &data, TRACE_UARTE_MAX_LEN);
+	if (len == 0) {
+		return;
+	}
+
+	if (nrfx_uarte_tx(&uarte_inst, data, len) == NRFX_SUCCESS) {
+		uart_tx_len = len;
+	}
+}
+
+static void trace_uart_evt_handler(nrfx_uarte_event_t const *event,
+				   void *context)
+{
+	u32_t key;
+
+	if (event->type != NRFX_UARTE_EVT_TX_DONE) {
+		return;
+	}
+
+	key = irq_lock();
+
+	/* Bytes not sent, if any, are sent again in the next transfer. */
+	trace_ring_release(&uart_ring, event->data.rxtx.bytes);
+	uart_tx_len = 0;
+
+	trace_uart_tx_start();
+
+	irq_unlock(key);
+}
+#endif /* CONFIG_BSD_LIBRARY_TRACE_ENABLED */
+
+#ifdef CONFIG_BSD_LIBRARY_TRACE_FLASH
+/* Find the newest page written before reset, and continue after it. */
+static int trace_flash_open(void)
+{
+	struct trace_flash_hdr hdr;
+	u32_t newest_page = TRACE_FLASH_PAGE_COUNT - 1;
+	bool found = false;
+	int err;
+
+	err = flash_area_open(PM_MODEM_TRACE_ID, &flash_fa);
+	if (err) {
+		LOG_ERR("Can't open modem trace flash area");
+		return err;
+	}
+
+	for (u32_t page = 0; page < TRACE_FLASH_PAGE_COUNT; page++) {
+		err = flash_area_read(flash_fa, page * TRACE_FLASH_PAGE_SIZE,
+				      &hdr, sizeof(hdr));
+		if (err) {
+			LOG_ERR("Can't read modem trace flash area");
+			return err;
+		}
+
+		if (hdr.magic != TRACE_FLASH_MAGIC) {
+			continue;
+		}
+
+		/* Sequence numbers are compared by difference to handle
+		 * wrap-around.
+		 */
+		if (!found || ((s32_t)(hdr.seq - flash_seq) > 0)) {
+			flash_seq = hdr.seq;
+			newest_page = page;
+			found = true;
+		}
+	}
+
+	flash_off = ((newest_page + 1) % TRACE_FLASH_PAGE_COUNT) *
+		    TRACE_FLASH_PAGE_SIZE;
+
+	return 0;
+}
+
+/* Get the number of bytes that fit into the current page. */
+static u32_t trace_flash_room(void)
+{
+	u32_t page_off = flash_off % TRACE_FLASH_PAGE_SIZE;
+
+	if (page_off == 0) {
+		return TRACE_FLASH_PAGE_SIZE - sizeof(struct trace_flash_hdr);
+	}
+
+	return TRACE_FLASH_PAGE_SIZE - page_off;
+}
+
+/* Write a block of traces, erasing the next page if needed. */
+static int trace_flash_write(const u8_t *data, u32_t len)
+{
+	struct trace_flash_hdr hdr = {
+		.magic = TRACE_FLASH_MAGIC,
+	};
+	int err;
+
+	if (flash_off % TRACE_FLASH_PAGE_SIZE == 0) {
+		err = flash_area_erase(flash_fa, flash_off,
+				       TRACE_FLASH_PAGE_SIZE);
+		if (err) {
+			return err;
+		}
+
+		hdr.seq = ++flash_seq;
+
+		err = flash_area_write(flash_fa, flash_off, &hdr, sizeof(hdr));
+		if (err) {
+			return err;
+		}
+
+		flash_off += sizeof(hdr);
+	}
+
+	err = flash_area_write(flash_fa, flash_off, data, len);
+	if (err) {
+		return err;
+	}
+
+	flash_off += len;
+	flash_written += len;
+
+	if (flash_off == PM_MODEM_TRACE_SIZE) {
+		flash_off = 0;
+	}
+
+	return 0;
+}
+
+static void trace_flash_thread_fn(void)
+{
+	u8_t *data;
+	u32_t len;
+	int err;
+
+	if (trace_flash_open()) {
+		return;
+	}
+
+	flash_ready = true;
+
+	while (true) {
+		k_sem_take(&flash_sem, K_FOREVER);
+
+		while (true) {
+			len = trace_ring_claim(&flash_ring, &data,
+					       trace_flash_room());
+
+			/* Keep an incomplete word until more data arrives. */
+			len -= len % TRACE_FLASH_WRITE_ALIGN;
+			if (len == 0) {
+				break;
+			}
+
+			err = trace_flash_write(data, len);
+			if (err) {
+				LOG_ERR("Modem trace flash write failed, "
+					"err %d", err);
+				flash_ready = false;
+				return;
+			}
+
+			trace_ring_release(&flash_ring, len);
+		}
+	}
+}
+
+K_THREAD_DEFINE(trace_flash_thread, TRACE_FLASH_STACK_SIZE,
+		trace_flash_thread_fn, NULL, NULL, NULL,
+		K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
+#endif /* CONFIG_BSD_LIBRARY_TRACE_FLASH */
+
 void trace_uart_init(void)
 {
 #ifdef CONFIG_BSD_LIBRARY_TRACE_ENABLED
@@ -422,21 +763,22 @@ void trace_uart_init(void)
 		.hal_cfg.parity = NRF_UARTE_PARITY_EXCLUDED,
 		.baudrate = NRF_UARTE_BAUDRATE_1000000,
 
-		/* IRQ handler not used. Blocking mode.*/
-		.interrupt_priority = NRFX_UARTE_DEFAULT_CONFIG_IRQ_PRIORITY,
+		.interrupt_priority = TRACE_UARTE_IRQ_PRIORITY,
 		.p_context = NULL,
 	};
 
-	/* Initialize nrfx UARTE driver in blocking mode. */
-	/* TODO: use UARTE in non-blocking mode with IRQ handler. */
-	nrfx_uarte_init(&uarte_inst, &config, NULL);
+	IRQ_CONNECT(TRACE_UARTE_IRQ, TRACE_UARTE_IRQ_PRIORITY,
+		    nrfx_uarte_1_irq_handler, NULL, 0);
+
+	/* Initialize nrfx UARTE driver in non-blocking mode. */
+	nrfx_uarte_init(&uarte_inst, &config, trace_uart_evt_handler);
 #endif
 }
 
 /* This function is called by bsd_init and must not be called explicitly. */
 void bsd_os_init(void)
 {
-	sys_slist_init(&sleeping_threads);
+	sys_dlist_init(&sleeping_threads);
 	atomic_clear(&rpc_event_cnt);
 
 	read_task_create();
@@ -449,20 +791,46 @@ void bsd_os_init(void)
 int32_t bsd_os_trace_put(const uint8_t * const data, uint32_t len)
 {
 #ifdef CONFIG_BSD_LIBRARY_TRACE_ENABLED
-	/* Max DMA transfers are 255 bytes.
-	 * Split RAM buffer into smaller chunks
-	 * to be transferred using DMA.
+	u32_t key;
+
+	/* Traces are only buffered here, the UARTE interrupt
+	 * sends them using chained DMA transfers.
 	 */
-	u32_t remaining_bytes = len;
+	if (trace_ring_put(&uart_ring, data, len)) {
+		key = irq_lock();
+		trace_uart_tx_start();
+		irq_unlock(key);
+	}
 
-	while (remaining_bytes) {
-		u8_t transfer_len = MIN(remaining_bytes, UINT8_MAX);
-		u32_t idx = len - remaining_bytes;
+#ifdef CONFIG_BSD_LIBRARY_TRACE_FLASH
+	if (flash_ready && trace_ring_put(&flash_ring, data, len)) {
+		k_sem_give(&flash_sem);
+	}
+#endif
+#endif
 
-		nrfx_uarte_tx(&uarte_inst, &data[idx], transfer_len);
-		remaining_bytes -= transfer_len;
+	return 0;
+}
+
+int bsdlib_trace_stats_get(struct bsdlib_trace_stats *stats)
+{
+#ifdef CONFIG_BSD_LIBRARY_TRACE_ENABLED
+	if (stats == NULL) {
+		return -EINVAL;
 	}
+
+	memset(stats, 0, sizeof(*stats));
+
+	stats->uart_dropped = uart_ring.dropped;
+	stats->uart_max_used = uart_ring.max_used;
+
+#ifdef CONFIG_BSD_LIBRARY_TRACE_FLASH
+	stats->flash_dropped = flash_ring.dropped;
+	stats->flash_written = flash_written;
 #endif
 
 	return 0;
+#else
+	return -ENOTSUP;
+#endif
 }
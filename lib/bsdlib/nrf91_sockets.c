@@ -30,14 +30,56 @@
 
 #define PROTO_WILDCARD 0
 
-/* Increment by 1 to make sure we do not store the value of 0, which has
- * a special meaning in the fdtable subsys.
+#define OBJ_TO_SD(obj) (((struct nrf_sock_ctx *)obj)->sd)
+
+/* Offloaded socket context, stored as the object in the fdtable subsys. */
+struct nrf_sock_ctx {
+	int sd; /* bsdlib socket descriptor. */
+	bool in_use;
+	bool dgram; /* Messages of the socket must not be split. */
+};
+
+static struct nrf_sock_ctx offload_ctx[BSD_MAX_SOCKET_COUNT];
+static K_MUTEX_DEFINE(ctx_lock);
+
+/* Intermediate buffers of sendmsg, taken from a pool so that messages
+ * can be repacked for several sockets in parallel.
  */
-#define SD_TO_OBJ(sd) ((void *)(sd + 1))
-#define OBJ_TO_SD(obj) (((int)obj) - 1)
+K_MEM_SLAB_DEFINE(sendmsg_slab, CONFIG_BSD_LIBRARY_SENDMSG_BUF_SIZE,
+		  CONFIG_BSD_LIBRARY_SENDMSG_BUF_COUNT, 4);
 
 static const struct socket_op_vtable nrf91_socket_fd_op_vtable;
 
+static struct nrf_sock_ctx *allocate_ctx(int sd, int type)
+{
+	struct nrf_sock_ctx *ctx = NULL;
+
+	k_mutex_lock(&ctx_lock, K_FOREVER);
+
+	for (int i = 0; i < ARRAY_SIZE(offload_ctx); i++) {
+		if (!offload_ctx[i].in_use) {
+			ctx = &offload_ctx[i];
+			ctx->in_use = true;
+			ctx->sd = sd;
+			ctx->dgram = (type != SOCK_STREAM);
+			break;
+		}
+	}
+
+	k_mutex_unlock(&ctx_lock);
+
+	return ctx;
+}
+
+static void release_ctx(struct nrf_sock_ctx *ctx)
+{
+	k_mutex_lock(&ctx_lock, K_FOREVER);
+
+	ctx->in_use = false;
+
+	k_mutex_unlock(&ctx_lock);
+}
+
 static void z_to_nrf_ipv4(const struct sockaddr *z_in,
 			  struct nrf_sockaddr_in *nrf_out)
 {
@@ -524,6 +566,7 @@ static int nrf91_socket_offload_accept(void *obj, struct sockaddr *addr,
 	int fd = z_reserve_fd();
 	int sd = OBJ_TO_SD(obj);
 	int new_sd;
+	struct nrf_sock_ctx *ctx;
 	struct nrf_sockaddr *nrf_addr_ptr = NULL;
 	nrf_socklen_t *nrf_addrlen_ptr = NULL;
 	/* Use `struct nrf_sockaddr_in6` to fit both, IPv4 and IPv6 */
@@ -569,7 +612,14 @@ static int nrf91_socket_offload_accept(void *obj, struct sockaddr *addr,
 		}
 	}
 
-	z_finalize_fd(fd, SD_TO_OBJ(new_sd),
+	ctx = allocate_ctx(new_sd, SOCK_STREAM);
+	if (ctx == NULL) {
+		nrf_close(new_sd);
+		errno = ENOMEM;
+		goto error;
+	}
+
+	z_finalize_fd(fd, ctx,
 		      (const struct fd_op_vtable *)&nrf91_socket_fd_op_vtable);
 
 	return fd;
@@ -815,70 +865,147 @@ error:
 	return retval;
 }
 
+/* Send the message, copying it into buf to reduce the number of `sendto`
+ * calls. Parts which fill the whole buffer are sent without copying, unless
+ * other parts are waiting in the buffer.
+ */
+static ssize_t sendmsg_coalesced(void *obj, const struct msghdr *msg,
+				 int flags, u8_t *buf, size_t buf_size)
+{
+	const u8_t *data;
+	size_t data_len;
+	const u8_t *chunk;
+	size_t chunk_len;
+	size_t len = 0;
+	size_t n;
+	ssize_t sent = 0;
+	ssize_t ret;
+
+	for (int i = 0; i < msg->msg_iovlen; i++) {
+		data = msg->msg_iov[i].iov_base;
+		data_len = msg->msg_iov[i].iov_len;
+
+		while (data_len > 0) {
+			if ((len == 0) && (data_len >= buf_size)) {
+				chunk = data;
+				chunk_len = data_len;
+				data_len = 0;
+			} else {
+				n = MIN(data_len, buf_size - len);
+				memcpy(buf + len, data, n);
+				len += n;
+				data += n;
+				data_len -= n;
+
+				if (len < buf_size) {
+					continue;
+				}
+
+				chunk = buf;
+				chunk_len = len;
+				len = 0;
+			}
+
+			ret = nrf91_socket_offload_sendto(obj, chunk, chunk_len,
+							  flags, msg->msg_name,
+							  msg->msg_namelen);
+			if (ret < 0) {
+				return (sent > 0) ? sent : ret;
+			}
+
+			sent += ret;
+
+			if (ret < chunk_len) {
+				/* The socket did not take all the data. */
+				return sent;
+			}
+		}
+	}
+
+	/* Send the rest, or an empty message. */
+	if ((len > 0) || (sent == 0)) {
+		ret = nrf91_socket_offload_sendto(obj, buf, len, flags,
+						  msg->msg_name,
+						  msg->msg_namelen);
+		if (ret < 0) {
+			return (sent > 0) ? sent : ret;
+		}
+
+		sent += ret;
+	}
+
+	return sent;
+}
+
+/* Whether the socket call must return instead of waiting. */
+static bool call_nonblocking(struct nrf_sock_ctx *ctx, int flags)
+{
+	int nrf_flags;
+
+	if (flags & MSG_DONTWAIT) {
+		return true;
+	}
+
+	nrf_flags = nrf_fcntl(ctx->sd, NRF_F_GETFL, 0);
+
+	return (nrf_flags > 0) && (nrf_flags & NRF_O_NONBLOCK);
+}
+
 static ssize_t nrf91_socket_offload_sendmsg(void *obj, const struct msghdr *msg,
 					    int flags)
 {
-	ssize_t len = 0;
+	struct nrf_sock_ctx *ctx = obj;
+	size_t len = 0;
+	size_t buf_size = CONFIG_BSD_LIBRARY_SENDMSG_BUF_SIZE;
+	u8_t *buf;
 	ssize_t ret;
 	int i;
-	static K_MUTEX_DEFINE(sendmsg_lock);
-	static u8_t buf[CONFIG_BSD_LIBRARY_SENDMSG_BUF_SIZE];
 
 	if (msg == NULL) {
 		errno = EINVAL;
 		return -1;
 	}
 
-	/* Try to reduce number of `sendto` calls - copy data if they fit into
-	 * a single buffer
-	 */
+	if (msg->msg_iovlen == 1) {
+		return nrf91_socket_offload_sendto(obj,
+						   msg->msg_iov[0].iov_base,
+						   msg->msg_iov[0].iov_len,
+						   flags, msg->msg_name,
+						   msg->msg_namelen);
+	}
 
 	for (i = 0; i < msg->msg_iovlen; i++) {
 		len += msg->msg_iov[i].iov_len;
 	}
 
-	if (len <= sizeof(buf)) {
-		/* Protect `buf` access with a mutex. */
-		k_mutex_lock(&sendmsg_lock, K_FOREVER);
-		len = 0;
-
-		for (i = 0; i < msg->msg_iovlen; i++) {
-			memcpy(buf + len, msg->msg_iov[i].iov_base,
-			       msg->msg_iov[i].iov_len);
-			len += msg->msg_iov[i].iov_len;
+	if (ctx->dgram && (len > buf_size)) {
+		/* A datagram must be sent in a single `sendto` call. */
+		buf = k_malloc(len);
+		if (buf == NULL) {
+			errno = ENOMEM;
+			return -1;
 		}
 
-		ret = nrf91_socket_offload_sendto(obj, buf, len,
-						  flags, msg->msg_name,
-						  msg->msg_namelen);
+		ret = sendmsg_coalesced(obj, msg, flags, buf, len);
 
-		k_mutex_unlock(&sendmsg_lock);
+		k_free(buf);
 		return ret;
 	}
 
-	/* If the data won't fit into intermediate buffer, send the buffers
-	 * separately
-	 */
-
-	len = 0;
-
-	for (i = 0; i < msg->msg_iovlen; i++) {
-		if (msg->msg_iov[i].iov_len == 0) {
-			continue;
-		}
-
-		ret = nrf91_socket_offload_sendto(obj, msg->msg_iov[i].iov_base,
-						  msg->msg_iov[i].iov_len,
-						  flags, msg->msg_name,
-						  msg->msg_namelen);
-		if (ret < 0) {
-			return ret;
+	if (k_mem_slab_alloc(&sendmsg_slab, (void **)&buf, K_NO_WAIT) != 0) {
+		/* All buffers are used by other sockets. */
+		if (call_nonblocking(ctx, flags)) {
+			errno = EAGAIN;
+			return -1;
 		}
 
-		len += ret;
+		(void)k_mem_slab_alloc(&sendmsg_slab, (void **)&buf, K_FOREVER);
 	}
 
-	return len;
+	ret = sendmsg_coalesced(obj, msg, flags, buf, buf_size);
+
+	k_mem_slab_free(&sendmsg_slab, (void **)&buf);
+	return ret;
 }
 
 static inline int nrf91_socket_offload_poll(struct pollfd *fds, int nfds,
@@ -1096,8 +1223,13 @@ static int nrf91_socket_offload_ioctl(void *obj, unsigned int request,
 
 	switch (request) {
 	/* Handle close specifically. */
-	case ZFD_IOCTL_CLOSE:
-		return nrf_close(sd);
+	case ZFD_IOCTL_CLOSE: {
+		int retval = nrf_close(sd);
+
+		release_ctx(obj);
+
+		return retval;
+	}
 
 	case ZFD_IOCTL_POLL_PREPARE:
 		return -EXDEV;
@@ -1162,6 +1294,7 @@ static int nrf91_socket_create(int family, int type, int proto)
 {
 	int fd = z_reserve_fd();
 	int sd;
+	struct nrf_sock_ctx *ctx;
 
 	if (fd < 0) {
 		return -1;
@@ -1173,7 +1306,15 @@ static int nrf91_socket_create(int family, int type, int proto)
 		return -1;
 	}
 
-	z_finalize_fd(fd, SD_TO_OBJ(sd),
+	ctx = allocate_ctx(sd, type);
+	if (ctx == NULL) {
+		nrf_close(sd);
+		z_free_fd(fd);
+		errno = ENOMEM;
+		return -1;
+	}
+
+	z_finalize_fd(fd, ctx,
 		      (const struct fd_op_vtable *)&nrf91_socket_fd_op_vtable);
 
 	return fd;
@@ -222,15 +222,12 @@ static int parse_cereg(const char *notification,
 		       struct lte_lc_psm_cfg *psm_cfg)
 {
 	int err, status;
-	struct at_param_list resp_list;
 	char str_buf[10];
 	size_t len = sizeof(str_buf) - 1;
-
-	err = at_params_list_init(&resp_list, AT_CEREG_PARAMS_COUNT_MAX);
-	if (err) {
-		LOG_ERR("Could not init AT params list, error: %d", err);
-		return err;
-	}
+	/* Notifications are parsed without using the heap. */
+	AT_PARAMS_LIST_DEFINE(resp_list, AT_CEREG_PARAMS_COUNT_MAX,
+			      AT_PARAMS_ARENA_SIZE(AT_CEREG_RESPONSE_MAX_LEN,
+						   AT_CEREG_PARAMS_COUNT_MAX));
 
 	/* Parse CEREG response and populate AT parameter list */
 	err = at_parser_params_from_str(notification,
@@ -22,6 +22,9 @@ LOG_MODULE_REGISTER(modem_info);
 
 #define INVALID_DESCRIPTOR	-1
 
+#define PARAMS_ARENA_SIZE AT_PARAMS_ARENA_SIZE(CONFIG_MODEM_INFO_BUFFER_SIZE, \
+				CONFIG_MODEM_INFO_MAX_AT_PARAMS_RSP)
+
 #define AT_CMD_CESQ		"AT+CESQ"
 #define AT_CMD_CESQ_ON		"AT%CESQ=1"
 #define AT_CMD_CESQ_OFF		"AT%CESQ=0"
@@ -341,7 +344,9 @@ static const struct modem_info_data *const modem_data[] = {
 };
 
 static rsrp_cb_t modem_info_rsrp_cb;
-static struct at_param_list m_param_list;
+/* Responses and notifications are parsed without using the heap. */
+AT_PARAMS_LIST_DEFINE(m_param_list, CONFIG_MODEM_INFO_MAX_AT_PARAMS_RSP,
+		      PARAMS_ARENA_SIZE);
 
 static bool is_cesq_notification(const char *buf, size_t len)
 {
@@ -652,9 +657,6 @@ int modem_info_rsrp_register(rsrp_cb_t cb)
 
 int modem_info_init(void)
 {
-	/* Init at_cmd_parser storage module */
-	int err = at_params_list_init(&m_param_list,
-				CONFIG_MODEM_INFO_MAX_AT_PARAMS_RSP);
-
-	return err;
+	/* The at_cmd_parser storage is statically allocated. */
+	return 0;
 }
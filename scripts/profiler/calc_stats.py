@@ -4,6 +4,7 @@
 # SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
 
 from stats_nordic import StatsNordic
+from events import dataset_events_filename
 
 import sys
 import argparse
@@ -33,8 +34,8 @@ def main():
     else:
         args.end_time = float(args.end_time)
 
-    sn = StatsNordic(args.dataset_name + ".csv", args.dataset_name + ".json",
-                     log_lvl_number)
+    sn = StatsNordic(dataset_events_filename(args.dataset_name),
+                     args.dataset_name + ".json", log_lvl_number)
     sn.calculate_stats_preset1(args.start_time, args.end_time)
 
 if __name__ == "__main__":
@@ -31,7 +31,7 @@ def main():
     end_ev = threading.Event()
 
     profiler = RttNordicProfilerHost(
-                event_filename=args.dataset_name + ".csv",
+                event_filename=args.dataset_name + ".bin",
                 finish_event=end_ev,
                 event_types_filename=args.dataset_name + ".json",
                 log_lvl=log_lvl_number)
@@ -7,9 +7,23 @@ import csv
 import json
 import hashlib
 import logging
+import mmap
+import os
+import struct
 import sys
 
 
+# Binary trace file starts with a header followed by event records. Every
+# record consists of RECORD_HEADER (event type ID and timestamp in seconds)
+# and 32-bit data values of the event type.
+TRACE_MAGIC = b'NPTR'
+TRACE_VERSION = 1
+TRACE_HEADER = struct.Struct('<4sB3x')
+RECORD_HEADER = struct.Struct('<Hd')
+TRACE_FILE_EXT = '.bin'
+CSV_FILE_EXT = '.csv'
+
+
 class Event():
     def __init__(self, type_id, timestamp, data):
         self.type_id = type_id
@@ -48,6 +62,194 @@ class TrackedEvent():
         self.proc_end_time = end_time
 
 
+class RingEventsDecoder():
+    """Decoder of events sent by the Nordic profiler ring buffer backend.
+
+    Every event starts with 16-bit event type ID followed by the difference
+    from the previous timestamp encoded as zigzag varint and by 32-bit data
+    values. Event type ID of OVERFLOW_ID is followed by varint number of
+    events dropped on the device.
+    """
+    OVERFLOW_ID = 0xFFFF
+    TIMESTAMP_RAW_MAX = 2**32
+
+    def __init__(self, registered_events_types, ms_per_timestamp_tick,
+                 byteorder='little'):
+        self.registered_events_types = registered_events_types
+        self.ms_per_timestamp_tick = ms_per_timestamp_tick
+        self.byteorder = byteorder
+        self.dropped_events = 0
+        self.timestamp_raw = None
+        self.timestamp_overflows = 0
+        self.new_stream = True
+
+    def reset(self):
+        """Start decoding a new stream.
+
+        The device encodes the first timestamp sent after START or STOP
+        command relative to zero.
+        """
+        self.new_stream = True
+
+    @staticmethod
+    def _read_varint(read_bytes):
+        value = 0
+        shift = 0
+        while True:
+            byte = read_bytes(1)[0]
+            value |= (byte & 0x7F) << shift
+            if byte & 0x80 == 0:
+                return value
+            shift += 7
+
+    def _update_timestamp(self, zigzag):
+        delta = (zigzag >> 1) ^ -(zigzag & 1)
+        if self.new_stream:
+            # First timestamp of the stream is relative to zero
+            raw = delta % self.TIMESTAMP_RAW_MAX
+            if self.timestamp_raw is not None and raw < self.timestamp_raw:
+                self.timestamp_overflows += 1
+            self.timestamp_raw = raw
+            self.new_stream = False
+            return
+        raw = (self.timestamp_raw + delta) % self.TIMESTAMP_RAW_MAX
+        if delta > 0 and raw < self.timestamp_raw:
+            self.timestamp_overflows += 1
+        elif delta < 0 and raw > self.timestamp_raw:
+            self.timestamp_overflows -= 1
+        self.timestamp_raw = raw
+
+    def read_event(self, read_bytes):
+        """Read single event using read_bytes(num_bytes) function.
+
+        Returns Event or None if overflow report was read.
+        """
+        type_id = int.from_bytes(read_bytes(2), byteorder=self.byteorder,
+                                 signed=False)
+        if type_id == self.OVERFLOW_ID:
+            self.dropped_events += RingEventsDecoder._read_varint(read_bytes)
+            return None
+
+        et = self.registered_events_types[type_id]
+        self._update_timestamp(RingEventsDecoder._read_varint(read_bytes))
+        ticks = self.timestamp_raw + \
+            self.timestamp_overflows * self.TIMESTAMP_RAW_MAX
+        timestamp = self.ms_per_timestamp_tick * ticks / 1000
+
+        data = []
+        for i in et.data_types:
+            signum = i[0] == 's'
+            data.append(int.from_bytes(read_bytes(4),
+                                       byteorder=self.byteorder,
+                                       signed=signum))
+        return Event(type_id, timestamp, data)
+
+    def decode(self, buf):
+        """Decode all complete events from bytes.
+
+        Returns list of events and number of bytes consumed.
+        """
+        events = []
+        consumed = 0
+        pos = 0
+
+        def read_bytes(num_bytes):
+            nonlocal pos
+            if pos + num_bytes > len(buf):
+                raise EOFError()
+            data = buf[pos:pos + num_bytes]
+            pos += num_bytes
+            return data
+
+        while consumed < len(buf):
+            state = (self.dropped_events, self.timestamp_raw,
+                     self.timestamp_overflows, self.new_stream)
+            try:
+                event = self.read_event(read_bytes)
+            except EOFError:
+                # Incomplete event, restore state for the next call
+                (self.dropped_events, self.timestamp_raw,
+                 self.timestamp_overflows, self.new_stream) = state
+                break
+            consumed = pos
+            if event is not None:
+                events.append(event)
+
+        return events, consumed
+
+
+def _record_struct(event_type):
+    data_format = ''.join('i' if i[0] == 's' else 'I'
+                          for i in event_type.data_types)
+    return struct.Struct(RECORD_HEADER.format + data_format)
+
+
+def dataset_events_filename(dataset_name):
+    """Returns name of the file with events of the dataset.
+
+    Binary trace file is used unless only csv file exists.
+    """
+    trace_filename = dataset_name + TRACE_FILE_EXT
+    csv_filename = dataset_name + CSV_FILE_EXT
+    if not os.path.exists(trace_filename) and os.path.exists(csv_filename):
+        return csv_filename
+    return trace_filename
+
+
+class TraceWriter():
+    """Writes events to binary trace file one by one."""
+
+    def __init__(self, filename, registered_events_types):
+        self.registered_events_types = registered_events_types
+        self.structs = {}
+        self.file = open(filename, 'wb')
+        self.file.write(TRACE_HEADER.pack(TRACE_MAGIC, TRACE_VERSION))
+
+    def write(self, ev):
+        st = self.structs.get(ev.type_id)
+        if st is None:
+            st = _record_struct(self.registered_events_types[ev.type_id])
+            self.structs[ev.type_id] = st
+        self.file.write(st.pack(ev.type_id, ev.timestamp, *ev.data))
+
+    def close(self):
+        self.file.close()
+
+
+class TraceReader():
+    """Iterates over events from binary trace file.
+
+    The file is memory-mapped, so events are read without loading the whole
+    file into memory.
+    """
+
+    def __init__(self, filename, registered_events_types):
+        self.filename = filename
+        self.registered_events_types = registered_events_types
+
+    def __iter__(self):
+        structs = {}
+        with open(self.filename, 'rb') as f:
+            if os.fstat(f.fileno()).st_size < TRACE_HEADER.size:
+                raise ValueError("Invalid trace file: " + self.filename)
+            with mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as mm:
+                magic, version = TRACE_HEADER.unpack_from(mm)
+                if magic != TRACE_MAGIC or version != TRACE_VERSION:
+                    raise ValueError("Invalid trace file: " + self.filename)
+                offset = TRACE_HEADER.size
+                size = len(mm)
+                while offset < size:
+                    type_id, = struct.unpack_from('<H', mm, offset)
+                    st = structs.get(type_id)
+                    if st is None:
+                        st = _record_struct(
+                            self.registered_events_types[type_id])
+                        structs[type_id] = st
+                    values = st.unpack_from(mm, offset)
+                    offset += st.size
+                    yield Event(type_id, values[1], list(values[2:]))
+
+
 class EventsData():
     def __init__(self, events, registered_events_types):
         self.events = events
@@ -73,29 +275,75 @@ class EventsData():
         return True
 
     def write_data_to_files(self, filename_events, filename_event_types):
-        self._write_events_csv(filename_events)
-        csv_hash = EventsData._calculate_md5_hash_of_file(filename_events)
-        self._write_events_types_json(filename_event_types, csv_hash)
+        """Write events and their descriptions to files.
+
+        Events are written to csv file if filename_events has csv extension
+        and to binary trace file otherwise.
+        """
+        if filename_events.endswith(CSV_FILE_EXT):
+            self._write_events_csv(filename_events, self.events)
+        else:
+            self._write_events_trace(filename_events, self.events)
+        events_hash = EventsData._calculate_md5_hash_of_file(filename_events)
+        self._write_events_types_json(filename_event_types, events_hash)
 
     def read_data_from_files(self, filename_events, filename_event_types):
-        self._read_events_csv(filename_events)
-        csv_hash1 = self._read_events_types_json(filename_event_types)
-        csv_hash2 = EventsData._calculate_md5_hash_of_file(filename_events)
-        if csv_hash1 != csv_hash2:
-            self.logger.warning("Hash values of csv files do not match")
+        self.read_event_types_from_files(filename_events, filename_event_types)
+        self.events.extend(self.iter_events_from_file(filename_events))
+
+    def read_event_types_from_files(self, filename_events,
+                                    filename_event_types):
+        """Read event descriptions without loading events."""
+        events_hash1 = self._read_events_types_json(filename_event_types)
+        events_hash2 = EventsData._calculate_md5_hash_of_file(filename_events)
+        if events_hash1 != events_hash2:
+            self.logger.warning("Hash values of events files do not match")
             self.logger.warning("Events and descriptions may be inconsistent")
 
+    def iter_events_from_file(self, filename):
+        """Generator reading events one by one from csv or trace file.
+
+        Event descriptions must be read before.
+        """
+        if filename.endswith(CSV_FILE_EXT):
+            return self._iter_events_csv(filename)
+        return iter(TraceReader(filename, self.registered_events_types))
+
     def _calculate_md5_hash_of_file(filename):
-        return hashlib.md5(open(filename, 'rb').read()).hexdigest()
+        md5 = hashlib.md5()
+        try:
+            with open(filename, 'rb') as f:
+                for chunk in iter(lambda: f.read(1 << 20), b''):
+                    md5.update(chunk)
+        except IOError:
+            logging.getLogger('Events Data').error(
+                "Problem with accessing file: " + filename)
+            sys.exit()
+        return md5.hexdigest()
+
+    def _write_events_trace(self, filename, events):
+        try:
+            writer = TraceWriter(filename, self.registered_events_types)
+            for ev in events:
+                writer.write(ev)
+            writer.close()
+        except IOError:
+            self.logger.error("Problem with accessing file: " + filename)
+            sys.exit()
+
+    def export_events_csv(self, filename_events, filename_csv):
+        """Convert events file to csv file without loading all events."""
+        self._write_events_csv(filename_csv,
+                               self.iter_events_from_file(filename_events))
 
-    def _write_events_csv(self, filename):
+    def _write_events_csv(self, filename, events):
         try:
             with open(filename, 'w', newline='') as csvfile:
                 fieldnames = ['type_id', 'timestamp', 'data']
                 wr = csv.DictWriter(csvfile, delimiter=',',
                                     fieldnames=fieldnames)
                 wr.writeheader()
-                for ev in self.events:
+                for ev in events:
                     wr.writerow({
                                  'type_id': ev.type_id,
                                  'timestamp': ev.timestamp,
@@ -105,7 +353,7 @@ class EventsData():
             self.logger.error("Problem with accessing file: " + filename)
             sys.exit()
 
-    def _read_events_csv(self, filename):
+    def _iter_events_csv(self, filename):
         try:
             with open(filename, 'r', newline='') as csvfile:
                 rd = csv.DictReader(csvfile, delimiter=',')
@@ -117,16 +365,15 @@ class EventsData():
                         data = list(map(int, (row['data'][1:-1].split(','))))
                     else:
                         data = []
-                    ev = Event(type_id, timestamp, data)
-                    self.events.append(ev)
+                    yield Event(type_id, timestamp, data)
         except IOError:
             self.logger.error("Problem with accessing file: " + filename)
             sys.exit()
 
-    def _write_events_types_json(self, filename, csv_hash):
+    def _write_events_types_json(self, filename, events_hash):
         d = dict((k, v.serialize())
                  for k, v in self.registered_events_types.items())
-        d['csv_hash'] = csv_hash
+        d['events_hash'] = events_hash
         try:
             with open(filename, "w") as wr:
                 json.dump(d, wr, indent=4)
@@ -141,8 +388,10 @@ class EventsData():
         except IOError:
             self.logger.error("Problem with accessing file: " + filename)
             sys.exit()
-        csv_hash = data['csv_hash']
-        del data['csv_hash']
-        self.registered_events_types = dict((int(k), EventType.deserialize(v))
-                                            for k, v in data.items())
-        return csv_hash
+        # Datasets saved before binary trace files were used have csv_hash
+        hash_key = 'events_hash' if 'events_hash' in data else 'csv_hash'
+        events_hash = data.pop(hash_key)
+        self.registered_events_types.clear()
+        self.registered_events_types.update(
+            (int(k), EventType.deserialize(v)) for k, v in data.items())
+        return events_hash
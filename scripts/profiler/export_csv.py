@@ -0,0 +1,32 @@
+#
+# Copyright (c) 2020 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+
+from events import EventsData, dataset_events_filename
+import argparse
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Export events from dataset to csv file.')
+    parser.add_argument('dataset_name', help='Name of dataset')
+    parser.add_argument('csv_filename', nargs='?',
+                        help='Name of csv file (default: dataset_name.csv)')
+    args = parser.parse_args()
+
+    if args.csv_filename is None:
+        args.csv_filename = args.dataset_name + ".csv"
+
+    events_filename = dataset_events_filename(args.dataset_name)
+    if events_filename == args.csv_filename:
+        print('Dataset is already stored in csv file')
+        return
+
+    ed = EventsData([], {})
+    ed.read_event_types_from_files(events_filename,
+                                   args.dataset_name + ".json")
+    ed.export_events_csv(events_filename, args.csv_filename)
+
+if __name__ == "__main__":
+    main()
@@ -3,7 +3,7 @@
 #
 # SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
 
-from events import EventsData, Event, EventType
+from events import EventsData, Event, EventType, dataset_events_filename
 import argparse
 import numpy as np
 
@@ -43,12 +43,14 @@ def main():
     args = parser.parse_args()
 
     evt_peripheral = EventsData([], {})
-    evt_peripheral.read_data_from_files(args.peripheral_dataset + ".csv",
-                                        args.peripheral_dataset + ".json")
+    evt_peripheral.read_data_from_files(
+        dataset_events_filename(args.peripheral_dataset),
+        args.peripheral_dataset + ".json")
 
     evt_central = EventsData([], {})
-    evt_central.read_data_from_files(args.central_dataset + ".csv",
-                                     args.central_dataset + ".json")
+    evt_central.read_data_from_files(
+        dataset_events_filename(args.central_dataset),
+        args.central_dataset + ".json")
 
     # Compensating clock drift - based on synchronization events
     sync_evt_peripheral = evt_peripheral.get_event_type_id(
@@ -125,7 +127,7 @@ def main():
     result_events = EventsData(evt_peripheral.events + evt_central.events,
                                all_registered_events_types)
 
-    result_events.write_data_to_files(args.result_dataset + ".csv",
+    result_events.write_data_to_files(args.result_dataset + ".bin",
                                       args.result_dataset + ".json")
 
     print('Profiler data merged successfully')
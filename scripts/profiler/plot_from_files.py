@@ -4,6 +4,7 @@
 # SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
 
 from plot_nordic import PlotNordic
+from events import dataset_events_filename
 import sys
 import argparse
 import logging
@@ -21,7 +22,7 @@ def main():
 	    log_lvl_number = logging.WARNING
 
     pn = PlotNordic(log_lvl=log_lvl_number)
-    pn.read_data_from_files(args.dataset_name + ".csv",
+    pn.read_data_from_files(dataset_events_filename(args.dataset_name),
                             args.dataset_name + ".json")
     pn.plot_events_from_file()
     pn.log_stats('log')
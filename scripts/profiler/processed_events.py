@@ -27,37 +27,54 @@ class ProcessedEvents():
         self.logger_console.setFormatter(self.log_format)
         self.logger.addHandler(self.logger_console)
 
-    def match_event_processing(self):
+    def find_tracking_event_types(self):
         self.event_processing_start_id = self.raw_data.get_event_type_id(
             'event_processing_start')
         self.event_processing_end_id = self.raw_data.get_event_type_id(
             'event_processing_end')
 
-        if (self.event_processing_start_id is None) or \
-          (self.event_processing_end_id is None):
-            self.tracking_execution = False
-            for ev in self.raw_data.events:
-                self.tracked_events.append(TrackedEvent(ev, None, None))
+        self.tracking_execution = \
+            (self.event_processing_start_id is not None) and \
+            (self.event_processing_end_id is not None)
+
+    def track_events(self, events):
+        """Generator matching event submissions with their processing.
+
+        Events are consumed one by one, so an iterator reading events from
+        file can be used. Only the last submission for every memory address
+        is kept in memory.
+        """
+        self.find_tracking_event_types()
+
+        if not self.tracking_execution:
+            for ev in events:
+                yield TrackedEvent(ev, None, None)
             return
 
-        for i in range(1, len(self.raw_data.events)):
-            if self.raw_data.events[i].type_id == self.event_processing_start_id:
-                self.start_event = self.raw_data.events[i]
-                for j in range(i - 1, -1, -1):
-                    # comparing memory addresses of event processing start
-                    # and event submit to identify matching events
-                    if self.raw_data.events[j].data[0] == self.start_event.data[0]:
-                        self.submit_event = self.raw_data.events[j]
-                        break
+        # Last submitted event for every memory address
+        submits = {}
+        submit_event = None
+        start_event = None
+
+        for ev in events:
+            # comparing memory addresses of event processing start
+            # and event submit to identify matching events
+            if ev.type_id == self.event_processing_start_id:
+                start_event = ev
+                submit_event = submits.pop(ev.data[0], None)
 
             # comparing memory addresses of event processing start and end
             # to identify matching events
-            if self.raw_data.events[i].type_id == self.event_processing_end_id:
-                if self.submit_event is not None \
-                        and self.raw_data.events[i].data[0] == self.start_event.data[0]:
-                    self.tracked_events.append(
-                        TrackedEvent(
-                            self.submit_event,
-                            self.start_event.timestamp,
-                            self.raw_data.events[i].timestamp))
-                    self.submit_event = None
+            elif ev.type_id == self.event_processing_end_id:
+                if submit_event is not None \
+                        and ev.data[0] == start_event.data[0]:
+                    yield TrackedEvent(submit_event,
+                                       start_event.timestamp,
+                                       ev.timestamp)
+                    submit_event = None
+
+            elif len(ev.data) > 0:
+                submits[ev.data[0]] = ev
+
+    def match_event_processing(self):
+        self.tracked_events.extend(self.track_events(self.raw_data.events))
@@ -36,7 +36,7 @@ def main():
     que = queue.Queue()
     t_rtt = threading.Thread(
         target=rtt_thread,
-        args=[que, ev, args.dataset_name + ".csv",
+        args=[que, ev, args.dataset_name + ".bin",
               args.dataset_name + ".json", log_lvl_number])
     t_rtt.start()
 
@@ -15,5 +15,6 @@ RttNordicConfig = {
     'timestamp_raw_max': 2**32, #timestamp on uC is stored as 32-bit value
     'rtt_read_period': 0.1, #in seconds
     'rtt_read_chunk_size': 64000,
-    'rtt_additional_read_thresh': 4096
+    'rtt_additional_read_thresh': 4096,
+    'ring_buffer': False #set if CONFIG_PROFILER_NORDIC_RING_BUFFER is enabled
 }
@@ -9,7 +9,7 @@ import time
 import sys
 from enum import Enum
 from rtt_nordic_config import RttNordicConfig
-from events import Event, EventType, EventsData
+from events import Event, EventType, EventsData, RingEventsDecoder
 import logging
 
 class Command(Enum):
@@ -29,6 +29,12 @@ class RttNordicProfilerHost:
         self.finish_event = finish_event
         self.queue = queue
         self.received_events = EventsData([], {})
+        self.ring_decoder = None
+        if self.config['ring_buffer']:
+            self.ring_decoder = RingEventsDecoder(
+                self.received_events.registered_events_types,
+                self.config['ms_per_timestamp_tick'],
+                self.config['byteorder'])
         self.timestamp_overflows = 0
         self.after_half = False
 
@@ -91,6 +97,10 @@ class RttNordicProfilerHost:
     def shutdown(self):
         self.disconnect()
         self._read_remaining_events()
+        if self.ring_decoder is not None and \
+        self.ring_decoder.dropped_events > 0:
+            self.logger.warning("Events dropped by device: {}".format(
+                self.ring_decoder.dropped_events))
         if self.event_filename and self.event_types_filename:
             self.received_events.write_data_to_files(self.event_filename,
                                                      self.event_types_filename)
@@ -231,6 +241,9 @@ class RttNordicProfilerHost:
         self.logger.info("Ready to start logging events")
 
     def _read_single_event_rtt(self):
+        if self.ring_decoder is not None:
+            return self.ring_decoder.read_event(self._read_bytes)
+
         id = int.from_bytes(
             self._read_bytes(1),
             byteorder=self.config['byteorder'],
@@ -269,6 +282,9 @@ class RttNordicProfilerHost:
         self.reading_data = False
         while self.bcnt != 0:
             event = self._read_single_event_rtt()
+            # Overflow reports are not events
+            if event is None:
+                continue
             self.received_events.events.append(event)
             if self.queue is not None:
                 self.queue.put(event)
@@ -284,9 +300,10 @@ class RttNordicProfilerHost:
         current_time = start_time
         while current_time - start_time < time_seconds or time_seconds < 0:
             event = self._read_single_event_rtt()
-            self.received_events.events.append(event)
-            if self.queue is not None:
-                self.queue.put(event)
+            if event is not None:
+                self.received_events.events.append(event)
+                if self.queue is not None:
+                    self.queue.put(event)
             current_time = time.time()
         self.logger.info("Real time transmission closed")
         self.shutdown()
@@ -294,6 +311,8 @@ class RttNordicProfilerHost:
         sys.exit()
 
     def start_logging_events(self):
+        if self.ring_decoder is not None:
+            self.ring_decoder.reset()
         self._send_command(Command.START)
 
     def stop_logging_events(self):
@@ -6,10 +6,10 @@
 from events import EventsData
 from processed_events import ProcessedEvents
 from enum import Enum
+from collections import deque
 import matplotlib.pyplot as plt
-import numpy as np
 import logging
-import csv
+import math
 import os
 
 
@@ -22,13 +22,54 @@ class EventState(Enum):
     PROC_END = 3
 
 
+class DurationStats():
+    """Statistics of durations calculated incrementally.
+
+    Durations are not stored, only a histogram with bins of given width
+    is kept. Median is estimated from the histogram.
+    """
+
+    def __init__(self, bin_width):
+        self.bin_width = bin_width
+        self.hist = {}
+        self.count = 0
+        self.mean = 0.0
+        self.m2 = 0.0
+        self.min = float('inf')
+        self.max = float('-inf')
+
+    def add(self, value):
+        # Welford's algorithm
+        self.count += 1
+        delta = value - self.mean
+        self.mean += delta / self.count
+        self.m2 += delta * (value - self.mean)
+        self.min = min(self.min, value)
+        self.max = max(self.max, value)
+
+        hist_bin = math.floor(value / self.bin_width)
+        self.hist[hist_bin] = self.hist.get(hist_bin, 0) + 1
+
+    def std(self):
+        return math.sqrt(self.m2 / self.count)
+
+    def median(self):
+        cnt = 0
+        for hist_bin in sorted(self.hist):
+            cnt += self.hist[hist_bin]
+            if 2 * cnt >= self.count:
+                return (hist_bin + 0.5) * self.bin_width
+        return None
+
+
 class StatsNordic():
     def __init__(self, events_filename, events_types_filename, log_lvl):
         self.data_name = events_filename.split('.')[0]
+        self.events_filename = events_filename
         self.processed_data = ProcessedEvents()
-        self.processed_data.raw_data.read_data_from_files(
+        self.processed_data.raw_data.read_event_types_from_files(
                                       events_filename, events_types_filename)
-        self.processed_data.match_event_processing()
+        self.processed_data.find_tracking_event_types()
 
         self.logger = logging.getLogger('Stats Nordic')
         self.logger_console = logging.StreamHandler()
@@ -56,55 +97,71 @@ class StatsNordic():
                                  0.05, start_meas, end_meas)
         plt.show()
 
-    def _get_timestamps(self, event_name, event_state, start_meas, end_meas):
-        event_type_id = self.processed_data.raw_data.get_event_type_id(event_name)
-        if event_type_id == None:
-            self.logger.error("Event name not found: " + event_name)
-            return None
-
-        trackings = list(filter(lambda x:
-                      x.submit.type_id == event_type_id,
-                      self.processed_data.tracked_events))
-
-        if type(event_state) is not EventState:
-            self.logger.error("Event state should be EventState enum")
-            return None
+    def _tracked_events(self):
+        # Events are streamed from file, so they are not kept in memory
+        raw_data = self.processed_data.raw_data
+        return self.processed_data.track_events(
+            raw_data.iter_events_from_file(self.events_filename))
 
+    @staticmethod
+    def _get_timestamp(tracked_event, event_state):
         if event_state == EventState.SUBMIT:
-            timestamps = np.fromiter(map(lambda x: x.submit.timestamp, trackings),
-                                     dtype=np.float)
+            return tracked_event.submit.timestamp
         elif event_state == EventState.PROC_START:
-            timestamps = np.fromiter(map(lambda x: x.proc_start_time, trackings),
-                                     dtype=np.float)
+            return tracked_event.proc_start_time
         elif event_state == EventState.PROC_END:
-            timestamps = np.fromiter(map(lambda x: x.proc_end_time, trackings),
-                                     dtype=np.float)
-
-        timestamps = timestamps[np.where((timestamps > start_meas)
-                                         & (timestamps < end_meas))]
-
-        return timestamps
-
-    def calculate_times_between(self, start_times, end_times):
-        if end_times[0] <= start_times[0]:
-            end_times = end_times[1:]
-        if len(start_times) > len(end_times):
-            start_times = start_times[:-1]
-
-        return (end_times - start_times) * 1000
-
-    def prepare_stats_txt(self, times_between):
+            return tracked_event.proc_end_time
+
+    def calculate_times_between(self, start_event_type_id, start_event_state,
+                                end_event_type_id, end_event_state,
+                                hist_bin_width, start_meas, end_meas):
+        """Calculate durations in single pass over events.
+
+        Every end event is paired with the oldest start event that is not
+        paired yet. End events without start event are skipped.
+        """
+        stats = DurationStats(hist_bin_width)
+        start_times = deque()
+        unpaired_end_cnt = 0
+
+        for tr in self._tracked_events():
+            type_id = tr.submit.type_id
+
+            # End is handled first, as the same event may be both end of
+            # the previous period and start of the next one.
+            if type_id == end_event_type_id:
+                ts = StatsNordic._get_timestamp(tr, end_event_state)
+                if start_meas < ts < end_meas:
+                    if len(start_times) > 0:
+                        stats.add((ts - start_times.popleft()) * 1000)
+                    else:
+                        unpaired_end_cnt += 1
+
+            if type_id == start_event_type_id:
+                ts = StatsNordic._get_timestamp(tr, start_event_state)
+                if start_meas < ts < end_meas:
+                    start_times.append(ts)
+
+        # One start or end without the pair is expected at the edges of
+        # the measurement
+        if unpaired_end_cnt > 1 or len(start_times) > 1:
+            self.logger.warning("Unpaired events: {} start, {} end".format(
+                len(start_times), unpaired_end_cnt))
+
+        return stats
+
+    def prepare_stats_txt(self, stats):
         stats_text = "Max time: "
-        stats_text += "{0:.3f}".format(max(times_between)) + "ms\n"
+        stats_text += "{0:.3f}".format(stats.max) + "ms\n"
         stats_text += "Min time: "
-        stats_text += "{0:.3f}".format(min(times_between)) + "ms\n"
+        stats_text += "{0:.3f}".format(stats.min) + "ms\n"
         stats_text += "Mean time: "
-        stats_text += "{0:.3f}".format(np.mean(times_between)) + "ms\n"
+        stats_text += "{0:.3f}".format(stats.mean) + "ms\n"
         stats_text += "Std dev of time: "
-        stats_text += "{0:.3f}".format(np.std(times_between)) + "ms\n"
+        stats_text += "{0:.3f}".format(stats.std()) + "ms\n"
         stats_text += "Median time: "
-        stats_text += "{0:.3f}".format(np.median(times_between)) + "ms\n"
-        stats_text += "Number of records: {}".format(len(times_between)) + "\n"
+        stats_text += "{0:.3f}".format(stats.median()) + "ms\n"
+        stats_text += "Number of records: {}".format(stats.count) + "\n"
 
         return stats_text
 
@@ -120,31 +177,36 @@ class StatsNordic():
                                   start_event_name + "->" + end_event_name)
                 return
 
-        start_times = self._get_timestamps(start_event_name, start_event_state,
-                                           start_meas, end_meas)
-        end_times = self._get_timestamps(end_event_name, end_event_state,
-                                           start_meas, end_meas)
-
-        if start_times is None or end_times is None:
+        if type(start_event_state) is not EventState or \
+          type(end_event_state) is not EventState:
+            self.logger.error("Event state should be EventState enum")
             return
 
-        if len(start_times) == 0:
-            self.logger.error("No events logged: " + start_event_name)
+        raw_data = self.processed_data.raw_data
+        start_event_type_id = raw_data.get_event_type_id(start_event_name)
+        end_event_type_id = raw_data.get_event_type_id(end_event_name)
+
+        if start_event_type_id is None:
+            self.logger.error("Event name not found: " + start_event_name)
             return
 
-        if len(end_times) == 0:
-            self.logger.error("No events logged: " + stop_event_name)
+        if end_event_type_id is None:
+            self.logger.error("Event name not found: " + end_event_name)
             return
 
-        if len(start_times) != len(end_times):
-            self.logger.error("Number of start_times and end_times is not equal")
-            self.logger.error("Got {} start_times and {} end_times".format(
-                len(start_times), len(end_times)))
+        stats = self.calculate_times_between(start_event_type_id,
+                                             start_event_state,
+                                             end_event_type_id,
+                                             end_event_state,
+                                             hist_bin_width,
+                                             start_meas, end_meas)
 
+        if stats.count == 0:
+            self.logger.error("No events logged: " + start_event_name +
+                              "->" + end_event_name)
             return
 
-        times_between = self.calculate_times_between(start_times, end_times)
-        stats_text = self.prepare_stats_txt(times_between)
+        stats_text = self.prepare_stats_txt(stats)
 
         plt.figure()
 
@@ -173,8 +235,10 @@ class StatsNordic():
                 end_event_name + ' ' + event_status_str[end_event_state] + \
                 ' (' + self.data_name + ')'
         plt.title(title)
-        plt.hist(times_between, bins = (int)((max(times_between) - min(times_between))
-                                        / hist_bin_width))
+        hist_bins = sorted(stats.hist)
+        plt.bar([i * hist_bin_width for i in hist_bins],
+                [stats.hist[i] for i in hist_bins],
+                width=hist_bin_width, align='edge')
 
         plt.yscale('log')
         plt.grid(True)
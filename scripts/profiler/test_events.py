@@ -0,0 +1,175 @@
+#
+# Copyright (c) 2020 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+
+# Run with: python3 -m unittest test_events
+
+import unittest
+from events import EventType, RingEventsDecoder
+
+# Same vectors as used by tests/subsys/profiler for the device side encoder
+VARINT_VECTORS = [
+    (0, b'\x00'),
+    (1, b'\x01'),
+    (127, b'\x7f'),
+    (128, b'\x80\x01'),
+    (300, b'\xac\x02'),
+    (16384, b'\x80\x80\x01'),
+    (0x0FFFFFFF, b'\xff\xff\xff\x7f'),
+    (0xFFFFFFFF, b'\xff\xff\xff\xff\x0f'),
+]
+
+ZIGZAG_VECTORS = [
+    (0, 0),
+    (-1, 1),
+    (1, 2),
+    (-2, 3),
+    (2, 4),
+    (2**31 - 1, 0xFFFFFFFE),
+    (-2**31, 0xFFFFFFFF),
+]
+
+TYPE_ID_NO_DATA = 0
+TYPE_ID_DATA = 1
+
+
+def varint_encode(value):
+    out = bytearray()
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+    return bytes(out)
+
+
+def zigzag_encode(value):
+    return ((value << 1) ^ (value >> 31)) & 0xFFFFFFFF
+
+
+def timestamp_delta(timestamp, last_timestamp):
+    """Difference of 32-bit timestamps as computed by the device."""
+    delta = (timestamp - last_timestamp) & 0xFFFFFFFF
+    return delta - 2**32 if delta >= 2**31 else delta
+
+
+def event_record(type_id, zigzag, data=b''):
+    return type_id.to_bytes(2, 'little') + varint_encode(zigzag) + data
+
+
+def overflow_record(dropped):
+    return event_record(RingEventsDecoder.OVERFLOW_ID, dropped)
+
+
+class TestRingEncoding(unittest.TestCase):
+    def test_varint_vectors(self):
+        for value, encoded in VARINT_VECTORS:
+            self.assertEqual(varint_encode(value), encoded)
+
+    def test_zigzag_vectors(self):
+        for value, encoded in ZIGZAG_VECTORS:
+            self.assertEqual(zigzag_encode(value), encoded)
+
+
+class TestRingEventsDecoder(unittest.TestCase):
+    def setUp(self):
+        self.decoder = RingEventsDecoder({
+            TYPE_ID_NO_DATA: EventType('no_data', [], []),
+            TYPE_ID_DATA: EventType('data', ['u32', 's32'], ['a', 'b']),
+        }, 1000)
+
+    def stream(self, timestamps):
+        """Encode events without data the same way as the device does."""
+        buf = b''
+        last_timestamp = 0
+        for timestamp in timestamps:
+            delta = timestamp_delta(timestamp, last_timestamp)
+            buf += event_record(TYPE_ID_NO_DATA, zigzag_encode(delta))
+            last_timestamp = timestamp
+        return buf
+
+    def timestamps(self, buf):
+        events, consumed = self.decoder.decode(buf)
+        self.assertEqual(consumed, len(buf))
+        return [event.timestamp for event in events]
+
+    def test_varint_decode(self):
+        for value, encoded in VARINT_VECTORS:
+            self.decoder.dropped_events = 0
+            buf = RingEventsDecoder.OVERFLOW_ID.to_bytes(2, 'little') + \
+                encoded
+            events, consumed = self.decoder.decode(buf)
+            self.assertEqual(events, [])
+            self.assertEqual(consumed, len(buf))
+            self.assertEqual(self.decoder.dropped_events, value)
+
+    def test_zigzag_decode(self):
+        for value, encoded in ZIGZAG_VECTORS:
+            self.decoder.reset()
+            self.decoder.timestamp_raw = None
+            self.decoder.timestamp_overflows = 0
+            buf = event_record(TYPE_ID_NO_DATA, encoded)
+            self.assertEqual(self.timestamps(buf), [value % 2**32])
+
+    def test_timestamp_deltas(self):
+        timestamps = [1000, 1010, 1005, 70000, 70000]
+        self.assertEqual(self.timestamps(self.stream(timestamps)),
+                         timestamps)
+
+    def test_timestamp_overflow(self):
+        timestamps = [0xFFFFFFF0, 0x10, 0xFFFFFFFF, 0x20]
+        self.assertEqual(self.timestamps(self.stream(timestamps)),
+                         [0xFFFFFFF0, 2**32 + 0x10, 0xFFFFFFFF,
+                          2**32 + 0x20])
+
+    def test_event_data(self):
+        data = (123456).to_bytes(4, 'little') + \
+            (-5).to_bytes(4, 'little', signed=True)
+        buf = event_record(TYPE_ID_DATA, zigzag_encode(100), data)
+        events, consumed = self.decoder.decode(buf)
+        self.assertEqual(consumed, len(buf))
+        self.assertEqual(len(events), 1)
+        self.assertEqual(events[0].type_id, TYPE_ID_DATA)
+        self.assertEqual(events[0].timestamp, 100)
+        self.assertEqual(events[0].data, [123456, -5])
+
+    def test_overflow_records(self):
+        buf = self.stream([10]) + overflow_record(3) + \
+            event_record(TYPE_ID_NO_DATA, zigzag_encode(5)) + \
+            overflow_record(200)
+        self.assertEqual(self.timestamps(buf), [10, 15])
+        self.assertEqual(self.decoder.dropped_events, 203)
+
+    def test_incomplete_event(self):
+        timestamps = [100, 200000, 50]
+        buf = self.stream(timestamps) + overflow_record(300)
+        decoded = []
+        pending = b''
+        # Feed data byte by byte, as if it was received in small chunks
+        for i in range(len(buf)):
+            pending += buf[i:i + 1]
+            events, consumed = self.decoder.decode(pending)
+            decoded += [event.timestamp for event in events]
+            pending = pending[consumed:]
+        self.assertEqual(pending, b'')
+        self.assertEqual(decoded, timestamps)
+        self.assertEqual(self.decoder.dropped_events, 300)
+
+    def test_reset(self):
+        self.assertEqual(self.timestamps(self.stream([5000, 6000])),
+                         [5000, 6000])
+        # Device encodes first timestamp after restart relative to zero
+        self.decoder.reset()
+        self.assertEqual(self.timestamps(self.stream([9000, 9500])),
+                         [9000, 9500])
+
+    def test_reset_after_overflow(self):
+        self.assertEqual(self.timestamps(self.stream([0xFFFFFF00])),
+                         [0xFFFFFF00])
+        self.decoder.reset()
+        self.assertEqual(self.timestamps(self.stream([0x100])),
+                         [2**32 + 0x100])
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -17,11 +17,16 @@
 #include <debug/ppi_trace.h>
 #include <logging/log.h>
 
+#include "cpu_load_attribution.h"
+
 LOG_MODULE_REGISTER(cpu_load, CONFIG_CPU_LOAD_LOG_LEVEL);
 
 /* Convert event address to associated publish register */
 #define PUBLISH_ADDR(evt) (volatile u32_t *)(evt + 0x80)
 
+/* Number of contexts displayed by the breakdown command. */
+#define BREAKDOWN_CMD_CTX_CNT 10
+
 /* Indicates that channel is not allocated. */
 #define CH_INVALID 0xFF
 
@@ -139,6 +144,14 @@ int cpu_load_init(void)
 		return 0;
 	}
 
+	if (IS_ENABLED(CONFIG_CPU_LOAD_ATTRIBUTION)) {
+		ret = cpu_load_attribution_init();
+		if (ret) {
+			LOG_ERR("Cycle counter not available");
+			return ret;
+		}
+	}
+
 	config.frequency = NRF_TIMER_FREQ_1MHz;
 	config.bit_width = NRF_TIMER_BIT_WIDTH_32;
 
@@ -211,6 +224,10 @@ void cpu_load_reset(void)
 {
 	nrfx_timer_clear(&timer);
 	cycle_ref = k_cycle_get_32();
+
+	if (IS_ENABLED(CONFIG_CPU_LOAD_ATTRIBUTION)) {
+		cpu_load_attribution_reset();
+	}
 }
 
 static u32_t sleep_ticks_to_us(u32_t ticks)
@@ -266,6 +283,33 @@ static int cmd_cpu_load_get(const struct shell *shell, size_t argc, char **argv)
 	return 0;
 }
 
+#ifdef CONFIG_CPU_LOAD_ATTRIBUTION
+static int cmd_cpu_load_breakdown(const struct shell *shell, size_t argc,
+				  char **argv)
+{
+	struct cpu_load_ctx ctxs[BREAKDOWN_CMD_CTX_CNT];
+	int cnt;
+
+	if (!ready) {
+		shell_error(shell, "Not initialized.");
+		return 0;
+	}
+
+	cnt = cpu_load_breakdown_get(ctxs, ARRAY_SIZE(ctxs));
+	if (cnt < 0) {
+		shell_error(shell, "Breakdown not available (err:%d)", cnt);
+		return 0;
+	}
+
+	for (size_t i = 0; i < cnt; i++) {
+		shell_print(shell, "%s:\t%d,%03d%%", ctxs[i].name,
+			    ctxs[i].load / 1000, ctxs[i].load % 1000);
+	}
+
+	return 0;
+}
+#endif /* CONFIG_CPU_LOAD_ATTRIBUTION */
+
 static int cmd_cpu_load_reset(const struct shell *shell,
 				size_t argc, char **argv)
 {
@@ -284,6 +328,9 @@ static int cmd_cpu_load_reset(const struct shell *shell,
 
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_cmd_cpu_load,
 	SHELL_CMD_ARG(get, NULL, "Get load", cmd_cpu_load_get, 1, 0),
+	SHELL_COND_CMD_ARG(CONFIG_CPU_LOAD_ATTRIBUTION, breakdown, NULL,
+			   "Get load of threads and interrupts",
+			   cmd_cpu_load_breakdown, 1, 0),
 	SHELL_CMD_ARG(reset, NULL, "Reset measurement",
 			cmd_cpu_load_reset, 1, 0),
 	SHELL_CMD_ARG(init, NULL, "Init",
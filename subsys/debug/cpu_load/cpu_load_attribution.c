@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+#include <string.h>
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <debug/cpu_load.h>
+
+#include "cpu_load_attribution.h"
+
+/* Interrupts can be nested once for every priority level. */
+#define NESTING_MAX (BIT(CONFIG_NUM_IRQ_PRIO_BITS) + 1)
+
+struct thread_cycles {
+	const struct k_thread *thread;
+	u64_t cycles;
+};
+
+static struct thread_cycles threads[CONFIG_CPU_LOAD_ATTRIBUTION_THREADS];
+static u64_t irq_cycles[CONFIG_NUM_IRQS];
+static u64_t other_cycles;
+
+/* Accumulator of the running context and accumulators of the contexts
+ * preempted by interrupts.
+ */
+static u64_t *cur_cycles = &other_cycles;
+static u64_t *nested_cycles[NESTING_MAX];
+static size_t nesting;
+
+static u32_t last_cyccnt;
+static u32_t ref_cycle;
+
+
+static u64_t *thread_cycles_get(const struct k_thread *thread)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(threads); i++) {
+		if (threads[i].thread == thread) {
+			return &threads[i].cycles;
+		}
+
+		if (threads[i].thread == NULL) {
+			threads[i].thread = thread;
+			return &threads[i].cycles;
+		}
+	}
+
+	return &other_cycles;
+}
+
+/* Called with interrupts locked. */
+static void cycles_charge(void)
+{
+	u32_t cyccnt = DWT->CYCCNT;
+
+	*cur_cycles += (u32_t)(cyccnt - last_cyccnt);
+	last_cyccnt = cyccnt;
+}
+
+/* Kernel tracing hooks, called by the architecture code if CONFIG_TRACING
+ * is enabled.
+ */
+void sys_trace_thread_switched_out(void)
+{
+	unsigned int key = irq_lock();
+
+	cycles_charge();
+
+	irq_unlock(key);
+}
+
+void sys_trace_thread_switched_in(void)
+{
+	unsigned int key = irq_lock();
+
+	cycles_charge();
+	cur_cycles = thread_cycles_get(k_current_get());
+
+	irq_unlock(key);
+}
+
+void sys_trace_isr_enter(void)
+{
+	unsigned int key = irq_lock();
+	int irq = (int)__get_IPSR() - 16;
+
+	cycles_charge();
+
+	if (nesting < ARRAY_SIZE(nested_cycles)) {
+		nested_cycles[nesting] = cur_cycles;
+	}
+	nesting++;
+
+	cur_cycles = ((irq >= 0) && (irq < ARRAY_SIZE(irq_cycles))) ?
+		     &irq_cycles[irq] : &other_cycles;
+
+	irq_unlock(key);
+}
+
+void sys_trace_isr_exit(void)
+{
+	unsigned int key = irq_lock();
+
+	cycles_charge();
+
+	/* Exit may be traced without matching enter, for example for
+	 * an interrupt that was entered before the tracing hooks started
+	 * to be called.
+	 */
+	if (nesting > 0) {
+		nesting--;
+		cur_cycles = (nesting < ARRAY_SIZE(nested_cycles)) ?
+			     nested_cycles[nesting] : &other_cycles;
+	}
+
+	irq_unlock(key);
+}
+
+void sys_trace_idle(void)
+{
+	unsigned int key = irq_lock();
+
+	cycles_charge();
+
+	irq_unlock(key);
+}
+
+int cpu_load_attribution_init(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+
+	if (DWT->CTRL & DWT_CTRL_NOCYCCNT_Msk) {
+		return -ENOTSUP;
+	}
+
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	cpu_load_attribution_reset();
+
+	return 0;
+}
+
+void cpu_load_attribution_reset(void)
+{
+	unsigned int key = irq_lock();
+
+	memset(threads, 0, sizeof(threads));
+	memset(irq_cycles, 0, sizeof(irq_cycles));
+	other_cycles = 0;
+
+	/* Called from a thread, so no interrupt is preempted. */
+	last_cyccnt = DWT->CYCCNT;
+	cur_cycles = thread_cycles_get(k_current_get());
+	ref_cycle = k_cycle_get_32();
+
+	irq_unlock(key);
+}
+
+/* Insert a context into the array sorted by load, dropping the least
+ * loaded context if the array is full.
+ */
+static size_t ctx_insert(struct cpu_load_ctx *ctxs, size_t len, size_t cnt,
+			 const struct cpu_load_ctx *ctx)
+{
+	size_t pos = len;
+
+	while ((pos > 0) && (ctxs[pos - 1].load < ctx->load)) {
+		pos--;
+	}
+
+	if (pos >= cnt) {
+		return len;
+	}
+
+	if (len == cnt) {
+		len--;
+	}
+
+	memmove(&ctxs[pos + 1], &ctxs[pos], (len - pos) * sizeof(ctxs[0]));
+	ctxs[pos] = *ctx;
+
+	return len + 1;
+}
+
+static u32_t cycles_to_load(u64_t cycles, u64_t total_cycles)
+{
+	return (total_cycles > 0) ? (u32_t)((cycles * 100000) / total_cycles) :
+				    0;
+}
+
+struct thread_find {
+	const struct k_thread *thread;
+	bool found;
+};
+
+static void thread_find_cb(const struct k_thread *thread, void *user_data)
+{
+	struct thread_find *tf = user_data;
+
+	if (thread == tf->thread) {
+		tf->found = true;
+	}
+}
+
+static bool thread_exists(const struct k_thread *thread)
+{
+	struct thread_find tf = {
+		.thread = thread,
+		.found = false,
+	};
+
+	/* Threads can be found only if CONFIG_THREAD_MONITOR is enabled. */
+	k_thread_foreach(thread_find_cb, &tf);
+
+	return tf.found;
+}
+
+static void ctx_name_fill(struct cpu_load_ctx *ctx)
+{
+	const char *name = NULL;
+
+	switch (ctx->type) {
+	case CPU_LOAD_CTX_THREAD:
+		/* Thread may not exist anymore, so its name is used only if
+		 * the thread is found.
+		 */
+		if (thread_exists(ctx->id.thread)) {
+			name = k_thread_name_get((k_tid_t)ctx->id.thread);
+		}
+
+		if (name && (name[0] != '\0')) {
+			strncpy(ctx->name, name, sizeof(ctx->name) - 1);
+			ctx->name[sizeof(ctx->name) - 1] = '\0';
+		} else {
+			snprintk(ctx->name, sizeof(ctx->name), "%p",
+				 ctx->id.thread);
+		}
+		break;
+
+	case CPU_LOAD_CTX_IRQ:
+		snprintk(ctx->name, sizeof(ctx->name), "irq %u", ctx->id.irq);
+		break;
+
+	default:
+		strcpy(ctx->name, "other");
+		break;
+	}
+}
+
+int cpu_load_breakdown_get(struct cpu_load_ctx *ctxs, size_t cnt)
+{
+	struct cpu_load_ctx ctx;
+	u64_t total_cycles;
+	size_t len = 0;
+
+	if (!ctxs && (cnt > 0)) {
+		return -EINVAL;
+	}
+
+	memset(&ctx, 0, sizeof(ctx));
+
+	unsigned int key = irq_lock();
+
+	cycles_charge();
+
+	total_cycles = ((u64_t)(k_cycle_get_32() - ref_cycle) *
+			SystemCoreClock) / sys_clock_hw_cycles_per_sec();
+
+	ctx.type = CPU_LOAD_CTX_THREAD;
+	for (size_t i = 0; i < ARRAY_SIZE(threads); i++) {
+		if ((threads[i].thread == NULL) || (threads[i].cycles == 0)) {
+			continue;
+		}
+
+		ctx.id.thread = threads[i].thread;
+		ctx.load = cycles_to_load(threads[i].cycles, total_cycles);
+		len = ctx_insert(ctxs, len, cnt, &ctx);
+	}
+
+	ctx.type = CPU_LOAD_CTX_IRQ;
+	for (size_t i = 0; i < ARRAY_SIZE(irq_cycles); i++) {
+		if (irq_cycles[i] == 0) {
+			continue;
+		}
+
+		ctx.id.irq = i;
+		ctx.load = cycles_to_load(irq_cycles[i], total_cycles);
+		len = ctx_insert(ctxs, len, cnt, &ctx);
+	}
+
+	if (other_cycles > 0) {
+		ctx.type = CPU_LOAD_CTX_OTHER;
+		ctx.id.thread = NULL;
+		ctx.load = cycles_to_load(other_cycles, total_cycles);
+		len = ctx_insert(ctxs, len, cnt, &ctx);
+	}
+
+	irq_unlock(key);
+
+	/* Names are filled without interrupts locked. */
+	for (size_t i = 0; i < len; i++) {
+		ctx_name_fill(&ctxs[i]);
+	}
+
+	return len;
+}
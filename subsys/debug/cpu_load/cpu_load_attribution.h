@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+/* CPU load attribution to threads and interrupts.
+ *
+ * Functions are used by the CPU load module only.
+ */
+
+#ifndef _CPU_LOAD_ATTRIBUTION_H_
+#define _CPU_LOAD_ATTRIBUTION_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Start the cycle counter. */
+int cpu_load_attribution_init(void);
+
+/* Clear cycles accumulated by threads and interrupts. */
+void cpu_load_attribution_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CPU_LOAD_ATTRIBUTION_H_ */
@@ -11,6 +11,8 @@
 #include <event_manager.h>
 #include <logging/log.h>
 
+#include "event_manager_pool.h"
+
 LOG_MODULE_REGISTER(event_manager, CONFIG_DESKTOP_EVENT_MANAGER_LOG_LEVEL);
 
 
@@ -29,9 +31,73 @@ extern u32_t event_manager_displayed_events;
 static u32_t event_manager_displayed_events;
 #endif
 
+#ifdef CONFIG_DESKTOP_EVENT_MANAGER_DISPATCH_CLASSES
+#define EVENT_QUEUE_CNT EVENT_DISPATCH_CLASS_COUNT
+#else
+#define EVENT_QUEUE_CNT 1
+#endif
+
+struct event_queue_stats_priv {
+	u32_t processed;
+	u32_t coalesced;
+	u32_t depth;
+	u32_t max_depth;
+	u32_t latency_max_us;
+	u64_t latency_sum_us;
+};
+
+struct event_queue {
+	sys_slist_t events;
+	struct k_work work;
+	struct k_work_q *work_q;
+#ifdef CONFIG_DESKTOP_EVENT_MANAGER_QUEUE_STATS
+	struct event_queue_stats_priv stats;
+#endif
+};
+
+#define EVENT_QUEUE_INITIALIZER(_queue, _work_q)			\
+	{								\
+		.events	= SYS_SLIST_STATIC_INIT(&_queue.events),	\
+		.work	= Z_WORK_INITIALIZER(event_processor_fn),	\
+		.work_q	= _work_q,					\
+	}
+
+#ifdef CONFIG_DESKTOP_EVENT_MANAGER_DISPATCH_CLASSES
+#define EVENT_WORK_Q_DEFINE(cls)							\
+	static K_THREAD_STACK_DEFINE(_CONCAT(cls, _stack_area),			\
+		_CONCAT(_CONCAT(CONFIG_DESKTOP_EVENT_MANAGER_, cls),		\
+			_THREAD_STACK_SIZE));					\
+	static struct k_work_q _CONCAT(cls, _work_q)
+
+#define EVENT_WORK_Q_START(cls)							\
+	k_work_q_start(&_CONCAT(cls, _work_q), _CONCAT(cls, _stack_area),	\
+		       K_THREAD_STACK_SIZEOF(_CONCAT(cls, _stack_area)),	\
+		       _CONCAT(_CONCAT(CONFIG_DESKTOP_EVENT_MANAGER_, cls),	\
+			       _THREAD_PRIORITY));				\
+	k_thread_name_set(&_CONCAT(cls, _work_q).thread,			\
+			  STRINGIFY(_CONCAT(event_manager_, cls)))
+
+EVENT_WORK_Q_DEFINE(REALTIME);
+EVENT_WORK_Q_DEFINE(NORMAL);
+EVENT_WORK_Q_DEFINE(BACKGROUND);
+
+static struct event_queue event_queues[EVENT_QUEUE_CNT] = {
+	[EVENT_DISPATCH_CLASS_REALTIME] = EVENT_QUEUE_INITIALIZER(
+		event_queues[EVENT_DISPATCH_CLASS_REALTIME], &REALTIME_work_q),
+	[EVENT_DISPATCH_CLASS_NORMAL] = EVENT_QUEUE_INITIALIZER(
+		event_queues[EVENT_DISPATCH_CLASS_NORMAL], &NORMAL_work_q),
+	[EVENT_DISPATCH_CLASS_BACKGROUND] = EVENT_QUEUE_INITIALIZER(
+		event_queues[EVENT_DISPATCH_CLASS_BACKGROUND], &BACKGROUND_work_q),
+};
+#else
+static struct event_queue event_queues[EVENT_QUEUE_CNT] = {
+	EVENT_QUEUE_INITIALIZER(event_queues[0], &k_sys_work_q),
+};
+#endif /* CONFIG_DESKTOP_EVENT_MANAGER_DISPATCH_CLASSES */
+
+BUILD_ASSERT(EVENT_QUEUE_CNT <= 32, "Queues do not fit the wakeup mask");
+
 static u16_t profiler_event_ids[IDS_COUNT];
-static K_WORK_DEFINE(event_processor, event_processor_fn);
-static sys_slist_t eventq = SYS_SLIST_STATIC_INIT(&eventq);
 static struct k_spinlock lock;
 
 
@@ -69,26 +135,20 @@ static void log_event(const struct event_header *eh)
 	}
 }
 
-static void log_event_progress(const struct event_type *et,
-			       const struct event_listener *el)
+static bool log_is_event_progress_displayed(const struct event_type *et)
 {
-	if (!IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_SHOW_EVENTS) ||
-	    !IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_SHOW_EVENT_HANDLERS) ||
-	    !log_is_event_displayed(et)) {
-		return;
-	}
+	return IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_SHOW_EVENTS) &&
+	       IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_SHOW_EVENT_HANDLERS) &&
+	       log_is_event_displayed(et);
+}
 
+static void log_event_progress(const struct event_listener *el)
+{
 	LOG_INF("|\tnotifying %s", el->name);
 }
 
-static void log_event_consumed(const struct event_type *et)
+static void log_event_consumed(void)
 {
-	if (!IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_SHOW_EVENTS) ||
-	    !IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_SHOW_EVENT_HANDLERS) ||
-	    !log_is_event_displayed(et)) {
-		return;
-	}
-
 	LOG_INF("|\tevent consumed");
 }
 
@@ -110,12 +170,15 @@ static void log_event_init(void)
 
 static void trace_event_execution(const struct event_header *eh, bool is_start)
 {
+	if (!IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_TRACE_EVENT_EXECUTION)) {
+		return;
+	}
+
 	size_t event_cnt = __stop_event_types - __start_event_types;
 	size_t event_idx = event_cnt + (is_start ? 0 : 1);
 	size_t trace_evt_id = profiler_event_ids[event_idx];
 
-	if (!IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_TRACE_EVENT_EXECUTION) ||
-	    !is_profiling_enabled(trace_evt_id)) {
+	if (!is_profiling_enabled(trace_evt_id)) {
 		return;
 	}
 
@@ -217,19 +280,149 @@ static int trace_event_init(void)
 	return 0;
 }
 
+static struct event_queue *event_queue_get(const struct event_type *et)
+{
+	if (IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_DISPATCH_CLASSES)) {
+		__ASSERT_NO_MSG(et->dispatch_class < EVENT_QUEUE_CNT);
+		return &event_queues[et->dispatch_class];
+	}
+
+	return &event_queues[0];
+}
+
+static void stats_event_submitted(struct event_queue *queue,
+				  struct event_header *eh)
+{
+#ifdef CONFIG_DESKTOP_EVENT_MANAGER_QUEUE_STATS
+	/* Called with the lock taken. */
+	struct event_queue_stats_priv *stats = &queue->stats;
+
+	eh->submit_cycles = k_cycle_get_32();
+	stats->depth++;
+	if (stats->depth > stats->max_depth) {
+		stats->max_depth = stats->depth;
+	}
+#endif
+}
+
+static void stats_event_coalesced(struct event_queue *queue)
+{
+#ifdef CONFIG_DESKTOP_EVENT_MANAGER_QUEUE_STATS
+	/* Called with the lock taken. */
+	queue->stats.coalesced++;
+#endif
+}
+
+static void stats_event_processing(struct event_queue *queue,
+				   const struct event_header *eh)
+{
+#ifdef CONFIG_DESKTOP_EVENT_MANAGER_QUEUE_STATS
+	struct event_queue_stats_priv *stats = &queue->stats;
+	u32_t latency_us = k_cyc_to_us_floor32(k_cycle_get_32() -
+					       eh->submit_cycles);
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	__ASSERT_NO_MSG(stats->depth > 0);
+	stats->depth--;
+	stats->processed++;
+	stats->latency_sum_us += latency_us;
+	if (latency_us > stats->latency_max_us) {
+		stats->latency_max_us = latency_us;
+	}
+
+	k_spin_unlock(&lock, key);
+#endif
+}
+
+#ifdef CONFIG_DESKTOP_EVENT_MANAGER_LATENCY_STATS
+static void latency_hist_add(struct event_latency_hist *hist, u32_t cycles)
+{
+	u32_t time_us = k_cyc_to_us_floor32(cycles);
+	size_t idx = (time_us > 0) ? (31 - __builtin_clz(time_us)) : 0;
+
+	atomic_inc(&hist->buckets[MIN(idx, EVENT_LATENCY_HIST_BUCKET_CNT - 1)]);
+
+	atomic_val_t max_us;
+
+	do {
+		max_us = atomic_get(&hist->max_us);
+		if (time_us <= (u32_t)max_us) {
+			return;
+		}
+	} while (!atomic_cas(&hist->max_us, max_us, time_us));
+}
+
+static void latency_hist_get(const struct event_latency_hist *hist,
+			     struct event_latency_stats *stats)
+{
+	stats->cnt = 0;
+	for (size_t i = 0; i < EVENT_LATENCY_HIST_BUCKET_CNT; i++) {
+		stats->buckets[i] = atomic_get(&hist->buckets[i]);
+		stats->cnt += stats->buckets[i];
+	}
+	stats->max_us = atomic_get(&hist->max_us);
+}
+
+static void latency_hist_reset(struct event_latency_hist *hist)
+{
+	for (size_t i = 0; i < EVENT_LATENCY_HIST_BUCKET_CNT; i++) {
+		atomic_clear(&hist->buckets[i]);
+	}
+	atomic_clear(&hist->max_us);
+}
+#endif /* CONFIG_DESKTOP_EVENT_MANAGER_LATENCY_STATS */
+
+static u32_t latency_cycles_get(void)
+{
+	if (!IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_LATENCY_STATS)) {
+		return 0;
+	}
+
+	return k_cycle_get_32();
+}
+
+static void latency_event_processing(const struct event_header *eh,
+				     u32_t start)
+{
+#ifdef CONFIG_DESKTOP_EVENT_MANAGER_LATENCY_STATS
+	latency_hist_add(&eh->type_id->latency->wait,
+			 start - eh->submit_cycles);
+#endif
+}
+
+static void latency_event_processed(const struct event_header *eh,
+				    u32_t start)
+{
+#ifdef CONFIG_DESKTOP_EVENT_MANAGER_LATENCY_STATS
+	latency_hist_add(&eh->type_id->latency->exec,
+			 k_cycle_get_32() - start);
+#endif
+}
+
+static void latency_listener_notified(const struct event_listener *el,
+				      u32_t start)
+{
+#ifdef CONFIG_DESKTOP_EVENT_MANAGER_LATENCY_STATS
+	latency_hist_add(el->latency, k_cycle_get_32() - start);
+#endif
+}
+
 static void event_processor_fn(struct k_work *work)
 {
+	struct event_queue *queue = CONTAINER_OF(work, struct event_queue,
+						 work);
 	sys_slist_t events = SYS_SLIST_STATIC_INIT(&events);
 
 	/* Make current event list local. */
 	k_spinlock_key_t key = k_spin_lock(&lock);
 
-	if (sys_slist_is_empty(&eventq)) {
+	if (sys_slist_is_empty(&queue->events)) {
 		k_spin_unlock(&lock, key);
 		return;
 	}
 
-	sys_slist_merge_slist(&events, &eventq);
+	sys_slist_merge_slist(&events, &queue->events);
 
 	k_spin_unlock(&lock, key);
 
@@ -245,41 +438,110 @@ static void event_processor_fn(struct k_work *work)
 
 		const struct event_type *et = eh->type_id;
 
+		stats_event_processing(queue, eh);
+
 		trace_event_execution(eh, true);
 
 		log_event(eh);
 
-		bool consumed = false;
+		/* Subscribers of all priorities form a single array. */
+		const struct event_subscriber *es = et->subs_start[SUBS_PRIO_MIN];
+		const struct event_subscriber *es_stop = et->subs_stop[SUBS_PRIO_MAX];
+		const bool log_progress = log_is_event_progress_displayed(et);
+		const u32_t exec_start = latency_cycles_get();
 
-		for (size_t prio = SUBS_PRIO_MIN;
-		     (prio <= SUBS_PRIO_MAX) && !consumed;
-		     prio++) {
-			for (const struct event_subscriber *es =
-					et->subs_start[prio];
-			     (es != et->subs_stop[prio]) && !consumed;
-			     es++) {
+		latency_event_processing(eh, exec_start);
 
-				__ASSERT_NO_MSG(es != NULL);
+		for (; es != es_stop; es++) {
+			const struct event_listener *el = es->listener;
 
-				const struct event_listener *el = es->listener;
+			__ASSERT_NO_MSG(el != NULL);
+			__ASSERT_NO_MSG(el->notification != NULL);
 
-				__ASSERT_NO_MSG(el != NULL);
-				__ASSERT_NO_MSG(el->notification != NULL);
+			if (log_progress) {
+				log_event_progress(el);
+			}
 
-				log_event_progress(et, el);
+			u32_t notify_start = latency_cycles_get();
+			bool consumed = el->notification(eh);
 
-				consumed = el->notification(eh);
+			latency_listener_notified(el, notify_start);
 
-				if (consumed) {
-					log_event_consumed(et);
+			if (consumed) {
+				if (log_progress) {
+					log_event_consumed();
 				}
+				break;
 			}
 		}
 
+		latency_event_processed(eh, exec_start);
+
 		trace_event_execution(eh, false);
 
-		k_free(eh);
+		event_manager_free(eh);
+	}
+}
+
+void *event_manager_alloc(size_t size)
+{
+	void *event;
+
+	if (IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_EVENT_POOL)) {
+		event = event_pool_alloc(size);
+	} else {
+		event = k_malloc(size);
+	}
+
+	if (unlikely(!event)) {
+		printk("Event Manager OOM error\n");
+		LOG_PANIC();
+		__ASSERT_NO_MSG(false);
+		sys_reboot(SYS_REBOOT_WARM);
+		return NULL;
+	}
+
+	return event;
+}
+
+void event_manager_free(void *addr)
+{
+	if (IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_EVENT_POOL)) {
+		event_pool_free(addr);
+	} else {
+		k_free(addr);
+	}
+}
+
+/* Called with the lock taken. Returns true if the event was merged into
+ * the last queued event and must be freed.
+ */
+static bool event_enqueue(struct event_queue *queue, struct event_header *eh)
+{
+	const struct event_type *et = eh->type_id;
+
+	if (et->coalesce) {
+		/* Events at the queue tail are not dispatched yet, the
+		 * processor takes the whole list before notifying listeners.
+		 */
+		sys_snode_t *tail = sys_slist_peek_tail(&queue->events);
+
+		if (tail) {
+			struct event_header *queued =
+				CONTAINER_OF(tail, struct event_header, node);
+
+			if ((queued->type_id == et) &&
+			    et->coalesce(queued, eh)) {
+				stats_event_coalesced(queue);
+				return true;
+			}
+		}
 	}
+
+	stats_event_submitted(queue, eh);
+	sys_slist_append(&queue->events, &eh->node);
+
+	return false;
 }
 
 void _event_submit(struct event_header *eh)
@@ -289,15 +551,210 @@ void _event_submit(struct event_header *eh)
 
 	trace_event_submission(eh);
 
+	struct event_queue *queue = event_queue_get(eh->type_id);
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	bool merged = event_enqueue(queue, eh);
+	k_spin_unlock(&lock, key);
+
+	if (merged) {
+		/* Queue is not empty, so its work is already submitted. */
+		event_manager_free(eh);
+	} else {
+		k_work_submit_to_queue(queue->work_q, &queue->work);
+	}
+}
+
+void _event_submit_batch(struct event_header *const *ehs, size_t cnt)
+{
+	__ASSERT_NO_MSG(ehs || (cnt == 0));
+
+	sys_slist_t merged = SYS_SLIST_STATIC_INIT(&merged);
+	u32_t wakeup_mask = 0;
+
+	for (size_t i = 0; i < cnt; i++) {
+		__ASSERT_NO_MSG(ehs[i]);
+		ASSERT_EVENT_ID(ehs[i]->type_id);
+
+		trace_event_submission(ehs[i]);
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	for (size_t i = 0; i < cnt; i++) {
+		struct event_queue *queue = event_queue_get(ehs[i]->type_id);
+
+		if (event_enqueue(queue, ehs[i])) {
+			/* Node of the merged event is not used anymore. */
+			sys_slist_append(&merged, &ehs[i]->node);
+		} else {
+			wakeup_mask |= BIT(queue - event_queues);
+		}
+	}
+
+	k_spin_unlock(&lock, key);
+
+	sys_snode_t *node;
+
+	while (NULL != (node = sys_slist_get(&merged))) {
+		event_manager_free(CONTAINER_OF(node, struct event_header,
+						node));
+	}
+
+	for (size_t i = 0; i < EVENT_QUEUE_CNT; i++) {
+		if (wakeup_mask & BIT(i)) {
+			k_work_submit_to_queue(event_queues[i].work_q,
+					       &event_queues[i].work);
+		}
+	}
+}
+
+size_t event_manager_queue_cnt(void)
+{
+	return EVENT_QUEUE_CNT;
+}
+
+int event_manager_queue_stats_get(size_t queue_idx,
+				  struct event_queue_stats *stats)
+{
+	if (!IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_QUEUE_STATS)) {
+		return -ENOTSUP;
+	}
+
+	if ((queue_idx >= EVENT_QUEUE_CNT) || !stats) {
+		return -EINVAL;
+	}
+
+#ifdef CONFIG_DESKTOP_EVENT_MANAGER_QUEUE_STATS
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	struct event_queue_stats_priv priv = event_queues[queue_idx].stats;
+	k_spin_unlock(&lock, key);
+
+	stats->processed = priv.processed;
+	stats->coalesced = priv.coalesced;
+	stats->depth = priv.depth;
+	stats->max_depth = priv.max_depth;
+	stats->latency_max_us = priv.latency_max_us;
+	stats->latency_avg_us = (priv.processed > 0) ?
+		(u32_t)(priv.latency_sum_us / priv.processed) : 0;
+#endif
+
+	return 0;
+}
+
+void event_manager_queue_stats_reset(void)
+{
+#ifdef CONFIG_DESKTOP_EVENT_MANAGER_QUEUE_STATS
 	k_spinlock_key_t key = k_spin_lock(&lock);
-	sys_slist_append(&eventq, &eh->node);
+
+	for (size_t i = 0; i < EVENT_QUEUE_CNT; i++) {
+		struct event_queue_stats_priv *stats = &event_queues[i].stats;
+
+		stats->processed = 0;
+		stats->coalesced = 0;
+		stats->max_depth = stats->depth;
+		stats->latency_max_us = 0;
+		stats->latency_sum_us = 0;
+	}
+
 	k_spin_unlock(&lock, key);
+#endif
+}
+
+int event_manager_event_latency_get(const struct event_type *et,
+				    struct event_latency_stats *wait,
+				    struct event_latency_stats *exec)
+{
+	if (!IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_LATENCY_STATS)) {
+		return -ENOTSUP;
+	}
+
+	if ((et < __start_event_types) || (et >= __stop_event_types)) {
+		return -EINVAL;
+	}
+
+#ifdef CONFIG_DESKTOP_EVENT_MANAGER_LATENCY_STATS
+	if (wait) {
+		latency_hist_get(&et->latency->wait, wait);
+	}
+	if (exec) {
+		latency_hist_get(&et->latency->exec, exec);
+	}
+#endif
+
+	return 0;
+}
+
+int event_manager_listener_latency_get(const struct event_listener *el,
+				       struct event_latency_stats *exec)
+{
+	if (!IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_LATENCY_STATS)) {
+		return -ENOTSUP;
+	}
+
+	if ((el < __start_event_listeners) ||
+	    (el >= __stop_event_listeners) || !exec) {
+		return -EINVAL;
+	}
 
-	k_work_submit(&event_processor);
+#ifdef CONFIG_DESKTOP_EVENT_MANAGER_LATENCY_STATS
+	latency_hist_get(el->latency, exec);
+#endif
+
+	return 0;
+}
+
+void event_manager_latency_stats_reset(void)
+{
+#ifdef CONFIG_DESKTOP_EVENT_MANAGER_LATENCY_STATS
+	for (const struct event_type *et = __start_event_types;
+	     (et != NULL) && (et != __stop_event_types);
+	     et++) {
+		latency_hist_reset(&et->latency->wait);
+		latency_hist_reset(&et->latency->exec);
+	}
+
+	for (const struct event_listener *el = __start_event_listeners;
+	     el != __stop_event_listeners;
+	     el++) {
+		latency_hist_reset(el->latency);
+	}
+#endif
+}
+
+u32_t event_latency_percentile_us(const struct event_latency_stats *stats,
+				  u8_t percent)
+{
+	__ASSERT_NO_MSG(stats);
+	__ASSERT_NO_MSG(percent <= 100);
+
+	/* Number of samples not longer than the percentile, rounded up. */
+	u32_t rank = ((u64_t)stats->cnt * percent + 99) / 100;
+	u32_t sum = 0;
+
+	for (size_t i = 0; i < EVENT_LATENCY_HIST_BUCKET_CNT - 1; i++) {
+		sum += stats->buckets[i];
+		if ((sum > 0) && (sum >= rank)) {
+			return MIN(BIT(i + 1), stats->max_us);
+		}
+	}
+
+	return stats->max_us;
+}
+
+static void dispatch_threads_start(void)
+{
+#ifdef CONFIG_DESKTOP_EVENT_MANAGER_DISPATCH_CLASSES
+	EVENT_WORK_Q_START(REALTIME);
+	EVENT_WORK_Q_START(NORMAL);
+	EVENT_WORK_Q_START(BACKGROUND);
+#endif
 }
 
 int event_manager_init(void)
 {
+	dispatch_threads_start();
+
 	log_event_init();
 
 	return trace_event_init();
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <zephyr.h>
+#include <sys/atomic.h>
+#include <sys/util.h>
+
+#include "event_manager_pool.h"
+
+
+/* Alignment of pool blocks. Events may contain 64-bit fields. */
+#define EVENT_POOL_ALIGN	8
+
+/* Free list head holds index of the first free block in lower half-word
+ * and a tag in upper half-word. The tag is changed on every update to
+ * prevent ABA problem when the list is modified from an interrupt.
+ */
+#define FREE_LIST_IDX_MASK	0x0000FFFF
+#define FREE_LIST_TAG_INC	0x00010000
+#define FREE_LIST_END		0xFFFF
+
+
+#define EVENT_POOL_BLOCK_SIZE(cls)						\
+	ROUND_UP(_CONCAT(_CONCAT(CONFIG_DESKTOP_EVENT_MANAGER_EVENT_POOL_, cls),\
+			 _BLOCK_SIZE),						\
+		 EVENT_POOL_ALIGN)
+
+#define EVENT_POOL_BLOCK_CNT(cls) \
+	_CONCAT(_CONCAT(CONFIG_DESKTOP_EVENT_MANAGER_EVENT_POOL_, cls), _BLOCK_CNT)
+
+#define EVENT_POOL_BUF_DEFINE(cls)						\
+	static u8_t _CONCAT(pool_buf_, cls)					\
+		[EVENT_POOL_BLOCK_CNT(cls) * EVENT_POOL_BLOCK_SIZE(cls)]	\
+		__aligned(EVENT_POOL_ALIGN);					\
+	static u16_t _CONCAT(pool_next_, cls)[EVENT_POOL_BLOCK_CNT(cls)]
+
+#define EVENT_POOL_INITIALIZER(cls)						\
+	{									\
+		.buf		= _CONCAT(pool_buf_, cls),			\
+		.next		= _CONCAT(pool_next_, cls),			\
+		.block_size	= EVENT_POOL_BLOCK_SIZE(cls),			\
+		.block_cnt	= EVENT_POOL_BLOCK_CNT(cls),			\
+		.free_head	= ATOMIC_INIT(FREE_LIST_END),			\
+	}
+
+
+struct event_pool {
+	u8_t *const buf;
+	u16_t *const next;
+	const size_t block_size;
+	const size_t block_cnt;
+
+	/* Head of the list of freed blocks. */
+	atomic_t free_head;
+
+	/* Number of blocks taken from the pool at least once. Blocks are
+	 * carved from the buffer on first use, so no initialization of
+	 * the free list is needed.
+	 */
+	atomic_t carved;
+
+	atomic_t used;
+	atomic_t max_used;
+	atomic_t exhausted_cnt;
+};
+
+
+BUILD_ASSERT(EVENT_POOL_BLOCK_SIZE(SMALL) <= EVENT_POOL_BLOCK_SIZE(MEDIUM),
+	     "Small block must not be bigger than medium block");
+BUILD_ASSERT(EVENT_POOL_BLOCK_SIZE(MEDIUM) <= EVENT_POOL_BLOCK_SIZE(LARGE),
+	     "Medium block must not be bigger than large block");
+
+EVENT_POOL_BUF_DEFINE(SMALL);
+EVENT_POOL_BUF_DEFINE(MEDIUM);
+EVENT_POOL_BUF_DEFINE(LARGE);
+
+/* Pools are sorted by block size. */
+static struct event_pool pools[] = {
+	EVENT_POOL_INITIALIZER(SMALL),
+	EVENT_POOL_INITIALIZER(MEDIUM),
+	EVENT_POOL_INITIALIZER(LARGE),
+};
+
+static atomic_t heap_alloc_cnt;
+
+
+static inline atomic_val_t free_list_head(atomic_val_t old_head, u16_t idx)
+{
+	return (atomic_val_t)(((u32_t)old_head + FREE_LIST_TAG_INC) &
+			      ~FREE_LIST_IDX_MASK) | idx;
+}
+
+static void update_max_used(struct event_pool *pool, atomic_val_t used)
+{
+	atomic_val_t max_used;
+
+	do {
+		max_used = atomic_get(&pool->max_used);
+		if (used <= max_used) {
+			return;
+		}
+	} while (!atomic_cas(&pool->max_used, max_used, used));
+}
+
+static void *pool_block_get(struct event_pool *pool)
+{
+	atomic_val_t head;
+	u16_t idx;
+
+	do {
+		head = atomic_get(&pool->free_head);
+		idx = head & FREE_LIST_IDX_MASK;
+
+		if (idx == FREE_LIST_END) {
+			break;
+		}
+	} while (!atomic_cas(&pool->free_head, head,
+			     free_list_head(head, pool->next[idx])));
+
+	if (idx == FREE_LIST_END) {
+		/* No freed block, use one that was never used. */
+		atomic_val_t carved;
+
+		do {
+			carved = atomic_get(&pool->carved);
+			if (carved >= pool->block_cnt) {
+				return NULL;
+			}
+		} while (!atomic_cas(&pool->carved, carved, carved + 1));
+
+		idx = carved;
+	}
+
+	update_max_used(pool, atomic_inc(&pool->used) + 1);
+
+	return &pool->buf[idx * pool->block_size];
+}
+
+static void pool_block_put(struct event_pool *pool, u16_t idx)
+{
+	atomic_val_t head;
+
+	/* Decrement before the block is visible on the list, so the number
+	 * of used blocks never exceeds the pool size.
+	 */
+	atomic_dec(&pool->used);
+
+	do {
+		head = atomic_get(&pool->free_head);
+		pool->next[idx] = head & FREE_LIST_IDX_MASK;
+	} while (!atomic_cas(&pool->free_head, head,
+			     free_list_head(head, idx)));
+}
+
+void *event_pool_alloc(size_t size)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(pools); i++) {
+		struct event_pool *pool = &pools[i];
+
+		if ((pool->block_size < size) || (pool->block_cnt == 0)) {
+			continue;
+		}
+
+		void *block = pool_block_get(pool);
+
+		if (block) {
+			return block;
+		}
+
+		atomic_inc(&pool->exhausted_cnt);
+	}
+
+	if (!IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_EVENT_POOL_HEAP_FALLBACK)) {
+		return NULL;
+	}
+
+	void *addr = k_malloc(size);
+
+	if (addr) {
+		atomic_inc(&heap_alloc_cnt);
+	}
+
+	return addr;
+}
+
+void event_pool_free(void *addr)
+{
+	uintptr_t a = (uintptr_t)addr;
+
+	for (size_t i = 0; i < ARRAY_SIZE(pools); i++) {
+		struct event_pool *pool = &pools[i];
+		uintptr_t start = (uintptr_t)pool->buf;
+		uintptr_t end = start + pool->block_cnt * pool->block_size;
+
+		if ((a >= start) && (a < end)) {
+			__ASSERT_NO_MSG(((a - start) % pool->block_size) == 0);
+			pool_block_put(pool, (a - start) / pool->block_size);
+			return;
+		}
+	}
+
+	k_free(addr);
+}
+
+size_t event_pool_cnt(void)
+{
+	return ARRAY_SIZE(pools);
+}
+
+void event_pool_stats_get(size_t pool_idx, struct event_pool_stats *stats)
+{
+	__ASSERT_NO_MSG(pool_idx < ARRAY_SIZE(pools));
+	__ASSERT_NO_MSG(stats);
+
+	struct event_pool *pool = &pools[pool_idx];
+
+	stats->block_size = pool->block_size;
+	stats->block_cnt = pool->block_cnt;
+	stats->used = atomic_get(&pool->used);
+	stats->max_used = atomic_get(&pool->max_used);
+	stats->exhausted_cnt = atomic_get(&pool->exhausted_cnt);
+}
+
+u32_t event_pool_heap_alloc_cnt(void)
+{
+	return atomic_get(&heap_alloc_cnt);
+}
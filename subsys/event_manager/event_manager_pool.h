@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+/* Event manager fixed-block pools.
+ *
+ * Functions are used by Event Manager and its shell only.
+ */
+
+#ifndef _EVENT_MANAGER_POOL_H_
+#define _EVENT_MANAGER_POOL_H_
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Event pool statistics. */
+struct event_pool_stats {
+	/* Size of a single block. */
+	size_t block_size;
+
+	/* Number of blocks in the pool. */
+	size_t block_cnt;
+
+	/* Number of blocks currently in use. */
+	size_t used;
+
+	/* Highest number of blocks used at once. */
+	size_t max_used;
+
+	/* Number of allocations that did not find a free block. */
+	u32_t exhausted_cnt;
+};
+
+
+/* Allocate memory for an event.
+ *
+ * Event is allocated from the smallest pool block that fits the event.
+ * If the pool is exhausted, larger blocks are used. If no block is
+ * available, the heap is used if fallback is enabled.
+ *
+ * Function can be called from an interrupt.
+ *
+ * Returns NULL if memory cannot be allocated.
+ */
+void *event_pool_alloc(size_t size);
+
+/* Free memory allocated with event_pool_alloc. */
+void event_pool_free(void *addr);
+
+/* Get number of pools. */
+size_t event_pool_cnt(void);
+
+/* Get statistics of the pool of given index. Pools are sorted by block
+ * size.
+ */
+void event_pool_stats_get(size_t pool_idx, struct event_pool_stats *stats);
+
+/* Get number of events allocated from the heap since boot. */
+u32_t event_pool_heap_alloc_cnt(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _EVENT_MANAGER_POOL_H_ */
@@ -26,48 +26,60 @@ extern "C" {
 #define _SUBS_PRIO_FINAL  2
 
 
-/* Convenience macros generating section names. */
+/* Subscribers of an event type are placed in sections sorted by name by the
+ * linker (see em_subscribers.ld), so that subscribers of all priorities form
+ * a single contiguous array ordered by priority:
+ *
+ * .event_subscribers.<ename>.<prio>.0	marker of the priority start
+ * .event_subscribers.<ename>.<prio>.1	subscribers of the priority
+ * .event_subscribers.<ename>.end	marker of the array end
+ */
+
+#define _EVENT_SUBSCRIBERS_SECTION_PREFIX(ename)	".event_subscribers." STRINGIFY(ename) "."
 
-#define _SUBS_PRIO_ID(level) _CONCAT(_CONCAT(_prio, level), _)
+#define _EVENT_SUBSCRIBERS_SECTION_NAME(ename, prio)	_EVENT_SUBSCRIBERS_SECTION_PREFIX(ename) STRINGIFY(prio) ".1"
 
-#define _EVENT_SUBSCRIBERS_SECTION_PREFIX(ename, prio)	_CONCAT(_CONCAT(event_subscribers_, ename), prio)
+#define _EVENT_SUBSCRIBERS_MARKER_SECTION_NAME(ename, prio)	_EVENT_SUBSCRIBERS_SECTION_PREFIX(ename) STRINGIFY(prio) ".0"
 
-#define _EVENT_SUBSCRIBERS_SECTION_NAME(ename, prio)	STRINGIFY(_EVENT_SUBSCRIBERS_SECTION_PREFIX(ename, prio))
+#define _EVENT_SUBSCRIBERS_END_SECTION_NAME(ename)	_EVENT_SUBSCRIBERS_SECTION_PREFIX(ename) "end"
 
 
-/* Declare a zero-length subscriber. */
-#define _EVENT_SUBSCRIBERS_EMPTY(ename, prio)								\
-	const struct {} _CONCAT(_EVENT_SUBSCRIBERS_SECTION_PREFIX(ename, prio), empty)			\
-	__attribute__((__section__(STRINGIFY(_EVENT_SUBSCRIBERS_SECTION_NAME(ename, prio))))) = {};
+/* Convenience macros generating marker names. */
 
+#define _EVENT_SUBSCRIBERS_MARKER(ename, suffix)	_CONCAT(_CONCAT(__event_subscribers_, ename), suffix)
 
-/* Convenience macros generating section start and stop markers. */
+#define _EVENT_SUBSCRIBERS_START(ename, prio)	_EVENT_SUBSCRIBERS_MARKER(ename, _CONCAT(_prio, prio))
 
-#define _EVENT_SUBSCRIBERS_START(ename, prio)	_CONCAT(__start_, _EVENT_SUBSCRIBERS_SECTION_PREFIX(ename, prio))
+#define _EVENT_SUBSCRIBERS_END(ename)		_EVENT_SUBSCRIBERS_MARKER(ename, _end)
 
-#define _EVENT_SUBSCRIBERS_STOP(ename, prio)	_CONCAT(__stop_,  _EVENT_SUBSCRIBERS_SECTION_PREFIX(ename, prio))
 
+/* Define a zero-length marker. */
+#define _EVENT_SUBSCRIBERS_MARKER_DEFINE(marker, section)				\
+	const struct event_subscriber marker[0] __used					\
+	__attribute__((__section__(section))) = {};
 
-#define _EVENT_SUBSCRIBERS_DECLARE(ename)										\
-	extern const struct event_subscriber _EVENT_SUBSCRIBERS_START(ename, _SUBS_PRIO_ID(_SUBS_PRIO_FIRST))[];	\
-	extern const struct event_subscriber _EVENT_SUBSCRIBERS_STOP(ename,  _SUBS_PRIO_ID(_SUBS_PRIO_FIRST))[];	\
-	extern const struct event_subscriber _EVENT_SUBSCRIBERS_START(ename, _SUBS_PRIO_ID(_SUBS_PRIO_NORMAL))[];	\
-	extern const struct event_subscriber _EVENT_SUBSCRIBERS_STOP(ename,  _SUBS_PRIO_ID(_SUBS_PRIO_NORMAL))[];	\
-	extern const struct event_subscriber _EVENT_SUBSCRIBERS_START(ename, _SUBS_PRIO_ID(_SUBS_PRIO_FINAL))[];	\
-	extern const struct event_subscriber _EVENT_SUBSCRIBERS_STOP(ename,  _SUBS_PRIO_ID(_SUBS_PRIO_FINAL))[];
 
+#define _EVENT_SUBSCRIBERS_DECLARE(ename)							\
+	extern const struct event_subscriber _EVENT_SUBSCRIBERS_START(ename, _SUBS_PRIO_FIRST)[];	\
+	extern const struct event_subscriber _EVENT_SUBSCRIBERS_START(ename, _SUBS_PRIO_NORMAL)[];	\
+	extern const struct event_subscriber _EVENT_SUBSCRIBERS_START(ename, _SUBS_PRIO_FINAL)[];	\
+	extern const struct event_subscriber _EVENT_SUBSCRIBERS_END(ename)[];
 
-/* Macro defining empty subscribers on each priority level.
- * Each event type keeps an array of subscribers for every priority level.
- * It can happen that for a given priority no subscriber will be registered.
- * This macro declares zero-length subscriber that will cause required section
- * to be generated by the linker. If no subscriber is registered at this
- * level section will remain empty.
+
+/* Macro defining markers of each priority level and of the array end.
+ * Markers cause required sections to be generated by the linker and provide
+ * boundaries of subscribers on each priority level. If no subscriber is
+ * registered at a level, its boundaries are equal.
  */
-#define _EVENT_SUBSCRIBERS_DEFINE(ename)					\
-	_EVENT_SUBSCRIBERS_EMPTY(ename, _SUBS_PRIO_ID(_SUBS_PRIO_FIRST))	\
-	_EVENT_SUBSCRIBERS_EMPTY(ename, _SUBS_PRIO_ID(_SUBS_PRIO_NORMAL))	\
-	_EVENT_SUBSCRIBERS_EMPTY(ename, _SUBS_PRIO_ID(_SUBS_PRIO_FINAL))
+#define _EVENT_SUBSCRIBERS_DEFINE(ename)								\
+	_EVENT_SUBSCRIBERS_MARKER_DEFINE(_EVENT_SUBSCRIBERS_START(ename, _SUBS_PRIO_FIRST),		\
+		_EVENT_SUBSCRIBERS_MARKER_SECTION_NAME(ename, _SUBS_PRIO_FIRST))			\
+	_EVENT_SUBSCRIBERS_MARKER_DEFINE(_EVENT_SUBSCRIBERS_START(ename, _SUBS_PRIO_NORMAL),		\
+		_EVENT_SUBSCRIBERS_MARKER_SECTION_NAME(ename, _SUBS_PRIO_NORMAL))			\
+	_EVENT_SUBSCRIBERS_MARKER_DEFINE(_EVENT_SUBSCRIBERS_START(ename, _SUBS_PRIO_FINAL),		\
+		_EVENT_SUBSCRIBERS_MARKER_SECTION_NAME(ename, _SUBS_PRIO_FINAL))			\
+	_EVENT_SUBSCRIBERS_MARKER_DEFINE(_EVENT_SUBSCRIBERS_END(ename),					\
+		_EVENT_SUBSCRIBERS_END_SECTION_NAME(ename))
 
 
 /* Subscribe a listener to an event. */
@@ -89,14 +101,11 @@ extern "C" {
 #define _EVENT_ALLOCATOR_FN(ename)					\
 	static inline struct ename *_CONCAT(new_, ename)(void)		\
 	{								\
-		struct ename *event = k_malloc(sizeof(*event));		\
+		struct ename *event =					\
+			event_manager_alloc(sizeof(*event));		\
 		BUILD_ASSERT(offsetof(struct ename, header) == 0,	\
 				 "");					\
 		if (unlikely(!event)) {					\
-			printk("Event Manager OOM error\n");		\
-			LOG_PANIC();					\
-			__ASSERT_NO_MSG(false);				\
-			sys_reboot(SYS_REBOOT_WARM);			\
 			return NULL;					\
 		}							\
 		event->header.type_id = _EVENT_ID(ename);		\
@@ -111,17 +120,14 @@ extern "C" {
 #define _EVENT_ALLOCATOR_DYNDATA_FN(ename)				\
 	static inline struct ename *_CONCAT(new_, ename)(size_t size)	\
 	{								\
-		struct ename *event = k_malloc(sizeof(*event) + size);	\
+		struct ename *event =					\
+			event_manager_alloc(sizeof(*event) + size);	\
 		BUILD_ASSERT((offsetof(struct ename, dyndata) +	\
 				  sizeof(event->dyndata.size)) ==	\
 				 sizeof(*event), "");			\
 		BUILD_ASSERT(offsetof(struct ename, header) == 0,	\
 				 "");					\
 		if (unlikely(!event)) {					\
-			printk("Event Manager OOM error\n");		\
-			LOG_PANIC();					\
-			__ASSERT_NO_MSG(false);				\
-			sys_reboot(SYS_REBOOT_WARM);			\
 			return NULL;					\
 		}							\
 		event->header.type_id = _EVENT_ID(ename);		\
@@ -196,11 +202,33 @@ extern "C" {
 			}
 
 
+/* Latency histograms are placed in RAM next to the event type or listener
+ * definition and referenced from the constant structure.
+ */
+#ifdef CONFIG_DESKTOP_EVENT_MANAGER_LATENCY_STATS
+#define _EVENT_TYPE_LATENCY_DEFINE(ename)						\
+	static struct event_type_latency _CONCAT(__event_type_latency_, ename);
+#define _EVENT_TYPE_LATENCY_INIT(ename)							\
+	.latency = &_CONCAT(__event_type_latency_, ename),
+#define _EVENT_LISTENER_LATENCY_DEFINE(lname)						\
+	static struct event_latency_hist _CONCAT(__event_listener_latency_, lname);
+#define _EVENT_LISTENER_LATENCY_INIT(lname)						\
+	.latency = &_CONCAT(__event_listener_latency_, lname),
+#else
+#define _EVENT_TYPE_LATENCY_DEFINE(ename)
+#define _EVENT_TYPE_LATENCY_INIT(ename)
+#define _EVENT_LISTENER_LATENCY_DEFINE(lname)
+#define _EVENT_LISTENER_LATENCY_INIT(lname)
+#endif /* CONFIG_DESKTOP_EVENT_MANAGER_LATENCY_STATS */
+
+
 #define _EVENT_LISTENER(lname, notification_fn)					\
+	_EVENT_LISTENER_LATENCY_DEFINE(lname)					\
 	const struct event_listener _CONCAT(__event_listener_, lname) __used	\
 	__attribute__((__section__("event_listeners"))) = {			\
 		.name = STRINGIFY(lname),					\
 		.notification = (notification_fn),				\
+		_EVENT_LISTENER_LATENCY_INIT(lname)				\
 	}
 
 
@@ -221,27 +249,41 @@ extern "C" {
 	_EVENT_ALLOCATOR_DYNDATA_FN(ename)
 
 
-#define _EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct)							\
+#define _EVENT_TYPE_COALESCE_DEFINE(ename, dispatch_cls, coalesce_fn, init_log_en, log_fn, ev_info_struct)		\
 	_EVENT_SUBSCRIBERS_DEFINE(ename);										\
+	_EVENT_TYPE_LATENCY_DEFINE(ename)										\
 	const struct event_type _CONCAT(__event_type_, ename) __used							\
 	__attribute__((__section__("event_types"))) = {									\
 		.name				= STRINGIFY(ename),							\
 		.subs_start	= {											\
-			[_SUBS_PRIO_FIRST]	= _EVENT_SUBSCRIBERS_START(ename, _SUBS_PRIO_ID(_SUBS_PRIO_FIRST)),	\
-			[_SUBS_PRIO_NORMAL]	= _EVENT_SUBSCRIBERS_START(ename, _SUBS_PRIO_ID(_SUBS_PRIO_NORMAL)),	\
-			[_SUBS_PRIO_FINAL]	= _EVENT_SUBSCRIBERS_START(ename, _SUBS_PRIO_ID(_SUBS_PRIO_FINAL)),	\
+			[_SUBS_PRIO_FIRST]	= _EVENT_SUBSCRIBERS_START(ename, _SUBS_PRIO_FIRST),			\
+			[_SUBS_PRIO_NORMAL]	= _EVENT_SUBSCRIBERS_START(ename, _SUBS_PRIO_NORMAL),			\
+			[_SUBS_PRIO_FINAL]	= _EVENT_SUBSCRIBERS_START(ename, _SUBS_PRIO_FINAL),			\
 		},													\
 		.subs_stop	= {											\
-			[_SUBS_PRIO_FIRST]	= _EVENT_SUBSCRIBERS_STOP(ename, _SUBS_PRIO_ID(_SUBS_PRIO_FIRST)),	\
-			[_SUBS_PRIO_NORMAL]	= _EVENT_SUBSCRIBERS_STOP(ename, _SUBS_PRIO_ID(_SUBS_PRIO_NORMAL)),	\
-			[_SUBS_PRIO_FINAL]	= _EVENT_SUBSCRIBERS_STOP(ename, _SUBS_PRIO_ID(_SUBS_PRIO_FINAL)),	\
+			[_SUBS_PRIO_FIRST]	= _EVENT_SUBSCRIBERS_START(ename, _SUBS_PRIO_NORMAL),			\
+			[_SUBS_PRIO_NORMAL]	= _EVENT_SUBSCRIBERS_START(ename, _SUBS_PRIO_FINAL),			\
+			[_SUBS_PRIO_FINAL]	= _EVENT_SUBSCRIBERS_END(ename),					\
 		},													\
 		.init_log_enable		= init_log_en,								\
+		.dispatch_class			= dispatch_cls,								\
+		.coalesce			= coalesce_fn,								\
 		.log_event			= log_fn,								\
 		.ev_info			= ev_info_struct,							\
+		_EVENT_TYPE_LATENCY_INIT(ename)										\
 	}
 
 
+#define _EVENT_TYPE_CLASS_DEFINE(ename, dispatch_cls, init_log_en, log_fn, ev_info_struct)	\
+	_EVENT_TYPE_COALESCE_DEFINE(ename, dispatch_cls, NULL, init_log_en,			\
+				    log_fn, ev_info_struct)
+
+
+#define _EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct)		\
+	_EVENT_TYPE_CLASS_DEFINE(ename, EVENT_DISPATCH_CLASS_NORMAL, init_log_en,	\
+				 log_fn, ev_info_struct)
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -8,6 +8,8 @@
 #include <shell/shell.h>
 #include <event_manager.h>
 
+#include "event_manager_pool.h"
+
 u32_t event_manager_displayed_events;
 
 static int show_events(const struct shell *shell, size_t argc,
@@ -89,6 +91,202 @@ static int show_subscribers(const struct shell *shell, size_t argc,
 	return 0;
 }
 
+static int show_pools(const struct shell *shell, size_t argc,
+		      char **argv)
+{
+#ifdef CONFIG_DESKTOP_EVENT_MANAGER_EVENT_POOL
+	shell_fprintf(shell, SHELL_NORMAL, "Event pools:\n");
+	for (size_t i = 0; i < event_pool_cnt(); i++) {
+		struct event_pool_stats stats;
+
+		event_pool_stats_get(i, &stats);
+		shell_fprintf(shell, SHELL_NORMAL,
+			      "|\tblock size:%zu\tblocks:%zu\tused:%zu\t"
+			      "max used:%zu\texhausted:%u\n",
+			      stats.block_size, stats.block_cnt, stats.used,
+			      stats.max_used, stats.exhausted_cnt);
+	}
+	shell_fprintf(shell, SHELL_NORMAL, "Heap allocations: %u\n",
+		      event_pool_heap_alloc_cnt());
+#else
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "Event pools disabled, events use the heap\n");
+#endif
+
+	return 0;
+}
+
+static int show_queues(const struct shell *shell, size_t argc,
+		       char **argv)
+{
+	static const char * const class_names[] = {
+		[EVENT_DISPATCH_CLASS_REALTIME] = "realtime",
+		[EVENT_DISPATCH_CLASS_NORMAL] = "normal",
+		[EVENT_DISPATCH_CLASS_BACKGROUND] = "background",
+	};
+
+	shell_fprintf(shell, SHELL_NORMAL, "Event queues:\n");
+	for (size_t i = 0; i < event_manager_queue_cnt(); i++) {
+		struct event_queue_stats stats;
+		int err = event_manager_queue_stats_get(i, &stats);
+
+		if (err) {
+			shell_error(shell, "Queue statistics disabled");
+			return err;
+		}
+
+		shell_fprintf(shell, SHELL_NORMAL,
+			      "|\t%s\tprocessed:%u\tcoalesced:%u\tdepth:%u\t"
+			      "max depth:%u\tlatency avg:%uus\tmax:%uus\n",
+			      (event_manager_queue_cnt() > 1) ?
+				class_names[i] : "all",
+			      stats.processed, stats.coalesced,
+			      stats.depth, stats.max_depth,
+			      stats.latency_avg_us, stats.latency_max_us);
+	}
+
+	return 0;
+}
+
+static int reset_queues(const struct shell *shell, size_t argc,
+			char **argv)
+{
+	event_manager_queue_stats_reset();
+	shell_fprintf(shell, SHELL_NORMAL, "Event queue statistics reset\n");
+
+	return 0;
+}
+
+static void print_latency(const struct shell *shell, const char *name,
+			  const struct event_latency_stats *stats)
+{
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "%s cnt:%u p50:%uus p99:%uus max:%uus",
+		      name, stats->cnt,
+		      event_latency_percentile_us(stats, 50),
+		      event_latency_percentile_us(stats, 99),
+		      stats->max_us);
+}
+
+static void print_latency_hist(const struct shell *shell, const char *name,
+			       const struct event_latency_stats *stats)
+{
+	shell_fprintf(shell, SHELL_NORMAL, "%s:\n", name);
+	for (size_t i = 0; i < EVENT_LATENCY_HIST_BUCKET_CNT; i++) {
+		if (stats->buckets[i] == 0) {
+			continue;
+		}
+
+		if (i < EVENT_LATENCY_HIST_BUCKET_CNT - 1) {
+			shell_fprintf(shell, SHELL_NORMAL,
+				      "|\t<%uus:\t%u\n",
+				      (u32_t)BIT(i + 1), stats->buckets[i]);
+		} else {
+			shell_fprintf(shell, SHELL_NORMAL,
+				      "|\t>=%uus:\t%u\n",
+				      (u32_t)BIT(i), stats->buckets[i]);
+		}
+	}
+}
+
+static int show_event_latency_hist(const struct shell *shell,
+				   const char *arg)
+{
+	char *end;
+	long ev_id = strtol(arg, &end, 10);
+
+	if ((ev_id < 0) ||
+	    (ev_id >= __stop_event_types - __start_event_types) ||
+	    (*end != '\0')) {
+		shell_error(shell, "Invalid event ID: %s", arg);
+		return -EINVAL;
+	}
+
+	const struct event_type *et = __start_event_types + ev_id;
+	struct event_latency_stats wait;
+	struct event_latency_stats exec;
+	int err = event_manager_event_latency_get(et, &wait, &exec);
+
+	if (err) {
+		return err;
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL, "Event %s\n", et->name);
+	print_latency_hist(shell, "Wait", &wait);
+	print_latency_hist(shell, "Exec", &exec);
+
+	return 0;
+}
+
+static int show_latency(const struct shell *shell, size_t argc,
+			char **argv)
+{
+	if (!IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_LATENCY_STATS)) {
+		shell_error(shell, "Latency statistics disabled");
+		return -ENOTSUP;
+	}
+
+	/* Show histograms of the given events. */
+	if (argc > 1) {
+		for (size_t i = 1; i < argc; i++) {
+			int err = show_event_latency_hist(shell, argv[i]);
+
+			if (err) {
+				return err;
+			}
+		}
+
+		return 0;
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL, "Event latency:\n");
+	for (const struct event_type *et = __start_event_types;
+	     (et != NULL) && (et != __stop_event_types); et++) {
+		struct event_latency_stats wait;
+		struct event_latency_stats exec;
+
+		event_manager_event_latency_get(et, &wait, &exec);
+		if (wait.cnt == 0) {
+			continue;
+		}
+
+		shell_fprintf(shell, SHELL_NORMAL, "|\t%d:\t%s\n",
+			      et - __start_event_types, et->name);
+		shell_fprintf(shell, SHELL_NORMAL, "|\t\t");
+		print_latency(shell, "wait", &wait);
+		shell_fprintf(shell, SHELL_NORMAL, "\t");
+		print_latency(shell, "exec", &exec);
+		shell_fprintf(shell, SHELL_NORMAL, "\n");
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL, "Listener latency:\n");
+	for (const struct event_listener *el = __start_event_listeners;
+	     el != __stop_event_listeners;
+	     el++) {
+		struct event_latency_stats exec;
+
+		event_manager_listener_latency_get(el, &exec);
+		if (exec.cnt == 0) {
+			continue;
+		}
+
+		shell_fprintf(shell, SHELL_NORMAL, "|\t[L:%s]\t", el->name);
+		print_latency(shell, "exec", &exec);
+		shell_fprintf(shell, SHELL_NORMAL, "\n");
+	}
+
+	return 0;
+}
+
+static int reset_latency(const struct shell *shell, size_t argc,
+			 char **argv)
+{
+	event_manager_latency_stats_reset();
+	shell_fprintf(shell, SHELL_NORMAL, "Latency statistics reset\n");
+
+	return 0;
+}
+
 static void set_event_displaying(const struct shell *shell, size_t argc,
 				 char **argv, bool enable)
 {
@@ -168,6 +366,19 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_event_manager,
 	SHELL_CMD_ARG(show_subscribers, NULL, "Show subscribers",
 		      show_subscribers, 0, 0),
 	SHELL_CMD_ARG(show_events, NULL, "Show events", show_events, 0, 0),
+	SHELL_CMD_ARG(show_pools, NULL, "Show event pools statistics",
+		      show_pools, 0, 0),
+	SHELL_CMD_ARG(show_queues, NULL, "Show event queues statistics",
+		      show_queues, 0, 0),
+	SHELL_CMD_ARG(reset_queues, NULL, "Reset event queues statistics",
+		      reset_queues, 0, 0),
+	SHELL_CMD_ARG(show_latency, NULL,
+		      "Show latency statistics or histograms of events with "
+		      "given IDs",
+		      show_latency, 0,
+		      sizeof(event_manager_displayed_events) * 8 - 1),
+	SHELL_CMD_ARG(reset_latency, NULL, "Reset latency statistics",
+		      reset_latency, 0, 0),
 	SHELL_CMD_ARG(disable, NULL, "Disable displaying event with given ID",
 		      disable_event_displaying, 0,
 		      sizeof(event_manager_displayed_events) * 8 - 1),
@@ -6,9 +6,11 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <ctype.h>
 #include <zephyr.h>
 #include <zephyr/types.h>
 #include <toolchain/common.h>
+#include <sys/atomic.h>
 #include <net/socket.h>
 #include <net/tls_credentials.h>
 #include <net/download_client.h>
@@ -243,6 +245,32 @@ static int socket_send(const struct download_client *client, size_t len)
 	return 0;
 }
 
+static bool zero_copy(const struct download_client *client)
+{
+	return client->rx_bufs != NULL;
+}
+
+static void rx_buf_acquire(struct download_client *client)
+{
+	size_t idx;
+
+	/* Wait until the application gives back at least one buffer */
+	k_sem_take(&client->rx_buf_sem, K_FOREVER);
+
+	for (size_t i = 0; i < client->rx_buf_cnt; i++) {
+		idx = (client->rx_buf_next + i) % client->rx_buf_cnt;
+
+		if (atomic_test_and_clear_bit(&client->rx_buf_free, idx)) {
+			client->rx_buf_next = (idx + 1) % client->rx_buf_cnt;
+			client->rx = client->rx_bufs + idx * client->rx_buf_size;
+			client->rx_size = client->rx_buf_size;
+			return;
+		}
+	}
+
+	__ASSERT(false, "No free buffer");
+}
+
 static int get_request_send(struct download_client *client)
 {
 	int err;
@@ -254,16 +282,16 @@ static int get_request_send(struct download_client *client)
 	__ASSERT_NO_MSG(client->file);
 
 	/* Offset of last byte in range (Content-Range) */
-	off = client->progress + client->fragment_size - 1;
+	off = client->requested + client->fragment_size - 1;
 
 	if (client->file_size != 0) {
 		/* Don't request bytes past the end of file */
-		off = MIN(off, client->file_size);
+		off = MIN(off, client->file_size - 1);
 	}
 
 	len = snprintf(client->buf, CONFIG_DOWNLOAD_CLIENT_MAX_RESPONSE_SIZE,
 		       GET_TEMPLATE, client->file, client->host,
-		       client->progress, off);
+		       client->requested, off);
 
 	if (len < 0 || len > CONFIG_DOWNLOAD_CLIENT_MAX_RESPONSE_SIZE) {
 		LOG_ERR("Cannot create GET request, buffer too small");
@@ -281,9 +309,109 @@ static int get_request_send(struct download_client *client)
 		return err;
 	}
 
+	client->requested = off + 1;
+	client->pending++;
+
+	return 0;
+}
+
+static size_t pipeline_depth_get(const struct download_client *client)
+{
+	return (client->config.pipeline_depth != 0) ?
+		client->config.pipeline_depth :
+		CONFIG_DOWNLOAD_CLIENT_PIPELINE_DEPTH;
+}
+
+/* Send requests for the next fragments until the pipeline is full.
+ * The file size is not known until the first response is received,
+ * so the first request is never pipelined.
+ */
+static int requests_send(struct download_client *client)
+{
+	int err;
+
+	while (client->pending < pipeline_depth_get(client)) {
+		if ((client->file_size == 0) ? (client->pending != 0) :
+		    (client->requested >= client->file_size)) {
+			break;
+		}
+
+		err = get_request_send(client);
+		if (err) {
+			return err;
+		}
+	}
+
 	return 0;
 }
 
+/* Offset of the end of the range requested for the response being received,
+ * valid until the HTTP header is received.
+ */
+static size_t range_end_get(const struct download_client *client)
+{
+	size_t end = client->progress + client->fragment_size;
+
+	if (client->file_size != 0) {
+		end = MIN(end, client->file_size);
+	}
+
+	return end;
+}
+
+/* Returns the value of the header field with the given name, which must be
+ * lowercase and include the colon. Field names are case-insensitive.
+ */
+static char *header_field_find(char *header, const char *name)
+{
+	size_t name_len = strlen(name);
+	char *line = header;
+
+	while ((line = strstr(line, "\r\n")) != NULL) {
+		size_t i;
+
+		line += strlen("\r\n");
+
+		for (i = 0; i < name_len; i++) {
+			if (tolower((unsigned char)line[i]) != name[i]) {
+				break;
+			}
+		}
+
+		if (i == name_len) {
+			line += name_len;
+			return line + strspn(line, " \t");
+		}
+	}
+
+	return NULL;
+}
+
+static void etag_parse(struct download_client *client)
+{
+	char *p;
+	size_t len;
+
+	client->etag[0] = '\0';
+
+	p = header_field_find(client->rx, "etag:");
+	if (!p) {
+		return;
+	}
+
+	len = strcspn(p, "\r\n");
+
+	if (len >= sizeof(client->etag)) {
+		LOG_WRN("ETag too long, truncated");
+		len = sizeof(client->etag) - 1;
+	}
+
+	memcpy(client->etag, p, len);
+	client->etag[len] = '\0';
+
+	LOG_DBG("ETag = %s", log_strdup(client->etag));
+}
+
 /* Returns:
  *  1 while the header is being received
  *  0 if the header has been fully received
@@ -294,7 +422,7 @@ static int header_parse(struct download_client *client)
 	char *p;
 	size_t hdr;
 
-	p = strstr(client->buf, "\r\n\r\n");
+	p = strstr(client->rx, "\r\n\r\n");
 	if (!p) {
 		/* Awaiting full GET response */
 		LOG_DBG("Awaiting full header in response");
@@ -302,19 +430,19 @@ static int header_parse(struct download_client *client)
 	}
 
 	/* Offset of the end of the HTTP header in the buffer */
-	hdr = p + strlen("\r\n\r\n") - client->buf;
+	hdr = p + strlen("\r\n\r\n") - client->rx;
 
-	__ASSERT(hdr < sizeof(client->buf), "Buffer overflow");
+	__ASSERT(hdr < client->rx_size, "Buffer overflow");
 
 	LOG_DBG("GET header size: %u", hdr);
 
 	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
-		LOG_HEXDUMP_DBG(client->buf, hdr, "GET");
+		LOG_HEXDUMP_DBG(client->rx, hdr, "GET");
 	}
 
 	/* If file size is not known, read it from the header */
 	if (client->file_size == 0) {
-		p = strstr(client->buf, "Content-Range: bytes");
+		p = strstr(client->rx, "Content-Range: bytes");
 		if (!p) {
 			/* Cannot continue */
 			LOG_ERR("Server did not send "
@@ -331,21 +459,31 @@ static int header_parse(struct download_client *client)
 		client->file_size = atoi(p + 1);
 
 		LOG_DBG("File size = %d", client->file_size);
+
+		etag_parse(client);
 	}
 
-	p = strstr(client->buf, "Connection: close");
+	p = strstr(client->rx, "Connection: close");
 	if (p) {
 		LOG_WRN("Peer closed connection, will attempt to re-connect");
 		client->connection_close = true;
 	}
 
-	if (client->offset != hdr) {
+	client->range_end = range_end_get(client);
+
+	if (zero_copy(client)) {
+		/* Leave the payload where it is, the buffer is handed
+		 * over to the application together with the fragment.
+		 */
+		client->body = hdr;
+		client->offset -= hdr;
+	} else if (client->offset != hdr) {
 		/* The current buffer contains some payload bytes.
 		 * Copy them at the beginning of the buffer
 		 * then update the offset.
 		 */
 		LOG_WRN("Copying %u payload bytes", client->offset - hdr);
-		memcpy(client->buf, client->buf + hdr, client->offset - hdr);
+		memmove(client->buf, client->buf + hdr, client->offset - hdr);
 
 		client->offset -= hdr;
 	} else {
@@ -358,22 +496,28 @@ static int header_parse(struct download_client *client)
 	return 0;
 }
 
-static int fragment_evt_send(const struct download_client *client)
+static int fragment_evt_send(struct download_client *client)
 {
 	__ASSERT(client->offset <= client->fragment_size,
 		 "Fragment overflow!");
 
-	__ASSERT(client->offset <= CONFIG_DOWNLOAD_CLIENT_MAX_RESPONSE_SIZE,
+	__ASSERT(client->body + client->offset <= client->rx_size,
 		 "Buffer overflow!");
 
 	const struct download_client_evt evt = {
 		.id = DOWNLOAD_CLIENT_EVT_FRAGMENT,
 		.fragment = {
-			.buf = client->buf,
+			.buf = client->rx + client->body,
 			.len = client->offset,
 		}
 	};
 
+	if (zero_copy(client)) {
+		/* The buffer is owned by the application from now on */
+		client->rx = NULL;
+		client->body = 0;
+	}
+
 	return client->callback(&evt);
 }
 
@@ -394,6 +538,10 @@ static int reconnect(struct download_client *dl)
 {
 	int err;
 
+	/* Requests sent over the previous connection are lost */
+	dl->pending = 0;
+	dl->requested = dl->progress;
+
 	LOG_INF("Reconnecting..");
 	err = download_client_disconnect(dl);
 	if (err) {
@@ -412,19 +560,38 @@ void download_thread(void *client, void *a, void *b)
 {
 	int rc;
 	size_t len;
+	size_t room;
 	struct download_client *const dl = client;
 
 restart_and_suspend:
 	k_thread_suspend(dl->tid);
 
 	while (true) {
-		__ASSERT(dl->offset < sizeof(dl->buf), "Buffer overflow");
+		if (dl->rx == NULL) {
+			rx_buf_acquire(dl);
+		}
+
+		__ASSERT(dl->body + dl->offset < dl->rx_size,
+			 "Buffer overflow");
+
+		/* Never receive past the end of the current response,
+		 * the responses to pipelined requests follow right after it.
+		 * While the header is received, the rest of the response is
+		 * at least one byte longer than the payload.
+		 */
+		if (dl->has_header) {
+			room = MIN(dl->rx_size - dl->body - dl->offset,
+				   dl->range_end - dl->progress);
+		} else {
+			/* Keep space for the null terminator of the header */
+			room = MIN(dl->rx_size - dl->offset - 1,
+				   range_end_get(dl) - dl->progress + 1);
+		}
 
-		LOG_DBG("Receiving up to %d bytes at %p...",
-			(sizeof(dl->buf) - dl->offset), (dl->buf + dl->offset));
+		LOG_DBG("Receiving up to %d bytes at %p...", room,
+			(dl->rx + dl->body + dl->offset));
 
-		len = recv(dl->fd, dl->buf + dl->offset,
-			   sizeof(dl->buf) - dl->offset, 0);
+		len = recv(dl->fd, dl->rx + dl->body + dl->offset, room, 0);
 
 		if ((len == 0) || (len == -1)) {
 			/* We just had an unexpected socket error or closure */
@@ -467,6 +634,8 @@ restart_and_suspend:
 		dl->offset += len;
 
 		if (!dl->has_header) {
+			dl->rx[dl->offset] = '\0';
+
 			rc = header_parse(dl);
 			if (rc > 0) {
 				/* Wait for payload */
@@ -496,9 +665,15 @@ restart_and_suspend:
 		 */
 		dl->progress += MIN(dl->offset, len);
 
-		/* Have we received a whole fragment or the whole file? */
+		/* Have we received a whole fragment or the whole file?
+		 * When receiving into application buffers, the HTTP header
+		 * is kept in the buffer, so the buffer can fill up before
+		 * and a fragment can be split across two buffers.
+		 */
 		if ((dl->offset < dl->fragment_size) &&
-		    (dl->progress != dl->file_size)) {
+		    (dl->progress < dl->range_end) &&
+		    (dl->progress != dl->file_size) &&
+		    (dl->body + dl->offset < dl->rx_size)) {
 			LOG_DBG("Awaiting full fragment (%u)", dl->offset);
 			continue;
 		}
@@ -506,6 +681,11 @@ restart_and_suspend:
 		LOG_INF("Downloaded %u/%u bytes (%d%%)", dl->progress,
 			dl->file_size, (dl->progress * 100) / dl->file_size);
 
+		if (dl->progress == dl->range_end) {
+			/* The response is complete */
+			dl->pending--;
+		}
+
 		/* Send fragment to application.
 		 * If the application callback returns non-zero, stop.
 		 */
@@ -526,19 +706,28 @@ restart_and_suspend:
 			break;
 		}
 
+		if (dl->progress < dl->range_end) {
+			/* Receive the rest of the response
+			 * into the next buffer.
+			 */
+			dl->offset = 0;
+			continue;
+		}
+
 		/* Attempt to reconnect if the connection was closed */
 		if (dl->connection_close) {
 			dl->connection_close = false;
 			reconnect(dl);
 		}
 
-		/* Request next fragment */
-		/* Send a GET request for the next bytes */
+		/* Request next fragments */
+		/* Send GET requests for the next bytes */
 send_again:
 		dl->offset = 0;
+		dl->body = 0;
 		dl->has_header = false;
 
-		rc = get_request_send(dl);
+		rc = requests_send(dl);
 		if (rc) {
 			rc = error_evt_send(dl, ECONNRESET);
 			if (rc) {
@@ -564,6 +753,9 @@ int download_client_init(struct download_client *const client,
 	client->fd = -1;
 	client->callback = callback;
 
+	client->rx = client->buf;
+	client->rx_size = sizeof(client->buf);
+
 	/* The thread is spawned now, but it will suspend itself;
 	 * it is resumed when the download is started via the API.
 	 */
@@ -647,6 +839,7 @@ int download_client_disconnect(struct download_client *const client)
 	}
 
 	client->fd = -1;
+	client->pending = 0;
 
 	return 0;
 }
@@ -660,17 +853,31 @@ int download_client_start(struct download_client *client, const char *file,
 		return -EINVAL;
 	}
 
+	if (client->pending != 0) {
+		/* Discard the responses to the requests
+		 * sent for the previous download.
+		 */
+		err = reconnect(client);
+		if (err) {
+			return err;
+		}
+	}
+
 	client->file = file;
 	client->file_size = 0;
+	client->etag[0] = '\0';
 	client->progress = from;
+	client->requested = from;
+	client->pending = 0;
 
 	client->offset = 0;
+	client->body = 0;
 	client->has_header = false;
 
 	LOG_INF("Downloading: %s [%u]", log_strdup(client->file),
 		client->progress);
 
-	err = get_request_send(client);
+	err = requests_send(client);
 	if (err) {
 		return err;
 	}
@@ -681,6 +888,67 @@ int download_client_start(struct download_client *client, const char *file,
 	return 0;
 }
 
+int download_client_rx_bufs_set(struct download_client *client, void *bufs,
+				size_t buf_cnt, size_t buf_size)
+{
+	if (client == NULL) {
+		return -EINVAL;
+	}
+
+	if (bufs == NULL) {
+		client->rx_bufs = NULL;
+		client->rx = client->buf;
+		client->rx_size = sizeof(client->buf);
+		return 0;
+	}
+
+	if ((buf_cnt == 0) || (buf_cnt > ATOMIC_BITS) ||
+	    (buf_size < CONFIG_DOWNLOAD_CLIENT_MAX_RESPONSE_SIZE)) {
+		return -EINVAL;
+	}
+
+	client->rx_bufs = bufs;
+	client->rx_buf_cnt = buf_cnt;
+	client->rx_buf_size = buf_size;
+	client->rx_buf_next = 0;
+	client->rx = NULL;
+
+	atomic_clear(&client->rx_buf_free);
+	for (size_t i = 0; i < buf_cnt; i++) {
+		atomic_set_bit(&client->rx_buf_free, i);
+	}
+	k_sem_init(&client->rx_buf_sem, buf_cnt, buf_cnt);
+
+	return 0;
+}
+
+int download_client_rx_buf_release(struct download_client *client,
+				   const void *buf)
+{
+	size_t off;
+
+	if (client == NULL || client->rx_bufs == NULL || buf == NULL) {
+		return -EINVAL;
+	}
+
+	off = (const char *)buf - client->rx_bufs;
+
+	if (((const char *)buf < client->rx_bufs) ||
+	    (off >= client->rx_buf_cnt * client->rx_buf_size)) {
+		return -EINVAL;
+	}
+
+	if (atomic_test_and_set_bit(&client->rx_buf_free,
+				    off / client->rx_buf_size)) {
+		/* Not owned by the application */
+		return -EALREADY;
+	}
+
+	k_sem_give(&client->rx_buf_sem);
+
+	return 0;
+}
+
 void download_client_pause(struct download_client *client)
 {
 	k_thread_suspend(client->tid);
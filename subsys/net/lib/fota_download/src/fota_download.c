@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
  */
 
+#include <string.h>
 #include <zephyr.h>
 #include <logging/log.h>
 #include <net/fota_download.h>
@@ -18,12 +19,28 @@
 #include <dfu_target_mcuboot.h>
 #endif
 
+#ifdef CONFIG_FOTA_DOWNLOAD_CHECKPOINT
+#include "fota_download_checkpoint.h"
+#endif
+
 LOG_MODULE_REGISTER(fota_download, CONFIG_FOTA_DOWNLOAD_LOG_LEVEL);
 
 static fota_download_callback_t callback;
 static struct download_client   dlc;
 static struct k_delayed_work    dlc_with_offset_work;
 static int socket_retries_left;
+static bool first_fragment = true;
+static bool downloading;
+static size_t file_size;
+
+#ifdef CONFIG_FOTA_DOWNLOAD_CHECKPOINT
+static struct k_delayed_work resume_work;
+static int resume_retries_left;
+/* The first fragment after resuming has not been received yet. */
+static bool resuming;
+/* Data before this offset has been written to the DFU target before reset. */
+static size_t target_offset;
+#endif
 
 static void send_evt(enum fota_download_evt_id id)
 {
@@ -31,6 +48,11 @@ static void send_evt(enum fota_download_evt_id id)
 	const struct fota_download_evt evt = {
 		.id = id
 	};
+
+	if ((id == FOTA_DOWNLOAD_EVT_FINISHED) ||
+	    (id == FOTA_DOWNLOAD_EVT_ERROR)) {
+		downloading = false;
+	}
 	callback(&evt);
 }
 
@@ -57,10 +79,89 @@ static void dfu_target_callback_handler(enum dfu_target_evt_id evt)
 	}
 }
 
+#ifdef CONFIG_FOTA_DOWNLOAD_CHECKPOINT
+static bool resume_schedule(void)
+{
+	if (resume_retries_left == 0) {
+		return false;
+	}
+
+	resume_retries_left--;
+	k_delayed_work_submit(&resume_work,
+			      K_SECONDS(CONFIG_FOTA_DOWNLOAD_RESUME_DELAY));
+
+	return true;
+}
+
+/* Check that the file on the server has not changed since the checkpoint. */
+static int resumed_file_check(void)
+{
+	const struct fota_download_checkpoint *cp =
+		fota_download_checkpoint_get();
+	size_t size;
+	int err;
+
+	/* Size of the file reported by the resumed response */
+	err = download_client_file_size_get(&dlc, &size);
+	if (err != 0) {
+		return err;
+	}
+
+	if ((size != cp->file_size) ||
+	    ((cp->etag[0] != '\0') && strcmp(cp->etag, dlc.etag))) {
+		LOG_ERR("File has changed since the download was interrupted");
+		return -ESTALE;
+	}
+
+	return 0;
+}
+#endif
+
+static int fragment_write(const u8_t *buf, size_t len)
+{
+	int err;
+
+#ifdef CONFIG_FOTA_DOWNLOAD_CHECKPOINT
+	const struct fota_download_checkpoint *cp =
+		fota_download_checkpoint_get();
+	size_t offset;
+
+	if (cp->offset < target_offset) {
+		/* Written to the DFU target before reset, only hash it */
+		size_t hashed = MIN(len, target_offset - cp->offset);
+
+		fota_download_checkpoint_data(buf, hashed);
+		buf += hashed;
+		len -= hashed;
+	}
+
+	if (len == 0) {
+		return 0;
+	}
+#endif
+
+	err = dfu_target_write(buf, len);
+	if (err != 0) {
+		return err;
+	}
+
+#ifdef CONFIG_FOTA_DOWNLOAD_CHECKPOINT
+	fota_download_checkpoint_data(buf, len);
+
+	err = dfu_target_offset_get(&offset);
+	if (err == 0) {
+		/* Failing to store checkpoint is not a critical error,
+		 * more data is downloaded again when resuming.
+		 */
+		(void)fota_download_checkpoint_save(offset);
+	}
+#endif
+
+	return 0;
+}
+
 static int download_client_callback(const struct download_client_evt *event)
 {
-	static bool first_fragment = true;
-	static size_t file_size;
 	size_t offset;
 	int err;
 
@@ -81,6 +182,7 @@ static int download_client_callback(const struct download_client_evt *event)
 			first_fragment = false;
 			int img_type = dfu_target_img_type(event->fragment.buf,
 							event->fragment.len);
+
 			err = dfu_target_init(img_type, file_size,
 					      dfu_target_callback_handler);
 			if ((err < 0) && (err != -EBUSY)) {
@@ -95,17 +197,38 @@ static int download_client_callback(const struct download_client_evt *event)
 				return err;
 			}
 
+#ifdef CONFIG_FOTA_DOWNLOAD_CHECKPOINT
+			/* The checkpoint becomes resumable only once the DFU
+			 * target has been initialized.
+			 */
+			struct fota_download_checkpoint *cp =
+				fota_download_checkpoint_get();
+
+			cp->img_type = img_type;
+			cp->file_size = file_size;
+			strcpy(cp->etag, dlc.etag);
+#endif
+
 			err = dfu_target_offset_get(&offset);
 			if (err != 0) {
 				LOG_DBG("unable to get dfu target offset err: "
 					"%d", err);
 				send_evt(FOTA_DOWNLOAD_EVT_ERROR);
+				return err;
 			}
 
+#ifdef CONFIG_FOTA_DOWNLOAD_CHECKPOINT
+			fota_download_checkpoint_offset_set(offset);
+#endif
+
 			if (offset != 0) {
 				/* Abort current download procedure, and
 				 * schedule new download from offset.
 				 */
+#ifdef CONFIG_FOTA_DOWNLOAD_CHECKPOINT
+				/* The file may change before the new request */
+				resuming = true;
+#endif
 				k_delayed_work_submit(&dlc_with_offset_work,
 						K_SECONDS(1));
 				LOG_INF("Refuse fragment, restart with offset");
@@ -114,8 +237,23 @@ static int download_client_callback(const struct download_client_evt *event)
 			}
 		}
 
-		err = dfu_target_write(event->fragment.buf,
-				       event->fragment.len);
+#ifdef CONFIG_FOTA_DOWNLOAD_CHECKPOINT
+		if (resuming) {
+			resuming = false;
+
+			err = resumed_file_check();
+			if (err != 0) {
+				(void) dfu_target_reset();
+				fota_download_checkpoint_clear();
+				first_fragment = true;
+				(void) download_client_disconnect(&dlc);
+				send_evt(FOTA_DOWNLOAD_EVT_ERROR);
+				return err;
+			}
+		}
+#endif
+
+		err = fragment_write(event->fragment.buf, event->fragment.len);
 		if (err != 0) {
 			LOG_ERR("dfu_target_write error %d", err);
 			int res = dfu_target_done(false);
@@ -123,6 +261,10 @@ static int download_client_callback(const struct download_client_evt *event)
 			if (res != 0) {
 				LOG_ERR("Unable to free DFU target resources");
 			}
+#ifdef CONFIG_FOTA_DOWNLOAD_CHECKPOINT
+			fota_download_checkpoint_clear();
+#endif
+			first_fragment = true;
 			(void) download_client_disconnect(&dlc);
 			send_evt(FOTA_DOWNLOAD_EVT_ERROR);
 			return err;
@@ -158,13 +300,17 @@ static int download_client_callback(const struct download_client_evt *event)
 			return err;
 		}
 
+#ifdef CONFIG_FOTA_DOWNLOAD_CHECKPOINT
+		fota_download_checkpoint_finish();
+#endif
+
 		err = download_client_disconnect(&dlc);
 		if (err != 0) {
 			send_evt(FOTA_DOWNLOAD_EVT_ERROR);
 			return err;
 		}
-		send_evt(FOTA_DOWNLOAD_EVT_FINISHED);
 		first_fragment = true;
+		send_evt(FOTA_DOWNLOAD_EVT_FINISHED);
 		break;
 
 	case DOWNLOAD_CLIENT_EVT_ERROR: {
@@ -181,6 +327,24 @@ static int download_client_callback(const struct download_client_evt *event)
 			 */
 		} else {
 			download_client_disconnect(&dlc);
+#ifdef CONFIG_FOTA_DOWNLOAD_CHECKPOINT
+			if ((event->error == -ENOTCONN) ||
+			    (event->error == -ECONNRESET)) {
+				/* Keep the DFU target and the checkpoint,
+				 * the download is resumed later.
+				 */
+				downloading = false;
+				if (resume_schedule()) {
+					LOG_WRN("Download interrupted, "
+						"resuming later");
+				} else {
+					LOG_ERR("Download interrupted");
+					send_evt(FOTA_DOWNLOAD_EVT_ERROR);
+				}
+				return event->error;
+			}
+			fota_download_checkpoint_clear();
+#endif
 			LOG_ERR("Download client error");
 			err = dfu_target_done(false);
 			if (err == -EACCES) {
@@ -204,7 +368,7 @@ static int download_client_callback(const struct download_client_evt *event)
 
 static void download_with_offset(struct k_work *unused)
 {
-	int offset;
+	size_t offset;
 	int err = dfu_target_offset_get(&offset);
 
 	err = download_client_start(&dlc, dlc.file, offset);
@@ -212,8 +376,88 @@ static void download_with_offset(struct k_work *unused)
 	LOG_INF("Downloading from offset: 0x%x", offset);
 	if (err != 0) {
 		LOG_ERR("%s failed with error %d", __func__, err);
+		send_evt(FOTA_DOWNLOAD_EVT_ERROR);
+	}
+}
+
+#ifdef CONFIG_FOTA_DOWNLOAD_CHECKPOINT
+static int download_resume(void)
+{
+	struct fota_download_checkpoint *cp = fota_download_checkpoint_get();
+	size_t offset;
+	int err;
+
+	const struct download_client_cfg config = {
+		.port = cp->port,
+		.sec_tag = cp->sec_tag,
+		.apn = (cp->apn[0] != '\0') ? cp->apn : NULL,
+	};
+
+	if (first_fragment && (cp->img_type != 0)) {
+		/* The DFU target is not initialized after reset */
+		err = dfu_target_init(cp->img_type, cp->file_size,
+				      dfu_target_callback_handler);
+		if ((err < 0) && (err != -EBUSY)) {
+			LOG_ERR("dfu_target_init error %d", err);
+			return err;
+		}
+
+		err = dfu_target_offset_get(&offset);
+		if (err != 0) {
+			LOG_ERR("unable to get dfu target offset err: %d", err);
+			return err;
+		}
+
+		/* If the DFU target has written more data than what has been
+		 * hashed, download it again for hashing only.
+		 */
+		if ((offset <= cp->offset) || !cp->hash_valid) {
+			fota_download_checkpoint_offset_set(offset);
+		}
+		target_offset = offset;
+
+		file_size = cp->file_size;
+		first_fragment = false;
+	}
+
+	resuming = (cp->img_type != 0);
+
+	socket_retries_left = CONFIG_FOTA_SOCKET_RETRIES;
+	downloading = true;
+
+	err = download_client_connect(&dlc, cp->host, &config);
+	if (err != 0) {
+		downloading = false;
+		return err;
+	}
+
+	LOG_INF("Resuming download from offset: 0x%x", cp->offset);
+
+	err = download_client_start(&dlc, cp->file, cp->offset);
+	if (err != 0) {
+		download_client_disconnect(&dlc);
+		downloading = false;
+		return err;
+	}
+
+	return 0;
+}
+
+static void download_resume_work(struct k_work *unused)
+{
+	int err = download_resume();
+
+	if (err != 0) {
+		if (resume_schedule()) {
+			LOG_WRN("Unable to resume download (err %d), "
+				"retrying later", err);
+		} else {
+			LOG_ERR("Unable to resume download (err %d)", err);
+			send_evt(FOTA_DOWNLOAD_EVT_ERROR);
+		}
 	}
 }
+#endif /* CONFIG_FOTA_DOWNLOAD_CHECKPOINT */
 
 int fota_download_start(const char *host, const char *file, int sec_tag,
 			u16_t port, const char *apn)
@@ -230,6 +474,10 @@ int fota_download_start(const char *host, const char *file, int sec_tag,
 		return -EINVAL;
 	}
 
+	if (downloading) {
+		return -EALREADY;
+	}
+
 	socket_retries_left = CONFIG_FOTA_SOCKET_RETRIES;
 
 #ifdef PM_S1_ADDRESS
@@ -264,14 +512,46 @@ int fota_download_start(const char *host, const char *file, int sec_tag,
 	}
 #endif /* PM_S1_ADDRESS */
 
+#ifdef CONFIG_FOTA_DOWNLOAD_CHECKPOINT
+	const struct fota_download_checkpoint *cp =
+		fota_download_checkpoint_get();
+
+	k_delayed_work_cancel(&resume_work);
+	resume_retries_left = CONFIG_FOTA_DOWNLOAD_RESUME_RETRIES;
+
+	if ((cp->img_type != 0) && !strcmp(cp->host, host) &&
+	    !strcmp(cp->file, file)) {
+		/* Continue the interrupted download of the same file */
+		return download_resume();
+	}
+
+	if (!first_fragment) {
+		/* Discard the interrupted download of another file */
+		(void)dfu_target_done(false);
+		first_fragment = true;
+	}
+
+	err = fota_download_checkpoint_begin(host, file, sec_tag, port, apn);
+	if (err != 0) {
+		return err;
+	}
+
+	target_offset = 0;
+	resuming = false;
+#endif
+
+	downloading = true;
+
 	err = download_client_connect(&dlc, host, &config);
 	if (err != 0) {
+		downloading = false;
 		return err;
 	}
 
 	err = download_client_start(&dlc, file, 0);
 	if (err != 0) {
 		download_client_disconnect(&dlc);
+		downloading = false;
 		return err;
 	}
 
@@ -294,5 +574,20 @@ int fota_download_init(fota_download_callback_t client_callback)
 		return err;
 	}
 
+#ifdef CONFIG_FOTA_DOWNLOAD_CHECKPOINT
+	k_delayed_work_init(&resume_work, download_resume_work);
+
+	err = fota_download_checkpoint_init();
+	if (err != 0) {
+		return err;
+	}
+
+	if (fota_download_checkpoint_get()->img_type != 0) {
+		/* Resume the download interrupted by reset */
+		resume_retries_left = CONFIG_FOTA_DOWNLOAD_RESUME_RETRIES;
+		(void)resume_schedule();
+	}
+#endif
+
 	return 0;
 }
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#include <logging/log.h>
+#include <settings/settings.h>
+#include <net/fota_download.h>
+#include <tinycrypt/constants.h>
+
+#include "fota_download_checkpoint.h"
+
+LOG_MODULE_DECLARE(fota_download, CONFIG_FOTA_DOWNLOAD_LOG_LEVEL);
+
+#define MODULE "fota_dl"
+#define KEY_CHECKPOINT "cp"
+
+static struct fota_download_checkpoint cp;
+/* Offset of the last stored checkpoint, or SIZE_MAX if none is stored. */
+static size_t stored_offset = SIZE_MAX;
+
+static u8_t digest[TC_SHA256_DIGEST_SIZE];
+static bool digest_valid;
+
+
+static int settings_set(const char *key, size_t len_rd,
+			settings_read_cb read_cb, void *cb_arg)
+{
+	if (!strcmp(key, KEY_CHECKPOINT)) {
+		if (len_rd != sizeof(cp)) {
+			/* Stored by a different version, cannot be used */
+			LOG_WRN("Ignoring stored checkpoint");
+			return 0;
+		}
+
+		ssize_t len = read_cb(cb_arg, &cp, sizeof(cp));
+
+		if (len != sizeof(cp)) {
+			LOG_ERR("Can't read checkpoint from storage");
+			memset(&cp, 0, sizeof(cp));
+			return len;
+		}
+
+		stored_offset = cp.offset;
+	}
+
+	return 0;
+}
+
+static int checkpoint_store(void)
+{
+	int err = settings_save_one(MODULE "/" KEY_CHECKPOINT, &cp, sizeof(cp));
+
+	if (err) {
+		LOG_ERR("Problem storing checkpoint (err %d)", err);
+		return err;
+	}
+
+	stored_offset = cp.offset;
+
+	LOG_DBG("Checkpoint stored at offset %zu", cp.offset);
+
+	return 0;
+}
+
+static void checkpoint_delete(void)
+{
+	int err;
+
+	if (stored_offset == SIZE_MAX) {
+		return;
+	}
+
+	err = settings_delete(MODULE "/" KEY_CHECKPOINT);
+	if (err) {
+		LOG_WRN("Unable to delete checkpoint (err %d)", err);
+	}
+
+	stored_offset = SIZE_MAX;
+}
+
+static int string_copy(char *dst, size_t size, const char *src)
+{
+	size_t len = (src != NULL) ? strlen(src) : 0;
+
+	if (len >= size) {
+		return -ENAMETOOLONG;
+	}
+
+	memcpy(dst, src, len);
+	dst[len] = '\0';
+
+	return 0;
+}
+
+int fota_download_checkpoint_init(void)
+{
+	static struct settings_handler sh = {
+		.name = MODULE,
+		.h_set = settings_set,
+	};
+	int err;
+
+	/* settings_subsys_init is idempotent so this is safe to do. */
+	err = settings_subsys_init();
+	if (err) {
+		LOG_ERR("settings_subsys_init failed (err %d)", err);
+		return err;
+	}
+
+	err = settings_register(&sh);
+	if (err) {
+		LOG_ERR("Cannot register settings (err %d)", err);
+		return err;
+	}
+
+	err = settings_load_subtree(MODULE);
+	if (err) {
+		LOG_ERR("Cannot load settings (err %d)", err);
+		return err;
+	}
+
+	if (cp.img_type != 0) {
+		LOG_INF("Checkpoint of %s at offset %zu",
+			log_strdup(cp.file), cp.offset);
+	}
+
+	return 0;
+}
+
+struct fota_download_checkpoint *fota_download_checkpoint_get(void)
+{
+	return &cp;
+}
+
+int fota_download_checkpoint_begin(const char *host, const char *file,
+				   int sec_tag, u16_t port, const char *apn)
+{
+	int err;
+
+	checkpoint_delete();
+	memset(&cp, 0, sizeof(cp));
+	digest_valid = false;
+
+	err = string_copy(cp.host, sizeof(cp.host), host);
+	if (!err) {
+		err = string_copy(cp.file, sizeof(cp.file), file);
+	}
+	if (!err) {
+		err = string_copy(cp.apn, sizeof(cp.apn), apn);
+	}
+	if (err) {
+		LOG_ERR("Host, file or APN too long for checkpoint");
+		memset(&cp, 0, sizeof(cp));
+		return err;
+	}
+
+	cp.sec_tag = sec_tag;
+	cp.port = port;
+
+	fota_download_checkpoint_offset_set(0);
+
+	return 0;
+}
+
+void fota_download_checkpoint_offset_set(size_t offset)
+{
+	if (offset == 0) {
+		(void)tc_sha256_init(&cp.sha);
+		cp.hash_valid = true;
+	} else if (offset != cp.offset) {
+		LOG_WRN("Download continues at offset %zu, hash discarded",
+			offset);
+		cp.hash_valid = false;
+	}
+
+	cp.offset = offset;
+}
+
+void fota_download_checkpoint_data(const void *buf, size_t len)
+{
+	if (cp.hash_valid) {
+		(void)tc_sha256_update(&cp.sha, buf, len);
+	}
+
+	cp.offset += len;
+}
+
+int fota_download_checkpoint_save(size_t target_offset)
+{
+	if ((stored_offset != SIZE_MAX) &&
+	    (cp.offset - stored_offset < CONFIG_FOTA_DOWNLOAD_CHECKPOINT_INTERVAL)) {
+		return 0;
+	}
+
+	if (target_offset != cp.offset) {
+		/* Some data is only buffered by the DFU target,
+		 * it would be lost on reset.
+		 */
+		return 0;
+	}
+
+	return checkpoint_store();
+}
+
+void fota_download_checkpoint_finish(void)
+{
+	struct tc_sha256_state_struct sha = cp.sha;
+
+	digest_valid = cp.hash_valid &&
+		       (tc_sha256_final(digest, &sha) == TC_CRYPTO_SUCCESS);
+
+	fota_download_checkpoint_clear();
+}
+
+void fota_download_checkpoint_clear(void)
+{
+	checkpoint_delete();
+	memset(&cp, 0, sizeof(cp));
+}
+
+int fota_download_sha256_get(u8_t *hash)
+{
+	if (hash == NULL) {
+		return -EINVAL;
+	}
+
+	if (!digest_valid) {
+		return -ENODATA;
+	}
+
+	memcpy(hash, digest, sizeof(digest));
+
+	return 0;
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+/* FOTA download checkpoint private header.
+ *
+ * Functions are used by fota_download only.
+ */
+
+#ifndef _FOTA_DOWNLOAD_CHECKPOINT_H_
+#define _FOTA_DOWNLOAD_CHECKPOINT_H_
+
+#include <zephyr/types.h>
+#include <tinycrypt/sha256.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Download context stored in settings. */
+struct fota_download_checkpoint {
+	char host[CONFIG_FOTA_DOWNLOAD_HOST_NAME_MAX_LEN];
+	char file[CONFIG_FOTA_DOWNLOAD_FILE_NAME_MAX_LEN];
+	char apn[CONFIG_FOTA_DOWNLOAD_APN_MAX_LEN];
+	char etag[CONFIG_DOWNLOAD_CLIENT_ETAG_SIZE];
+	int sec_tag;
+	u16_t port;
+	/* DFU target image type, zero until the first fragment is received. */
+	int img_type;
+	size_t file_size;
+	/* Offset of the next byte to download. */
+	size_t offset;
+	/* Hash of the data before the offset is known. */
+	bool hash_valid;
+	struct tc_sha256_state_struct sha;
+};
+
+/* Register settings handler and load the stored checkpoint. */
+int fota_download_checkpoint_init(void);
+
+/* Get the checkpoint. Image type is zero if there is no download to resume. */
+struct fota_download_checkpoint *fota_download_checkpoint_get(void);
+
+/* Start the checkpoint of a new download. */
+int fota_download_checkpoint_begin(const char *host, const char *file,
+				   int sec_tag, u16_t port, const char *apn);
+
+/* Continue the download from the given offset. Hashing starts over
+ * from the beginning of the file or the hash is discarded.
+ */
+void fota_download_checkpoint_offset_set(size_t offset);
+
+/* Account the downloaded data. */
+void fota_download_checkpoint_data(const void *buf, size_t len);
+
+/* Store the checkpoint if enough data has been downloaded since the last one
+ * and the DFU target has written all of the data (target_offset).
+ */
+int fota_download_checkpoint_save(size_t target_offset);
+
+/* Calculate the hash of the whole file and delete the checkpoint. */
+void fota_download_checkpoint_finish(void);
+
+/* Delete the checkpoint. */
+void fota_download_checkpoint_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _FOTA_DOWNLOAD_CHECKPOINT_H_ */
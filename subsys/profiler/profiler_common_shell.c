@@ -10,15 +10,17 @@
 #include <shell/shell_rtt.h>
 #include <profiler.h>
 
-u32_t profiler_enabled_events;
+/* Shell stores the number of optional arguments in one byte and never
+ * passes more than CONFIG_SHELL_ARGC_MAX arguments.
+ */
+#define EVENT_IDS_ARG_MAX MIN(CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS, \
+			      CONFIG_SHELL_ARGC_MAX)
+
+ATOMIC_DEFINE(profiler_enabled_events, CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS);
 
 static int display_registered_events(const struct shell *shell, size_t argc,
 				char **argv)
 {
-	/* Check if flags for enabling/disabling custom event fit on u32_t */
-	BUILD_ASSERT(CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS <=
-			 sizeof(profiler_enabled_events) * 8,
-			 "Max 32 profiler events may be used");
 	shell_fprintf(shell, SHELL_NORMAL, "EVENTS REGISTERED IN PROFILER:\n");
 	for (size_t i = 0; i < profiler_num_events; i++) {
 		const char *event_name = profiler_get_event_descr(i);
@@ -28,7 +30,8 @@ static int display_registered_events(const struct shell *shell, size_t argc,
 		shell_fprintf(shell,
 			      SHELL_NORMAL,
 			      "%c %d:\t%.*s\n",
-			      (profiler_enabled_events & BIT(i)) ? 'E' : 'D',
+			      atomic_test_bit(profiler_enabled_events, i) ?
+			      'E' : 'D',
 			      i,
 			      event_name_end - event_name,
 			      event_name);
@@ -37,15 +40,22 @@ static int display_registered_events(const struct shell *shell, size_t argc,
 	return 0;
 }
 
+static void event_profiling_set(size_t profiler_event_id, bool enable)
+{
+	if (enable) {
+		atomic_set_bit(profiler_enabled_events, profiler_event_id);
+	} else {
+		atomic_clear_bit(profiler_enabled_events, profiler_event_id);
+	}
+}
+
 static void set_event_profiling(const struct shell *shell, size_t argc,
 				char **argv, bool enable)
 {
-	u32_t evt_mask = 0;
-
 	/* If no IDs specified, all registered events are affected */
 	if (argc == 1) {
-		for (int i = 0; i < profiler_num_events; i++) {
-			evt_mask |= BIT(i);
+		for (size_t i = 0; i < profiler_num_events; i++) {
+			event_profiling_set(i, enable);
 		}
 
 		shell_fprintf(shell,
@@ -71,7 +81,7 @@ static void set_event_profiling(const struct shell *shell, size_t argc,
 		}
 
 		for (size_t i = 0; i < index_cnt; i++) {
-			evt_mask |= BIT(event_indexes[i]);
+			event_profiling_set(event_indexes[i], enable);
 			const char *event_name = profiler_get_event_descr(
 							event_indexes[i]);
 			/* Looking for event name delimiter (',') */
@@ -85,11 +95,6 @@ static void set_event_profiling(const struct shell *shell, size_t argc,
 				      enable ? "en":"dis");
 		}
 	}
-	if (enable) {
-		profiler_enabled_events |= evt_mask;
-	} else {
-		profiler_enabled_events &= ~evt_mask;
-	}
 }
 
 static int enable_event_profiling(const struct shell *shell, size_t argc,
@@ -106,15 +111,35 @@ static int disable_event_profiling(const struct shell *shell, size_t argc,
 	return 0;
 }
 
+static int display_ring_stats(const struct shell *shell, size_t argc,
+			      char **argv)
+{
+	struct profiler_ring_stats stats;
+	int err = profiler_ring_stats_get(&stats);
+
+	if (err) {
+		shell_error(shell, "Ring buffer statistics not available");
+		return err;
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "Ring buffer:\tsize:%u\tmax used:%u\n"
+		      "Events:\tsent:%u\tdropped:%u\n",
+		      stats.size, stats.max_used,
+		      stats.sent_events, stats.dropped_events);
+
+	return 0;
+}
+
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_profiler,
 	SHELL_CMD_ARG(list, NULL, "Display list of events",
 			display_registered_events, 0, 0),
 	SHELL_CMD_ARG(enable, NULL, "Enable profiling of event with given ID",
-			enable_event_profiling, 1,
-			sizeof(profiler_enabled_events) * 8),
+			enable_event_profiling, 1, EVENT_IDS_ARG_MAX),
 	SHELL_CMD_ARG(disable, NULL, "Disable profiling of event with given ID",
-			disable_event_profiling, 1,
-			sizeof(profiler_enabled_events) * 8),
+			disable_event_profiling, 1, EVENT_IDS_ARG_MAX),
+	SHELL_CMD_ARG(stats, NULL, "Display ring buffer statistics",
+			display_ring_stats, 0, 0),
 	SHELL_SUBCMD_SET_END
 );
 SHELL_CMD_REGISTER(profiler, &sub_profiler, "Profiler commands", NULL);
@@ -14,10 +14,10 @@
 #include <profiler.h>
 #include <string.h>
 
+#include "profiler_nordic_ring.h"
 
-/* By default, when there is no shell, all events are profiled. */
 #ifndef CONFIG_SHELL
-u32_t profiler_enabled_events = 0xffffffff;
+ATOMIC_DEFINE(profiler_enabled_events, CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS);
 #endif
 
 
@@ -44,7 +44,7 @@ static char *arg_types_encodings[] = {
 					"t"    /* time */
 				     };
 
-u8_t profiler_num_events;
+u16_t profiler_num_events;
 
 static u8_t buffer_data[CONFIG_PROFILER_NORDIC_DATA_BUFFER_SIZE];
 static u8_t buffer_info[CONFIG_PROFILER_NORDIC_INFO_BUFFER_SIZE];
@@ -63,7 +63,7 @@ static void send_system_description(void)
 	/* Memory barrier to make sure that data is visible
 	 * before being accessed
 	 */
-	u8_t ne = profiler_num_events;
+	u16_t ne = profiler_num_events;
 
 	__DMB();
 	char end_line = '\n';
@@ -99,10 +99,18 @@ static void profiler_nordic_thread_fn(void)
 			command = (enum nordic_command)read_data;
 			switch (command) {
 			case NORDIC_COMMAND_START:
+				if (IS_ENABLED(
+				     CONFIG_PROFILER_NORDIC_RING_BUFFER)) {
+					profiler_ring_restart();
+				}
 				sending_events = true;
 				break;
 			case NORDIC_COMMAND_STOP:
 				sending_events = false;
+				if (IS_ENABLED(
+				     CONFIG_PROFILER_NORDIC_RING_BUFFER)) {
+					profiler_ring_restart();
+				}
 				break;
 			case NORDIC_COMMAND_INFO:
 				send_system_description();
@@ -149,6 +157,10 @@ int profiler_init(void)
 		SEGGER_RTT_MODE_NO_BLOCK_SKIP);
 	__ASSERT_NO_MSG(ret >= 0);
 
+	if (IS_ENABLED(CONFIG_PROFILER_NORDIC_RING_BUFFER)) {
+		profiler_ring_init();
+	}
+
 	protocol_thread_id =  k_thread_create(&profiler_nordic_thread,
 			profiler_nordic_stack,
 			K_THREAD_STACK_SIZEOF(profiler_nordic_stack),
@@ -179,7 +191,9 @@ u16_t profiler_register_event_type(const char *name, const char **args,
 	 * from multiple threads
 	 */
 	k_sched_lock();
-	u8_t ne = profiler_num_events;
+	u16_t ne = profiler_num_events;
+
+	__ASSERT_NO_MSG(ne < CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS);
 	size_t temp = snprintf(descr[ne],
 			CONFIG_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS,
 			"%s,%d", name, ne);
@@ -207,6 +221,11 @@ u16_t profiler_register_event_type(const char *name, const char **args,
 		  (pos < CONFIG_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS)
 		   && (temp > 0));
 	}
+#ifndef CONFIG_SHELL
+	/* By default, when there is no shell, all events are profiled. */
+	atomic_set_bit(profiler_enabled_events, ne);
+#endif
+
 	/* Memory barrier to make sure that data is visible
 	 * before being accessed
 	 */
@@ -219,9 +238,16 @@ u16_t profiler_register_event_type(const char *name, const char **args,
 
 void profiler_log_start(struct log_event_buf *buf)
 {
-	/* Adding one to pointer to make space for event type ID */
-	__ASSERT_NO_MSG(sizeof(u8_t) <= CONFIG_PROFILER_CUSTOM_EVENT_BUF_LEN);
-	buf->payload = buf->payload_start + sizeof(u8_t);
+	if (IS_ENABLED(CONFIG_PROFILER_NORDIC_RING_BUFFER)) {
+		/* Make space for record length and event type ID */
+		buf->payload = buf->payload_start +
+			       PROFILER_RING_RECORD_HDR_LEN;
+	} else {
+		/* Adding one to pointer to make space for event type ID */
+		__ASSERT_NO_MSG(sizeof(u8_t) <=
+				CONFIG_PROFILER_CUSTOM_EVENT_BUF_LEN);
+		buf->payload = buf->payload_start + sizeof(u8_t);
+	}
 	profiler_log_encode_u32(buf, k_cycle_get_32());
 }
 
@@ -239,8 +265,28 @@ void profiler_log_add_mem_address(struct log_event_buf *buf,
 	profiler_log_encode_u32(buf, (u32_t)mem_address);
 }
 
+static void profiler_log_send_ring(struct log_event_buf *buf,
+				  u16_t event_type_id)
+{
+	__ASSERT_NO_MSG(event_type_id != PROFILER_RING_ID_OVERFLOW);
+	if (sending_events) {
+		size_t len = buf->payload - buf->payload_start;
+
+		buf->payload_start[0] = len;
+		sys_put_le16(event_type_id, &buf->payload_start[1]);
+
+		/* Dropped records are counted by the ring buffer. */
+		(void)profiler_ring_put(buf->payload_start, len);
+	}
+}
+
 void profiler_log_send(struct log_event_buf *buf, u16_t event_type_id)
 {
+	if (IS_ENABLED(CONFIG_PROFILER_NORDIC_RING_BUFFER)) {
+		profiler_log_send_ring(buf, event_type_id);
+		return;
+	}
+
 	__ASSERT_NO_MSG(event_type_id <= UCHAR_MAX);
 	if (sending_events) {
 		u8_t type_id = event_type_id & UCHAR_MAX;
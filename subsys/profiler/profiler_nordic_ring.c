@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#include <sys/atomic.h>
+#include <sys/byteorder.h>
+#include <sys/util.h>
+#include <profiler.h>
+
+#ifdef CONFIG_PROFILER_NORDIC_DRAIN_UART
+#include <drivers/uart.h>
+#else
+#include <SEGGER_RTT.h>
+#endif
+
+#include "profiler_nordic_ring.h"
+
+#define RING_SIZE CONFIG_PROFILER_NORDIC_RING_BUFFER_SIZE
+#define RING_MASK (RING_SIZE - 1)
+
+BUILD_ASSERT((RING_SIZE & RING_MASK) == 0,
+	     "Ring buffer size must be a power of two");
+BUILD_ASSERT(CONFIG_PROFILER_CUSTOM_EVENT_BUF_LEN <= UINT8_MAX,
+	     "Record length must fit in one byte");
+BUILD_ASSERT(CONFIG_PROFILER_CUSTOM_EVENT_BUF_LEN < RING_SIZE,
+	     "Ring buffer too small");
+
+/* Head and tail are free running byte counters. Producers reserve space by
+ * moving the head and commit a record by writing its length as the last
+ * byte. Unused bytes are kept zeroed, so the drain thread stops at the first
+ * record that is not committed yet.
+ */
+static struct {
+	u8_t buf[RING_SIZE];
+	atomic_t head;
+	atomic_t tail;
+	atomic_t max_used;
+	atomic_t dropped;
+	atomic_t sent;
+	atomic_t restart;
+	atomic_t restart_head;
+} ring;
+
+/* Drain thread state. */
+static u32_t discard_end;
+static u32_t last_timestamp;
+static u32_t reported_dropped;
+static bool drain_started;
+
+#ifdef CONFIG_PROFILER_NORDIC_DRAIN_UART
+static struct device *uart_dev;
+#endif
+
+static K_THREAD_STACK_DEFINE(profiler_drain_stack,
+			     CONFIG_PROFILER_NORDIC_DRAIN_STACK_SIZE);
+static struct k_thread profiler_drain_thread;
+
+
+static void ring_copy_in(u32_t pos, const u8_t *data, size_t len)
+{
+	size_t idx = pos & RING_MASK;
+	size_t first = MIN(len, RING_SIZE - idx);
+
+	memcpy(&ring.buf[idx], data, first);
+	memcpy(ring.buf, data + first, len - first);
+}
+
+static void ring_copy_out(u32_t pos, u8_t *data, size_t len)
+{
+	size_t idx = pos & RING_MASK;
+	size_t first = MIN(len, RING_SIZE - idx);
+
+	memcpy(data, &ring.buf[idx], first);
+	memcpy(data + first, ring.buf, len - first);
+}
+
+static void ring_clear(u32_t pos, size_t len)
+{
+	size_t idx = pos & RING_MASK;
+	size_t first = MIN(len, RING_SIZE - idx);
+
+	memset(&ring.buf[idx], 0, first);
+	memset(ring.buf, 0, len - first);
+}
+
+static void update_max_used(atomic_val_t used)
+{
+	atomic_val_t max_used;
+
+	do {
+		max_used = atomic_get(&ring.max_used);
+		if (used <= max_used) {
+			return;
+		}
+	} while (!atomic_cas(&ring.max_used, max_used, used));
+}
+
+bool profiler_ring_put(const u8_t *record, size_t len)
+{
+	__ASSERT_NO_MSG((len > PROFILER_RING_RECORD_HDR_LEN) &&
+			(len <= CONFIG_PROFILER_CUSTOM_EVENT_BUF_LEN));
+	__ASSERT_NO_MSG(record[0] == len);
+
+	atomic_val_t head;
+	u32_t used;
+
+	do {
+		head = atomic_get(&ring.head);
+		used = (u32_t)head - (u32_t)atomic_get(&ring.tail);
+
+		if (used + len > RING_SIZE) {
+			atomic_inc(&ring.dropped);
+			return false;
+		}
+	} while (!atomic_cas(&ring.head, head, (u32_t)head + len));
+
+	update_max_used(used + len);
+
+	ring_copy_in((u32_t)head + 1, record + 1, len - 1);
+
+	/* Make sure the record is complete before it is committed. */
+	__DMB();
+	ring.buf[(u32_t)head & RING_MASK] = record[0];
+
+	return true;
+}
+
+void profiler_ring_restart(void)
+{
+	atomic_set(&ring.restart_head, atomic_get(&ring.head));
+	atomic_set(&ring.restart, true);
+}
+
+static bool output_write(const u8_t *data, size_t len)
+{
+#ifdef CONFIG_PROFILER_NORDIC_DRAIN_UART
+	for (size_t i = 0; i < len; i++) {
+		uart_poll_out(uart_dev, data[i]);
+	}
+
+	return true;
+#else
+	/* Data channel is written only by this thread. Records are written
+	 * entirely or not at all, so the stream stays consistent when RTT
+	 * buffer is full.
+	 */
+	return SEGGER_RTT_WriteNoLock(CONFIG_PROFILER_NORDIC_RTT_CHANNEL_DATA,
+				      data, len) == len;
+#endif
+}
+
+static bool overflow_report(void)
+{
+	u32_t dropped = atomic_get(&ring.dropped);
+
+	if (dropped == reported_dropped) {
+		return true;
+	}
+
+	u8_t out[sizeof(u16_t) + PROFILER_RING_VARINT_MAX_LEN];
+	size_t pos = 0;
+
+	sys_put_le16(PROFILER_RING_ID_OVERFLOW, out);
+	pos += sizeof(u16_t);
+	pos += profiler_ring_varint_encode(dropped - reported_dropped,
+					   &out[pos]);
+
+	if (!output_write(out, pos)) {
+		return false;
+	}
+
+	reported_dropped = dropped;
+
+	return true;
+}
+
+static bool record_send(const u8_t *record, size_t len)
+{
+	u8_t out[CONFIG_PROFILER_CUSTOM_EVENT_BUF_LEN +
+		 PROFILER_RING_VARINT_MAX_LEN];
+	const u8_t *data = &record[PROFILER_RING_RECORD_HDR_LEN];
+	size_t data_len = len - PROFILER_RING_RECORD_HDR_LEN;
+	size_t pos = 0;
+
+	__ASSERT_NO_MSG(data_len >= sizeof(u32_t));
+
+	u32_t timestamp = sys_get_le32(data);
+	/* Timestamps are taken before the record is reserved, so records
+	 * may be slightly out of order and the difference may be negative.
+	 */
+	s32_t delta = timestamp - last_timestamp;
+
+	/* Event type ID is copied as is. */
+	memcpy(out, &record[1], sizeof(u16_t));
+	pos += sizeof(u16_t);
+	pos += profiler_ring_varint_encode(profiler_ring_zigzag_encode(delta),
+					   &out[pos]);
+
+	memcpy(&out[pos], data + sizeof(u32_t), data_len - sizeof(u32_t));
+	pos += data_len - sizeof(u32_t);
+
+	if (!output_write(out, pos)) {
+		return false;
+	}
+
+	last_timestamp = timestamp;
+	atomic_inc(&ring.sent);
+
+	return true;
+}
+
+static void ring_drain(void)
+{
+	u32_t tail = atomic_get(&ring.tail);
+	u32_t head = atomic_get(&ring.head);
+
+	if (atomic_cas(&ring.restart, true, false)) {
+		/* Records put before the restart belong to the previous
+		 * stream and are discarded.
+		 */
+		discard_end = atomic_get(&ring.restart_head);
+		last_timestamp = 0;
+		reported_dropped = atomic_get(&ring.dropped);
+	}
+
+	if (!overflow_report()) {
+		return;
+	}
+
+	while (tail != head) {
+		u8_t record[CONFIG_PROFILER_CUSTOM_EVENT_BUF_LEN];
+		u8_t len = ring.buf[tail & RING_MASK];
+
+		if (len == 0) {
+			/* Record is not committed yet. */
+			break;
+		}
+
+		__ASSERT_NO_MSG(len <= sizeof(record));
+		__DMB();
+
+		if ((s32_t)(discard_end - tail) <= 0) {
+			ring_copy_out(tail, record, len);
+
+			if (!record_send(record, len)) {
+				/* Output is full, retry later. */
+				break;
+			}
+		}
+
+		ring_clear(tail, len);
+		tail += len;
+
+		/* Space must be zeroed before it is released. */
+		__DMB();
+		atomic_set(&ring.tail, tail);
+	}
+}
+
+static void profiler_drain_thread_fn(void)
+{
+	while (true) {
+		ring_drain();
+		k_sleep(K_MSEC(CONFIG_PROFILER_NORDIC_DRAIN_PERIOD_MS));
+	}
+}
+
+void profiler_ring_init(void)
+{
+	if (drain_started) {
+		return;
+	}
+
+#ifdef CONFIG_PROFILER_NORDIC_DRAIN_UART
+	uart_dev = device_get_binding(CONFIG_PROFILER_NORDIC_DRAIN_UART_DEV_NAME);
+	__ASSERT_NO_MSG(uart_dev != NULL);
+#endif
+
+	k_thread_create(&profiler_drain_thread,
+			profiler_drain_stack,
+			K_THREAD_STACK_SIZEOF(profiler_drain_stack),
+			(k_thread_entry_t) profiler_drain_thread_fn,
+			NULL, NULL, NULL,
+			CONFIG_PROFILER_NORDIC_DRAIN_THREAD_PRIORITY, 0,
+			K_NO_WAIT);
+	k_thread_name_set(&profiler_drain_thread, "profiler_drain");
+
+	drain_started = true;
+}
+
+int profiler_ring_stats_get(struct profiler_ring_stats *stats)
+{
+	if (!stats) {
+		return -EINVAL;
+	}
+
+	stats->size = RING_SIZE;
+	stats->max_used = atomic_get(&ring.max_used);
+	stats->sent_events = atomic_get(&ring.sent);
+	stats->dropped_events = atomic_get(&ring.dropped);
+
+	return 0;
+}
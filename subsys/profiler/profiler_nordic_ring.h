@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+/* Nordic profiler ring buffer private header.
+ *
+ * Records put into the ring buffer have the following layout (little endian):
+ *
+ * u8_t  length of the whole record
+ * u16_t event type ID
+ * u32_t timestamp
+ * u32_t event data values
+ *
+ * The drain thread converts records to the format sent to the host:
+ *
+ * u16_t  event type ID
+ * varint zigzag encoded difference from the previous timestamp
+ * u32_t  event data values
+ *
+ * Event type ID of PROFILER_RING_ID_OVERFLOW is followed by varint number of
+ * events dropped because the ring buffer was full.
+ */
+
+#ifndef _PROFILER_NORDIC_RING_H_
+#define _PROFILER_NORDIC_RING_H_
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Size of record length and event type ID placed before the timestamp. */
+#define PROFILER_RING_RECORD_HDR_LEN 3
+
+/* Event type ID reserved for overflow reports. */
+#define PROFILER_RING_ID_OVERFLOW 0xFFFF
+
+/* Longest varint encoding of 32-bit value. */
+#define PROFILER_RING_VARINT_MAX_LEN 5
+
+/* Map signed value to unsigned one, so that values of small magnitude have
+ * short varint encoding regardless of the sign.
+ */
+static inline u32_t profiler_ring_zigzag_encode(s32_t value)
+{
+	return ((u32_t)value << 1) ^ (u32_t)(value >> 31);
+}
+
+/* Encode value as varint: 7 bits per byte, least significant group first,
+ * most significant bit set in all bytes but the last one. Returns number of
+ * bytes written to out.
+ */
+static inline size_t profiler_ring_varint_encode(u32_t value, u8_t *out)
+{
+	size_t len = 0;
+
+	while (value >= 0x80) {
+		out[len++] = (value & 0x7F) | 0x80;
+		value >>= 7;
+	}
+	out[len++] = value;
+
+	return len;
+}
+
+/* Initialize the ring buffer and start the drain thread. */
+void profiler_ring_init(void);
+
+/* Put a record into the ring buffer. The function is lock-free and can be
+ * called from interrupts. Returns false if the record was dropped.
+ */
+bool profiler_ring_put(const u8_t *record, size_t len);
+
+/* Discard records put so far and request the next sent timestamp to be
+ * encoded relative to zero, so that the host can decode a new stream.
+ */
+void profiler_ring_restart(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PROFILER_NORDIC_RING_H_ */
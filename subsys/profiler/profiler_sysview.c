@@ -9,15 +9,14 @@
 #include <kernel_structs.h>
 
 
-/* By default, when there is no shell, all events are profiled. */
 #ifndef CONFIG_SHELL
-u32_t profiler_enabled_events = 0xffffffff;
+ATOMIC_DEFINE(profiler_enabled_events, CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS);
 #endif
 
 static char descr[CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS]
 		 [CONFIG_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS];
 
-u8_t profiler_num_events;
+u16_t profiler_num_events;
 
 static char *arg_types_encodings[] = {
 					"%u",	/* u8_t */
@@ -89,6 +88,7 @@ u16_t profiler_register_event_type(const char *name, const char **args,
 	k_sched_lock();
 	u32_t ne = events.NumEvents;
 
+	__ASSERT_NO_MSG(ne < CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS);
 	size_t temp = snprintf(descr[ne],
 			CONFIG_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS,
 			"%u %s", ne, name);
@@ -107,6 +107,11 @@ u16_t profiler_register_event_type(const char *name, const char **args,
 		  && (temp > 0));
 	}
 
+#ifndef CONFIG_SHELL
+	/* By default, when there is no shell, all events are profiled. */
+	atomic_set_bit(profiler_enabled_events, ne);
+#endif
+
 	/* Memory barrier to make sure that data is visible
 	 * before being accessed
 	 */
@@ -0,0 +1,7 @@
+/* bsdlib limits, copied to simplify building the test */
+#ifndef BSD_LIMITS_H__
+#define BSD_LIMITS_H__
+
+#define BSD_MAX_SOCKET_COUNT 8
+
+#endif /* BSD_LIMITS_H__ */
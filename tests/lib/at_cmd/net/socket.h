@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+/* Subset of the socket API used by the AT command driver,
+ * implemented by the AT socket mock.
+ */
+#ifndef ZEPHYR_INCLUDE_NET_SOCKET_H_
+#define ZEPHYR_INCLUDE_NET_SOCKET_H_
+
+#include <sys/types.h>
+
+#define AF_LTE 102
+#define SOCK_DGRAM 2
+#define NPROTO_AT 513
+
+int zsock_socket(int family, int type, int proto);
+int zsock_close(int sock);
+ssize_t zsock_send(int sock, const void *buf, size_t len, int flags);
+ssize_t zsock_recv(int sock, void *buf, size_t max_len, int flags);
+
+static inline int socket(int family, int type, int proto)
+{
+	return zsock_socket(family, type, proto);
+}
+
+static inline int close(int sock)
+{
+	return zsock_close(sock);
+}
+
+static inline ssize_t send(int sock, const void *buf, size_t len, int flags)
+{
+	return zsock_send(sock, buf, len, flags);
+}
+
+static inline ssize_t recv(int sock, void *buf, size_t max_len, int flags)
+{
+	return zsock_recv(sock, buf, max_len, flags);
+}
+
+#endif /* ZEPHYR_INCLUDE_NET_SOCKET_H_ */
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+#include <zephyr.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <net/socket.h>
+
+#include "at_socket_mock.h"
+
+#define MOCK_FD 1
+#define MOCK_MSG_MAX_LEN 64
+#define MOCK_MSG_COUNT 32
+
+/* Message on its way from the modem. */
+struct mock_msg {
+	char text[MOCK_MSG_MAX_LEN];
+	s64_t due;
+	bool response;
+};
+
+K_MSGQ_DEFINE(messages, sizeof(struct mock_msg), MOCK_MSG_COUNT, 4);
+
+static K_MUTEX_DEFINE(mock_lock);
+static struct mock_at_stats stats;
+static u32_t pending;
+/* Time at which the modem has executed all commands sent so far. */
+static s64_t modem_idle;
+
+int zsock_socket(int family, int type, int proto)
+{
+	if ((family != AF_LTE) || (type != SOCK_DGRAM) ||
+	    (proto != NPROTO_AT)) {
+		errno = EAFNOSUPPORT;
+		return -1;
+	}
+
+	return MOCK_FD;
+}
+
+int zsock_close(int sock)
+{
+	return 0;
+}
+
+ssize_t zsock_send(int sock, const void *buf, size_t len, int flags)
+{
+	struct mock_msg msg = { .response = true };
+	s64_t now = k_uptime_get();
+	int err;
+
+	if ((sock != MOCK_FD) ||
+	    (len + sizeof("\r\nOK\r\n") > sizeof(msg.text))) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if ((len == strlen(MOCK_CMD_FAIL)) &&
+	    !memcmp(buf, MOCK_CMD_FAIL, len)) {
+		strcpy(msg.text, "ERROR\r\n");
+	} else {
+		snprintf(msg.text, sizeof(msg.text), "%.*s\r\nOK\r\n",
+			 (int)len, (const char *)buf);
+	}
+
+	k_mutex_lock(&mock_lock, K_FOREVER);
+
+	/* The modem executes the commands one at a time. */
+	modem_idle = MAX(modem_idle, now + MOCK_LATENCY_MS / 2) +
+		     MOCK_PROCESSING_MS;
+	msg.due = modem_idle + MOCK_LATENCY_MS / 2;
+
+	err = k_msgq_put(&messages, &msg, K_NO_WAIT);
+	if (!err) {
+		stats.commands++;
+		pending++;
+		stats.max_pending = MAX(stats.max_pending, pending);
+	}
+
+	k_mutex_unlock(&mock_lock);
+
+	if (err) {
+		errno = ENOBUFS;
+		return -1;
+	}
+
+	return len;
+}
+
+ssize_t zsock_recv(int sock, void *buf, size_t max_len, int flags)
+{
+	struct mock_msg msg;
+	s64_t now;
+	size_t len;
+
+	if (sock != MOCK_FD) {
+		errno = EBADF;
+		return -1;
+	}
+
+	k_msgq_get(&messages, &msg, K_FOREVER);
+
+	now = k_uptime_get();
+	if (msg.due > now) {
+		k_sleep(K_MSEC(msg.due - now));
+	}
+
+	if (msg.response) {
+		k_mutex_lock(&mock_lock, K_FOREVER);
+		pending--;
+		k_mutex_unlock(&mock_lock);
+	}
+
+	len = MIN(strlen(msg.text) + 1, max_len);
+	memcpy(buf, msg.text, len);
+
+	return len;
+}
+
+void mock_at_notify(const char *notif)
+{
+	struct mock_msg msg = {
+		.due = k_uptime_get(),
+		.response = false,
+	};
+
+	strncpy(msg.text, notif, sizeof(msg.text) - 1);
+
+	(void)k_msgq_put(&messages, &msg, K_NO_WAIT);
+}
+
+void mock_at_stats_get(struct mock_at_stats *out)
+{
+	k_mutex_lock(&mock_lock, K_FOREVER);
+	*out = stats;
+	k_mutex_unlock(&mock_lock);
+}
+
+void mock_at_reset(void)
+{
+	k_mutex_lock(&mock_lock, K_FOREVER);
+	memset(&stats, 0, sizeof(stats));
+	k_mutex_unlock(&mock_lock);
+}
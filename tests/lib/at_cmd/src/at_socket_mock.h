@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+#ifndef AT_SOCKET_MOCK_H_
+#define AT_SOCKET_MOCK_H_
+
+#include <zephyr/types.h>
+
+/* Round trip time between the application and the modem. */
+#define MOCK_LATENCY_MS 20
+/* Time taken by the modem to execute a command. */
+#define MOCK_PROCESSING_MS 2
+
+/* Command answered with ERROR by the mocked modem. Any other command is
+ * answered with a copy of itself, followed by OK.
+ */
+#define MOCK_CMD_FAIL "AT+FAIL"
+
+struct mock_at_stats {
+	u32_t commands;
+	u32_t max_pending; /* Maximum number of commands awaiting a response. */
+};
+
+/* Send a notification, after the responses already on their way. */
+void mock_at_notify(const char *notif);
+
+void mock_at_stats_get(struct mock_at_stats *stats);
+
+void mock_at_reset(void);
+
+#endif /* AT_SOCKET_MOCK_H_ */
@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+#include <stdio.h>
+#include <string.h>
+#include <zephyr.h>
+#include <ztest.h>
+#include <modem/at_cmd.h>
+
+#include "at_socket_mock.h"
+
+#define RESP_MAX_LEN 64
+
+#define WRITER_COUNT 4
+#define WRITER_STACK_SIZE 1024
+#define WRITER_PRIORITY K_PRIO_PREEMPT(1)
+#define WRITER_CMDS 10
+
+/* Modem queries issued by an application on boot. */
+static const char *const boot_cmds[] = {
+	"AT+CGMR", "AT+CGSN", "AT+CIMI", "AT%XICCID",
+	"AT+CFUN?", "AT+CEREG?", "AT%XSYSTEMMODE?", "AT+CGDCONT?",
+	"AT%XCBAND", "AT+CESQ", "AT%XMONITOR", "AT%XVBAT",
+	"AT%XTEMP?", "AT+CNUM", "AT+COPS?", "AT%XCONNSTAT?",
+};
+
+static struct at_cmd_batch_item batch[ARRAY_SIZE(boot_cmds)];
+static char resp[ARRAY_SIZE(boot_cmds)][RESP_MAX_LEN];
+
+static struct k_thread writer_threads[WRITER_COUNT];
+static K_THREAD_STACK_ARRAY_DEFINE(writer_stacks, WRITER_COUNT,
+				   WRITER_STACK_SIZE);
+static K_SEM_DEFINE(writers_done, 0, WRITER_COUNT);
+static atomic_t writer_errors;
+
+static char notification[RESP_MAX_LEN];
+static atomic_t notifications;
+
+/* The mocked modem answers with a copy of the command. */
+static bool resp_matches(const char *buf, const char *cmd)
+{
+	char expected[RESP_MAX_LEN];
+
+	snprintf(expected, sizeof(expected), "%s\r\n", cmd);
+
+	return strcmp(buf, expected) == 0;
+}
+
+static void notification_handler(const char *response)
+{
+	strncpy(notification, response, sizeof(notification) - 1);
+	atomic_inc(&notifications);
+}
+
+static void batch_prepare(size_t count)
+{
+	memset(batch, 0, sizeof(batch));
+	memset(resp, 0, sizeof(resp));
+
+	for (size_t i = 0; i < count; i++) {
+		batch[i].cmd = boot_cmds[i];
+		batch[i].buf = resp[i];
+		batch[i].buf_len = sizeof(resp[i]);
+	}
+}
+
+static void test_write(void)
+{
+	char buf[RESP_MAX_LEN];
+	enum at_cmd_state state;
+	int err;
+
+	err = at_cmd_write("AT+CGMR", buf, sizeof(buf), &state);
+	zassert_equal(err, 0, "Unexpected error %d", err);
+	zassert_equal(state, AT_CMD_OK, "Unexpected state %d", state);
+	zassert_true(resp_matches(buf, "AT+CGMR"), "Wrong response");
+
+	err = at_cmd_write(MOCK_CMD_FAIL, buf, sizeof(buf), &state);
+	zassert_equal(err, -ENOEXEC, "Unexpected error %d", err);
+	zassert_equal(state, AT_CMD_ERROR, "Unexpected state %d", state);
+}
+
+static void writer_fn(void *p1, void *p2, void *p3)
+{
+	int id = POINTER_TO_INT(p1);
+	char cmd[16];
+	char buf[RESP_MAX_LEN];
+	int err;
+
+	for (int i = 0; i < WRITER_CMDS; i++) {
+		snprintf(cmd, sizeof(cmd), "AT+T%d%d", id, i);
+
+		err = at_cmd_write(cmd, buf, sizeof(buf), NULL);
+		if (err || !resp_matches(buf, cmd)) {
+			atomic_inc(&writer_errors);
+		}
+	}
+
+	k_sem_give(&writers_done);
+}
+
+static void test_write_parallel(void)
+{
+	struct mock_at_stats stats;
+	int err;
+
+	mock_at_reset();
+	atomic_clear(&writer_errors);
+
+	for (int i = 0; i < WRITER_COUNT; i++) {
+		k_thread_create(&writer_threads[i], writer_stacks[i],
+				K_THREAD_STACK_SIZEOF(writer_stacks[i]),
+				writer_fn, INT_TO_POINTER(i), NULL, NULL,
+				WRITER_PRIORITY, 0, K_NO_WAIT);
+	}
+
+	for (int i = 0; i < WRITER_COUNT; i++) {
+		err = k_sem_take(&writers_done, K_SECONDS(10));
+		zassert_equal(err, 0, "Writer timed out");
+	}
+
+	mock_at_stats_get(&stats);
+
+	zassert_equal(atomic_get(&writer_errors), 0,
+		      "Responses routed to the wrong command");
+	zassert_equal(stats.commands, WRITER_COUNT * WRITER_CMDS,
+		      "Commands lost");
+#if CONFIG_AT_CMD_PIPELINE_DEPTH > 1
+	zassert_true(stats.max_pending > 1, "Commands were not pipelined");
+#endif
+	zassert_true(stats.max_pending <= CONFIG_AT_CMD_PIPELINE_DEPTH,
+		     "Too many commands awaiting a response");
+}
+
+static void test_write_batch(void)
+{
+	int err;
+
+	batch_prepare(4);
+	batch[2].cmd = MOCK_CMD_FAIL;
+	atomic_clear(&notifications);
+
+	/* The notification arrives while the batch awaits its responses. */
+	mock_at_notify("+CEREG: 5");
+
+	err = at_cmd_write_batch(batch, 4);
+	zassert_equal(err, -ENOEXEC, "Unexpected error %d", err);
+
+	for (size_t i = 0; i < 4; i++) {
+		if (i == 2) {
+			zassert_equal(batch[i].state, AT_CMD_ERROR,
+				      "Unexpected state %d", batch[i].state);
+			zassert_equal(batch[i].code, -ENOEXEC,
+				      "Unexpected error %d", batch[i].code);
+			continue;
+		}
+
+		zassert_equal(batch[i].state, AT_CMD_OK,
+			      "Unexpected state %d", batch[i].state);
+		zassert_equal(batch[i].code, 0,
+			      "Unexpected error %d", batch[i].code);
+		zassert_true(resp_matches(resp[i], boot_cmds[i]),
+			     "Wrong response for %s", boot_cmds[i]);
+	}
+
+	zassert_equal(atomic_get(&notifications), 1, "Notification lost");
+	zassert_equal(strcmp(notification, "+CEREG: 5"), 0,
+		      "Wrong notification");
+
+	zassert_equal(at_cmd_write_batch(NULL, 1), -EINVAL, NULL);
+	zassert_equal(at_cmd_write_batch(batch, 0), -EINVAL, NULL);
+}
+
+static void test_boot_time(void)
+{
+	s64_t start;
+	s64_t serial;
+	s64_t batched;
+	int err;
+
+	start = k_uptime_get();
+
+	for (size_t i = 0; i < ARRAY_SIZE(boot_cmds); i++) {
+		err = at_cmd_write(boot_cmds[i], resp[i], sizeof(resp[i]),
+				   NULL);
+		zassert_equal(err, 0, "Unexpected error %d", err);
+	}
+
+	serial = k_uptime_delta(&start);
+
+	batch_prepare(ARRAY_SIZE(boot_cmds));
+
+	start = k_uptime_get();
+
+	err = at_cmd_write_batch(batch, ARRAY_SIZE(batch));
+	zassert_equal(err, 0, "Unexpected error %d", err);
+
+	batched = k_uptime_delta(&start);
+
+	for (size_t i = 0; i < ARRAY_SIZE(boot_cmds); i++) {
+		zassert_true(resp_matches(resp[i], boot_cmds[i]),
+			     "Wrong response for %s", boot_cmds[i]);
+	}
+
+	TC_PRINT("%d boot queries with %d ms latency: %d ms serial, "
+		 "%d ms batched\n", (int)ARRAY_SIZE(boot_cmds), MOCK_LATENCY_MS,
+		 (int)serial, (int)batched);
+
+#if CONFIG_AT_CMD_PIPELINE_DEPTH > 1
+	zassert_true(2 * batched < serial,
+		     "Pipelining did not reduce the boot time");
+#endif
+}
+
+void test_main(void)
+{
+	int err;
+
+	err = at_cmd_init();
+	zassert_equal(err, 0, "Cannot initialize at_cmd");
+
+	at_cmd_set_notification_handler(notification_handler);
+
+	ztest_test_suite(lib_at_cmd_test,
+			 ztest_unit_test(test_write),
+			 ztest_unit_test(test_write_parallel),
+			 ztest_unit_test(test_write_batch),
+			 ztest_unit_test(test_boot_time)
+			 );
+
+	ztest_run_test_suite(lib_at_cmd_test);
+}
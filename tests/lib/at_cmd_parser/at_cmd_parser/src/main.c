@@ -29,9 +29,40 @@ const char *certificate = "%CMNG: 12345678, 0, \"978C...02C4\","
 			  "...bW9aAa4"
 			  "-----END CERTIFICATE-----\"\r\n";
 
+#define BENCHMARK_PARAMS 10
+#define BENCHMARK_ROUNDS 1000
+
+const char *notifications[] = {
+	"+CEREG: 5,\"76C1\",\"0102DA04\",7,,,\"11100000\",\"11100000\"\r\n",
+	"%CESQ: 54,2,16,2\r\n",
+	"%XMONITOR: 1,\"EDAV\",\"EDAV\",\"26295\",\"00B7\",7,20,"
+	"\"00011B07\",7,2300,63,39,\"\",\"11100000\",\"00010011\"\r\n",
+};
+
 static struct at_param_list test_list;
 static struct at_param_list test_list2;
 
+AT_PARAMS_LIST_DEFINE(arena_list, BENCHMARK_PARAMS,
+		      AT_PARAMS_ARENA_SIZE(128, BENCHMARK_PARAMS));
+
+/* Count the heap allocations, see the linker options of the test. */
+static u32_t allocations;
+
+void *__real_k_malloc(size_t size);
+void *__real_k_calloc(size_t nmemb, size_t size);
+
+void *__wrap_k_malloc(size_t size)
+{
+	allocations++;
+	return __real_k_malloc(size);
+}
+
+void *__wrap_k_calloc(size_t nmemb, size_t size)
+{
+	allocations++;
+	return __real_k_calloc(nmemb, size);
+}
+
 static void test_params_fail_on_invalid_input_setup(void)
 {
 	at_params_list_init(&test_list, TEST_PARAMS);
@@ -727,6 +758,67 @@ static void test_at_cmd_test_teardown(void)
 	at_params_list_free(&test_list2);
 }
 
+/* Parse the notifications as the notification handlers do, returns the
+ * number of cycles taken.
+ */
+static u32_t notifications_parse(struct at_param_list *list, bool heap)
+{
+	u32_t start = k_cycle_get_32();
+	int ret;
+
+	for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+		for (size_t j = 0; j < ARRAY_SIZE(notifications); j++) {
+			if (heap) {
+				at_params_list_init(list, BENCHMARK_PARAMS);
+			}
+
+			ret = at_parser_params_from_str(notifications[j], NULL,
+							list);
+			zassert_true((ret == 0) || (ret == -E2BIG),
+				     "Parsing failed");
+
+			if (heap) {
+				at_params_list_free(list);
+			}
+		}
+	}
+
+	return k_cycle_get_32() - start;
+}
+
+static void test_params_arena_benchmark(void)
+{
+	static struct at_param_list heap_list;
+	u32_t heap_allocations;
+	u32_t heap_us;
+	u32_t arena_us;
+	u32_t count = BENCHMARK_ROUNDS * ARRAY_SIZE(notifications);
+	char tmpbuf[16];
+	size_t len = sizeof(tmpbuf);
+
+	allocations = 0;
+	heap_us = k_cyc_to_us_floor32(notifications_parse(&heap_list, true));
+	heap_allocations = allocations;
+
+	allocations = 0;
+	arena_us = k_cyc_to_us_floor32(notifications_parse(&arena_list,
+							    false));
+
+	TC_PRINT("%u notifications parsed\n", count);
+	TC_PRINT("Heap:  %u allocations, %u us\n", heap_allocations, heap_us);
+	TC_PRINT("Arena: %u allocations, %u us\n", allocations, arena_us);
+
+	zassert_true(heap_allocations > count, "Heap allocations not counted");
+	zassert_equal(0, allocations, "Arena list allocated memory");
+
+	/* The getters work on the arena list. */
+	zassert_equal(0, at_params_string_get(&arena_list, 4,
+					      tmpbuf, &len),
+		      "Get string should not fail");
+	zassert_equal(0, memcmp("26295", tmpbuf, len),
+		      "The string in tmpbuf should equal to 26295");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(at_cmd_parser,
@@ -757,7 +849,8 @@ void test_main(void)
 			 ztest_unit_test_setup_teardown(
 				test_at_cmd_test,
 				test_at_cmd_test_setup,
-				test_at_cmd_test_teardown)
+				test_at_cmd_test_teardown),
+			 ztest_unit_test(test_params_arena_benchmark)
 			);
 
 	ztest_run_test_suite(at_cmd_parser);
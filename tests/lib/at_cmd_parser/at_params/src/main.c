@@ -414,6 +414,71 @@ static void test_params_list_management_teardown(void)
 	at_params_list_free(&test_list);
 }
 
+static void test_params_arena(void)
+{
+	static struct at_param params[TEST_PARAMS];
+	static struct at_params_arena arena;
+	static u32_t buf[4];
+	static const char test_str[] = "Arena";
+	static const u32_t test_array[] = { 1, 2 };
+	struct at_param_list list;
+	char tmp_str[sizeof(test_str)];
+	u32_t tmp_array[ARRAY_SIZE(test_array)];
+	size_t len;
+
+	zassert_equal(-EINVAL, at_params_list_init_arena(NULL, params,
+							 TEST_PARAMS, &arena,
+							 buf, sizeof(buf)),
+		      "Init arena should return -EINVAL");
+	zassert_equal(-EINVAL, at_params_list_init_arena(&list, params,
+							 TEST_PARAMS, NULL,
+							 buf, sizeof(buf)),
+		      "Init arena should return -EINVAL");
+	zassert_equal(0, at_params_list_init_arena(&list, params,
+						   TEST_PARAMS, &arena,
+						   buf, sizeof(buf)),
+		      "Init arena should return 0");
+
+	zassert_equal(0, at_params_string_put(&list, 0, test_str,
+					      strlen(test_str)),
+		      "Put string should return 0");
+	zassert_equal(0, at_params_array_put(&list, 1, test_array,
+					     sizeof(test_array)),
+		      "Put array should return 0");
+
+	/* The padded string and the array fill the arena. */
+	zassert_equal(-ENOMEM, at_params_string_put(&list, 2, test_str, 1),
+		      "Put string should return -ENOMEM");
+
+	len = sizeof(tmp_str);
+	zassert_equal(0, at_params_string_get(&list, 0, tmp_str, &len),
+		      "Get string should return 0");
+	zassert_equal(strlen(test_str), len, "String length mismatch");
+	zassert_equal(0, memcmp(test_str, tmp_str, len), "String mismatch");
+
+	len = sizeof(tmp_array);
+	zassert_equal(0, at_params_array_get(&list, 1, tmp_array, &len),
+		      "Get array should return 0");
+	zassert_equal(sizeof(test_array), len, "Array length mismatch");
+	zassert_equal(0, memcmp(test_array, tmp_array, len),
+		      "Array mismatch");
+
+	/* Clearing the list empties the arena. */
+	at_params_list_clear(&list);
+	zassert_equal(0, at_params_valid_count_get(&list),
+		      "Params valid count should return 0");
+	zassert_equal(0, at_params_string_put(&list, 2, test_str, 1),
+		      "Put string should return 0");
+
+	/* The memory of the list is not freed. */
+	at_params_list_free(&list);
+	zassert_equal(TEST_PARAMS, list.param_count,
+		      "Params count should be the same as TEST_PARAMS");
+	zassert_equal_ptr(params, list.params, "Params should be kept");
+	zassert_equal(AT_PARAM_TYPE_INVALID, at_params_type_get(&list, 2),
+		      "Get type should return AT_PARAM_TYPE_INVALID");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(at_cmd_parser,
@@ -449,7 +514,8 @@ void test_main(void)
 			 ztest_unit_test_setup_teardown(
 					test_params_list_management,
 					test_params_list_management_setup,
-					test_params_list_management_teardown)
+					test_params_list_management_teardown),
+			 ztest_unit_test(test_params_arena)
 			);
 
 	ztest_run_test_suite(at_cmd_parser);
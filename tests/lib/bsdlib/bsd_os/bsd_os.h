@@ -0,0 +1,18 @@
+/* bsdlib OS glue interface, copied to simplify building the test */
+#ifndef BSD_OS_H__
+#define BSD_OS_H__
+
+#include <stdint.h>
+
+void bsd_os_init(void);
+int32_t bsd_os_timedwait(uint32_t context, int32_t *timeout);
+void bsd_os_errno_set(int errno_val);
+void bsd_os_application_irq_set(void);
+void bsd_os_application_irq_clear(void);
+void bsd_os_application_irq_handler(void);
+void bsd_os_trace_irq_set(void);
+void bsd_os_trace_irq_clear(void);
+void bsd_os_trace_irq_handler(void);
+int32_t bsd_os_trace_put(const uint8_t * const data, uint32_t len);
+
+#endif /* BSD_OS_H__ */
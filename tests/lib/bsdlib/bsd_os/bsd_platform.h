@@ -0,0 +1,8 @@
+/* bsdlib platform definitions for the test platform */
+#ifndef BSD_PLATFORM_H__
+#define BSD_PLATFORM_H__
+
+#define BSD_APPLICATION_IRQ 30
+#define BSD_APPLICATION_IRQ_PRIORITY 6
+
+#endif /* BSD_PLATFORM_H__ */
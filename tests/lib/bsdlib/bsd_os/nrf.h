@@ -0,0 +1,7 @@
+/* nRF definitions used by bsd_os.c, mapped to the test platform */
+#ifndef NRF_H__
+#define NRF_H__
+
+#define EGU2_IRQn 31
+
+#endif /* NRF_H__ */
@@ -0,0 +1,42 @@
+/* bsdlib error codes, copied to simplify building the test */
+#ifndef NRF_ERRNO_H__
+#define NRF_ERRNO_H__
+
+#define NRF_EPERM 1
+#define NRF_ENOENT 2
+#define NRF_EIO 5
+#define NRF_ENOEXEC 8
+#define NRF_EBADF 9
+#define NRF_EAGAIN 11
+#define NRF_ENOMEM 12
+#define NRF_EACCES 13
+#define NRF_EFAULT 14
+#define NRF_EINVAL 22
+#define NRF_EMFILE 24
+#define NRF_EDOM 33
+#define NRF_EMSGSIZE 90
+#define NRF_EPROTOTYPE 91
+#define NRF_ENOPROTOOPT 92
+#define NRF_EPROTONOSUPPORT 93
+#define NRF_ESOCKTNOSUPPORT 94
+#define NRF_EOPNOTSUPP 95
+#define NRF_EAFNOSUPPORT 97
+#define NRF_EADDRINUSE 98
+#define NRF_ENETDOWN 100
+#define NRF_ENETUNREACH 101
+#define NRF_ENETRESET 102
+#define NRF_ECONNRESET 104
+#define NRF_ENOBUFS 105
+#define NRF_EISCONN 106
+#define NRF_ENOTCONN 107
+#define NRF_ETIMEDOUT 110
+#define NRF_EHOSTDOWN 112
+#define NRF_EALREADY 114
+#define NRF_EINPROGRESS 115
+#define NRF_ECANCELED 125
+#define NRF_ENOKEY 126
+#define NRF_EKEYEXPIRED 127
+#define NRF_EKEYREVOKED 128
+#define NRF_EKEYREJECTED 129
+
+#endif /* NRF_ERRNO_H__ */
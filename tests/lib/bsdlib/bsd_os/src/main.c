@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+#include <zephyr.h>
+#include <ztest.h>
+#include <bsd_os.h>
+#include <nrf_errno.h>
+
+/* More threads than the thread monitor table has entries. */
+#define WAITER_COUNT 12
+#define WAITER_STACK_SIZE 512
+#define WAITER_PRIORITY K_PRIO_PREEMPT(1)
+
+#define ROUNDS 500
+#define WAKEUP_TIMEOUT K_MSEC(500)
+
+/* A thread blocked in a bsdlib call, such as recv() on a socket.
+ * Like bsdlib, it checks whether its context is ready and waits otherwise.
+ */
+struct waiter {
+	u32_t context;
+	atomic_t ready;
+	u32_t ready_time; /* Cycle count at which the context became ready. */
+	struct k_sem done;
+};
+
+static struct waiter waiters[WAITER_COUNT];
+static struct k_thread waiter_threads[WAITER_COUNT];
+static K_THREAD_STACK_ARRAY_DEFINE(waiter_stacks, WAITER_COUNT,
+				   WAITER_STACK_SIZE);
+
+static atomic_t wakeups;
+static atomic_t spurious_wakeups;
+static u32_t latency_sum;
+static u32_t latency_max;
+
+void bsd_os_application_irq_handler(void)
+{
+}
+
+void bsd_os_trace_irq_handler(void)
+{
+}
+
+void IPC_IRQHandler(void)
+{
+}
+
+static void waiter_fn(void *p1, void *p2, void *p3)
+{
+	struct waiter *waiter = p1;
+	int32_t timeout;
+	int32_t err;
+	u32_t latency;
+
+	while (true) {
+		while (!atomic_get(&waiter->ready)) {
+			timeout = -1;
+			err = bsd_os_timedwait(waiter->context, &timeout);
+			zassert_equal(err, 0, "Unexpected error %d", err);
+
+			atomic_inc(&wakeups);
+			if (!atomic_get(&waiter->ready)) {
+				atomic_inc(&spurious_wakeups);
+			}
+		}
+
+		latency = k_cycle_get_32() - waiter->ready_time;
+		latency_sum += latency;
+		latency_max = MAX(latency_max, latency);
+
+		atomic_clear(&waiter->ready);
+		k_sem_give(&waiter->done);
+	}
+}
+
+static void stats_reset(void)
+{
+	atomic_clear(&wakeups);
+	atomic_clear(&spurious_wakeups);
+	latency_sum = 0;
+	latency_max = 0;
+}
+
+static void stats_print(u32_t events, u32_t ready)
+{
+	TC_PRINT("%u events for %u contexts: %u wakeups, %u spurious\n",
+		 events, ready, (u32_t)atomic_get(&wakeups),
+		 (u32_t)atomic_get(&spurious_wakeups));
+	TC_PRINT("Wakeup latency: %u us average, %u us max\n",
+		 k_cyc_to_us_floor32(latency_sum / ready),
+		 k_cyc_to_us_floor32(latency_max));
+}
+
+static void context_ready(struct waiter *waiter)
+{
+	waiter->ready_time = k_cycle_get_32();
+	atomic_set(&waiter->ready, 1);
+}
+
+static void test_wakeup_one(void)
+{
+	struct waiter *waiter;
+	int err;
+
+	stats_reset();
+
+	for (u32_t i = 0; i < ROUNDS; i++) {
+		waiter = &waiters[i % WAITER_COUNT];
+
+		context_ready(waiter);
+		bsd_os_application_irq_set();
+
+		err = k_sem_take(&waiter->done, WAKEUP_TIMEOUT);
+		zassert_equal(err, 0, "Wakeup of context %u lost",
+			      waiter->context);
+	}
+
+	stats_print(ROUNDS, ROUNDS);
+
+	zassert_true(atomic_get(&wakeups) >= ROUNDS, "Too few wakeups");
+}
+
+static void test_wakeup_all(void)
+{
+	int err;
+
+	stats_reset();
+
+	/* One event makes every context ready. */
+	for (u32_t i = 0; i < ROUNDS / WAITER_COUNT; i++) {
+		for (size_t j = 0; j < WAITER_COUNT; j++) {
+			context_ready(&waiters[j]);
+		}
+
+		bsd_os_application_irq_set();
+
+		for (size_t j = 0; j < WAITER_COUNT; j++) {
+			err = k_sem_take(&waiters[j].done, WAKEUP_TIMEOUT);
+			zassert_equal(err, 0, "Wakeup of context %u lost",
+				      waiters[j].context);
+		}
+	}
+
+	stats_print(ROUNDS / WAITER_COUNT,
+		    (ROUNDS / WAITER_COUNT) * WAITER_COUNT);
+}
+
+static void test_timeout(void)
+{
+	int32_t timeout = 50;
+	int32_t err;
+	s64_t start = k_uptime_get();
+
+	/* The first wait of a thread returns to let bsdlib check again. */
+	while ((err = bsd_os_timedwait(0, &timeout)) == 0) {
+		zassert_true(k_uptime_get() - start < 100, "Timeout missed");
+	}
+
+	zassert_equal(err, NRF_ETIMEDOUT, "Unexpected error %d", err);
+	zassert_equal(timeout, 0, "Timeout not updated");
+}
+
+void test_main(void)
+{
+	bsd_os_init();
+
+	for (size_t i = 0; i < WAITER_COUNT; i++) {
+		waiters[i].context = i + 1;
+		k_sem_init(&waiters[i].done, 0, 1);
+
+		k_thread_create(&waiter_threads[i], waiter_stacks[i],
+				K_THREAD_STACK_SIZEOF(waiter_stacks[i]),
+				waiter_fn, &waiters[i], NULL, NULL,
+				WAITER_PRIORITY, 0, K_NO_WAIT);
+	}
+
+	ztest_test_suite(lib_bsd_os_test,
+			 ztest_unit_test(test_wakeup_one),
+			 ztest_unit_test(test_wakeup_all),
+			 ztest_unit_test(test_timeout)
+			 );
+
+	ztest_run_test_suite(lib_bsd_os_test);
+}
@@ -0,0 +1,156 @@
+/* bsdlib socket interface, reduced to what nrf91_sockets.c uses */
+#ifndef NRF_SOCKET_H__
+#define NRF_SOCKET_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#define NRF_AF_UNSPEC 0
+#define NRF_AF_LOCAL 1
+#define NRF_AF_INET 2
+#define NRF_AF_PACKET 5
+#define NRF_AF_INET6 10
+#define NRF_AF_LTE 102
+
+#define NRF_SOCK_STREAM 1
+#define NRF_SOCK_DGRAM 2
+#define NRF_SOCK_RAW 3
+#define NRF_SOCK_MGMT 512
+
+#define NRF_IPPROTO_TCP 6
+#define NRF_IPPROTO_UDP 17
+#define NRF_SPROTO_TLS1v2 260
+#define NRF_SPROTO_TLS1v3 261
+#define NRF_SPROTO_DTLS1v2 270
+#define NRF_PROTO_AT 513
+#define NRF_PROTO_PDN 514
+#define NRF_PROTO_DFU 515
+
+#define NRF_SOL_SOCKET 1
+#define NRF_SOL_SECURE 282
+#define NRF_SOL_DFU 515
+#define NRF_SOL_PDN 514
+
+#define NRF_SO_REUSEADDR 2
+#define NRF_SO_ERROR 4
+#define NRF_SO_RCVTIMEO 20
+#define NRF_SO_SNDTIMEO 21
+#define NRF_SO_BINDTODEVICE 25
+#define NRF_SO_SILENCE_ALL 30
+#define NRF_SO_SILENCE_IP_ECHO_REPLY 31
+#define NRF_SO_SILENCE_IPV6_ECHO_REPLY 32
+#define NRF_SO_HOSTNAME 1
+#define NRF_SO_CIPHERSUITE_LIST 2
+#define NRF_SO_CIPHER_IN_USE 3
+#define NRF_SO_SEC_TAG_LIST 4
+#define NRF_SO_SEC_PEER_VERIFY 5
+#define NRF_SO_SEC_ROLE 6
+#define NRF_SO_SEC_SESSION_CACHE 12
+#define NRF_SO_DFU_FW_VERSION 1
+#define NRF_SO_DFU_RESOURCES 2
+#define NRF_SO_DFU_TIMEO 3
+#define NRF_SO_DFU_APPLY 4
+#define NRF_SO_DFU_REVERT 5
+#define NRF_SO_DFU_BACKUP_DELETE 6
+#define NRF_SO_DFU_OFFSET 7
+#define NRF_SO_DFU_ERROR 20
+#define NRF_SO_PDN_AF 1
+#define NRF_SO_PDN_CONTEXT_ID 2
+#define NRF_SO_PDN_STATE 3
+
+#define NRF_MSG_DONTROUTE 0x01
+#define NRF_MSG_DONTWAIT 0x02
+#define NRF_MSG_OOB 0x04
+#define NRF_MSG_PEEK 0x08
+#define NRF_MSG_WAITALL 0x10
+#define NRF_MSG_TRUNC 0x20
+
+#define NRF_POLLIN 0x01
+#define NRF_POLLOUT 0x04
+#define NRF_POLLERR 0x08
+#define NRF_POLLHUP 0x10
+#define NRF_POLLNVAL 0x20
+
+#define NRF_F_SETFL 1
+#define NRF_F_GETFL 2
+#define NRF_O_NONBLOCK 0x01
+
+typedef int nrf_socket_family_t;
+typedef uint32_t nrf_socklen_t;
+typedef uint32_t nrf_sec_session_cache_t;
+
+struct nrf_in_addr {
+	uint32_t s_addr;
+};
+
+struct nrf_in6_addr {
+	uint8_t s6_addr[16];
+};
+
+struct nrf_sockaddr {
+	uint8_t sa_len;
+	nrf_socket_family_t sa_family;
+	char sa_data[];
+};
+
+struct nrf_sockaddr_in {
+	uint8_t sin_len;
+	nrf_socket_family_t sin_family;
+	uint16_t sin_port;
+	struct nrf_in_addr sin_addr;
+};
+
+struct nrf_sockaddr_in6 {
+	uint8_t sin6_len;
+	nrf_socket_family_t sin6_family;
+	uint16_t sin6_port;
+	uint32_t sin6_flowinfo;
+	struct nrf_in6_addr sin6_addr;
+	uint32_t sin6_scope_id;
+};
+
+struct nrf_timeval {
+	uint32_t tv_sec;
+	uint32_t tv_usec;
+};
+
+struct nrf_pollfd {
+	int fd;
+	short events;
+	short revents;
+};
+
+struct nrf_addrinfo {
+	int ai_flags;
+	int ai_family;
+	int ai_socktype;
+	int ai_protocol;
+	nrf_socklen_t ai_addrlen;
+	struct nrf_sockaddr *ai_addr;
+	char *ai_canonname;
+	struct nrf_addrinfo *ai_next;
+};
+
+int nrf_socket(int family, int type, int protocol);
+int nrf_close(int fd);
+ssize_t nrf_sendto(int fd, const void *message, size_t length, int flags,
+		   const void *dest_addr, nrf_socklen_t dest_len);
+ssize_t nrf_recvfrom(int fd, void *buffer, size_t length, int flags,
+		     void *address, nrf_socklen_t *address_len);
+int nrf_bind(int fd, const void *address, nrf_socklen_t address_len);
+int nrf_listen(int fd, int backlog);
+int nrf_accept(int fd, void *address, nrf_socklen_t *address_len);
+int nrf_connect(int fd, const void *address, nrf_socklen_t address_len);
+int nrf_setsockopt(int fd, int level, int option_name,
+		   const void *option_value, nrf_socklen_t option_len);
+int nrf_getsockopt(int fd, int level, int option_name, void *option_value,
+		   nrf_socklen_t *option_len);
+int nrf_fcntl(int fd, int cmd, int flags);
+int nrf_poll(struct nrf_pollfd *fds, uint32_t nfds, int timeout);
+int nrf_getaddrinfo(const char *nodename, const char *servname,
+		    const struct nrf_addrinfo *hints,
+		    struct nrf_addrinfo **res);
+void nrf_freeaddrinfo(struct nrf_addrinfo *ai);
+
+#endif /* NRF_SOCKET_H__ */
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+#include <zephyr.h>
+#include <ztest.h>
+#include <net/socket.h>
+#include <fcntl.h>
+
+#include "nrf_socket_mock.h"
+
+#define PUBLISHER_COUNT 2 /* Of each kind. */
+#define PUBLISHER_STACK_SIZE 1024
+#define PUBLISHER_PRIORITY K_PRIO_PREEMPT(1)
+#define MESSAGES 50
+
+/* An MQTT PUBLISH packet is sent as its fields: the fixed header, the topic
+ * length, the topic, the packet identifier and the payload. The packet does
+ * not fit into a sendmsg buffer, so it cannot be sent in one sendto call.
+ */
+#define MQTT_FIXED_HEADER_LEN 3
+#define MQTT_TOPIC_LEN 40
+#define MQTT_PAYLOAD_LEN 100
+#define MQTT_MSG_LEN (MQTT_FIXED_HEADER_LEN + 2 + MQTT_TOPIC_LEN + 2 + \
+		      MQTT_PAYLOAD_LEN)
+#define MQTT_PARTS 5
+
+/* Parts are coalesced into full buffers instead of being sent one by one. */
+#define MQTT_SENDTO_CALLS \
+	ceiling_fraction(MQTT_MSG_LEN, CONFIG_BSD_LIBRARY_SENDMSG_BUF_SIZE)
+
+BUILD_ASSERT(MQTT_MSG_LEN > CONFIG_BSD_LIBRARY_SENDMSG_BUF_SIZE,
+	     "MQTT packet must not fit into a sendmsg buffer");
+BUILD_ASSERT(MQTT_SENDTO_CALLS < MQTT_PARTS,
+	     "MQTT packet parts cannot be coalesced");
+
+/* A CoAP request is sent as the header with the token, the options and
+ * the payload, in one datagram that does not fit into a sendmsg buffer.
+ */
+#define COAP_HEADER_LEN 12
+#define COAP_OPTIONS_LEN 21
+#define COAP_PAYLOAD_LEN 200
+#define COAP_MSG_LEN (COAP_HEADER_LEN + COAP_OPTIONS_LEN + COAP_PAYLOAD_LEN)
+
+struct publisher {
+	int type;
+	struct k_sem done;
+	int err;
+};
+
+static struct publisher publishers[2 * PUBLISHER_COUNT];
+static struct k_thread publisher_threads[2 * PUBLISHER_COUNT];
+static K_THREAD_STACK_ARRAY_DEFINE(publisher_stacks, 2 * PUBLISHER_COUNT,
+				   PUBLISHER_STACK_SIZE);
+static K_SEM_DEFINE(start, 0, 2 * PUBLISHER_COUNT);
+
+/* Intermediate buffers of sendmsg. */
+extern struct k_mem_slab sendmsg_slab;
+
+static u8_t data[MAX(MQTT_MSG_LEN, COAP_MSG_LEN)];
+
+static ssize_t mqtt_send(int fd, int flags)
+{
+	u8_t *topic = data + MQTT_FIXED_HEADER_LEN + 2;
+	u8_t *payload = topic + MQTT_TOPIC_LEN + 2;
+	struct iovec iov[MQTT_PARTS] = {
+		{ .iov_base = data, .iov_len = MQTT_FIXED_HEADER_LEN },
+		{ .iov_base = topic - 2, .iov_len = 2 },
+		{ .iov_base = topic, .iov_len = MQTT_TOPIC_LEN },
+		{ .iov_base = payload - 2, .iov_len = 2 },
+		{ .iov_base = payload, .iov_len = MQTT_PAYLOAD_LEN },
+	};
+	struct msghdr msg = {
+		.msg_iov = iov,
+		.msg_iovlen = ARRAY_SIZE(iov),
+	};
+
+	return sendmsg(fd, &msg, flags);
+}
+
+static int mqtt_publish(int fd)
+{
+	return mqtt_send(fd, 0) == MQTT_MSG_LEN ? 0 : -EIO;
+}
+
+static int coap_publish(int fd)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(5683),
+	};
+	struct iovec iov[] = {
+		{ .iov_base = data, .iov_len = COAP_HEADER_LEN },
+		{ .iov_base = data + COAP_HEADER_LEN,
+		  .iov_len = COAP_OPTIONS_LEN },
+		{ .iov_base = data + COAP_HEADER_LEN + COAP_OPTIONS_LEN,
+		  .iov_len = COAP_PAYLOAD_LEN },
+	};
+	struct msghdr msg = {
+		.msg_name = &addr,
+		.msg_namelen = sizeof(addr),
+		.msg_iov = iov,
+		.msg_iovlen = ARRAY_SIZE(iov),
+	};
+
+	return sendmsg(fd, &msg, 0) == COAP_MSG_LEN ? 0 : -EIO;
+}
+
+static void publisher_fn(void *p1, void *p2, void *p3)
+{
+	struct publisher *publisher = p1;
+	int fd;
+
+	if (publisher->type == SOCK_STREAM) {
+		fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	} else {
+		fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	}
+
+	publisher->err = (fd < 0) ? -errno : 0;
+
+	k_sem_take(&start, K_FOREVER);
+
+	for (int i = 0; (i < MESSAGES) && !publisher->err; i++) {
+		if (publisher->type == SOCK_STREAM) {
+			publisher->err = mqtt_publish(fd);
+		} else {
+			publisher->err = coap_publish(fd);
+		}
+	}
+
+	if (fd >= 0) {
+		close(fd);
+	}
+
+	k_sem_give(&publisher->done);
+}
+
+static void test_sendmsg_throughput(void)
+{
+	struct mock_socket_stats stats;
+	u32_t calls = 0;
+	u32_t bytes = 0;
+	u32_t busy_ms = 0;
+	s64_t start_time;
+	s64_t elapsed;
+	int err;
+
+	mock_socket_reset();
+
+	for (size_t i = 0; i < ARRAY_SIZE(publishers); i++) {
+		publishers[i].type = (i < PUBLISHER_COUNT) ?
+				     SOCK_STREAM : SOCK_DGRAM;
+		k_sem_init(&publishers[i].done, 0, 1);
+
+		k_thread_create(&publisher_threads[i], publisher_stacks[i],
+				K_THREAD_STACK_SIZEOF(publisher_stacks[i]),
+				publisher_fn, &publishers[i], NULL, NULL,
+				PUBLISHER_PRIORITY, 0, K_NO_WAIT);
+	}
+
+	/* Let the publishers open their sockets. */
+	k_sleep(K_MSEC(10));
+
+	start_time = k_uptime_get();
+
+	for (size_t i = 0; i < ARRAY_SIZE(publishers); i++) {
+		k_sem_give(&start);
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(publishers); i++) {
+		err = k_sem_take(&publishers[i].done, K_SECONDS(10));
+		zassert_equal(err, 0, "Publisher %d timed out", i);
+		zassert_equal(publishers[i].err, 0, "Publisher %d failed", i);
+	}
+
+	elapsed = k_uptime_delta(&start_time);
+
+	for (int i = 0; i < PUBLISHER_COUNT; i++) {
+		mock_socket_stats_get(SOCK_STREAM, i, &stats);
+		zassert_equal(stats.bytes, MESSAGES * MQTT_MSG_LEN,
+			      "MQTT data lost");
+		zassert_equal(stats.calls, MESSAGES * MQTT_SENDTO_CALLS,
+			      "MQTT packet parts not coalesced");
+		calls += stats.calls;
+		bytes += stats.bytes;
+		busy_ms += stats.busy_ms;
+
+		mock_socket_stats_get(SOCK_DGRAM, i, &stats);
+		zassert_equal(stats.calls, MESSAGES, "CoAP datagram split");
+		zassert_equal(stats.min_len, COAP_MSG_LEN,
+			      "CoAP datagram split");
+		zassert_equal(stats.max_len, COAP_MSG_LEN,
+			      "CoAP datagram split");
+		calls += stats.calls;
+		bytes += stats.bytes;
+		busy_ms += stats.busy_ms;
+	}
+
+	TC_PRINT("%u bytes in %u sendto calls, %u ms: %u B/s\n",
+		 bytes, calls, (u32_t)elapsed,
+		 (u32_t)(bytes * MSEC_PER_SEC / MAX(elapsed, 1)));
+
+	/* Sockets wait for the modem in parallel. */
+	zassert_true(elapsed < busy_ms / 2, "Sockets were serialized");
+}
+
+static void test_sendmsg_nonblocking(void)
+{
+	void *bufs[CONFIG_BSD_LIBRARY_SENDMSG_BUF_COUNT];
+	ssize_t ret;
+	int fd;
+	int err;
+
+	mock_socket_reset();
+
+	fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(fd >= 0, "Cannot open socket");
+
+	/* All intermediate buffers are used by other sockets. */
+	for (size_t i = 0; i < ARRAY_SIZE(bufs); i++) {
+		err = k_mem_slab_alloc(&sendmsg_slab, &bufs[i], K_NO_WAIT);
+		zassert_equal(err, 0, "Cannot take sendmsg buffer");
+	}
+
+	ret = mqtt_send(fd, MSG_DONTWAIT);
+	zassert_equal(ret, -1, "MSG_DONTWAIT sendmsg blocked");
+	zassert_equal(errno, EAGAIN, "Wrong error");
+
+	err = fcntl(fd, F_SETFL, O_NONBLOCK);
+	zassert_equal(err, 0, "Cannot set socket non-blocking");
+
+	ret = mqtt_send(fd, 0);
+	zassert_equal(ret, -1, "Non-blocking sendmsg blocked");
+	zassert_equal(errno, EAGAIN, "Wrong error");
+
+	for (size_t i = 0; i < ARRAY_SIZE(bufs); i++) {
+		k_mem_slab_free(&sendmsg_slab, &bufs[i]);
+	}
+
+	ret = mqtt_send(fd, 0);
+	zassert_equal(ret, MQTT_MSG_LEN, "Cannot send when buffer is free");
+
+	close(fd);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(lib_nrf91_sockets_test,
+			 ztest_unit_test(test_sendmsg_throughput),
+			 ztest_unit_test(test_sendmsg_nonblocking)
+			 );
+
+	ztest_run_test_suite(lib_nrf91_sockets_test);
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+#include <zephyr.h>
+#include <string.h>
+#include <nrf_socket.h>
+#include <bsd_limits.h>
+#include <nrf_errno.h>
+
+#include "nrf_socket_mock.h"
+
+/* bsdlib sockets standing in for the modem. */
+static struct mock_socket {
+	bool open;
+	int type;
+	int flags;
+	struct mock_socket_stats stats;
+} sockets[BSD_MAX_SOCKET_COUNT];
+
+static K_MUTEX_DEFINE(mock_lock);
+
+void mock_socket_reset(void)
+{
+	memset(sockets, 0, sizeof(sockets));
+}
+
+void mock_socket_stats_get(int type, int index,
+			   struct mock_socket_stats *stats)
+{
+	for (int sd = 0; sd < ARRAY_SIZE(sockets); sd++) {
+		if ((sockets[sd].type == type) && (index-- == 0)) {
+			*stats = sockets[sd].stats;
+			return;
+		}
+	}
+
+	memset(stats, 0, sizeof(*stats));
+}
+
+int nrf_socket(int family, int type, int protocol)
+{
+	int sd;
+
+	k_mutex_lock(&mock_lock, K_FOREVER);
+
+	for (sd = 0; sd < ARRAY_SIZE(sockets); sd++) {
+		if (!sockets[sd].open) {
+			sockets[sd].open = true;
+			sockets[sd].type = type;
+			sockets[sd].stats.min_len = UINT32_MAX;
+			break;
+		}
+	}
+
+	k_mutex_unlock(&mock_lock);
+
+	if (sd == ARRAY_SIZE(sockets)) {
+		errno = ENOBUFS;
+		return -1;
+	}
+
+	return sd;
+}
+
+int nrf_close(int fd)
+{
+	sockets[fd].open = false;
+
+	return 0;
+}
+
+ssize_t nrf_sendto(int fd, const void *message, size_t length, int flags,
+		   const void *dest_addr, nrf_socklen_t dest_len)
+{
+	struct mock_socket_stats *stats = &sockets[fd].stats;
+	s64_t start = k_uptime_get();
+
+	/* The calling thread waits for the modem, others can run. */
+	k_sleep(K_MSEC(MOCK_SENDTO_LATENCY_MS));
+
+	stats->busy_ms += k_uptime_delta(&start);
+
+	stats->calls++;
+	stats->bytes += length;
+	stats->min_len = MIN(stats->min_len, length);
+	stats->max_len = MAX(stats->max_len, length);
+
+	return length;
+}
+
+ssize_t nrf_recvfrom(int fd, void *buffer, size_t length, int flags,
+		     void *address, nrf_socklen_t *address_len)
+{
+	errno = EOPNOTSUPP;
+	return -1;
+}
+
+int nrf_bind(int fd, const void *address, nrf_socklen_t address_len)
+{
+	return 0;
+}
+
+int nrf_listen(int fd, int backlog)
+{
+	return 0;
+}
+
+int nrf_accept(int fd, void *address, nrf_socklen_t *address_len)
+{
+	errno = EOPNOTSUPP;
+	return -1;
+}
+
+int nrf_connect(int fd, const void *address, nrf_socklen_t address_len)
+{
+	return 0;
+}
+
+int nrf_setsockopt(int fd, int level, int option_name,
+		   const void *option_value, nrf_socklen_t option_len)
+{
+	return 0;
+}
+
+int nrf_getsockopt(int fd, int level, int option_name, void *option_value,
+		   nrf_socklen_t *option_len)
+{
+	errno = EOPNOTSUPP;
+	return -1;
+}
+
+int nrf_fcntl(int fd, int cmd, int flags)
+{
+	switch (cmd) {
+	case NRF_F_SETFL:
+		sockets[fd].flags = flags;
+		return 0;
+
+	case NRF_F_GETFL:
+		return sockets[fd].flags;
+
+	default:
+		errno = EINVAL;
+		return -1;
+	}
+}
+
+int nrf_poll(struct nrf_pollfd *fds, uint32_t nfds, int timeout)
+{
+	return 0;
+}
+
+int nrf_getaddrinfo(const char *nodename, const char *servname,
+		    const struct nrf_addrinfo *hints,
+		    struct nrf_addrinfo **res)
+{
+	return NRF_EAFNOSUPPORT;
+}
+
+void nrf_freeaddrinfo(struct nrf_addrinfo *ai)
+{
+}
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef NRF_SOCKET_MOCK_H_
+#define NRF_SOCKET_MOCK_H_
+
+#include <zephyr/types.h>
+
+/* Time spent by the modem in each sendto call. */
+#define MOCK_SENDTO_LATENCY_MS 2
+
+struct mock_socket_stats {
+	u32_t calls;
+	u32_t bytes;
+	u32_t min_len;
+	u32_t max_len;
+	u32_t busy_ms; /* Time spent in sendto calls. */
+};
+
+/* Get the sendto statistics of the n-th socket of the given type. */
+void mock_socket_stats_get(int type, int index,
+			   struct mock_socket_stats *stats);
+
+void mock_socket_reset(void);
+
+#endif /* NRF_SOCKET_MOCK_H_ */
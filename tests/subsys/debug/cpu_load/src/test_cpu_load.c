@@ -84,10 +84,138 @@ void test_cpu_load(void)
 	zassert_true(load < SMALL_LOAD, "Unexpected load:%d", load);
 }
 
+#ifdef CONFIG_CPU_LOAD_ATTRIBUTION
+#define BUSY_THREAD_STACK_SIZE 512
+#define BUSY_THREAD_PRIORITY 5
+#define BUSY_THREAD_TIME_US 10000
+#define BUSY_IRQ_TIME_US 2000
+
+#ifdef CONFIG_SOC_NRF9160
+#define BUSY_IRQN EGU0_IRQn
+#else
+#define BUSY_IRQN SWI0_EGU0_IRQn
+#endif
+
+static K_THREAD_STACK_DEFINE(busy_thread_stack, BUSY_THREAD_STACK_SIZE);
+static struct k_thread busy_thread;
+static K_SEM_DEFINE(busy_sem, 0, 1);
+
+static void busy_thread_fn(void)
+{
+	k_busy_wait(BUSY_THREAD_TIME_US);
+	k_sem_give(&busy_sem);
+}
+
+static void busy_isr(void *arg)
+{
+	k_busy_wait(BUSY_IRQ_TIME_US);
+}
+
+static const struct cpu_load_ctx *thread_ctx_find(
+		const struct cpu_load_ctx *ctxs, size_t cnt,
+		const struct k_thread *thread)
+{
+	for (size_t i = 0; i < cnt; i++) {
+		if ((ctxs[i].type == CPU_LOAD_CTX_THREAD) &&
+		    (ctxs[i].id.thread == thread)) {
+			return &ctxs[i];
+		}
+	}
+
+	return NULL;
+}
+
+static const struct cpu_load_ctx *irq_ctx_find(
+		const struct cpu_load_ctx *ctxs, size_t cnt, u16_t irq)
+{
+	for (size_t i = 0; i < cnt; i++) {
+		if ((ctxs[i].type == CPU_LOAD_CTX_IRQ) &&
+		    (ctxs[i].id.irq == irq)) {
+			return &ctxs[i];
+		}
+	}
+
+	return NULL;
+}
+
+void test_cpu_load_attribution(void)
+{
+	struct cpu_load_ctx ctxs[CONFIG_CPU_LOAD_ATTRIBUTION_THREADS + 4];
+	const struct cpu_load_ctx *ctx;
+	u32_t load;
+	int cnt;
+
+	IRQ_CONNECT(BUSY_IRQN, 1, busy_isr, NULL, 0);
+	irq_enable(BUSY_IRQN);
+
+	cnt = cpu_load_init();
+	zassert_equal(cnt, 0, "Unexpected err:%d", cnt);
+
+	cpu_load_reset();
+
+	k_thread_create(&busy_thread, busy_thread_stack,
+			K_THREAD_STACK_SIZEOF(busy_thread_stack),
+			(k_thread_entry_t)busy_thread_fn,
+			NULL, NULL, NULL,
+			BUSY_THREAD_PRIORITY, 0, K_NO_WAIT);
+	k_thread_name_set(&busy_thread, "busy");
+
+	NVIC_SetPendingIRQ(BUSY_IRQN);
+
+	cnt = k_sem_take(&busy_sem, K_SECONDS(1));
+	zassert_equal(cnt, 0, "Busy thread hanged");
+
+	cnt = cpu_load_breakdown_get(ctxs, ARRAY_SIZE(ctxs));
+	zassert_true(cnt > 0, "Unexpected cnt:%d", cnt);
+
+	for (size_t i = 1; i < cnt; i++) {
+		zassert_true(ctxs[i - 1].load >= ctxs[i].load,
+			     "Breakdown not sorted");
+	}
+
+	/* Busy thread was running for most of the time. */
+	ctx = thread_ctx_find(ctxs, cnt, &busy_thread);
+	zassert_not_null(ctx, "Busy thread not found");
+	zassert_true(ctx->load > SMALL_LOAD, "Unexpected load:%d", ctx->load);
+	if (IS_ENABLED(CONFIG_THREAD_NAME) &&
+	    IS_ENABLED(CONFIG_THREAD_MONITOR)) {
+		zassert_equal(strcmp(ctx->name, "busy"), 0,
+			      "Unexpected name:%s", ctx->name);
+	}
+	load = ctx->load;
+
+	ctx = irq_ctx_find(ctxs, cnt, BUSY_IRQN);
+	zassert_not_null(ctx, "Busy interrupt not found");
+	zassert_true(ctx->load > 0, "Unexpected load:%d", ctx->load);
+	zassert_true(ctx->load < load, "Unexpected load:%d", ctx->load);
+
+	/* Load of all contexts cannot exceed the total load. */
+	load = 0;
+	for (size_t i = 0; i < cnt; i++) {
+		load += ctxs[i].load;
+	}
+	zassert_true(load <= FULL_LOAD, "Unexpected load:%d", load);
+
+	irq_disable(BUSY_IRQN);
+
+	cpu_load_reset();
+	cnt = cpu_load_breakdown_get(ctxs, ARRAY_SIZE(ctxs));
+	zassert_true(cnt >= 0, "Unexpected cnt:%d", cnt);
+	zassert_is_null(thread_ctx_find(ctxs, cnt, &busy_thread),
+			"Breakdown not reset");
+}
+#else
+void test_cpu_load_attribution(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_CPU_LOAD_ATTRIBUTION */
+
 void test_main(void)
 {
 	ztest_test_suite(cpu_load,
-		ztest_unit_test(test_cpu_load)
+		ztest_unit_test(test_cpu_load),
+		ztest_unit_test(test_cpu_load_attribution)
 	);
 	ztest_run_test_suite(cpu_load);
 }
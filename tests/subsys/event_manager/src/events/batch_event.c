@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include "batch_event.h"
+
+
+static bool coalesce_delta_event(struct event_header *queued,
+				 const struct event_header *eh)
+{
+	struct delta_event *queued_event = cast_delta_event(queued);
+	const struct delta_event *event = cast_delta_event(eh);
+
+	queued_event->delta += event->delta;
+	queued_event->merged_cnt += event->merged_cnt;
+
+	return true;
+}
+
+EVENT_TYPE_DEFINE(batch_event,
+		  false,
+		  NULL,
+		  NULL);
+
+EVENT_TYPE_COALESCE_DEFINE(delta_event,
+			   EVENT_DISPATCH_CLASS_NORMAL,
+			   coalesce_delta_event,
+			   false,
+			   NULL,
+			   NULL);
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef _BATCH_EVENT_H_
+#define _BATCH_EVENT_H_
+
+/**
+ * @brief Batch and Coalescing Events
+ * @defgroup batch_event Batch and Coalescing Events
+ * @{
+ */
+
+#include "event_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct batch_event {
+	struct event_header header;
+
+	int val;
+};
+
+EVENT_TYPE_DECLARE(batch_event);
+
+struct delta_event {
+	struct event_header header;
+
+	int delta;
+	int merged_cnt;
+};
+
+EVENT_TYPE_DECLARE(delta_event);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _BATCH_EVENT_H_ */
@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include "bench_event.h"
+
+
+EVENT_TYPE_DEFINE(bench_single_event,
+		  false,
+		  NULL,
+		  NULL);
+
+EVENT_TYPE_DEFINE(bench_multi_event,
+		  false,
+		  NULL,
+		  NULL);
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef _BENCH_EVENT_H_
+#define _BENCH_EVENT_H_
+
+/**
+ * @brief Dispatch Benchmark Events
+ * @defgroup bench_event Dispatch Benchmark Events
+ * @{
+ */
+
+#include "event_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Event with a single listener. */
+struct bench_single_event {
+	struct event_header header;
+};
+
+EVENT_TYPE_DECLARE(bench_single_event);
+
+/* Event with listeners on all priority levels. */
+struct bench_multi_event {
+	struct event_header header;
+};
+
+EVENT_TYPE_DECLARE(bench_multi_event);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _BENCH_EVENT_H_ */
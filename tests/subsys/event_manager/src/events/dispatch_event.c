@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include "dispatch_event.h"
+
+
+EVENT_TYPE_CLASS_DEFINE(realtime_event,
+			EVENT_DISPATCH_CLASS_REALTIME,
+			false,
+			NULL,
+			NULL);
+
+EVENT_TYPE_CLASS_DEFINE(background_event,
+			EVENT_DISPATCH_CLASS_BACKGROUND,
+			false,
+			NULL,
+			NULL);
@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include "latency_event.h"
+
+
+EVENT_TYPE_DEFINE(latency_event,
+		  false,
+		  NULL,
+		  NULL);
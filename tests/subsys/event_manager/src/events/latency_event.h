@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef _LATENCY_EVENT_H_
+#define _LATENCY_EVENT_H_
+
+/**
+ * @brief Latency Event
+ * @defgroup latency_event Latency Event
+ * @{
+ */
+
+#include "event_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct latency_event {
+	struct event_header header;
+
+	bool check;
+};
+
+EVENT_TYPE_DECLARE(latency_event);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _LATENCY_EVENT_H_ */
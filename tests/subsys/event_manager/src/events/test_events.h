@@ -27,6 +27,13 @@ enum test_id {
 	TEST_SUBSCRIBER_ORDER,
 	TEST_OOM_RESET,
 	TEST_MULTICONTEXT,
+	TEST_EVENT_POOL,
+	TEST_EVENT_POOL_BENCHMARK,
+	TEST_DISPATCH_CLASSES,
+	TEST_DISPATCH_BENCHMARK,
+	TEST_EVENT_BATCH,
+	TEST_EVENT_COALESCE,
+	TEST_EVENT_LATENCY,
 
 	TEST_CNT
 };
@@ -59,6 +59,64 @@ static void test_multicontext(void)
 	test_start(TEST_MULTICONTEXT);
 }
 
+static void test_event_pool(void)
+{
+	if (!IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_EVENT_POOL)) {
+		ztest_test_skip();
+	}
+
+	test_start(TEST_EVENT_POOL);
+}
+
+static void test_event_pool_benchmark(void)
+{
+	if (!IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_EVENT_POOL)) {
+		ztest_test_skip();
+	}
+
+	test_start(TEST_EVENT_POOL_BENCHMARK);
+}
+
+static void test_dispatch_classes(void)
+{
+	if (!IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_DISPATCH_CLASSES)) {
+		ztest_test_skip();
+	}
+
+	test_start(TEST_DISPATCH_CLASSES);
+}
+
+static void test_dispatch_benchmark(void)
+{
+	/* Collecting statistics adds to the cost of every dispatched event,
+	 * so the benchmark runs only in scenarios without statistics.
+	 */
+	if (IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_QUEUE_STATS)) {
+		ztest_test_skip();
+	}
+
+	test_start(TEST_DISPATCH_BENCHMARK);
+}
+
+static void test_event_batch(void)
+{
+	test_start(TEST_EVENT_BATCH);
+}
+
+static void test_event_coalesce(void)
+{
+	test_start(TEST_EVENT_COALESCE);
+}
+
+static void test_event_latency(void)
+{
+	if (!IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_LATENCY_STATS)) {
+		ztest_test_skip();
+	}
+
+	test_start(TEST_EVENT_LATENCY);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(event_manager_tests,
@@ -68,7 +126,14 @@ void test_main(void)
 			 ztest_unit_test(test_event_order),
 			 ztest_unit_test(test_subs_order),
 			 ztest_unit_test(test_oom_reset),
-			 ztest_unit_test(test_multicontext)
+			 ztest_unit_test(test_multicontext),
+			 ztest_unit_test(test_event_pool),
+			 ztest_unit_test(test_event_pool_benchmark),
+			 ztest_unit_test(test_dispatch_classes),
+			 ztest_unit_test(test_dispatch_benchmark),
+			 ztest_unit_test(test_event_batch),
+			 ztest_unit_test(test_event_coalesce),
+			 ztest_unit_test(test_event_latency)
 			 );
 
 	ztest_run_test_suite(event_manager_tests);
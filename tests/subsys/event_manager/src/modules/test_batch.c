@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <test_events.h>
+#include <batch_event.h>
+
+#define MODULE test_batch
+#define BATCH_EVENT_CNT 8
+#define DELTA_EVENT_CNT 5
+
+
+static enum test_id cur_test_id;
+static int batch_cnt;
+static int delta_cnt;
+
+
+static void end_test(void)
+{
+	struct test_end_event *et = new_test_end_event();
+
+	et->test_id = cur_test_id;
+	EVENT_SUBMIT(et);
+}
+
+static void start_batch_test(void)
+{
+	struct event_header *ehs[BATCH_EVENT_CNT];
+
+	for (size_t i = 0; i < ARRAY_SIZE(ehs); i++) {
+		struct batch_event *event = new_batch_event();
+
+		event->val = i;
+		ehs[i] = &event->header;
+	}
+
+	EVENT_SUBMIT_BATCH(ehs, ARRAY_SIZE(ehs));
+}
+
+static void delta_event_send(int delta)
+{
+	struct delta_event *event = new_delta_event();
+
+	event->delta = delta;
+	event->merged_cnt = 1;
+	EVENT_SUBMIT(event);
+}
+
+static void start_coalesce_test(void)
+{
+	event_manager_queue_stats_reset();
+
+	/* Events are submitted from the thread processing events, so none
+	 * of them is dispatched before this function returns. Delta events
+	 * are merged unless separated by another event.
+	 */
+	for (int i = 1; i <= DELTA_EVENT_CNT; i++) {
+		delta_event_send(i);
+	}
+
+	struct batch_event *event = new_batch_event();
+
+	event->val = 0;
+	EVENT_SUBMIT(event);
+
+	for (int i = 1; i <= DELTA_EVENT_CNT; i++) {
+		delta_event_send(-i);
+	}
+}
+
+static void check_coalesce_stats(void)
+{
+	struct event_queue_stats stats;
+	size_t queue_idx = 0;
+
+	/* Without dispatch classes all events use a single queue. */
+	if (IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_DISPATCH_CLASSES)) {
+		queue_idx = EVENT_DISPATCH_CLASS_NORMAL;
+	}
+
+	int err = event_manager_queue_stats_get(queue_idx, &stats);
+
+	zassert_equal(err, 0, "Cannot get queue statistics");
+	zassert_equal(stats.coalesced, 2 * (DELTA_EVENT_CNT - 1),
+		      "Wrong number of coalesced events");
+}
+
+static void handle_delta_event(const struct delta_event *event)
+{
+	int sum = DELTA_EVENT_CNT * (DELTA_EVENT_CNT + 1) / 2;
+
+	zassert_equal(cur_test_id, TEST_EVENT_COALESCE, "Unexpected event");
+	zassert_equal(event->merged_cnt, DELTA_EVENT_CNT,
+		      "Events not coalesced");
+
+	if (delta_cnt == 0) {
+		zassert_equal(batch_cnt, 0, "Wrong event order");
+		zassert_equal(event->delta, sum, "Wrong coalesced value");
+	} else {
+		zassert_equal(batch_cnt, 1, "Wrong event order");
+		zassert_equal(event->delta, -sum, "Wrong coalesced value");
+	}
+	delta_cnt++;
+
+	if (delta_cnt == 2) {
+		if (IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_QUEUE_STATS)) {
+			check_coalesce_stats();
+		}
+		end_test();
+	}
+}
+
+static void handle_batch_event(const struct batch_event *event)
+{
+	zassert_equal(event->val, batch_cnt, "Wrong event order");
+	batch_cnt++;
+
+	if ((cur_test_id == TEST_EVENT_BATCH) &&
+	    (batch_cnt == BATCH_EVENT_CNT)) {
+		end_test();
+	}
+}
+
+static bool event_handler(const struct event_header *eh)
+{
+	if (is_test_start_event(eh)) {
+		struct test_start_event *st = cast_test_start_event(eh);
+
+		cur_test_id = st->test_id;
+		batch_cnt = 0;
+		delta_cnt = 0;
+
+		switch (st->test_id) {
+		case TEST_EVENT_BATCH:
+			start_batch_test();
+			break;
+		case TEST_EVENT_COALESCE:
+			start_coalesce_test();
+			break;
+		default:
+			/* Ignore other test cases, check if proper test_id. */
+			zassert_true(st->test_id < TEST_CNT,
+				     "test_id out of range");
+			break;
+		}
+
+		return false;
+	}
+
+	if (is_batch_event(eh)) {
+		handle_batch_event(cast_batch_event(eh));
+		return false;
+	}
+
+	if (is_delta_event(eh)) {
+		handle_delta_event(cast_delta_event(eh));
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+
+	return false;
+}
+
+EVENT_LISTENER(MODULE, event_handler);
+EVENT_SUBSCRIBE(MODULE, test_start_event);
+EVENT_SUBSCRIBE(MODULE, batch_event);
+EVENT_SUBSCRIBE(MODULE, delta_event);
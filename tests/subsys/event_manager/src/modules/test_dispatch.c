@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <test_events.h>
+#include <dispatch_event.h>
+
+#define MODULE test_dispatch
+#define DISPATCH_EVENT_CNT 10
+
+
+static k_tid_t normal_thread;
+static k_tid_t realtime_thread;
+static int realtime_cnt;
+static int background_cnt;
+
+
+static void check_queue_stats(void)
+{
+	struct event_queue_stats stats;
+	int err;
+
+	zassert_equal(event_manager_queue_cnt(), EVENT_DISPATCH_CLASS_COUNT,
+		      "Wrong number of queues");
+
+	err = event_manager_queue_stats_get(EVENT_DISPATCH_CLASS_REALTIME,
+					    &stats);
+	zassert_equal(err, 0, "Cannot get queue statistics");
+	zassert_true(stats.processed >= DISPATCH_EVENT_CNT,
+		     "Processed events not counted");
+	zassert_true(stats.max_depth >= DISPATCH_EVENT_CNT,
+		     "Queue depth not counted");
+	zassert_true(stats.latency_avg_us <= stats.latency_max_us,
+		     "Invalid latency");
+
+	err = event_manager_queue_stats_get(EVENT_DISPATCH_CLASS_BACKGROUND,
+					    &stats);
+	zassert_equal(err, 0, "Cannot get queue statistics");
+	/* Event being processed is no longer counted as waiting. */
+	zassert_equal(stats.depth, 0, "Wrong queue depth");
+}
+
+static void start_dispatch_test(void)
+{
+	normal_thread = k_current_get();
+	realtime_thread = NULL;
+	realtime_cnt = 0;
+	background_cnt = 0;
+
+	/* Background events are submitted first, but realtime events
+	 * must not wait for them.
+	 */
+	for (int i = 0; i < DISPATCH_EVENT_CNT; i++) {
+		struct background_event *event = new_background_event();
+
+		event->val = i;
+		EVENT_SUBMIT(event);
+	}
+
+	for (int i = 0; i < DISPATCH_EVENT_CNT; i++) {
+		struct realtime_event *event = new_realtime_event();
+
+		event->val = i;
+		EVENT_SUBMIT(event);
+	}
+}
+
+static bool event_handler(const struct event_header *eh)
+{
+	if (is_test_start_event(eh)) {
+		struct test_start_event *st = cast_test_start_event(eh);
+
+		switch (st->test_id) {
+		case TEST_DISPATCH_CLASSES:
+			start_dispatch_test();
+			break;
+		default:
+			/* Ignore other test cases, check if proper test_id. */
+			zassert_true(st->test_id < TEST_CNT,
+				     "test_id out of range");
+			break;
+		}
+
+		return false;
+	}
+
+	if (is_realtime_event(eh)) {
+		struct realtime_event *event = cast_realtime_event(eh);
+
+		zassert_not_equal(k_current_get(), normal_thread,
+				  "Realtime event in normal thread");
+		realtime_thread = k_current_get();
+
+		zassert_equal(event->val, realtime_cnt, "Wrong event order");
+		zassert_equal(background_cnt, 0,
+			      "Realtime event delayed by background events");
+		realtime_cnt++;
+
+		return false;
+	}
+
+	if (is_background_event(eh)) {
+		struct background_event *event = cast_background_event(eh);
+
+		zassert_not_equal(k_current_get(), normal_thread,
+				  "Background event in normal thread");
+		zassert_not_equal(k_current_get(), realtime_thread,
+				  "Background event in realtime thread");
+
+		zassert_equal(event->val, background_cnt, "Wrong event order");
+		zassert_equal(realtime_cnt, DISPATCH_EVENT_CNT,
+			      "Realtime events not processed");
+		background_cnt++;
+
+		if (background_cnt == DISPATCH_EVENT_CNT) {
+			if (IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_QUEUE_STATS)) {
+				check_queue_stats();
+			}
+
+			struct test_end_event *et = new_test_end_event();
+
+			et->test_id = TEST_DISPATCH_CLASSES;
+			EVENT_SUBMIT(et);
+		}
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+
+	return false;
+}
+
+EVENT_LISTENER(MODULE, event_handler);
+EVENT_SUBSCRIBE(MODULE, test_start_event);
+EVENT_SUBSCRIBE(MODULE, realtime_event);
+EVENT_SUBSCRIBE(MODULE, background_event);
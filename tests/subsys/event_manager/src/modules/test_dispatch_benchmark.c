@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <test_events.h>
+#include <bench_event.h>
+
+#define MODULE test_dispatch_bench
+/* All events are allocated before they are processed, keep the number low
+ * to fit into event pools and heap.
+ */
+#define BENCH_EVENT_CNT 50
+/* Number of listeners subscribed to bench_multi_event. */
+#define BENCH_LISTENER_CNT 8
+
+
+static u32_t start_cycles;
+static u32_t single_cycles;
+static int single_cnt;
+static int multi_cnt;
+static int listener_calls;
+
+
+static void submit_events(bool multi)
+{
+	start_cycles = k_cycle_get_32();
+
+	for (size_t i = 0; i < BENCH_EVENT_CNT; i++) {
+		if (multi) {
+			struct bench_multi_event *event = new_bench_multi_event();
+
+			EVENT_SUBMIT(event);
+		} else {
+			struct bench_single_event *event = new_bench_single_event();
+
+			EVENT_SUBMIT(event);
+		}
+	}
+}
+
+static void print_results(u32_t multi_cycles)
+{
+	u64_t single_ns = k_cyc_to_ns_floor64(single_cycles);
+	u64_t multi_ns = k_cyc_to_ns_floor64(multi_cycles);
+	u32_t event_ns = single_ns / BENCH_EVENT_CNT;
+	u32_t listener_ns = 0;
+
+	if (multi_ns > single_ns) {
+		listener_ns = (multi_ns - single_ns) /
+			      (BENCH_EVENT_CNT * (BENCH_LISTENER_CNT - 1));
+	}
+
+	TC_PRINT("Event dispatch [ns]:\n");
+	TC_PRINT("  event with single listener: %u\n", event_ns);
+	TC_PRINT("  additional listener: %u\n", listener_ns);
+}
+
+static bool bench_listener(const struct event_header *eh)
+{
+	listener_calls++;
+
+	return false;
+}
+
+static bool bench_single_handler(const struct event_header *eh)
+{
+	if (is_test_start_event(eh)) {
+		struct test_start_event *st = cast_test_start_event(eh);
+
+		if (st->test_id == TEST_DISPATCH_BENCHMARK) {
+			single_cnt = 0;
+			multi_cnt = 0;
+			listener_calls = 0;
+			submit_events(false);
+		} else {
+			/* Ignore other test cases, check if proper test_id. */
+			zassert_true(st->test_id < TEST_CNT,
+				     "test_id out of range");
+		}
+
+		return false;
+	}
+
+	if (is_bench_single_event(eh)) {
+		single_cnt++;
+		if (single_cnt == BENCH_EVENT_CNT) {
+			single_cycles = k_cycle_get_32() - start_cycles;
+			submit_events(true);
+		}
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+
+	return false;
+}
+
+static bool bench_multi_handler(const struct event_header *eh)
+{
+	if (is_bench_multi_event(eh)) {
+		multi_cnt++;
+		if (multi_cnt == BENCH_EVENT_CNT) {
+			u32_t multi_cycles = k_cycle_get_32() - start_cycles;
+
+			zassert_equal(listener_calls,
+				      BENCH_EVENT_CNT * (BENCH_LISTENER_CNT - 1),
+				      "Listener not notified");
+			print_results(multi_cycles);
+
+			struct test_end_event *et = new_test_end_event();
+
+			et->test_id = TEST_DISPATCH_BENCHMARK;
+			EVENT_SUBMIT(et);
+		}
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+
+	return false;
+}
+
+EVENT_LISTENER(MODULE, bench_single_handler);
+EVENT_SUBSCRIBE(MODULE, test_start_event);
+EVENT_SUBSCRIBE(MODULE, bench_single_event);
+
+/* Listeners on all priority levels, the last one counts events. */
+EVENT_LISTENER(bench_l1, bench_listener);
+EVENT_SUBSCRIBE_EARLY(bench_l1, bench_multi_event);
+EVENT_LISTENER(bench_l2, bench_listener);
+EVENT_SUBSCRIBE_EARLY(bench_l2, bench_multi_event);
+EVENT_LISTENER(bench_l3, bench_listener);
+EVENT_SUBSCRIBE(bench_l3, bench_multi_event);
+EVENT_LISTENER(bench_l4, bench_listener);
+EVENT_SUBSCRIBE(bench_l4, bench_multi_event);
+EVENT_LISTENER(bench_l5, bench_listener);
+EVENT_SUBSCRIBE(bench_l5, bench_multi_event);
+EVENT_LISTENER(bench_l6, bench_listener);
+EVENT_SUBSCRIBE(bench_l6, bench_multi_event);
+EVENT_LISTENER(bench_l7, bench_listener);
+EVENT_SUBSCRIBE(bench_l7, bench_multi_event);
+EVENT_LISTENER(bench_final, bench_multi_handler);
+EVENT_SUBSCRIBE_FINAL(bench_final, bench_multi_event);
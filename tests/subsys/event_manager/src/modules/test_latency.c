@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <test_events.h>
+#include <latency_event.h>
+
+#define MODULE test_latency
+#define LATENCY_EVENT_CNT 4
+#define LATENCY_BUSY_US 1000
+
+/* Index of the first bucket counting times not shorter than
+ * LATENCY_BUSY_US.
+ */
+#define LATENCY_BUSY_BUCKET 9
+
+
+static void end_test(void)
+{
+	struct test_end_event *et = new_test_end_event();
+
+	et->test_id = TEST_EVENT_LATENCY;
+	EVENT_SUBMIT(et);
+}
+
+static void latency_event_send(bool check)
+{
+	struct latency_event *event = new_latency_event();
+
+	event->check = check;
+	EVENT_SUBMIT(event);
+}
+
+static void start_latency_test(void)
+{
+	event_manager_latency_stats_reset();
+
+	/* Events are submitted from the thread processing events, so every
+	 * event waits for the events submitted before it.
+	 */
+	for (size_t i = 0; i < LATENCY_EVENT_CNT; i++) {
+		latency_event_send(false);
+	}
+
+	/* Statistics of the previous events are checked while the last
+	 * event is processed.
+	 */
+	latency_event_send(true);
+}
+
+static u32_t busy_samples_cnt(const struct event_latency_stats *stats)
+{
+	u32_t cnt = 0;
+
+	for (size_t i = LATENCY_BUSY_BUCKET;
+	     i < EVENT_LATENCY_HIST_BUCKET_CNT; i++) {
+		cnt += stats->buckets[i];
+	}
+
+	return cnt;
+}
+
+static const struct event_listener *listener_find(const char *name)
+{
+	for (const struct event_listener *el = __start_event_listeners;
+	     el != __stop_event_listeners;
+	     el++) {
+		if (!strcmp(el->name, name)) {
+			return el;
+		}
+	}
+
+	return NULL;
+}
+
+static void check_latency_stats(const struct event_header *eh)
+{
+	struct event_latency_stats wait;
+	struct event_latency_stats exec;
+	int err;
+
+	BUILD_ASSERT(BIT(LATENCY_BUSY_BUCKET) <= LATENCY_BUSY_US,
+		     "Wrong bucket");
+	BUILD_ASSERT(BIT(LATENCY_BUSY_BUCKET + 1) > LATENCY_BUSY_US,
+		     "Wrong bucket");
+
+	err = event_manager_event_latency_get(eh->type_id, &wait, &exec);
+	zassert_equal(err, 0, "Cannot get event latency");
+
+	/* Wait time of the event being processed is already counted. */
+	zassert_equal(wait.cnt, LATENCY_EVENT_CNT + 1,
+		      "Wrong number of samples");
+	zassert_equal(exec.cnt, LATENCY_EVENT_CNT, "Wrong number of samples");
+	zassert_equal(busy_samples_cnt(&exec), LATENCY_EVENT_CNT,
+		      "Wrong execution time");
+	zassert_true(exec.max_us >= LATENCY_BUSY_US, "Wrong execution time");
+	zassert_true(event_latency_percentile_us(&exec, 50) >= LATENCY_BUSY_US,
+		     "Wrong percentile");
+
+	/* This event waited for processing of all previous events. */
+	zassert_true(wait.max_us >= LATENCY_EVENT_CNT * LATENCY_BUSY_US,
+		     "Wrong wait time");
+
+	const struct event_listener *el = listener_find(STRINGIFY(MODULE));
+
+	zassert_not_null(el, "Listener not found");
+	err = event_manager_listener_latency_get(el, &exec);
+	zassert_equal(err, 0, "Cannot get listener latency");
+
+	/* Test start event is also counted. */
+	zassert_equal(exec.cnt, LATENCY_EVENT_CNT + 1,
+		      "Wrong number of samples");
+	zassert_equal(busy_samples_cnt(&exec), LATENCY_EVENT_CNT,
+		      "Wrong execution time");
+
+	event_manager_latency_stats_reset();
+	err = event_manager_event_latency_get(eh->type_id, &wait, &exec);
+	zassert_equal(err, 0, "Cannot get event latency");
+	zassert_equal(wait.cnt, 0, "Statistics not reset");
+	zassert_equal(exec.max_us, 0, "Statistics not reset");
+}
+
+static bool event_handler(const struct event_header *eh)
+{
+	if (is_test_start_event(eh)) {
+		struct test_start_event *st = cast_test_start_event(eh);
+
+		switch (st->test_id) {
+		case TEST_EVENT_LATENCY:
+			start_latency_test();
+			break;
+		default:
+			/* Ignore other test cases, check if proper test_id. */
+			zassert_true(st->test_id < TEST_CNT,
+				     "test_id out of range");
+			break;
+		}
+
+		return false;
+	}
+
+	if (is_latency_event(eh)) {
+		if (cast_latency_event(eh)->check) {
+			check_latency_stats(eh);
+			end_test();
+		} else {
+			k_busy_wait(LATENCY_BUSY_US);
+		}
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+
+	return false;
+}
+
+EVENT_LISTENER(MODULE, event_handler);
+EVENT_SUBSCRIBE(MODULE, test_start_event);
+EVENT_SUBSCRIBE(MODULE, latency_event);
@@ -11,7 +11,14 @@
 #include <data_event.h>
 
 #define MODULE test_oom
+#if defined(CONFIG_DESKTOP_EVENT_MANAGER_EVENT_POOL)
+/* Pool blocks are used before the heap, so more events are allocated
+ * before out of memory error.
+ */
+#define TEST_EVENTS_CNT 200
+#else
 #define TEST_EVENTS_CNT 100
+#endif
 
 static struct data_event *event_tab[TEST_EVENTS_CNT];
 static bool oom_error;
@@ -47,7 +54,11 @@ static bool event_handler(const struct event_header *eh)
 			 */
 			i -= 2;
 			while (i != 0) {
+#if defined(CONFIG_DESKTOP_EVENT_MANAGER_EVENT_POOL)
+				event_manager_free(event_tab[i]);
+#else
 				k_free(event_tab[i]);
+#endif
 				i--;
 			}
 
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <test_events.h>
+#include <data_event.h>
+#include <event_manager_pool.h>
+
+#define MODULE test_pool
+
+/* Index of the pool used for data_event. */
+#define SMALL_POOL_IDX		0
+#define BENCHMARK_ITERATIONS	1000
+#define BENCHMARK_BURST		8
+
+static struct data_event *event_tab[CONFIG_DESKTOP_EVENT_MANAGER_EVENT_POOL_SMALL_BLOCK_CNT];
+
+BUILD_ASSERT(ARRAY_SIZE(event_tab) >= BENCHMARK_BURST, "Too few small blocks");
+
+
+static void test_pool_stats(void)
+{
+	struct event_pool_stats before;
+	struct event_pool_stats stats;
+
+	event_pool_stats_get(SMALL_POOL_IDX, &before);
+	zassert_true(sizeof(struct data_event) <= before.block_size,
+		     "data_event does not fit into small pool block");
+
+	size_t free_cnt = before.block_cnt - before.used;
+
+	for (size_t i = 0; i < free_cnt; i++) {
+		event_tab[i] = new_data_event();
+		zassert_not_null(event_tab[i], "Event not allocated");
+	}
+
+	event_pool_stats_get(SMALL_POOL_IDX, &stats);
+	zassert_equal(stats.used, stats.block_cnt, "Wrong number of used blocks");
+	zassert_equal(stats.max_used, stats.block_cnt, "Wrong high-water mark");
+
+	/* Small pool is exhausted, next event uses bigger block or heap. */
+	struct data_event *extra = new_data_event();
+
+	zassert_not_null(extra, "Event not allocated");
+	event_pool_stats_get(SMALL_POOL_IDX, &stats);
+	zassert_equal(stats.used, stats.block_cnt, "Wrong number of used blocks");
+	zassert_equal(stats.exhausted_cnt, before.exhausted_cnt + 1,
+		      "Pool exhaustion not counted");
+	event_manager_free(extra);
+
+	for (size_t i = 0; i < free_cnt; i++) {
+		event_manager_free(event_tab[i]);
+	}
+
+	event_pool_stats_get(SMALL_POOL_IDX, &stats);
+	zassert_equal(stats.used, before.used, "Blocks not returned to pool");
+	zassert_equal(stats.max_used, stats.block_cnt,
+		      "High-water mark must not decrease");
+
+	/* Freed block is reused. */
+	struct data_event *ev = new_data_event();
+
+	event_pool_stats_get(SMALL_POOL_IDX, &stats);
+	zassert_equal(stats.used, before.used + 1, "Block not taken from pool");
+	event_manager_free(ev);
+}
+
+static u32_t cycles_to_ns_per_op(u32_t cycles, size_t ops)
+{
+	return (u32_t)(k_cyc_to_ns_floor64(cycles) / ops);
+}
+
+static void test_pool_benchmark(void)
+{
+	u32_t start;
+	u32_t pool_cycles;
+	u32_t heap_cycles;
+	u32_t pool_burst_cycles;
+	u32_t heap_burst_cycles;
+
+	start = k_cycle_get_32();
+	for (size_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		struct data_event *ev = new_data_event();
+
+		event_manager_free(ev);
+	}
+	pool_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (size_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		struct data_event *ev = k_malloc(sizeof(*ev));
+
+		zassert_not_null(ev, "Heap allocation failed");
+		k_free(ev);
+	}
+	heap_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (size_t i = 0; i < BENCHMARK_ITERATIONS / BENCHMARK_BURST; i++) {
+		for (size_t j = 0; j < BENCHMARK_BURST; j++) {
+			event_tab[j] = new_data_event();
+		}
+		for (size_t j = 0; j < BENCHMARK_BURST; j++) {
+			event_manager_free(event_tab[j]);
+		}
+	}
+	pool_burst_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (size_t i = 0; i < BENCHMARK_ITERATIONS / BENCHMARK_BURST; i++) {
+		for (size_t j = 0; j < BENCHMARK_BURST; j++) {
+			event_tab[j] = k_malloc(sizeof(struct data_event));
+			zassert_not_null(event_tab[j], "Heap allocation failed");
+		}
+		for (size_t j = 0; j < BENCHMARK_BURST; j++) {
+			k_free(event_tab[j]);
+		}
+	}
+	heap_burst_cycles = k_cycle_get_32() - start;
+
+	TC_PRINT("Event allocation and free [ns]:\n");
+	TC_PRINT("  single: pool %u, heap %u\n",
+		 cycles_to_ns_per_op(pool_cycles, BENCHMARK_ITERATIONS),
+		 cycles_to_ns_per_op(heap_cycles, BENCHMARK_ITERATIONS));
+	TC_PRINT("  burst of %u: pool %u, heap %u\n", BENCHMARK_BURST,
+		 cycles_to_ns_per_op(pool_burst_cycles, BENCHMARK_ITERATIONS),
+		 cycles_to_ns_per_op(heap_burst_cycles, BENCHMARK_ITERATIONS));
+}
+
+static bool event_handler(const struct event_header *eh)
+{
+	if (is_test_start_event(eh)) {
+		struct test_start_event *st = cast_test_start_event(eh);
+
+		switch (st->test_id) {
+		case TEST_EVENT_POOL:
+		{
+			test_pool_stats();
+
+			struct test_end_event *et = new_test_end_event();
+
+			et->test_id = st->test_id;
+			EVENT_SUBMIT(et);
+			break;
+		}
+		case TEST_EVENT_POOL_BENCHMARK:
+		{
+			test_pool_benchmark();
+
+			struct test_end_event *et = new_test_end_event();
+
+			et->test_id = st->test_id;
+			EVENT_SUBMIT(et);
+			break;
+		}
+		default:
+			/* Ignore other test cases, check if proper test_id. */
+			zassert_true(st->test_id < TEST_CNT,
+				     "test_id out of range");
+			break;
+		}
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+
+	return false;
+}
+
+EVENT_LISTENER(MODULE, event_handler);
+EVENT_SUBSCRIBE(MODULE, test_start_event);
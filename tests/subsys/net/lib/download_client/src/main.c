@@ -0,0 +1,390 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+#include <stdio.h>
+#include <string.h>
+#include <zephyr.h>
+#include <ztest.h>
+#include <net/socket.h>
+#include <net/download_client.h>
+
+#define SERVER_HOST "127.0.0.1"
+#define SERVER_PORT 8080
+#define SERVER_STACK_SIZE 2048
+#define SERVER_CHUNK_SIZE 256
+#define SERVER_QUEUE_LEN 16
+
+#define FILE_NAME "file.bin"
+#define FILE_SIZE (32 * 1024)
+
+#define LATENCY_MS 100
+#define DOWNLOAD_TIMEOUT K_SECONDS(120)
+
+/* Local HTTP server standing in for the remote server.
+ * Each response is sent a round-trip time after its request was received,
+ * so that the throughput depends on the number of pipelined requests.
+ */
+struct request {
+	size_t from;
+	size_t to;
+	s64_t due;
+};
+
+static int server_latency_ms;
+static int server_close_every;
+static K_SEM_DEFINE(server_ready, 0, 1);
+
+static struct download_client client;
+static K_SEM_DEFINE(download_done, 0, 1);
+static size_t received;
+static bool failed;
+
+static u8_t rx_bufs[2][CONFIG_DOWNLOAD_CLIENT_MAX_RESPONSE_SIZE];
+static const void *held_buf;
+
+static u8_t file_byte(size_t off)
+{
+	return (u8_t)(off ^ (off >> 8));
+}
+
+static int data_send(int fd, const void *data, size_t len)
+{
+	const u8_t *p = data;
+
+	while (len) {
+		ssize_t sent = send(fd, p, len, 0);
+
+		if (sent <= 0) {
+			return -EIO;
+		}
+
+		p += sent;
+		len -= sent;
+	}
+
+	return 0;
+}
+
+static int response_send(int fd, const struct request *req, bool close_conn)
+{
+	static char hdr[160];
+	static u8_t chunk[SERVER_CHUNK_SIZE];
+	size_t to = MIN(req->to, FILE_SIZE - 1);
+	int len;
+	int err;
+
+	len = snprintf(hdr, sizeof(hdr),
+		       "HTTP/1.1 206 Partial Content\r\n"
+		       "Content-Range: bytes %u-%u/%u\r\n"
+		       "Content-Length: %u\r\n"
+		       "%s\r\n",
+		       req->from, to, FILE_SIZE, to - req->from + 1,
+		       close_conn ? "Connection: close\r\n" : "");
+
+	err = data_send(fd, hdr, len);
+	if (err) {
+		return err;
+	}
+
+	for (size_t off = req->from; off <= to; off += sizeof(chunk)) {
+		size_t n = MIN(sizeof(chunk), to + 1 - off);
+
+		for (size_t i = 0; i < n; i++) {
+			chunk[i] = file_byte(off + i);
+		}
+
+		err = data_send(fd, chunk, n);
+		if (err) {
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+/* Parse the requests received so far, returns the number of bytes used. */
+static size_t requests_parse(char *buf, struct request *queue, size_t *cnt)
+{
+	char *start = buf;
+	char *end;
+	char *range;
+	unsigned int from;
+	unsigned int to;
+
+	while ((end = strstr(start, "\r\n\r\n")) != NULL) {
+		range = strstr(start, "Range: bytes=");
+		zassert_not_null(range, "No range in request");
+		zassert_true(range < end, "No range in request");
+		zassert_equal(sscanf(range, "Range: bytes=%u-%u", &from, &to),
+			      2, "Invalid range");
+		zassert_true(*cnt < SERVER_QUEUE_LEN, "Too many requests");
+
+		queue[*cnt].from = from;
+		queue[*cnt].to = to;
+		queue[*cnt].due = k_uptime_get() + server_latency_ms;
+		(*cnt)++;
+
+		start = end + strlen("\r\n\r\n");
+	}
+
+	return start - buf;
+}
+
+static void connection_serve(int fd)
+{
+	static char buf[512];
+	static struct request queue[SERVER_QUEUE_LEN];
+	struct pollfd pfd = {
+		.fd = fd,
+		.events = POLLIN,
+	};
+	size_t len = 0;
+	size_t cnt = 0;
+	size_t used;
+	int served = 0;
+	int timeout;
+	ssize_t rc;
+
+	while (true) {
+		timeout = -1;
+		if (cnt > 0) {
+			timeout = MAX(queue[0].due - k_uptime_get(), 0);
+		}
+
+		rc = poll(&pfd, 1, timeout);
+		zassert_true(rc >= 0, "poll() failed");
+
+		if (pfd.revents & (POLLIN | POLLHUP | POLLERR)) {
+			rc = recv(fd, buf + len, sizeof(buf) - len - 1, 0);
+			if (rc <= 0) {
+				return;
+			}
+
+			len += rc;
+			buf[len] = '\0';
+
+			used = requests_parse(buf, queue, &cnt);
+			memmove(buf, buf + used, len - used + 1);
+			len -= used;
+		}
+
+		while ((cnt > 0) && (queue[0].due <= k_uptime_get())) {
+			bool close_conn = (server_close_every != 0) &&
+				(++served % server_close_every == 0);
+
+			if (response_send(fd, &queue[0], close_conn) ||
+			    close_conn) {
+				return;
+			}
+
+			cnt--;
+			memmove(queue, queue + 1, cnt * sizeof(queue[0]));
+		}
+	}
+}
+
+static void server_thread_fn(void)
+{
+	int fd;
+	int conn;
+	int err;
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+	};
+
+	err = inet_pton(AF_INET, SERVER_HOST, &addr.sin_addr);
+	zassert_equal(err, 1, "inet_pton() failed");
+
+	fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(fd >= 0, "socket() failed");
+
+	err = bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(err, 0, "bind() failed");
+
+	err = listen(fd, 1);
+	zassert_equal(err, 0, "listen() failed");
+
+	k_sem_give(&server_ready);
+
+	while (true) {
+		conn = accept(fd, NULL, NULL);
+		if (conn < 0) {
+			continue;
+		}
+
+		connection_serve(conn);
+		close(conn);
+	}
+}
+
+K_THREAD_DEFINE(server_thread, SERVER_STACK_SIZE, server_thread_fn,
+		NULL, NULL, NULL, K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
+
+static int download_client_callback(const struct download_client_evt *evt)
+{
+	const u8_t *data;
+
+	switch (evt->id) {
+	case DOWNLOAD_CLIENT_EVT_FRAGMENT:
+		data = evt->fragment.buf;
+
+		for (size_t i = 0; i < evt->fragment.len; i++) {
+			if (data[i] != file_byte(received + i)) {
+				failed = true;
+			}
+		}
+		received += evt->fragment.len;
+
+		if (client.rx_bufs != NULL) {
+			/* Keep the last fragment until the next one arrives */
+			if (held_buf != NULL) {
+				zassert_equal(download_client_rx_buf_release(
+						&client, held_buf), 0, NULL);
+			}
+			held_buf = evt->fragment.buf;
+		}
+		break;
+
+	case DOWNLOAD_CLIENT_EVT_ERROR:
+		if ((evt->error == -ENOTCONN) || (evt->error == -ECONNRESET)) {
+			/* Let the client reconnect */
+			return 0;
+		}
+
+		failed = true;
+		k_sem_give(&download_done);
+		return evt->error;
+
+	case DOWNLOAD_CLIENT_EVT_DONE:
+		k_sem_give(&download_done);
+		break;
+
+	default:
+		failed = true;
+		break;
+	}
+
+	return 0;
+}
+
+/* Download the file, returns the throughput in bytes per second. */
+static u32_t download(u8_t pipeline_depth)
+{
+	int err;
+	s64_t start;
+	s64_t elapsed;
+	const struct download_client_cfg config = {
+		.port = SERVER_PORT,
+		.sec_tag = -1,
+		.pipeline_depth = pipeline_depth,
+	};
+
+	received = 0;
+	failed = false;
+
+	start = k_uptime_get();
+
+	err = download_client_connect(&client, SERVER_HOST, &config);
+	zassert_equal(err, 0, "Cannot connect");
+
+	err = download_client_start(&client, FILE_NAME, 0);
+	zassert_equal(err, 0, "Cannot start download");
+
+	err = k_sem_take(&download_done, DOWNLOAD_TIMEOUT);
+	zassert_equal(err, 0, "Download timed out");
+
+	elapsed = k_uptime_delta(&start);
+
+	zassert_false(failed, "Download failed");
+	zassert_equal(received, FILE_SIZE, "Invalid file size");
+
+	err = download_client_disconnect(&client);
+	zassert_equal(err, 0, "Cannot disconnect");
+
+	return (FILE_SIZE * MSEC_PER_SEC) / MAX(elapsed, 1);
+}
+
+static void test_download(void)
+{
+	server_latency_ms = 0;
+	server_close_every = 0;
+
+	download(1);
+}
+
+static void test_download_pipelined_throughput(void)
+{
+	u32_t sequential;
+	u32_t pipelined;
+
+	server_latency_ms = LATENCY_MS;
+	server_close_every = 0;
+
+	sequential = download(1);
+	pipelined = download(4);
+
+	TC_PRINT("Throughput with %d ms latency: %u B/s sequential, "
+		 "%u B/s pipelined\n", LATENCY_MS, sequential, pipelined);
+
+	zassert_true(pipelined >= 2 * sequential,
+		     "Pipelining did not increase throughput");
+}
+
+static void test_download_connection_close(void)
+{
+	/* Pipelined requests are lost when the server closes
+	 * the connection, the client must request them again.
+	 */
+	server_latency_ms = LATENCY_MS / 5;
+	server_close_every = 3;
+
+	download(4);
+}
+
+static void test_download_zero_copy(void)
+{
+	int err;
+
+	err = download_client_rx_bufs_set(&client, rx_bufs,
+					  ARRAY_SIZE(rx_bufs),
+					  sizeof(rx_bufs[0]));
+	zassert_equal(err, 0, "Cannot set receive buffers");
+
+	server_latency_ms = LATENCY_MS / 5;
+	server_close_every = 0;
+	held_buf = NULL;
+
+	download(4);
+
+	zassert_not_null(held_buf, "No fragment received");
+	err = download_client_rx_buf_release(&client, held_buf);
+	zassert_equal(err, 0, "Cannot release buffer");
+	err = download_client_rx_buf_release(&client, held_buf);
+	zassert_equal(err, -EALREADY, "Buffer released twice");
+
+	err = download_client_rx_bufs_set(&client, NULL, 0, 0);
+	zassert_equal(err, 0, "Cannot unset receive buffers");
+}
+
+void test_main(void)
+{
+	int err;
+
+	err = k_sem_take(&server_ready, K_SECONDS(1));
+	zassert_equal(err, 0, "Server not started");
+
+	err = download_client_init(&client, download_client_callback);
+	zassert_equal(err, 0, "Cannot initialize download client");
+
+	ztest_test_suite(lib_download_client_test,
+			 ztest_unit_test(test_download),
+			 ztest_unit_test(test_download_pipelined_throughput),
+			 ztest_unit_test(test_download_connection_close),
+			 ztest_unit_test(test_download_zero_copy)
+			 );
+
+	ztest_run_test_suite(lib_download_client_test);
+}
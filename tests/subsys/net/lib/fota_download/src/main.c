@@ -11,6 +11,14 @@
 #include <fw_info.h>
 #include <pm_config.h>
 #include <fota_download.h>
+#include <dfu/dfu_target.h>
+
+#if defined(CONFIG_FOTA_DOWNLOAD_CHECKPOINT)
+#include <settings/settings.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/sha256.h>
+#include "fota_download_checkpoint.h"
+#endif
 
 /* Create buffer which we will fill with strings to test with.
  * This is needed since 'dfu_ctx_Mcuboot_set_b1_file` will modify its
@@ -26,6 +34,7 @@ char buf[1024];
 #define NO_TLS -1
 #define DEFAULT_PORT 0
 #define DEFAULT_APN NULL
+#define TEST_IMG_TYPE 1
 
 /* Stubs and mocks */
 bool dfu_ctx_mcuboot_set_b1_file__s0_active;
@@ -33,24 +42,36 @@ static u32_t s0_version;
 static u32_t s1_version;
 const char *download_client_start_file;
 char *dfu_ctx_mcuboot_set_b1_file__update;
+/* Data written to the DFU target, kept across a simulated reset */
+static size_t dfu_target_offset;
+static int dfu_target_init_img_type;
+static int dfu_target_reset_cnt;
+static struct download_client *download_client;
+static download_client_callback_t download_client_callback;
+static size_t download_client_start_offset;
+static int fota_download_error_cnt;
+static int fota_download_finished_cnt;
 
-int dfu_target_init(int img_type, size_t file_size)
+int dfu_target_init(int img_type, size_t file_size, dfu_target_callback_t cb)
 {
+	dfu_target_init_img_type = img_type;
 	return 0;
 }
 
 int dfu_target_img_type(const void *const buf, size_t len)
 {
-	return 0;
+	return TEST_IMG_TYPE;
 }
 
 int dfu_target_offset_get(size_t *offset)
 {
+	*offset = dfu_target_offset;
 	return 0;
 }
 
 int dfu_target_write(const void *const buf, size_t len)
 {
+	dfu_target_offset += len;
 	return 0;
 }
 
@@ -59,6 +80,13 @@ int dfu_target_done(bool successful)
 	return 0;
 }
 
+int dfu_target_reset(void)
+{
+	dfu_target_offset = 0;
+	dfu_target_reset_cnt++;
+	return 0;
+}
+
 int download_client_disconnect(struct download_client *client)
 {
 	return 0;
@@ -68,17 +96,21 @@ int download_client_start(struct download_client *client, const char *file,
 			  size_t from)
 {
 	download_client_start_file = file;
+	download_client_start_offset = from;
 	return 0;
 }
 
 int download_client_file_size_get(struct download_client *client, size_t *size)
 {
+	*size = client->file_size;
 	return 0;
 }
 
 int download_client_init(struct download_client *client,
 			 download_client_callback_t callback)
 {
+	download_client = client;
+	download_client_callback = callback;
 	return 0;
 }
 
@@ -110,9 +142,70 @@ int dfu_ctx_mcuboot_set_b1_file(char *file, bool s0_active, char **update)
 	return 0;
 }
 
+#if defined(CONFIG_FOTA_DOWNLOAD_CHECKPOINT)
+/* Settings storage holding a single checkpoint */
+static u8_t settings_data[sizeof(struct fota_download_checkpoint)];
+static size_t settings_data_len;
+static struct settings_handler *settings_handler;
+
+int settings_subsys_init(void)
+{
+	return 0;
+}
+
+int settings_register(struct settings_handler *handler)
+{
+	settings_handler = handler;
+	return 0;
+}
+
+static ssize_t settings_data_read(void *cb_arg, void *data, size_t len)
+{
+	len = MIN(len, settings_data_len);
+	memcpy(data, settings_data, len);
+	return len;
+}
+
+int settings_load_subtree(const char *subtree)
+{
+	if (settings_data_len == 0) {
+		return 0;
+	}
+
+	return settings_handler->h_set("cp", settings_data_len,
+				       settings_data_read, NULL);
+}
+
+int settings_save_one(const char *name, const void *value, size_t val_len)
+{
+	zassert_true(val_len <= sizeof(settings_data), NULL);
+	memcpy(settings_data, value, val_len);
+	settings_data_len = val_len;
+	return 0;
+}
+
+int settings_delete(const char *name)
+{
+	settings_data_len = 0;
+	return 0;
+}
+#endif /* CONFIG_FOTA_DOWNLOAD_CHECKPOINT */
+
 /* END stubs and mocks */
 
-void client_callback(enum fota_download_evt_id evt_id) { }
+void client_callback(const struct fota_download_evt *evt)
+{
+	switch (evt->id) {
+	case FOTA_DOWNLOAD_EVT_ERROR:
+		fota_download_error_cnt++;
+		break;
+	case FOTA_DOWNLOAD_EVT_FINISHED:
+		fota_download_finished_cnt++;
+		break;
+	default:
+		break;
+	}
+}
 
 static void init(void)
 {
@@ -122,6 +215,16 @@ static void init(void)
 	zassert_equal(err, 0, NULL);
 }
 
+static void download_client_error_send(int error)
+{
+	const struct download_client_evt evt = {
+		.id = DOWNLOAD_CLIENT_EVT_ERROR,
+		.error = error,
+	};
+
+	(void)download_client_callback(&evt);
+}
+
 static void test_fota_download_start(void)
 {
 	int err;
@@ -143,6 +246,7 @@ static void test_fota_download_start(void)
 	s0_version = 2;
 	s1_version = 1;
 	expect_s0_active = true;
+	download_client_error_send(-EIO);
 	err = fota_download_start("something.com", buf, NO_TLS, DEFAULT_PORT,
 				  DEFAULT_APN);
 	zassert_equal(err, 0, NULL);
@@ -157,6 +261,7 @@ static void test_fota_download_start(void)
 	/* update set to null indicates to use original file param */
 	dfu_ctx_mcuboot_set_b1_file__update = NULL;
 	strcpy(buf, S0_S1);
+	download_client_error_send(-EIO);
 	err = fota_download_start("something.com", buf, NO_TLS, DEFAULT_PORT,
 				  DEFAULT_APN);
 	zassert_equal(err, 0, NULL);
@@ -165,17 +270,318 @@ static void test_fota_download_start(void)
 	/* update set to not null indicates to use update for file param */
 	dfu_ctx_mcuboot_set_b1_file__update = S1;
 	strcpy(buf, S0_S1);
+	download_client_error_send(-EIO);
 	err = fota_download_start("something.com", buf, NO_TLS, DEFAULT_PORT,
 				  DEFAULT_APN);
 	zassert_equal(err, 0, NULL);
 	zassert_true(strcmp(download_client_start_file, S1) == 0, NULL);
+
+	/* Only one download can be ongoing */
+	err = fota_download_start("something.com", buf, NO_TLS, DEFAULT_PORT,
+				  DEFAULT_APN);
+	zassert_equal(err, -EALREADY, NULL);
+	download_client_error_send(-EIO);
+}
+
+#if defined(CONFIG_FOTA_DOWNLOAD_CHECKPOINT)
+#define TEST_HOST "something.com"
+#define TEST_FILE "fw.bin"
+#define TEST_ETAG "\"v1\""
+#define TEST_FILE_SIZE 256
+#define TEST_FRAGMENT_SIZE 32
+/* Checkpoints are stored at 32 and 96, the interval is 64 bytes */
+#define TEST_INTERRUPTED_AT 128
+#define TEST_CHECKPOINT_OFFSET 96
+
+static u8_t test_file[TEST_FILE_SIZE];
+
+static int fragments_send(size_t from, size_t to)
+{
+	struct download_client_evt evt = {
+		.id = DOWNLOAD_CLIENT_EVT_FRAGMENT,
+	};
+	int err = 0;
+
+	for (size_t off = from; (off < to) && (err == 0);
+	     off += TEST_FRAGMENT_SIZE) {
+		evt.fragment.buf = &test_file[off];
+		evt.fragment.len = MIN(TEST_FRAGMENT_SIZE, to - off);
+		err = download_client_callback(&evt);
+	}
+
+	return err;
+}
+
+static void checkpoint_test_setup(void)
+{
+	for (size_t i = 0; i < sizeof(test_file); i++) {
+		test_file[i] = (u8_t)(i * 7);
+	}
+
+	/* Abort any download left by the previous test */
+	settings_data_len = 0;
+	if (download_client_callback != NULL) {
+		download_client_error_send(-EIO);
+	}
+
+	init();
+
+	dfu_target_offset = 0;
+	dfu_target_init_img_type = 0;
+	dfu_target_reset_cnt = 0;
+	fota_download_error_cnt = 0;
+	fota_download_finished_cnt = 0;
+	dfu_ctx_mcuboot_set_b1_file__update = NULL;
+
+	download_client->file_size = TEST_FILE_SIZE;
+	strcpy(download_client->etag, TEST_ETAG);
+}
+
+/* Download the beginning of the file, and reset. Data written to the DFU
+ * target is kept, fota_download is initialized from the stored checkpoint.
+ */
+static void download_interrupted(size_t dfu_target_kept)
+{
+	u8_t stored[sizeof(settings_data)];
+	size_t stored_len;
+	int err;
+
+	strcpy(buf, TEST_FILE);
+	err = fota_download_start(TEST_HOST, buf, NO_TLS, DEFAULT_PORT,
+				  DEFAULT_APN);
+	zassert_equal(err, 0, NULL);
+	zassert_equal(download_client_start_offset, 0, NULL);
+
+	err = fragments_send(0, TEST_INTERRUPTED_AT);
+	zassert_equal(err, 0, NULL);
+	zassert_equal(dfu_target_offset, TEST_INTERRUPTED_AT, NULL);
+	zassert_equal(settings_data_len, sizeof(settings_data),
+		      "Checkpoint not stored");
+
+	/* Reset, aborting the download deletes the checkpoint which is
+	 * restored afterwards.
+	 */
+	memcpy(stored, settings_data, sizeof(stored));
+	stored_len = settings_data_len;
+	download_client_error_send(-EIO);
+	memcpy(settings_data, stored, sizeof(stored));
+	settings_data_len = stored_len;
+	zassert_equal(fota_download_checkpoint_get()->img_type, 0, NULL);
+
+	dfu_target_offset = dfu_target_kept;
+	dfu_target_init_img_type = 0;
+	fota_download_error_cnt = 0;
+
+	/* Download is resumed from the system work queue */
+	init();
+	k_sleep(K_MSEC(100));
 }
 
+static void sha256_check(void)
+{
+	struct tc_sha256_state_struct sha;
+	u8_t expected[TC_SHA256_DIGEST_SIZE];
+	u8_t hash[TC_SHA256_DIGEST_SIZE];
+	int err;
+
+	(void)tc_sha256_init(&sha);
+	(void)tc_sha256_update(&sha, test_file, sizeof(test_file));
+	(void)tc_sha256_final(expected, &sha);
+
+	err = fota_download_sha256_get(hash);
+	zassert_equal(err, 0, "Hash not available");
+	zassert_mem_equal(hash, expected, sizeof(hash), "Wrong hash");
+}
+
+static void download_finish(void)
+{
+	const struct download_client_evt evt = {
+		.id = DOWNLOAD_CLIENT_EVT_DONE,
+	};
+	int err;
+
+	err = fragments_send(download_client_start_offset, TEST_FILE_SIZE);
+	zassert_equal(err, 0, NULL);
+
+	err = download_client_callback(&evt);
+	zassert_equal(err, 0, NULL);
+	zassert_equal(fota_download_finished_cnt, 1, NULL);
+	zassert_equal(fota_download_error_cnt, 0, NULL);
+	zassert_equal(settings_data_len, 0, "Checkpoint not deleted");
+}
+
+static void test_checkpoint_save_load(void)
+{
+	const struct fota_download_checkpoint *stored =
+		(const struct fota_download_checkpoint *)settings_data;
+	const struct fota_download_checkpoint *cp;
+
+	checkpoint_test_setup();
+	download_interrupted(TEST_CHECKPOINT_OFFSET);
+
+	zassert_equal(stored->offset, TEST_CHECKPOINT_OFFSET, NULL);
+	zassert_equal(stored->img_type, TEST_IMG_TYPE, NULL);
+	zassert_equal(stored->file_size, TEST_FILE_SIZE, NULL);
+	zassert_true(stored->hash_valid, NULL);
+	zassert_equal(strcmp(stored->host, TEST_HOST), 0, NULL);
+	zassert_equal(strcmp(stored->file, TEST_FILE), 0, NULL);
+	zassert_equal(strcmp(stored->etag, TEST_ETAG), 0, NULL);
+
+	/* Loaded after reset */
+	cp = fota_download_checkpoint_get();
+	zassert_equal(cp->offset, TEST_CHECKPOINT_OFFSET, NULL);
+	zassert_equal(cp->img_type, TEST_IMG_TYPE, NULL);
+	zassert_equal(dfu_target_init_img_type, TEST_IMG_TYPE,
+		      "DFU target not initialized when resuming");
+	zassert_equal(download_client_start_offset, TEST_CHECKPOINT_OFFSET,
+		      "Download not resumed from checkpoint");
+	zassert_equal(strcmp(download_client_start_file, TEST_FILE), 0, NULL);
+}
+
+static void test_checkpoint_sha256_resume(void)
+{
+	checkpoint_test_setup();
+	download_interrupted(TEST_CHECKPOINT_OFFSET);
+	zassert_equal(download_client_start_offset, TEST_CHECKPOINT_OFFSET,
+		      NULL);
+
+	download_finish();
+
+	zassert_equal(dfu_target_offset, TEST_FILE_SIZE, NULL);
+	sha256_check();
+}
+
+static void test_checkpoint_hash_only_gap(void)
+{
+	checkpoint_test_setup();
+	/* The DFU target has written more than the checkpoint covers */
+	download_interrupted(TEST_INTERRUPTED_AT);
+	zassert_equal(download_client_start_offset, TEST_CHECKPOINT_OFFSET,
+		      "Gap not downloaded again for hashing");
+
+	download_finish();
+
+	/* Data of the gap is hashed, but not written again */
+	zassert_equal(dfu_target_offset, TEST_FILE_SIZE,
+		      "Data written to DFU target twice");
+	sha256_check();
+}
+
+static void test_checkpoint_interrupted_resume(void)
+{
+	int err;
+
+	checkpoint_test_setup();
+
+	strcpy(buf, TEST_FILE);
+	err = fota_download_start(TEST_HOST, buf, NO_TLS, DEFAULT_PORT,
+				  DEFAULT_APN);
+	zassert_equal(err, 0, NULL);
+
+	err = fragments_send(0, TEST_INTERRUPTED_AT);
+	zassert_equal(err, 0, NULL);
+
+	/* Ongoing download is neither restarted nor resumed */
+	err = fota_download_start(TEST_HOST, buf, NO_TLS, DEFAULT_PORT,
+				  DEFAULT_APN);
+	zassert_equal(err, -EALREADY, NULL);
+	zassert_equal(download_client_start_offset, 0, NULL);
+
+	/* Socket retries run out, download is resumed from the work queue */
+	for (int i = 0; i <= CONFIG_FOTA_SOCKET_RETRIES; i++) {
+		download_client_error_send(-ECONNRESET);
+	}
+	k_sleep(K_MSEC(100));
+	zassert_equal(fota_download_error_cnt, 0, NULL);
+	zassert_equal(download_client_start_offset, TEST_INTERRUPTED_AT,
+		      "Download not resumed");
+
+	err = fota_download_start(TEST_HOST, buf, NO_TLS, DEFAULT_PORT,
+				  DEFAULT_APN);
+	zassert_equal(err, -EALREADY, NULL);
+
+	download_finish();
+
+	zassert_equal(dfu_target_offset, TEST_FILE_SIZE, NULL);
+	sha256_check();
+}
+
+static void file_changed_check(void)
+{
+	int err;
+
+	err = fragments_send(download_client_start_offset,
+			     download_client_start_offset + TEST_FRAGMENT_SIZE);
+	zassert_equal(err, -ESTALE, "Changed file not detected");
+	zassert_equal(dfu_target_reset_cnt, 1, "DFU target not reset");
+	zassert_equal(fota_download_error_cnt, 1, NULL);
+	zassert_equal(fota_download_checkpoint_get()->img_type, 0, NULL);
+	zassert_equal(settings_data_len, 0, "Checkpoint not deleted");
+}
+
+static void test_checkpoint_etag_mismatch(void)
+{
+	checkpoint_test_setup();
+	download_interrupted(TEST_CHECKPOINT_OFFSET);
+
+	strcpy(download_client->etag, "\"v2\"");
+	file_changed_check();
+}
+
+static void test_checkpoint_size_mismatch(void)
+{
+	checkpoint_test_setup();
+	download_interrupted(TEST_CHECKPOINT_OFFSET);
+
+	/* Total size from the Content-Range of the resumed response */
+	download_client->file_size = 2 * TEST_FILE_SIZE;
+	file_changed_check();
+}
+
+static void test_checkpoint_offset_restart_changed(void)
+{
+	int err;
+
+	checkpoint_test_setup();
+	/* The DFU target holds the beginning of the file */
+	dfu_target_offset = TEST_CHECKPOINT_OFFSET;
+
+	strcpy(buf, TEST_FILE);
+	err = fota_download_start(TEST_HOST, buf, NO_TLS, DEFAULT_PORT,
+				  DEFAULT_APN);
+	zassert_equal(err, 0, NULL);
+
+	err = fragments_send(0, TEST_FRAGMENT_SIZE);
+	zassert_not_equal(err, 0, "First fragment not refused");
+
+	/* File changes before the download is restarted from the offset */
+	strcpy(download_client->etag, "\"v2\"");
+	k_sleep(K_MSEC(1100));
+	zassert_equal(download_client_start_offset, TEST_CHECKPOINT_OFFSET,
+		      "Download not restarted from offset");
+
+	file_changed_check();
+}
+#endif /* CONFIG_FOTA_DOWNLOAD_CHECKPOINT */
+
 void test_main(void)
 {
+#if !defined(CONFIG_FOTA_DOWNLOAD_CHECKPOINT)
 	ztest_test_suite(lib_fota_download_test,
 	     ztest_unit_test(test_fota_download_start)
 	 );
+#else
+	ztest_test_suite(lib_fota_download_test,
+	     ztest_unit_test(test_fota_download_start),
+	     ztest_unit_test(test_checkpoint_save_load),
+	     ztest_unit_test(test_checkpoint_sha256_resume),
+	     ztest_unit_test(test_checkpoint_hash_only_gap),
+	     ztest_unit_test(test_checkpoint_interrupted_resume),
+	     ztest_unit_test(test_checkpoint_etag_mismatch),
+	     ztest_unit_test(test_checkpoint_size_mismatch),
+	     ztest_unit_test(test_checkpoint_offset_restart_changed)
+	 );
+#endif
 
 	ztest_run_test_suite(lib_fota_download_test);
 }
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+/* Subset of the SEGGER RTT API used by the Nordic profiler,
+ * implemented by the RTT mock.
+ */
+#ifndef SEGGER_RTT_H
+#define SEGGER_RTT_H
+
+#define SEGGER_RTT_MODE_NO_BLOCK_SKIP 0
+
+int SEGGER_RTT_ConfigUpBuffer(unsigned int buf_idx, const char *name,
+			      void *buf, unsigned int size,
+			      unsigned int flags);
+int SEGGER_RTT_ConfigDownBuffer(unsigned int buf_idx, const char *name,
+				void *buf, unsigned int size,
+				unsigned int flags);
+unsigned int SEGGER_RTT_Read(unsigned int buf_idx, void *buf,
+			     unsigned int size);
+unsigned int SEGGER_RTT_WriteNoLock(unsigned int buf_idx, const void *buf,
+				    unsigned int len);
+
+#endif /* SEGGER_RTT_H */
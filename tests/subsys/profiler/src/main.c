@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <ztest.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/byteorder.h>
+#include <profiler.h>
+
+#include "profiler_nordic_ring.h"
+#include "rtt_mock.h"
+
+/* Encodings are also decoded by scripts/profiler/test_events.py, keep both
+ * in sync.
+ */
+struct varint_vector {
+	u32_t value;
+	u8_t len;
+	u8_t encoded[PROFILER_RING_VARINT_MAX_LEN];
+};
+
+static const struct varint_vector varint_vectors[] = {
+	{ 0, 1, { 0x00 } },
+	{ 1, 1, { 0x01 } },
+	{ 127, 1, { 0x7F } },
+	{ 128, 2, { 0x80, 0x01 } },
+	{ 300, 2, { 0xAC, 0x02 } },
+	{ 16384, 3, { 0x80, 0x80, 0x01 } },
+	{ 0x0FFFFFFF, 4, { 0xFF, 0xFF, 0xFF, 0x7F } },
+	{ 0xFFFFFFFF, 5, { 0xFF, 0xFF, 0xFF, 0xFF, 0x0F } },
+};
+
+static void test_zigzag_encode(void)
+{
+	zassert_equal(profiler_ring_zigzag_encode(0), 0, NULL);
+	zassert_equal(profiler_ring_zigzag_encode(-1), 1, NULL);
+	zassert_equal(profiler_ring_zigzag_encode(1), 2, NULL);
+	zassert_equal(profiler_ring_zigzag_encode(-2), 3, NULL);
+	zassert_equal(profiler_ring_zigzag_encode(2), 4, NULL);
+	zassert_equal(profiler_ring_zigzag_encode(INT32_MAX), 0xFFFFFFFE, NULL);
+	zassert_equal(profiler_ring_zigzag_encode(INT32_MIN), 0xFFFFFFFF, NULL);
+}
+
+static void test_zigzag_timestamp_wrap(void)
+{
+	/* Difference of timestamps is taken modulo 2^32, so a counter
+	 * overflow is encoded as a small positive value.
+	 */
+	u32_t prev = 0xFFFFFFF0;
+	u32_t next = 0x00000010;
+
+	zassert_equal(profiler_ring_zigzag_encode((s32_t)(next - prev)),
+		      0x40, NULL);
+	zassert_equal(profiler_ring_zigzag_encode((s32_t)(prev - next)),
+		      0x3F, NULL);
+}
+
+static void test_varint_encode(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(varint_vectors); i++) {
+		const struct varint_vector *v = &varint_vectors[i];
+		u8_t out[PROFILER_RING_VARINT_MAX_LEN + 1];
+		size_t len;
+
+		memset(out, 0xA5, sizeof(out));
+		len = profiler_ring_varint_encode(v->value, out);
+
+		zassert_equal(len, v->len, "Wrong length for 0x%x", v->value);
+		zassert_mem_equal(out, v->encoded, len,
+				  "Wrong encoding for 0x%x", v->value);
+		zassert_equal(out[len], 0xA5, "Write past encoding");
+	}
+}
+
+#if defined(CONFIG_PROFILER_NORDIC_RING_BUFFER)
+#define EVENT_TYPES_NUM CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS
+#define EVENT_DATA 0x12345678
+
+BUILD_ASSERT(EVENT_TYPES_NUM > UINT8_MAX,
+	     "Event type IDs must not fit in one byte");
+
+static void test_register_many_event_types(void)
+{
+	char name[CONFIG_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS];
+	u16_t last_id = EVENT_TYPES_NUM - 1;
+	u16_t id;
+
+	zassert_equal(profiler_init(), 0, NULL);
+
+	for (unsigned int i = 0; i < EVENT_TYPES_NUM; i++) {
+		snprintf(name, sizeof(name), "ev%u", i);
+		id = profiler_register_event_type(name, NULL, NULL, 0);
+		zassert_equal(id, i, "Wrong ID of event type %u", i);
+	}
+
+	zassert_equal(profiler_num_events, EVENT_TYPES_NUM,
+		      "Wrong number of event types");
+
+	snprintf(name, sizeof(name), "ev%u,%u", last_id, last_id);
+	zassert_equal(strcmp(profiler_get_event_descr(last_id), name), 0,
+		      "Wrong event description");
+	zassert_true(is_profiling_enabled(last_id), "Event not profiled");
+}
+
+static void test_send_event_type_id(void)
+{
+	struct log_event_buf buf;
+	u16_t id = EVENT_TYPES_NUM - 1;
+	u8_t out[RTT_MOCK_CHANNEL_SIZE];
+	size_t pos = sizeof(u16_t);
+	size_t len;
+
+	profiler_log_start(&buf);
+	profiler_log_encode_u32(&buf, EVENT_DATA);
+	profiler_log_send(&buf, id);
+
+	k_sleep(K_MSEC(5 * CONFIG_PROFILER_NORDIC_DRAIN_PERIOD_MS));
+
+	len = rtt_mock_data_take(CONFIG_PROFILER_NORDIC_RTT_CHANNEL_DATA, out,
+				 sizeof(out));
+	zassert_true(len > pos, "Event not sent");
+	zassert_equal(sys_get_le16(out), id, "Wrong event type ID");
+
+	/* Skip varint encoded timestamp. */
+	while ((pos < len) && (out[pos] & 0x80)) {
+		pos++;
+	}
+	pos++;
+
+	zassert_equal(len, pos + sizeof(u32_t), "Wrong event length");
+	zassert_equal(sys_get_le32(&out[pos]), EVENT_DATA,
+		      "Wrong event data");
+}
+#else
+static void test_register_many_event_types(void)
+{
+	ztest_test_skip();
+}
+
+static void test_send_event_type_id(void)
+{
+	ztest_test_skip();
+}
+#endif
+
+void test_main(void)
+{
+	ztest_test_suite(test_profiler_ring,
+			 ztest_unit_test(test_zigzag_encode),
+			 ztest_unit_test(test_zigzag_timestamp_wrap),
+			 ztest_unit_test(test_varint_encode),
+			 ztest_unit_test(test_register_many_event_types),
+			 ztest_unit_test(test_send_event_type_id)
+	);
+	ztest_run_test_suite(test_profiler_ring);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+#include <string.h>
+#include <zephyr.h>
+#include <SEGGER_RTT.h>
+
+#include "rtt_mock.h"
+
+static struct {
+	u8_t data[RTT_MOCK_CHANNEL_SIZE];
+	size_t len;
+} channels[RTT_MOCK_CHANNELS];
+
+int SEGGER_RTT_ConfigUpBuffer(unsigned int buf_idx, const char *name,
+			      void *buf, unsigned int size,
+			      unsigned int flags)
+{
+	return (buf_idx < RTT_MOCK_CHANNELS) ? 0 : -1;
+}
+
+int SEGGER_RTT_ConfigDownBuffer(unsigned int buf_idx, const char *name,
+				void *buf, unsigned int size,
+				unsigned int flags)
+{
+	return 0;
+}
+
+unsigned int SEGGER_RTT_Read(unsigned int buf_idx, void *buf,
+			     unsigned int size)
+{
+	/* No commands from the host. */
+	return 0;
+}
+
+unsigned int SEGGER_RTT_WriteNoLock(unsigned int buf_idx, const void *buf,
+				    unsigned int len)
+{
+	unsigned int written = 0;
+	int key = irq_lock();
+
+	/* Like in the no block skip mode, data is written entirely or not
+	 * at all.
+	 */
+	if ((buf_idx < RTT_MOCK_CHANNELS) &&
+	    (len <= sizeof(channels[buf_idx].data) - channels[buf_idx].len)) {
+		memcpy(&channels[buf_idx].data[channels[buf_idx].len], buf,
+		       len);
+		channels[buf_idx].len += len;
+		written = len;
+	}
+
+	irq_unlock(key);
+
+	return written;
+}
+
+size_t rtt_mock_data_take(unsigned int buf_idx, u8_t *buf, size_t size)
+{
+	size_t len;
+	int key = irq_lock();
+
+	len = MIN(size, channels[buf_idx].len);
+	memcpy(buf, channels[buf_idx].data, len);
+	channels[buf_idx].len = 0;
+
+	irq_unlock(key);
+
+	return len;
+}
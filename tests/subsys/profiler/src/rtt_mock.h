@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2020 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+#ifndef RTT_MOCK_H_
+#define RTT_MOCK_H_
+
+#include <zephyr/types.h>
+
+/* Number of up channels whose data is stored by the mock. */
+#define RTT_MOCK_CHANNELS 3
+/* Size of data stored for every up channel. */
+#define RTT_MOCK_CHANNEL_SIZE 64
+
+/* Take data written to an up channel so far. Returns number of bytes. */
+size_t rtt_mock_data_take(unsigned int buf_idx, u8_t *buf, size_t size);
+
+#endif /* RTT_MOCK_H_ */